@@ -8,6 +8,10 @@
  *   /sys/kernel/aod_voltages/mem_vddio  — MemVddio (VDD)
  *   /sys/kernel/aod_voltages/mem_vddq   — MemVddq
  *   /sys/kernel/aod_voltages/mem_vpp    — MemVpp
+ *   /sys/kernel/aod_voltages/snapshot   — all named rails, one binary struct
+ *   /sys/kernel/aod_voltages/region     — read-only mmap of the AOD region
+ *
+ * The snapshot layout is defined in aod_voltages.h.
  *
  * Offsets for the named voltages are set via module parameters after
  * identifying them from the scan output:
@@ -23,11 +27,16 @@
 #include <linux/io.h>
 #include <linux/memremap.h>
 #include <linux/string.h>
+#include <linux/mm.h>
+#include <linux/mutex.h>
+#include <linux/version.h>
+
+#include "aod_voltages.h"
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("TuxTimings");
 MODULE_DESCRIPTION("AMD AOD memory voltage reader");
-MODULE_VERSION("0.3");
+MODULE_VERSION("0.4");
 
 /*
  * Some vendors/AGESA revisions ship the AOD SSDT under different OEM Table IDs.
@@ -85,6 +94,7 @@ static const u8 aode_pattern[] = { 0x5B, 0x80, 0x41, 0x4F, 0x44, 0x45, 0x00 };
 static const u8 aodt_pattern[] = { 0x5B, 0x80, 0x41, 0x4F, 0x44, 0x54, 0x00 };
 
 static void *aod_base;          /* remapped AOD region          */
+static phys_addr_t aod_phys;
 static struct kobject *aod_kobj;
 
 /* Module parameters: byte offsets of each voltage in the AODE region.
@@ -224,6 +234,136 @@ static ssize_t raw_wcns_show(struct kobject *kobj,
     return len;
 }
 
+/*
+ * snapshot — all named rails in one struct aod_snapshot.
+ *
+ * Firmware may rewrite the region underneath us, so the rails are read
+ * until two consecutive passes agree (bounded) before the result is
+ * compared against the last one handed out for the generation counter.
+ */
+#define SNAPSHOT_PASSES 4
+
+static DEFINE_MUTEX(snap_lock);
+static u32 snap_generation;
+static u32 snap_last_mv[AOD_RAIL_COUNT];
+
+static void read_rails(const int *offs, u32 *mv)
+{
+    int i;
+
+    for (i = 0; i < AOD_RAIL_COUNT; i++)
+        mv[i] = read_mv(offs[i]);
+}
+
+static void fill_snapshot(struct aod_snapshot *s)
+{
+    int offs[AOD_RAIL_COUNT];
+    u32 mv[AOD_RAIL_COUNT];
+    int i, pass;
+
+    offs[AOD_RAIL_MEM_VDDIO] = READ_ONCE(off_vddio);
+    offs[AOD_RAIL_MEM_VDDQ]  = READ_ONCE(off_vddq);
+    offs[AOD_RAIL_MEM_VPP]   = READ_ONCE(off_vpp);
+    offs[AOD_RAIL_CPU_VDDIO] = READ_ONCE(off_cpu_vddio);
+
+    memset(s, 0, sizeof(*s));
+    s->magic         = AOD_SNAPSHOT_MAGIC;
+    s->version       = AOD_SNAPSHOT_VERSION;
+    s->size          = sizeof(*s);
+    s->region_offset = offset_in_page(aod_phys);
+    s->region_size   = AOD_REGION_SIZE;
+
+    for (i = 0; i < AOD_RAIL_COUNT; i++)
+        if (offs[i] >= 0 && offs[i] + 4 <= AOD_REGION_SIZE)
+            s->valid |= 1U << i;
+
+    read_rails(offs, s->mv);
+    for (pass = 1; pass < SNAPSHOT_PASSES; pass++) {
+        read_rails(offs, mv);
+        if (memcmp(mv, s->mv, sizeof(mv)) == 0)
+            break;
+        memcpy(s->mv, mv, sizeof(mv));
+    }
+
+    mutex_lock(&snap_lock);
+    if (memcmp(s->mv, snap_last_mv, sizeof(snap_last_mv)) != 0) {
+        memcpy(snap_last_mv, s->mv, sizeof(snap_last_mv));
+        snap_generation++;
+    }
+    s->generation = snap_generation;
+    mutex_unlock(&snap_lock);
+}
+
+/*
+ * bin_attribute callbacks took a const attribute in 6.13; read() was
+ * briefly spelled read_new() until 6.16.
+ */
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 13, 0)
+#define AOD_BIN_CONST const
+#else
+#define AOD_BIN_CONST
+#endif
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 13, 0) && \
+    LINUX_VERSION_CODE <  KERNEL_VERSION(6, 16, 0)
+#define AOD_BIN_READ read_new
+#else
+#define AOD_BIN_READ read
+#endif
+
+static ssize_t snapshot_read(struct file *filp, struct kobject *kobj,
+                             AOD_BIN_CONST struct bin_attribute *attr,
+                             char *buf, loff_t off, size_t count)
+{
+    struct aod_snapshot s;
+
+    if (!aod_base)
+        return -ENODEV;
+    if (off >= sizeof(s))
+        return 0;
+    if (count > sizeof(s) - off)
+        count = sizeof(s) - off;
+
+    fill_snapshot(&s);
+    memcpy(buf, (u8 *)&s + off, count);
+    return count;
+}
+
+/* region — the pages holding the AOD region, mapped read-only */
+static int region_mmap(struct file *filp, struct kobject *kobj,
+                       AOD_BIN_CONST struct bin_attribute *attr,
+                       struct vm_area_struct *vma)
+{
+    unsigned long len = vma->vm_end - vma->vm_start;
+
+    if (!aod_phys)
+        return -ENODEV;
+    if (vma->vm_flags & VM_WRITE)
+        return -EPERM;
+    if (vma->vm_pgoff != 0 || len > PAGE_ALIGN(attr->size))
+        return -EINVAL;
+
+#if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0)
+    vm_flags_clear(vma, VM_MAYWRITE);
+#else
+    vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+    /* Same cacheability as the kernel's MEMREMAP_WB view */
+    return remap_pfn_range(vma, vma->vm_start, PHYS_PFN(aod_phys), len,
+                           vma->vm_page_prot);
+}
+
+static struct bin_attribute snapshot_attr = {
+    .attr         = { .name = "snapshot", .mode = 0444 },
+    .size         = sizeof(struct aod_snapshot),
+    .AOD_BIN_READ = snapshot_read,
+};
+
+/* .size is set once the region's physical address is known */
+static struct bin_attribute region_attr = {
+    .attr = { .name = "region", .mode = 0400 },
+    .mmap = region_mmap,
+};
+
 static struct kobj_attribute scan_attr      = __ATTR_RO(scan);
 static struct kobj_attribute vddio_attr     = __ATTR_RO(mem_vddio);
 static struct kobj_attribute vddq_attr      = __ATTR_RO(mem_vddq);
@@ -316,6 +456,8 @@ static int __init aod_voltages_init(void)
                (unsigned long long)phys);
         return -ENOMEM;
     }
+    aod_phys = phys;
+    region_attr.size = PAGE_ALIGN(offset_in_page(phys) + AOD_REGION_SIZE);
 
     aod_kobj = kobject_create_and_add("aod_voltages", kernel_kobj);
     if (!aod_kobj) {
@@ -329,6 +471,12 @@ static int __init aod_voltages_init(void)
         return -ENOMEM;
     }
 
+    /* The binary views are optional — the text attributes still work */
+    if (sysfs_create_bin_file(aod_kobj, &snapshot_attr) != 0)
+        pr_warn("aod_voltages: snapshot attribute unavailable\n");
+    if (sysfs_create_bin_file(aod_kobj, &region_attr) != 0)
+        pr_warn("aod_voltages: region attribute unavailable\n");
+
     pr_info("aod_voltages: ready — offsets vddio=%d vddq=%d vpp=%d\n",
             off_vddio, off_vddq, off_vpp);
 
@@ -338,6 +486,8 @@ static int __init aod_voltages_init(void)
 static void __exit aod_voltages_exit(void)
 {
     if (aod_kobj) {
+        sysfs_remove_bin_file(aod_kobj, &region_attr);
+        sysfs_remove_bin_file(aod_kobj, &snapshot_attr);
         sysfs_remove_group(aod_kobj, &aod_attr_group);
         kobject_put(aod_kobj);
     }
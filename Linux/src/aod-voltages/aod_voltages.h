@@ -0,0 +1,45 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+/*
+ * aod_voltages.h — shared ABI between the aod_voltages module and backend.c
+ *
+ * /sys/kernel/aod_voltages/snapshot is a binary attribute holding one
+ * struct aod_snapshot: every named rail read in a single pass, so the
+ * values are consistent with each other, plus a generation counter that
+ * bumps whenever any of them changed since the previous read.  Userspace
+ * must check magic, version and size before use; the text attributes
+ * (mem_vddio, ...) remain for older callers and for humans.
+ *
+ * /sys/kernel/aod_voltages/region is a read-only, mmap()-only view of the
+ * pages holding the AOD region.  The region starts region_offset bytes
+ * into the mapping and is region_size bytes long.
+ */
+
+#ifndef AOD_VOLTAGES_H
+#define AOD_VOLTAGES_H
+
+#include <linux/types.h>
+
+#define AOD_SNAPSHOT_MAGIC    0x53444f41u     /* "AODS" */
+#define AOD_SNAPSHOT_VERSION  1
+
+/* Index into aod_snapshot.mv[] and bit in aod_snapshot.valid */
+enum {
+    AOD_RAIL_MEM_VDDIO,
+    AOD_RAIL_MEM_VDDQ,
+    AOD_RAIL_MEM_VPP,
+    AOD_RAIL_CPU_VDDIO,
+    AOD_RAIL_COUNT
+};
+
+struct aod_snapshot {
+    __u32 magic;
+    __u16 version;
+    __u16 size;                 /* sizeof(struct aod_snapshot)          */
+    __u32 generation;           /* bumps when any mv[] value changed    */
+    __u32 valid;                /* bit i: rail i has an offset set      */
+    __u32 mv[AOD_RAIL_COUNT];   /* millivolts, 0 where not valid        */
+    __u32 region_offset;        /* region start within the mmap view    */
+    __u32 region_size;
+};
+
+#endif /* AOD_VOLTAGES_H */
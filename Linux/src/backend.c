@@ -1,16 +1,25 @@
 #include "backend.h"
 #include "pm_table.h"
 #include "dram.h"
+#include "smu.h"
+#include "aod-voltages/aod_voltages.h"
 #include "util.h"
+#include "sensor.h"
+#include "hwmon.h"
+#include "topology.h"
+#include "smbios.h"
+#include "results.h"
+#include "profile.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <dirent.h>
 #include <ctype.h>
 #include <fcntl.h>
 #include <unistd.h>
-#include <sys/stat.h>
 #include <sys/wait.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #include <math.h>
 
 #define SMU_PATH "/sys/kernel/ryzen_smu_drv"
@@ -25,23 +34,50 @@
 static void run_shell(const char *cmd) { int r = system(cmd); (void)r; }
 
 /* ── Cached static data ─────────────────────────────────────────────── */
+
+/* Firmware-derived info: SMBIOS, AGESA and BCLK.  Filled by the static
+ * worker (or the on-disk cache) and copied out by the consumer; BCLK is
+ * the DMI External Clock, or the MSR-derived value when that is missing. */
+typedef struct {
+    char  processor_name[STR_LEN];
+    char  board_product[STR_LEN];
+    char  bios_version[STR_LEN];
+    char  bios_date[STR_SHORT];
+    char  agesa_version[STR_LEN];
+    memory_module_t modules[MAX_MODULES];
+    int   module_count;
+    float bclk_mhz;
+} static_info_t;
+
 static int  s_cached_static = 0;
 static int  s_loaded_aod_voltages = 0;
 static int  s_loaded_ryzen_smu    = 0;
 static int  s_loaded_tuxbench     = 0;
-static char s_processor_name[STR_LEN];
-static char s_board_product[STR_LEN];
-static char s_bios_version[STR_LEN];
-static char s_bios_date[STR_SHORT];
-static char s_agesa_version[STR_LEN];
-static memory_module_t s_modules[MAX_MODULES];
-static int  s_module_count;
-
-/* Previous /proc/stat per-logical-cpu times for usage delta */
-#define MAX_LOGICAL_CPUS 256
-static uint64_t s_prev_idle[MAX_LOGICAL_CPUS];
-static uint64_t s_prev_total[MAX_LOGICAL_CPUS];
-static int      s_prev_valid[MAX_LOGICAL_CPUS];
+
+static pthread_mutex_t s_info_lock = PTHREAD_MUTEX_INITIALIZER;
+static static_info_t   s_info;          /* guarded by s_info_lock */
+static unsigned        s_info_gen;      /* guarded by s_info_lock; 0 = none yet */
+static int             s_info_final;    /* guarded by s_info_lock; worker done */
+static atomic_int      s_static_busy;   /* static worker still running */
+
+/* Consumer side (the thread calling backend_read_static) */
+static unsigned s_info_seen;            /* generation last copied out */
+static float    s_bclk_mhz;
+
+/* Cached per-boot SMU identity — read by backend_read_static() and reused
+ * by every backend_read_dynamic() tick to decode the PM table. */
+static int      s_codename_idx = -1;
+static uint32_t s_pm_ver;
+
+/* Per-logical-CPU state, one array per attribute, sized from the topology
+ * on first use (cpu_state_init). */
+static int       s_ncpus;
+static uint64_t *s_prev_idle;      /* previous /proc/stat times for usage delta */
+static uint64_t *s_prev_total;
+static uint8_t  *s_prev_valid;
+static float    *s_cpu_usage;      /* last usage / frequency per logical CPU */
+static float    *s_cpu_freq;
+static sensor_t *s_freq_sensors;
 
 /* ── Helpers ────────────────────────────────────────────────────────── */
 
@@ -101,70 +137,7 @@ static const char *map_codename(int idx)
     }
 }
 
-/* ── dmidecode parsing ──────────────────────────────────────────────── */
-
-static void parse_dmidecode_processor(void)
-{
-    char *out = run_command("dmidecode -t processor");
-    if (!out) return;
-
-    int in_proc = 0;
-    char *line = strtok(out, "\n");
-    while (line) {
-        if (strstr(line, "Processor Information"))
-            in_proc = 1;
-        else if (in_proc && strstr(line, "Version:")) {
-            const char *colon = strchr(line, ':');
-            if (colon) {
-                colon++;
-                while (*colon == ' ') colon++;
-                snprintf(s_processor_name, STR_LEN, "%s", colon);
-            }
-            break;
-        }
-        line = strtok(NULL, "\n");
-    }
-    free(out);
-}
-
-static void parse_dmidecode_board(void)
-{
-    char *out = run_command("dmidecode -s baseboard-product-name");
-    if (out) { snprintf(s_board_product, STR_LEN, "%s", out); free(out); }
-    /* trim trailing newline */
-    char *nl = strchr(s_board_product, '\n');
-    if (nl) *nl = '\0';
-
-    out = run_command("dmidecode -s bios-version");
-    if (out) { snprintf(s_bios_version, STR_LEN, "%s", out); free(out); }
-    nl = strchr(s_bios_version, '\n');
-    if (nl) *nl = '\0';
-
-    out = run_command("dmidecode -s bios-release-date");
-    if (out) { snprintf(s_bios_date, STR_SHORT, "%s", out); free(out); }
-    nl = strchr(s_bios_date, '\n');
-    if (nl) *nl = '\0';
-}
-
-static uint64_t parse_capacity(const char *val)
-{
-    if (!val) return 0;
-    if (strstr(val, "No Module") || strstr(val, "Not Installed"))
-        return 0;
-    uint64_t size = 0;
-    char unit[16] = {0};
-    if (sscanf(val, "%lu %15s", &size, unit) < 2) return 0;
-    if (size > 0x100000) return 0; /* sanity: reject anything over ~1 TB */
-    /* upper-case unit */
-    for (char *p = unit; *p; p++) *p = (char)toupper((unsigned char)*p);
-    if (strcmp(unit, "GB") == 0 || strcmp(unit, "GIB") == 0)
-        return size * 1024ULL * 1024ULL * 1024ULL;
-    if (strcmp(unit, "MB") == 0 || strcmp(unit, "MIB") == 0)
-        return size * 1024ULL * 1024ULL;
-    if (strcmp(unit, "KB") == 0 || strcmp(unit, "KIB") == 0)
-        return size * 1024ULL;
-    return size;
-}
+/* ── SMBIOS memory modules ─────────────────────────────────────────── */
 
 static void build_module_display(memory_module_t *m, int index)
 {
@@ -195,104 +168,6 @@ static void build_module_display(memory_module_t *m, int index)
     snprintf(m->slot_display, sizeof(m->slot_display), "Module %d: %s - %s", index + 1, m->slot_label, m->capacity_display);
 }
 
-static void parse_dmidecode_memory(void)
-{
-    /* dmidecode is often in /usr/sbin which may not be in PATH under pkexec */
-    const char *cmds[] = {
-        "/usr/sbin/dmidecode -t memory",
-        "/usr/bin/dmidecode -t memory",
-        "dmidecode -t memory",
-        NULL
-    };
-    char *out = NULL;
-    for (int ci = 0; cmds[ci]; ci++) {
-        out = run_command(cmds[ci]);
-        if (out && out[0]) break;
-        if (out) { free(out); out = NULL; }
-    }
-    if (!out) return;
-
-    /* Parse into a temporary list; only overwrite globals on success. */
-    memory_module_t tmp_modules[MAX_MODULES];
-    int tmp_count = 0;
-
-    memory_module_t cur;
-    memset(&cur, 0, sizeof(cur));
-    int in_device = 0;
-    uint64_t cap = 0;
-
-    char *line = strtok(out, "\n");
-    while (line) {
-        if (strstr(line, "Memory Device") && !strstr(line, "Mapped")) {
-            /* save previous */
-            if (in_device && cap > 0 && tmp_count < MAX_MODULES) {
-                cur.capacity_bytes = cap;
-                build_module_display(&cur, tmp_count);
-                tmp_modules[tmp_count++] = cur;
-            }
-            memset(&cur, 0, sizeof(cur));
-            cap = 0;
-            in_device = 1;
-            line = strtok(NULL, "\n");
-            continue;
-        }
-        if (!in_device) { line = strtok(NULL, "\n"); continue; }
-
-        /* trim leading whitespace */
-        const char *trimmed = line;
-        while (*trimmed == ' ' || *trimmed == '\t') trimmed++;
-        const char *colon = strchr(trimmed, ':');
-        if (!colon) { line = strtok(NULL, "\n"); continue; }
-
-        /* key/value */
-        int klen = (int)(colon - trimmed);
-        const char *val = colon + 1;
-        while (*val == ' ') val++;
-
-        if (klen == 4 && strncmp(trimmed, "Size", 4) == 0)
-            cap = parse_capacity(val);
-        else if (klen == 7 && strncmp(trimmed, "Locator", 7) == 0)
-            snprintf(cur.device_locator, STR_LEN, "%s", val);
-        else if (klen == 12 && strncmp(trimmed, "Bank Locator", 12) == 0)
-            snprintf(cur.bank_label, STR_LEN, "%s", val);
-        else if (klen == 12 && strncmp(trimmed, "Manufacturer", 12) == 0) {
-            if (strcmp(val, "Unknown") != 0 && strcmp(val, "Not Specified") != 0)
-                snprintf(cur.manufacturer, STR_LEN, "%s", val);
-        }
-        else if (klen == 11 && strncmp(trimmed, "Part Number", 11) == 0) {
-            if (strcmp(val, "Unknown") != 0 && strcmp(val, "NO DIMM") != 0 && strcmp(val, "Not Specified") != 0)
-                snprintf(cur.part_number, STR_LEN, "%s", val);
-        }
-        else if (klen == 13 && strncmp(trimmed, "Serial Number", 13) == 0) {
-            if (strcmp(val, "Unknown") != 0 && strcmp(val, "Not Specified") != 0 && strcmp(val, "00000000") != 0)
-                snprintf(cur.serial_number, STR_LEN, "%s", val);
-        }
-        else if (klen == 4 && strncmp(trimmed, "Rank", 4) == 0) {
-            int r = atoi(val);
-            cur.rank = (r == 4) ? RANK_QR : (r == 2) ? RANK_DR : RANK_SR;
-        }
-        else if (strstr(trimmed, "Configured Memory Speed") || strstr(trimmed, "Configured Clock Speed")) {
-            uint32_t mhz = 0;
-            sscanf(val, "%u", &mhz);
-            cur.clock_speed_mhz = mhz;
-        }
-
-        line = strtok(NULL, "\n");
-    }
-    /* last device */
-    if (in_device && cap > 0 && tmp_count < MAX_MODULES) {
-        cur.capacity_bytes = cap;
-        build_module_display(&cur, tmp_count);
-        tmp_modules[tmp_count++] = cur;
-    }
-    free(out);
-
-    if (tmp_count > 0) {
-        s_module_count = tmp_count;
-        memcpy(s_modules, tmp_modules, tmp_count * sizeof(memory_module_t));
-    }
-}
-
 /* ── AGESA version ──────────────────────────────────────────────────── */
 
 static int agesa_allowed(unsigned char c)
@@ -325,7 +200,9 @@ static int find_agesa_in_buf(const uint8_t *buf, size_t len, char *out, size_t o
     return 0;
 }
 
-static void read_agesa_version(void)
+/* Slow: up to 128 KiB of /dev/mem plus every ACPI table — runs on the
+ * static worker, and only when the on-disk cache has no answer. */
+static void read_agesa_version(char *out, size_t outsz)
 {
     /* 1) /dev/mem BIOS region 0xE0000–0xFFFFF */
     FILE *f = fopen("/dev/mem", "rb");
@@ -336,7 +213,7 @@ static void read_agesa_version(void)
         if (buf) {
             if (fseek(f, base, SEEK_SET) == 0) {
                 size_t rd = fread(buf, 1, len, f);
-                if (rd > 0 && find_agesa_in_buf(buf, rd, s_agesa_version, STR_LEN)) {
+                if (rd > 0 && find_agesa_in_buf(buf, rd, out, outsz)) {
                     free(buf);
                     fclose(f);
                     return;
@@ -366,24 +243,14 @@ static void read_agesa_version(void)
         if (!buf) { fclose(af); continue; }
         size_t rd = fread(buf, 1, sz, af);
         fclose(af);
-        if (rd > 0 && find_agesa_in_buf(buf, rd, s_agesa_version, STR_LEN)) {
+        if (rd > 0 && find_agesa_in_buf(buf, rd, out, outsz)) {
             free(buf);
             return;
         }
         free(buf);
     }
 
-    /* 3) dmidecode -t bios output (contains AGESA in BIOS version or ROM info) */
-    char *out = run_command("dmidecode -t bios");
-    if (out) {
-        if (find_agesa_in_buf((const uint8_t *)out, strlen(out), s_agesa_version, STR_LEN)) {
-            free(out);
-            return;
-        }
-        free(out);
-    }
-
-    /* 4) Scan entire SMBIOS/DMI raw blob */
+    /* 3) Scan entire SMBIOS/DMI raw blob (what dmidecode -t bios decodes) */
     const char *dmi_paths[] = {
         "/sys/firmware/dmi/tables/DMI",
         "/sys/firmware/dmi/tables/smbios_entry_point",
@@ -400,7 +267,7 @@ static void read_agesa_version(void)
         if (!buf) { fclose(df); continue; }
         size_t rd = fread(buf, 1, sz, df);
         fclose(df);
-        if (rd > 0 && find_agesa_in_buf(buf, rd, s_agesa_version, STR_LEN)) {
+        if (rd > 0 && find_agesa_in_buf(buf, rd, out, outsz)) {
             free(buf);
             return;
         }
@@ -440,233 +307,81 @@ static mem_type_t mem_type_for_codename(int idx)
     }
 }
 
-/* ── hwmon helpers ──────────────────────────────────────────────────── */
+/* ── Per-logical-CPU state ───────────────────────────────────────────── */
 
-/* Find a hwmon directory by name match. Returns path in buf or empty. */
-static int find_hwmon_by_name(const char *match, char *buf, size_t sz)
-{
-    DIR *d = opendir("/sys/class/hwmon");
-    if (!d) return 0;
-    struct dirent *ent;
-    while ((ent = readdir(d))) {
-        if (ent->d_name[0] == '.') continue;
-        char namepath[512];
-        snprintf(namepath, sizeof(namepath), "/sys/class/hwmon/%s/name", ent->d_name);
-        char name[64];
-        if (!read_file_string(namepath, name, sizeof(name))) continue;
-        /* case-insensitive contains */
-        char name_lower[64];
-        int nli = 0;
-        for (; name[nli] && nli < 63; nli++)
-            name_lower[nli] = (char)tolower((unsigned char)name[nli]);
-        name_lower[nli] = '\0';
-        if (strstr(name_lower, match)) {
-            snprintf(buf, sz, "/sys/class/hwmon/%s", ent->d_name);
-            closedir(d);
-            return 1;
-        }
-    }
-    closedir(d);
-    return 0;
-}
+/* /proc/stat is held open and re-read with pread.  The buffer covers the
+ * cpuN lines of every configured CPU (they come first, the intr line
+ * after them may be truncated — it is never parsed). */
+static sensor_t s_stat_sensor;
+static char    *s_stat_buf;
+static size_t   s_stat_cap;
 
-static float read_temp_input(const char *hwmon_dir, int index)
+static int cpu_state_init(void)
 {
-    char path[512];
-    snprintf(path, sizeof(path), "%s/temp%d_input", hwmon_dir, index);
-    int raw = read_int_file(path);
-    if (raw == 0) return -1.0f;
-    float c = raw / 1000.0f;
-    return (c >= 0.0f && c <= 150.0f) ? c : -1.0f;
-}
-
-/* ── k10temp Tctl/Tccd overlay ──────────────────────────────────────── */
-
-static void apply_k10temp_tctl_tccd(smu_metrics_t *m)
-{
-    char k10dir[640];
-    if (find_hwmon_by_name("k10temp", k10dir, sizeof(k10dir))) {
-        float tctl = read_temp_input(k10dir, 1);
-        float tccd1 = read_temp_input(k10dir, 3);
-        float tccd2 = read_temp_input(k10dir, 4);
-        if (tctl >= 0) { m->tctl_c = tctl; m->has_tctl = true; }
-        if (tccd1 >= 0) { m->tccd1_c = tccd1; m->has_tccd1 = true; }
-        if (tccd2 >= 0) { m->tccd2_c = tccd2; m->has_tccd2 = true; }
-
-        /* Derive Tdie from Tctl if PM table didn't provide it */
-        if (!m->has_tdie && m->has_tctl) {
-            m->tdie_c = m->tctl_c;
-            m->has_tdie = true;
-        }
-        return;
-    }
-
-    /* Fallback: zenpower Tdie/Tctl/Tccd1 from labels */
-    char zpdir[640];
-    if (!find_hwmon_by_name("zenpower", zpdir, sizeof(zpdir))) return;
-
-    DIR *d = opendir(zpdir);
-    if (!d) return;
-    struct dirent *ent;
-    while ((ent = readdir(d))) {
-        if (strncmp(ent->d_name, "temp", 4) != 0 || !strstr(ent->d_name, "_label"))
-            continue;
-        int idx = 0;
-        if (sscanf(ent->d_name, "temp%d_label", &idx) != 1) continue;
-        char lpath[640], label[64];
-        snprintf(lpath, sizeof(lpath), "%s/temp%d_label", zpdir, idx);
-        if (!read_file_string(lpath, label, sizeof(label))) continue;
-        float c = read_temp_input(zpdir, idx);
-        if (c < 0) continue;
-        /* case insensitive match */
-        char lower[64];
-        int li = 0;
-        for (; label[li] && li < 63; li++)
-            lower[li] = (char)tolower((unsigned char)label[li]);
-        lower[li] = '\0';
-        if (strstr(lower, "tdie")) { m->tdie_c = c; m->has_tdie = true; }
-        else if (strstr(lower, "tctl")) { m->tctl_c = c; m->has_tctl = true; }
-        else if (strstr(lower, "tccd1")) { m->tccd1_c = c; m->has_tccd1 = true; }
-        else if (strstr(lower, "tccd2")) { m->tccd2_c = c; m->has_tccd2 = true; }
-    }
-    closedir(d);
-
-    if (!m->has_tdie && m->has_tctl) {
-        m->tdie_c = m->tctl_c;
-        m->has_tdie = true;
-    }
-    if (!m->has_tdie && m->cpu_temp_c > 0) {
-        m->tdie_c = m->cpu_temp_c;
-        m->has_tdie = true;
-    }
-}
-
-/* ── Per-core temps from hwmon "Core N" labels ──────────────────────── */
-
-static void apply_per_core_temps_hwmon(smu_metrics_t *m)
-{
-    DIR *hwmon = opendir("/sys/class/hwmon");
-    if (!hwmon) return;
-    struct dirent *ent;
-    while ((ent = readdir(hwmon))) {
-        if (ent->d_name[0] == '.') continue;
-        char dir[640];
-        snprintf(dir, sizeof(dir), "/sys/class/hwmon/%s", ent->d_name);
-
-        DIR *d2 = opendir(dir);
-        if (!d2) continue;
-        struct dirent *e2;
-        while ((e2 = readdir(d2))) {
-            if (strncmp(e2->d_name, "temp", 4) != 0 || !strstr(e2->d_name, "_label"))
-                continue;
-            int idx = 0;
-            if (sscanf(e2->d_name, "temp%d_label", &idx) != 1) continue;
-            char lpath[640], label[64];
-            snprintf(lpath, sizeof(lpath), "%s/temp%d_label", dir, idx);
-            if (!read_file_string(lpath, label, sizeof(label))) continue;
-            if (strncmp(label, "Core ", 5) != 0) continue;
-            int core = atoi(label + 5);
-            if (core < 0 || core >= MAX_CORES) continue;
-            float c = read_temp_input(dir, idx);
-            if (c >= 0) {
-                m->core_temps_c[core] = c;
-                if (core >= m->core_temps_count)
-                    m->core_temps_count = core + 1;
-            }
-        }
-        closedir(d2);
-    }
-    closedir(hwmon);
-}
-
-/* ── SPD5118 DIMM temps ─────────────────────────────────────────────── */
-
-static void read_spd_temps(smu_metrics_t *m)
-{
-    /* Try hwmon entries named spd5118 */
-    DIR *hwmon = opendir("/sys/class/hwmon");
-    if (!hwmon) return;
-    struct dirent *ent;
-    m->spd_temps_count = 0;
-    while ((ent = readdir(hwmon)) && m->spd_temps_count < MAX_MODULES) {
-        if (ent->d_name[0] == '.') continue;
-        char namepath[640], name[64];
-        snprintf(namepath, sizeof(namepath), "/sys/class/hwmon/%s/name", ent->d_name);
-        if (!read_file_string(namepath, name, sizeof(name))) continue;
-        char lower[64];
-        int li = 0;
-        for (; name[li] && li < 63; li++)
-            lower[li] = (char)tolower((unsigned char)name[li]);
-        lower[li] = '\0';
-        if (!strstr(lower, "spd5118")) continue;
-
-        char tpath[640];
-        snprintf(tpath, sizeof(tpath), "/sys/class/hwmon/%s/temp1_input", ent->d_name);
-        int raw = read_int_file(tpath);
-        if (raw == 0) continue;
-        float c = raw / 1000.0f;
-        if (c >= 0.0f && c <= 150.0f)
-            m->spd_temps_c[m->spd_temps_count++] = c;
+    if (s_ncpus > 0) return 1;
+    const topology_t *t = topology_get();
+    int n = t->ncpus;
+
+    s_prev_idle    = calloc((size_t)n, sizeof(*s_prev_idle));
+    s_prev_total   = calloc((size_t)n, sizeof(*s_prev_total));
+    s_prev_valid   = calloc((size_t)n, sizeof(*s_prev_valid));
+    s_cpu_usage    = calloc((size_t)n, sizeof(*s_cpu_usage));
+    s_cpu_freq     = calloc((size_t)n, sizeof(*s_cpu_freq));
+    s_freq_sensors = calloc((size_t)n, sizeof(*s_freq_sensors));
+    s_stat_cap     = 4096 + (size_t)n * 160;
+    s_stat_buf     = malloc(s_stat_cap);
+    if (!s_prev_idle || !s_prev_total || !s_prev_valid || !s_cpu_usage ||
+        !s_cpu_freq || !s_freq_sensors || !s_stat_buf) {
+        free(s_prev_idle);  free(s_prev_total); free(s_prev_valid);
+        free(s_cpu_usage);  free(s_cpu_freq);   free(s_freq_sensors);
+        free(s_stat_buf);
+        s_freq_sensors = NULL;      /* close_sensors() walks it */
+        return 0;
     }
-    closedir(hwmon);
+    s_ncpus = n;
+    return 1;
 }
 
-/* ── Fan speeds (Nuvoton nct6xxx) ───────────────────────────────────── */
-
-static void read_fans(fan_reading_t *fans, int *count)
+/* Core value = mean over its online threads (skipping zeros if skip0) */
+static int aggregate_cores(const float *per_cpu, int skip0, float *out)
 {
-    *count = 0;
-    DIR *hwmon = opendir("/sys/class/hwmon");
-    if (!hwmon) return;
-    struct dirent *ent;
-    while ((ent = readdir(hwmon))) {
-        if (ent->d_name[0] == '.') continue;
-        char namepath[640], name[64];
-        snprintf(namepath, sizeof(namepath), "/sys/class/hwmon/%s/name", ent->d_name);
-        if (!read_file_string(namepath, name, sizeof(name))) continue;
-        char lower[64];
-        int li = 0;
-        for (; name[li] && li < 63; li++)
-            lower[li] = (char)tolower((unsigned char)name[li]);
-        lower[li] = '\0';
-        if (strncmp(lower, "nct6", 4) != 0 && !strstr(lower, "nuvoton"))
-            continue;
-
-        char dir[640];
-        snprintf(dir, sizeof(dir), "/sys/class/hwmon/%s", ent->d_name);
-        int found_any = 0;
-        for (int i = 1; i <= 7 && *count < MAX_FANS; i++) {
-            char path[640];
-            snprintf(path, sizeof(path), "%s/fan%d_input", dir, i);
-            int rpm = read_int_file(path);
-            if (rpm <= 0) continue;
-            fan_reading_t *fan = &fans[(*count)++];
-            if (i == 7)
-                snprintf(fan->label, sizeof(fan->label), "Pump");
-            else
-                snprintf(fan->label, sizeof(fan->label), "Fan%d", i);
-            fan->rpm = rpm;
-            found_any = 1;
+    const topology_t *t = topology_get();
+    int nc = t->ncores < MAX_CORES ? t->ncores : MAX_CORES;
+    for (int c = 0; c < nc; c++) {
+        const int *th = &t->thread_cpu[t->core_thread0[c]];
+        float sum = 0; int cnt = 0;
+        for (int j = 0; j < t->core_nthreads[c]; j++) {
+            float v = per_cpu[th[j]];
+            if (skip0 && v <= 0) continue;
+            sum += v;
+            cnt++;
         }
-        if (found_any) break;
+        out[c] = cnt > 0 ? sum / cnt : 0;
     }
-    closedir(hwmon);
+    return nc;
 }
 
 /* ── /proc/stat per-core usage ──────────────────────────────────────── */
 
 static void read_core_usage(smu_metrics_t *m)
 {
-    FILE *f = fopen("/proc/stat", "r");
-    if (!f) return;
-
-    float logical_usage[MAX_LOGICAL_CPUS];
-    int logical_count = 0;
-    memset(logical_usage, 0, sizeof(logical_usage));
-
-    char line[512];
-    while (fgets(line, sizeof(line), f)) {
-        if (strncmp(line, "cpu", 3) != 0 || !isdigit((unsigned char)line[3]))
+    if (!cpu_state_init()) return;
+    if (!sensor_open(&s_stat_sensor, "/proc/stat")) return;
+    ssize_t n = sensor_read(&s_stat_sensor, s_stat_buf, s_stat_cap - 1);
+    if (n <= 0) return;
+    s_stat_buf[n] = '\0';
+
+    char *p = s_stat_buf;
+    while (*p) {
+        /* Terminate each line so sscanf can't run into the next one */
+        char *line = p;
+        char *nl = strchr(p, '\n');
+        if (nl) { *nl = '\0'; p = nl + 1; }
+        else    p += strlen(p);
+
+        if (strncmp(line, "cpu", 3) != 0)
+            break;              /* past the cpu block */
+        if (!isdigit((unsigned char)line[3]))
             continue;
         int cpuid = 0;
         uint64_t user, nice, sys, idle, iowait, irq, softirq, steal, guest, gnice;
@@ -675,7 +390,7 @@ static void read_core_usage(smu_metrics_t *m)
                    &cpuid, &user, &nice, &sys, &idle, &iowait, &irq, &softirq,
                    &steal, &guest, &gnice) < 5)
             continue;
-        if (cpuid < 0 || cpuid >= MAX_LOGICAL_CPUS) continue;
+        if (cpuid < 0 || cpuid >= s_ncpus) continue;
 
         uint64_t idle_all = idle + iowait;
         uint64_t total = user + nice + sys + idle + iowait + irq + softirq + steal + guest + gnice;
@@ -694,100 +409,33 @@ static void read_core_usage(smu_metrics_t *m)
         s_prev_idle[cpuid] = idle_all;
         s_prev_total[cpuid] = total;
         s_prev_valid[cpuid] = 1;
-
-        if (cpuid < MAX_LOGICAL_CPUS) {
-            logical_usage[cpuid] = usage;
-            if (cpuid >= logical_count) logical_count = cpuid + 1;
-        }
+        s_cpu_usage[cpuid] = usage;
     }
-    fclose(f);
 
-    /* Aggregate SMT pairs: core N = avg(cpu 2N, cpu 2N+1) */
-    int max_core = (logical_count + 1) / 2;
-    if (max_core > MAX_CORES) max_core = MAX_CORES;
-    for (int c = 0; c < max_core; c++) {
-        int l0 = c * 2, l1 = c * 2 + 1;
-        float sum = 0; int cnt = 0;
-        if (l0 < logical_count) { sum += logical_usage[l0]; cnt++; }
-        if (l1 < logical_count) { sum += logical_usage[l1]; cnt++; }
-        m->core_usage_pct[c] = cnt > 0 ? sum / cnt : 0;
-    }
-    m->core_usage_count = max_core;
+    /* Core N = mean over its SMT siblings, wherever they are numbered */
+    m->core_usage_count = aggregate_cores(s_cpu_usage, 0, m->core_usage_pct);
 }
 
 /* ── Per-core frequency from cpufreq ────────────────────────────────── */
 
 static void read_core_freq(smu_metrics_t *m)
 {
-    float logical_freq[MAX_LOGICAL_CPUS];
-    int logical_count = 0;
-    memset(logical_freq, 0, sizeof(logical_freq));
-
-    for (int i = 0; i < MAX_LOGICAL_CPUS; i++) {
-        char path[256];
-        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", i);
-        int khz = read_int_file(path);
-        if (khz <= 0) {
-            if (i > 0) break;
-            continue;
+    if (!cpu_state_init()) return;
+    const topology_t *t = topology_get();
+
+    for (int i = 0; i < t->nonline; i++) {
+        int cpu = t->thread_cpu[i];
+        sensor_t *fs = &s_freq_sensors[cpu];
+        if (!fs->valid) {
+            char path[256];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", cpu);
+            sensor_open(fs, path);
         }
-        logical_freq[i] = khz / 1000.0f;
-        if (i >= logical_count) logical_count = i + 1;
+        int khz = sensor_read_int(fs);
+        s_cpu_freq[cpu] = khz > 0 ? khz / 1000.0f : 0;
     }
 
-    int max_core = (logical_count + 1) / 2;
-    if (max_core > MAX_CORES) max_core = MAX_CORES;
-    for (int c = 0; c < max_core; c++) {
-        int l0 = c * 2, l1 = c * 2 + 1;
-        float sum = 0; int cnt = 0;
-        if (l0 < logical_count && logical_freq[l0] > 0) { sum += logical_freq[l0]; cnt++; }
-        if (l1 < logical_count && logical_freq[l1] > 0) { sum += logical_freq[l1]; cnt++; }
-        m->core_freq_mhz[c] = cnt > 0 ? sum / cnt : 0;
-    }
-    m->core_freq_count = max_core;
-}
-
-/* ── BCLK from DMI Type 4 (External Clock field) ───────────────────── */
-
-static float try_read_bclk_dmi(void)
-{
-    /*
-     * DMI Type 4 (Processor Information), offset 0x12: External Clock (MHz, WORD).
-     * This is the BIOS-reported BCLK — exact integer, same source CPU-X uses.
-     * Requires root (binary runs via pkexec).
-     */
-    int fd = open("/sys/firmware/dmi/tables/DMI", O_RDONLY);
-    if (fd < 0) return 0;
-
-    uint8_t buf[65536];
-    ssize_t total = 0, n;
-    while (total < (ssize_t)sizeof(buf) &&
-           (n = read(fd, buf + total, sizeof(buf) - total)) > 0)
-        total += n;
-    close(fd);
-    if (total < 4) return 0;
-
-    int i = 0;
-    while (i < total - 4) {
-        uint8_t type = buf[i];
-        uint8_t len  = buf[i + 1];
-        if (i + len > total) break;
-        if (type == 127) break; /* end-of-table */
-
-        if (type == 4 && len >= 0x14) {
-            uint16_t ext_clk;
-            memcpy(&ext_clk, buf + i + 0x12, sizeof(ext_clk));
-            if (ext_clk >= 80 && ext_clk <= 200)
-                return (float)ext_clk;
-        }
-
-        /* advance past fixed part + string table (ends with double NUL) */
-        int end = i + len;
-        while (end < total - 1 && !(buf[end] == 0 && buf[end + 1] == 0))
-            end++;
-        i = end + 2;
-    }
-    return 0;
+    m->core_freq_count = aggregate_cores(s_cpu_freq, 1, m->core_freq_mhz);
 }
 
 /* ── BCLK from MSR ──────────────────────────────────────────────────── */
@@ -865,41 +513,16 @@ static float try_read_bclk(void)
     return (bclk >= 80.0f && bclk <= 120.0f) ? bclk : 0;
 }
 
-/* ── Read PM table binary ───────────────────────────────────────────── */
+/* ── Public API ─────────────────────────────────────────────────────── */
 
-static int read_pm_table_raw(float **out_floats, int *out_count)
+/* Use absolute path — pkexec strips PATH */
+static const char *modprobe_path(void)
 {
-    char path[512];
-    snprintf(path, sizeof(path), "%s/pm_table", SMU_PATH);
-
-    FILE *f = fopen(path, "rb");
-    if (!f) { *out_floats = NULL; *out_count = 0; return 0; }
-
-    fseek(f, 0, SEEK_END);
-    long sz = ftell(f);
-    if (sz < 4) { fclose(f); *out_floats = NULL; *out_count = 0; return 0; }
-    rewind(f);
-
-    uint8_t *raw = malloc(sz);
-    if (!raw) { fclose(f); *out_floats = NULL; *out_count = 0; return 0; }
-    size_t rd = fread(raw, 1, sz, f);
-    fclose(f);
-    if ((int)rd < 4) { free(raw); *out_floats = NULL; *out_count = 0; return 0; }
-
-    int count = (int)rd / 4;
-    float *floats = malloc(count * sizeof(float));
-    if (!floats) { free(raw); *out_floats = NULL; *out_count = 0; return 0; }
-    memcpy(floats, raw, count * sizeof(float));
-    free(raw);
-
-    *out_floats = floats;
-    *out_count = count;
-    return 1;
+    return access("/usr/bin/modprobe", X_OK) == 0 ? "/usr/bin/modprobe" :
+           access("/sbin/modprobe",    X_OK) == 0 ? "/sbin/modprobe"    :
+                                                    "modprobe";
 }
 
-
-/* ── Public API ─────────────────────────────────────────────────────── */
-
 int backend_is_supported(void)
 {
     char path[512];
@@ -907,164 +530,523 @@ int backend_is_supported(void)
     if (file_exists(path)) return 1;
 
     /* Module may have been unloaded — try loading it now */
-    const char *mp = access("/usr/bin/modprobe", X_OK) == 0 ? "/usr/bin/modprobe" :
-                     access("/sbin/modprobe",    X_OK) == 0 ? "/sbin/modprobe"    :
-                                                               "modprobe";
     char cmd[256];
-    snprintf(cmd, sizeof(cmd), "%s ryzen_smu 2>/dev/null", mp);
+    snprintf(cmd, sizeof(cmd), "%s ryzen_smu 2>/dev/null", modprobe_path());
     run_shell(cmd);
     return file_exists(path);
 }
 
-void backend_read_summary(system_summary_t *out)
+/* Start "modprobe module" without waiting; returns the child pid or -1 */
+static pid_t spawn_modprobe(const char *mp, const char *module)
 {
-    memset(out, 0, sizeof(*out));
+    pid_t pid = fork();
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) { dup2(devnull, STDERR_FILENO); close(devnull); }
+        execlp(mp, mp, module, (char *)NULL);
+        _exit(1);
+    }
+    return pid;
+}
 
-    /* Load kernel modules and cache static data on first call */
-    if (!s_cached_static) {
-        /* Use absolute path — pkexec strips PATH */
-        const char *mp = access("/usr/bin/modprobe", X_OK) == 0 ? "/usr/bin/modprobe" :
-                         access("/sbin/modprobe",    X_OK) == 0 ? "/sbin/modprobe"    :
-                                                                   "modprobe";
-        char cmd[256];
-        snprintf(cmd, sizeof(cmd), "%s msr 2>/dev/null", mp);
-        run_shell(cmd);
-        snprintf(cmd, sizeof(cmd), "%s ryzen_smu 2>/dev/null", mp);
-        run_shell(cmd);
-        if (!file_exists("/sys/kernel/aod_voltages/mem_vddio")) {
-            snprintf(cmd, sizeof(cmd), "%s aod_voltages 2>/dev/null", mp);
-            run_shell(cmd);
-        }
-        /* Always unload on exit — these modules are only useful while the app runs */
-        if (file_exists("/sys/kernel/aod_voltages/mem_vddio"))
-            s_loaded_aod_voltages = 1;
-        if (file_exists("/sys/kernel/ryzen_smu_drv/version"))
-            s_loaded_ryzen_smu = 1;
-        if (access("/sys/module/tuxbench", F_OK) != 0) {
-            snprintf(cmd, sizeof(cmd), "%s tuxbench 2>/dev/null", mp);
-            run_shell(cmd);
-        }
-        if (access("/sys/module/tuxbench", F_OK) == 0)
-            s_loaded_tuxbench = 1;
-
-        /* Load nct6775 if no Nuvoton hwmon driver is active.
-         * Covers NCT6775F/6776F/6779D/6791D/6792D/6793D/
-         *        6795D/6796D/6797D/6798D/6799D — no-op if hardware absent. */
-        {
-            char hwmon_path[640];
-            if (!find_hwmon_by_name("nct6", hwmon_path, sizeof(hwmon_path))) {
-                snprintf(cmd, sizeof(cmd), "%s nct6775 2>/dev/null", mp);
-                run_shell(cmd);
+/* ── On-disk static cache ───────────────────────────────────────────── */
+
+/* static_info_t as text in the config directory, valid while the board,
+ * BIOS version and BIOS date in /sys/class/dmi/id (world-readable, no
+ * table parse) match.  One "key<TAB>value" per line; modules are one line
+ * each with tab-separated fields.  A BIOS update changes the key, which is
+ * also the only thing that can change the AGESA string. */
+#define STATIC_CACHE_MAGIC "tuxtimings-static 1"
+#define DMI_ID_PATH        "/sys/class/dmi/id"
+
+/* Written by load_static_once() before the worker starts, read-only after */
+static char          s_cache_key[640];   /* "" = no key, never cached */
+static static_info_t s_cache;
+static int           s_cache_hit;
+
+static int static_cache_key(char *buf, size_t sz)
+{
+    char board[STR_LEN], ver[STR_LEN], date[STR_SHORT];
+    if (!read_file_string(DMI_ID_PATH "/bios_version", ver, sizeof(ver)) || !ver[0])
+        return 0;
+    if (!read_file_string(DMI_ID_PATH "/bios_date", date, sizeof(date))) date[0] = '\0';
+    if (!read_file_string(DMI_ID_PATH "/board_name", board, sizeof(board))) board[0] = '\0';
+    snprintf(buf, sz, "%s|%s|%s", board, ver, date);
+    return 1;
+}
+
+static int static_cache_path(char *buf, size_t sz)
+{
+    char dir[2048];
+    if (results_dir(dir, sizeof(dir)) < 0) return 0;
+    return (size_t)snprintf(buf, sz, "%s/static-cache", dir) < sz;
+}
+
+/* Split line at tabs in place; returns the field count (at most max) */
+static int split_tabs(char *line, char **f, int max)
+{
+    int n = 0;
+    f[n++] = line;
+    for (char *p = line; *p && n < max; p++)
+        if (*p == '\t') { *p = '\0'; f[n++] = p + 1; }
+    return n;
+}
+
+static int static_cache_load(const char *key, static_info_t *info)
+{
+    char path[2304], line[2048];
+    if (!static_cache_path(path, sizeof(path))) return 0;
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+
+    memset(info, 0, sizeof(*info));
+    int ok = 0;
+    if (fgets(line, sizeof(line), f) && !strncmp(line, STATIC_CACHE_MAGIC "\n", sizeof(line))) {
+        while (fgets(line, sizeof(line), f)) {
+            line[strcspn(line, "\n")] = '\0';
+            char *fl[9];
+            int n = split_tabs(line, fl, 9);
+            if (n < 2) continue;
+            if (!strcmp(fl[0], "key"))            ok = !strcmp(fl[1], key);
+            else if (!ok)                         break;
+            else if (!strcmp(fl[0], "processor")) snprintf(info->processor_name, STR_LEN, "%s", fl[1]);
+            else if (!strcmp(fl[0], "board"))     snprintf(info->board_product, STR_LEN, "%s", fl[1]);
+            else if (!strcmp(fl[0], "bios"))      snprintf(info->bios_version, STR_LEN, "%s", fl[1]);
+            else if (!strcmp(fl[0], "bios_date")) snprintf(info->bios_date, STR_SHORT, "%s", fl[1]);
+            else if (!strcmp(fl[0], "agesa"))     snprintf(info->agesa_version, STR_LEN, "%s", fl[1]);
+            else if (!strcmp(fl[0], "bclk"))      info->bclk_mhz = strtof(fl[1], NULL);
+            else if (!strcmp(fl[0], "module") && n == 9 && info->module_count < MAX_MODULES) {
+                memory_module_t *m = &info->modules[info->module_count];
+                snprintf(m->bank_label,     STR_LEN, "%s", fl[1]);
+                snprintf(m->device_locator, STR_LEN, "%s", fl[2]);
+                snprintf(m->manufacturer,   STR_LEN, "%s", fl[3]);
+                snprintf(m->part_number,    STR_LEN, "%s", fl[4]);
+                snprintf(m->serial_number,  STR_LEN, "%s", fl[5]);
+                m->capacity_bytes  = strtoull(fl[6], NULL, 10);
+                m->clock_speed_mhz = (uint32_t)strtoul(fl[7], NULL, 10);
+                int r = atoi(fl[8]);
+                m->rank = r == RANK_QR ? RANK_QR : r == RANK_DR ? RANK_DR : RANK_SR;
+                build_module_display(m, info->module_count++);
             }
         }
+    }
+    fclose(f);
+    return ok;
+}
 
-        parse_dmidecode_processor();
-        parse_dmidecode_board();
-        parse_dmidecode_memory();
-        read_agesa_version();
-        s_cached_static = 1;
+static void static_cache_save(const char *key, const static_info_t *info)
+{
+    char path[2304], tmp[2320];
+    if (!static_cache_path(path, sizeof(path))) return;
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "w");
+    if (!f) return;
+
+    fprintf(f, STATIC_CACHE_MAGIC "\n");
+    fprintf(f, "key\t%s\n", key);
+    fprintf(f, "processor\t%s\n", info->processor_name);
+    fprintf(f, "board\t%s\n", info->board_product);
+    fprintf(f, "bios\t%s\n", info->bios_version);
+    fprintf(f, "bios_date\t%s\n", info->bios_date);
+    fprintf(f, "agesa\t%s\n", info->agesa_version);
+    fprintf(f, "bclk\t%.9g\n", (double)info->bclk_mhz);
+    for (int i = 0; i < info->module_count; i++) {
+        const memory_module_t *m = &info->modules[i];
+        fprintf(f, "module\t%s\t%s\t%s\t%s\t%s\t%llu\t%u\t%d\n",
+                m->bank_label, m->device_locator, m->manufacturer,
+                m->part_number, m->serial_number,
+                (unsigned long long)m->capacity_bytes, m->clock_speed_mhz, (int)m->rank);
     }
+    if (fclose(f) != 0 || rename(tmp, path) != 0)
+        unlink(tmp);
+}
 
-    /* CPU info */
-    int codename_idx = read_codename_index();
-    snprintf(out->cpu.name, STR_LEN, "AMD Ryzen (from ryzen_smu)");
-    snprintf(out->cpu.processor_name, STR_LEN, "%s", s_processor_name);
-    snprintf(out->cpu.codename, STR_SHORT, "%s", map_codename(codename_idx));
-    read_smu_string("version", out->cpu.smu_version, STR_SHORT);
+/* ── Static worker ──────────────────────────────────────────────────── */
+
+/* Nothing here is needed to show live PM data, so it all runs off the
+ * consumer thread: the optional modules load in parallel child processes
+ * while SMBIOS is parsed and, on a cache miss, AGESA is scanned for. */
+static void *static_worker(void *arg)
+{
+    (void)arg;
+    const char *mp = modprobe_path();
+    pid_t pids[4];
+    int   npids = 0;
+
+    pids[npids++] = spawn_modprobe(mp, "msr");
+    if (!file_exists("/sys/kernel/aod_voltages/mem_vddio"))
+        pids[npids++] = spawn_modprobe(mp, "aod_voltages");
+    if (access("/sys/module/tuxbench", F_OK) != 0)
+        pids[npids++] = spawn_modprobe(mp, "tuxbench");
+    /* Load nct6775 if no Nuvoton hwmon driver is active.
+     * Covers NCT6775F/6776F/6779D/6791D/6792D/6793D/
+     *        6795D/6796D/6797D/6798D/6799D — no-op if hardware absent.
+     * hwmon picks it up through its uevent socket once bound. */
+    {
+        char hwmon_path[640];
+        if (!hwmon_find_by_name("nct6", hwmon_path, sizeof(hwmon_path)))
+            pids[npids++] = spawn_modprobe(mp, "nct6775");
+    }
+
+    static static_info_t info;
+    const char *key = s_cache_key;
+    const int have_key = key[0] != '\0';
+    const int hit = s_cache_hit;
+    const static_info_t *cached = &s_cache;
+
+    smbios_info_t *smb = malloc(sizeof(*smb));
+    if (smb && smbios_read(smb)) {
+        memset(&info, 0, sizeof(info));
+        snprintf(info.processor_name, STR_LEN, "%s", smb->processor_version);
+        snprintf(info.board_product, STR_LEN, "%s", smb->board_product);
+        snprintf(info.bios_version, STR_LEN, "%s", smb->bios_version);
+        snprintf(info.bios_date, STR_SHORT, "%s", smb->bios_date);
+        info.module_count = smb->module_count;
+        for (int i = 0; i < smb->module_count; i++) {
+            info.modules[i] = smb->modules[i];
+            build_module_display(&info.modules[i], i);
+        }
+        info.bclk_mhz = smb->ext_clock_mhz;
+        if (hit)
+            snprintf(info.agesa_version, STR_LEN, "%s", cached->agesa_version);
+        else
+            read_agesa_version(info.agesa_version, STR_LEN);
+    } else if (hit) {
+        info = *cached;             /* no table access — trust the cache */
+    } else {
+        memset(&info, 0, sizeof(info));
+        read_agesa_version(info.agesa_version, STR_LEN);
+    }
+    free(smb);
 
-    uint32_t pm_ver = read_smu_uint32("pm_table_version");
-    if (pm_ver)
-        snprintf(out->cpu.pm_table_version, STR_SHORT, "PM table 0x%08X", pm_ver);
+    for (int i = 0; i < npids; i++)
+        if (pids[i] > 0) waitpid(pids[i], NULL, 0);
 
-    /* Board info */
-    snprintf(out->board.motherboard, STR_LEN, "%s", s_board_product);
-    snprintf(out->board.bios_version, STR_LEN, "%s", s_bios_version);
-    snprintf(out->board.bios_date, STR_SHORT, "%s", s_bios_date);
-    snprintf(out->board.agesa_version, STR_LEN, "%s", s_agesa_version);
-    snprintf(out->board.display_line, sizeof(out->board.display_line),
-             "%s | BIOS %s (%s) | AGESA %s",
-             s_board_product, s_bios_version, s_bios_date,
-             s_agesa_version[0] ? s_agesa_version : "N/A");
-
-    /* Modules (cached) */
-    out->module_count = s_module_count;
-    memcpy(out->modules, s_modules, s_module_count * sizeof(memory_module_t));
+    /* Always unload on exit — these modules are only useful while the app runs */
+    if (file_exists("/sys/kernel/aod_voltages/mem_vddio"))
+        s_loaded_aod_voltages = 1;
+    if (access("/sys/module/tuxbench", F_OK) == 0)
+        s_loaded_tuxbench = 1;
 
-    /* PM table → metrics */
-    float *pm_floats = NULL;
-    int pm_count = 0;
-    if (read_pm_table_raw(&pm_floats, &pm_count)) {
-        pm_table_read(pm_ver, pm_floats, pm_count, codename_idx, &out->metrics);
-        free(pm_floats);
+    /* BCLK: DMI (exact BIOS value) with MSR as fallback — fixed at boot */
+    if (info.bclk_mhz <= 0.0f)
+        info.bclk_mhz = try_read_bclk();
+
+    if (have_key && (!hit || memcmp(&info, cached, sizeof(info)) != 0))
+        static_cache_save(key, &info);
+
+    pthread_mutex_lock(&s_info_lock);
+    s_info = info;
+    s_info_gen++;
+    s_info_final = 1;
+    pthread_mutex_unlock(&s_info_lock);
+
+    atomic_store(&s_static_busy, 0);
+    return NULL;
+}
+
+/* Make the PM table available now and start everything else in the
+ * background. With a cache hit the firmware info is there immediately
+ * too; otherwise it is published as soon as the worker has it. Runs once. */
+static void load_static_once(void)
+{
+    if (s_cached_static) return;
+    s_cached_static = 1;
+
+    if (!file_exists(SMU_PATH "/version")) {
+        char cmd[256];
+        snprintf(cmd, sizeof(cmd), "%s ryzen_smu 2>/dev/null", modprobe_path());
+        run_shell(cmd);
+    }
+    if (file_exists(SMU_PATH "/version"))
+        s_loaded_ryzen_smu = 1;
+
+    if (static_cache_key(s_cache_key, sizeof(s_cache_key)) &&
+        static_cache_load(s_cache_key, &s_cache)) {
+        s_cache_hit = 1;
+        pthread_mutex_lock(&s_info_lock);
+        s_info = s_cache;
+        s_info_gen++;
+        pthread_mutex_unlock(&s_info_lock);
+    } else {
+        /* Provisional until the worker has the DMI External Clock */
+        s_bclk_mhz = try_read_bclk();
     }
 
-    /* BCLK: DMI (exact BIOS value) with MSR as fallback */
-    out->metrics.bclk_mhz = try_read_bclk_dmi();
-    if (out->metrics.bclk_mhz <= 0.0f)
-        out->metrics.bclk_mhz = try_read_bclk();
+    atomic_store(&s_static_busy, 1);
+    pthread_t th;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&th, &attr, static_worker, NULL) != 0)
+        static_worker(NULL);
+    pthread_attr_destroy(&attr);
+}
+
+/* Memory voltages from aod_voltages sysfs: one binary snapshot of every
+ * rail, or per-rail text files ("1234 mV (1.234 V)") from older modules */
+#define AOD_PATH "/sys/kernel/aod_voltages"
 
-    /* Memory voltages from aod_voltages kernel module sysfs */
-    {
-        int mv;
-        mv = read_int_file("/sys/kernel/aod_voltages/mem_vddio");
-        if (mv > 500 && mv < 3000) out->metrics.mem_vdd    = mv / 1000.0f;
-        mv = read_int_file("/sys/kernel/aod_voltages/mem_vddq");
-        if (mv > 500 && mv < 3000) out->metrics.mem_vddq   = mv / 1000.0f;
-        mv = read_int_file("/sys/kernel/aod_voltages/mem_vpp");
-        if (mv > 500 && mv < 3000) out->metrics.mem_vpp    = mv / 1000.0f;
-        mv = read_int_file("/sys/kernel/aod_voltages/cpu_vddio");
-        if (mv > 500 && mv < 3000) out->metrics.cpu_vddio  = mv / 1000.0f;
+static sensor_t s_aod_snap_sensor;
+static sensor_t s_aod_sensors[AOD_RAIL_COUNT];
+
+static int read_aod_snapshot(int *mv)
+{
+    struct aod_snapshot snap;
+    if (!sensor_open(&s_aod_snap_sensor, AOD_PATH "/snapshot")) return 0;
+    if (sensor_read(&s_aod_snap_sensor, &snap, sizeof(snap)) != (ssize_t)sizeof(snap) ||
+        snap.magic != AOD_SNAPSHOT_MAGIC || snap.version != AOD_SNAPSHOT_VERSION ||
+        snap.size < sizeof(snap))
+        return 0;
+    for (int i = 0; i < AOD_RAIL_COUNT; i++)
+        mv[i] = (snap.valid & (1u << i)) ? (int)snap.mv[i] : 0;
+    return 1;
+}
+
+static void read_aod_voltages(smu_metrics_t *m)
+{
+    static const char *const paths[AOD_RAIL_COUNT] = {
+        [AOD_RAIL_MEM_VDDIO] = AOD_PATH "/mem_vddio",
+        [AOD_RAIL_MEM_VDDQ]  = AOD_PATH "/mem_vddq",
+        [AOD_RAIL_MEM_VPP]   = AOD_PATH "/mem_vpp",
+        [AOD_RAIL_CPU_VDDIO] = AOD_PATH "/cpu_vddio",
+    };
+    float *dst[AOD_RAIL_COUNT] = {
+        [AOD_RAIL_MEM_VDDIO] = &m->mem_vdd,  [AOD_RAIL_MEM_VDDQ]  = &m->mem_vddq,
+        [AOD_RAIL_MEM_VPP]   = &m->mem_vpp,  [AOD_RAIL_CPU_VDDIO] = &m->cpu_vddio,
+    };
+
+    int mv[AOD_RAIL_COUNT];
+    if (!read_aod_snapshot(mv)) {
+        for (int i = 0; i < AOD_RAIL_COUNT; i++)
+            mv[i] = sensor_read_int_path(&s_aod_sensors[i], paths[i]);
     }
+    for (int i = 0; i < AOD_RAIL_COUNT; i++)
+        if (mv[i] > 500 && mv[i] < 3000) *dst[i] = mv[i] / 1000.0f;
+}
 
-    /* hwmon overlays */
-    apply_per_core_temps_hwmon(&out->metrics);
-    apply_k10temp_tctl_tccd(&out->metrics);
-    read_spd_temps(&out->metrics);
+/* Drop every persistent handle — must happen before the modules that own
+ * the attributes are unloaded. */
+static void close_sensors(void)
+{
+    smu_close();
+    sensor_close(&s_stat_sensor);
+    for (int i = 0; s_freq_sensors && i < s_ncpus; i++)
+        sensor_close(&s_freq_sensors[i]);
+    sensor_close(&s_aod_snap_sensor);
+    for (int i = 0; i < AOD_RAIL_COUNT; i++)
+        sensor_close(&s_aod_sensors[i]);
+    hwmon_close();
+}
 
-    /* Per-core usage and frequency */
-    read_core_usage(&out->metrics);
-    read_core_freq(&out->metrics);
+/* PM table → metrics. The decode is cached per table generation, so a
+ * table the SMU has not refreshed since the last read is not decoded
+ * again. The SMU's shared lock covers only copying a changed table into
+ * s_pm_copy; the decode runs from the copy under s_pm_decode_lock. */
+static pthread_mutex_t s_pm_decode_lock = PTHREAD_MUTEX_INITIALIZER;
+static smu_metrics_t   s_pm_decoded;
+static uint64_t        s_pm_decoded_gen;     /* 0 = nothing decoded yet */
+static float          *s_pm_copy;            /* under s_pm_decode_lock */
+static int             s_pm_copy_cap;
+
+static int pm_copy_reserve(int count)
+{
+    if (count <= s_pm_copy_cap) return 1;
+    float *p = realloc(s_pm_copy, (size_t)count * sizeof(float));
+    if (!p) return 0;
+    s_pm_copy     = p;
+    s_pm_copy_cap = count;
+    return 1;
+}
 
-    /* DRAM timings */
-    dram_read_timings(codename_idx, &out->dram);
+static void read_pm_metrics(smu_metrics_t *m)
+{
+    const float *pm_floats;
+    int pm_count;
+    uint64_t gen;
+    long long t0 = prof_begin();
+    if (!smu_pm_acquire(SMU_PM_COALESCE_NS, &pm_floats, &pm_count, &gen))
+        return;
+    prof_end(PROF_PM_READ, t0);
+
+    pthread_mutex_lock(&s_pm_decode_lock);
+    int changed = gen != s_pm_decoded_gen && pm_copy_reserve(pm_count);
+    if (changed)
+        memcpy(s_pm_copy, pm_floats, (size_t)pm_count * sizeof(float));
+    smu_pm_release();
+
+    if (changed) {
+        t0 = prof_begin();
+        pm_table_read(s_pm_ver, s_pm_copy, pm_count, s_codename_idx, &s_pm_decoded);
+        s_pm_decoded_gen = gen;
+        prof_end(PROF_PM_DECODE, t0);
+    }
+    memcpy(m, &s_pm_decoded, sizeof(*m));
+    pthread_mutex_unlock(&s_pm_decode_lock);
+}
 
-    /* Memory config */
-    out->memory.type = mem_type_for_codename(codename_idx);
+/* Effective memory speed from the timing-derived hint, MCLK or SMBIOS */
+static void update_memory_frequency(system_summary_t *out, float mclk_mhz)
+{
     float mem_freq = out->dram.frequency_hint_mhz;
 
-    /* dmidecode "Configured Memory Speed" (MT/s) */
+    /* SMBIOS Type 17 "Configured Memory Speed" (MT/s) */
     uint32_t max_cfg = 0;
-    for (int i = 0; i < s_module_count; i++) {
-        if (s_modules[i].clock_speed_mhz > max_cfg)
-            max_cfg = s_modules[i].clock_speed_mhz;
+    for (int i = 0; i < out->module_count; i++) {
+        if (out->modules[i].clock_speed_mhz > max_cfg)
+            max_cfg = out->modules[i].clock_speed_mhz;
     }
     if (out->memory.type == MEM_DDR4) {
-        /* For DDR4, prefer SMN-derived effective MT/s; fall back to dmidecode. */
+        /* For DDR4, prefer SMN-derived effective MT/s; fall back to SMBIOS. */
         if (mem_freq <= 0.0f && max_cfg > 0)
             mem_freq = (float)max_cfg;
     } else {
         /* Non-DDR4: prefer timing-derived hint, else fall back to MCLK MHz. */
-        if (mem_freq == 0 && out->metrics.mclk_mhz > 0)
-            mem_freq = out->metrics.mclk_mhz;
+        if (mem_freq == 0 && mclk_mhz > 0)
+            mem_freq = mclk_mhz;
         else if (mem_freq <= 0.0f && max_cfg > 0)
             mem_freq = (float)max_cfg;
     }
     out->memory.frequency = mem_freq;
-    read_total_memory(out->memory.total_capacity, sizeof(out->memory.total_capacity));
+}
+
+/* Copy the published firmware info into out if it changed since the last
+ * copy (or always, with force). Returns 1 if out was written. */
+static int apply_static_info(system_summary_t *out, int force)
+{
+    pthread_mutex_lock(&s_info_lock);
+    if (!force && s_info_gen == s_info_seen) {
+        pthread_mutex_unlock(&s_info_lock);
+        return 0;
+    }
+    const static_info_t *in = &s_info;
+    s_info_seen = s_info_gen;
+
+    snprintf(out->cpu.processor_name, STR_LEN, "%s", in->processor_name);
+
+    /* Board info */
+    snprintf(out->board.motherboard, STR_LEN, "%s", in->board_product);
+    snprintf(out->board.bios_version, STR_LEN, "%s", in->bios_version);
+    snprintf(out->board.bios_date, STR_SHORT, "%s", in->bios_date);
+    snprintf(out->board.agesa_version, STR_LEN, "%s", in->agesa_version);
+    if (s_info_gen == 0)
+        snprintf(out->board.display_line, sizeof(out->board.display_line),
+                 "Reading board information…");
+    else
+        snprintf(out->board.display_line, sizeof(out->board.display_line),
+                 "%s | BIOS %s (%s) | AGESA %s",
+                 in->board_product, in->bios_version, in->bios_date,
+                 in->agesa_version[0] ? in->agesa_version :
+                 s_info_final ? "N/A" : "…");
+
+    /* Modules */
+    out->module_count = in->module_count;
+    memcpy(out->modules, in->modules, in->module_count * sizeof(memory_module_t));
 
     /* Build part number string from unique module part numbers */
     char *pn_buf = out->memory.part_number;
     pn_buf[0] = '\0';
-    for (int i = 0; i < s_module_count; i++) {
-        if (s_modules[i].part_number[0] == '\0') continue;
+    for (int i = 0; i < in->module_count; i++) {
+        if (in->modules[i].part_number[0] == '\0') continue;
         /* check duplicate */
-        if (strstr(pn_buf, s_modules[i].part_number)) continue;
+        if (strstr(pn_buf, in->modules[i].part_number)) continue;
         if (pn_buf[0] != '\0') strncat(pn_buf, ", ", STR_LEN - strlen(pn_buf) - 1);
-        strncat(pn_buf, s_modules[i].part_number, STR_LEN - strlen(pn_buf) - 1);
+        strncat(pn_buf, in->modules[i].part_number, STR_LEN - strlen(pn_buf) - 1);
     }
 
-    /* Fans */
-    read_fans(out->fans, &out->fan_count);
+    if (in->bclk_mhz > 0.0f)
+        s_bclk_mhz = in->bclk_mhz;
+    pthread_mutex_unlock(&s_info_lock);
+    return 1;
+}
+
+void backend_read_static(system_summary_t *out)
+{
+    load_static_once();
+
+    /* CPU info */
+    s_codename_idx = read_codename_index();
+    snprintf(out->cpu.name, STR_LEN, "AMD Ryzen (from ryzen_smu)");
+    snprintf(out->cpu.codename, STR_SHORT, "%s", map_codename(s_codename_idx));
+    read_smu_string("version", out->cpu.smu_version, STR_SHORT);
+
+    s_pm_ver = read_smu_uint32("pm_table_version");
+    if (s_pm_ver)
+        snprintf(out->cpu.pm_table_version, STR_SHORT, "PM table 0x%08X", s_pm_ver);
+
+    /* Board info and modules — whatever the cache or worker has so far */
+    apply_static_info(out, 1);
+
+    /* DRAM timings — one PM sample gives the MCLK the cache is keyed on */
+    smu_metrics_t pm;
+    memset(&pm, 0, sizeof(pm));
+    read_pm_metrics(&pm);
+    dram_read_timings_cached(s_codename_idx, pm.mclk_mhz, 1, &out->dram);
+
+    /* Memory config */
+    out->memory.type = mem_type_for_codename(s_codename_idx);
+    update_memory_frequency(out, pm.mclk_mhz);
+    read_total_memory(out->memory.total_capacity, sizeof(out->memory.total_capacity));
+}
+
+int backend_refresh_static(system_summary_t *out)
+{
+    if (!apply_static_info(out, 0)) return 0;
+    update_memory_frequency(out, out->dyn.metrics.mclk_mhz);
+    return 1;
+}
+
+int backend_refresh_timings(system_summary_t *out, int force)
+{
+    float mclk = out->dyn.metrics.mclk_mhz;
+    long long t0 = prof_begin();
+    if (!dram_read_timings_cached(s_codename_idx, mclk, force, &out->dram))
+        return 0;
+    prof_end(PROF_SMN, t0);
+    update_memory_frequency(out, mclk);
+    return 1;
+}
+
+void backend_read_dynamic(system_dynamic_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    /* PM table → metrics */
+    read_pm_metrics(&out->metrics);
+    out->metrics.bclk_mhz = s_bclk_mhz;
+
+    /* Memory voltages from aod_voltages kernel module sysfs */
+    long long t0 = prof_begin();
+    read_aod_voltages(&out->metrics);
+    prof_end(PROF_AOD, t0);
+
+    /* hwmon overlays and fans — cached handles, rediscovered only on hotplug */
+    t0 = prof_begin();
+    hwmon_refresh();
+    hwmon_apply_temps(&out->metrics);
+    hwmon_read_fans(out->fans, &out->fan_count);
+    prof_end(PROF_HWMON, t0);
+
+    /* Per-core usage and frequency */
+    t0 = prof_begin();
+    read_core_usage(&out->metrics);
+    prof_end(PROF_PROC_STAT, t0);
+    t0 = prof_begin();
+    read_core_freq(&out->metrics);
+    prof_end(PROF_CPUFREQ, t0);
+}
+
+void backend_read_pm(smu_metrics_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    read_pm_metrics(out);
+}
+
+void backend_read_summary(system_summary_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    backend_read_static(out);
+    backend_read_dynamic(&out->dyn);
 }
 
 static void rmmod_module(const char *rm, const char *module)
@@ -1082,6 +1064,15 @@ static void rmmod_module(const char *rm, const char *module)
 
 void backend_cleanup(void)
 {
+    close_sensors();
+
+    /* The static worker may still be loading modules — give it a bounded
+     * wait (nanosleep is async-signal-safe) so none is left behind */
+    for (int i = 0; i < 500 && atomic_load(&s_static_busy); i++) {
+        struct timespec ts = { 0, 10 * 1000000L };
+        nanosleep(&ts, NULL);
+    }
+
     const char *rm = access("/usr/bin/rmmod", X_OK) == 0 ? "/usr/bin/rmmod" :
                      access("/sbin/rmmod",    X_OK) == 0 ? "/sbin/rmmod"    :
                                                            "/usr/bin/rmmod";
@@ -1158,9 +1149,9 @@ char *backend_read_debug_dump(void)
     /* ── PM table raw floats ──────────────────────────────────────── */
     DUMP("\n=== PM Table Raw Entries ===\n");
     {
-        float *t = NULL;
-        int count = 0;
-        if (read_pm_table_raw(&t, &count)) {
+        const float *t;
+        int count;
+        if (smu_pm_acquire(SMU_PM_COALESCE_NS, &t, &count, NULL)) {
             DUMP("Total entries: %d\n\n", count);
             DUMP("%-8s  %-14s\n", "Index", "Value");
             DUMP("%-8s  %-14s\n", "-----", "-----");
@@ -1172,7 +1163,7 @@ char *backend_read_debug_dump(void)
                     break;
                 }
             }
-            free(t);
+            smu_pm_release();
         } else {
             DUMP("(PM table unavailable)\n");
         }
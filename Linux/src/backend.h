@@ -6,11 +6,38 @@
 /* Returns true if the ryzen_smu driver is loaded and accessible. */
 int backend_is_supported(void);
 
-/* Read all system data into out. Call every ~1 second for live refresh.
- * Static data (dmidecode, AGESA) is cached after first call. */
+/* Read the static half of the summary: CPU/board info, DIMM modules,
+ * DRAM timings, memory config and AGESA; call once at startup. out->dyn is
+ * untouched. Returns as soon as the PM table is readable: the other kernel
+ * modules, SMBIOS and the AGESA scan are handled by a background worker,
+ * so board and DIMM info may still be empty (unless cached on disk from a
+ * previous run with the same BIOS) — see backend_refresh_static(). */
+void backend_read_static(system_summary_t *out);
+
+/* Copy board/DIMM/AGESA info the background worker has published since
+ * the last call into out (and re-derive the memory speed). Returns 1 if
+ * out changed. Cheap when nothing did; call from the same thread as
+ * backend_read_static(), after backend_read_dynamic(). */
+int backend_refresh_static(system_summary_t *out);
+
+/* Refresh the hot half: PM table, voltages, temps, fans, per-core usage and
+ * frequency. Call every ~1 second; never re-reads static data. */
+void backend_read_dynamic(system_dynamic_t *out);
+
+/* PM table only — decode into out, no sysfs/hwmon overlays. Cheap enough
+ * for the high-rate sampler (one pread + decode). */
+void backend_read_pm(smu_metrics_t *out);
+
+/* Re-read DRAM timings (and the derived memory speed) into out. The SMN
+ * registers are only touched when force is set or out->dyn.metrics.mclk_mhz
+ * changed since the last read; call after backend_read_dynamic().
+ * Returns 1 if the timings were re-read. */
+int backend_refresh_timings(system_summary_t *out, int force);
+
+/* Static + dynamic in one call (static data is cached after first call). */
 void backend_read_summary(system_summary_t *out);
 
-/* Unload any kernel modules that were loaded by backend_read_summary().
+/* Unload any kernel modules that were loaded by backend_read_static().
  * Call once on application exit. */
 void backend_cleanup(void);
 void backend_set_tuxbench_loaded(void);
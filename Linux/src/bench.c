@@ -20,16 +20,22 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <time.h>
+#include <math.h>
 #include <sys/mman.h>
 #include <immintrin.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <sched.h>
 #include <unistd.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 #include <linux/ioctl.h>
 #include <linux/types.h>
 #include "tuxbench/tuxbench.h"
+#include "topology.h"
 
 /* ── Timing ──────────────────────────────────────────────────────────── */
 
@@ -40,6 +46,111 @@ static long long now_ns(void)
     return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
 }
 
+/* ── Progress and cancellation ──────────────────────────────────────── */
+
+/*
+ * done/total are in whatever units the runner chose (samples and passes for
+ * bench_run_ex, points, levels or steps for the others).  While an ioctl is
+ * in flight, fd is its /dev/tuxbench handle and kspan the units that one
+ * call stands for; progress then interpolates with the module's own pass
+ * count.  lock orders the fd hand-off against bench_token_cancel(), so a
+ * cancel either sees the fd or is seen by kernel_enter() before the ioctl.
+ */
+struct bench_token {
+    atomic_int      cancel;
+    atomic_long     done, total;
+    pthread_mutex_t lock;
+    int             fd;             /* -1 = no ioctl in flight */
+    long            kspan;
+};
+
+bench_token_t *bench_token_new(void)
+{
+    bench_token_t *t = calloc(1, sizeof(*t));
+    if (!t) return NULL;
+    pthread_mutex_init(&t->lock, NULL);
+    t->fd = -1;
+    return t;
+}
+
+void bench_token_free(bench_token_t *t)
+{
+    if (!t) return;
+    pthread_mutex_destroy(&t->lock);
+    free(t);
+}
+
+void bench_token_cancel(bench_token_t *t)
+{
+    if (!t) return;
+    atomic_store(&t->cancel, 1);
+    pthread_mutex_lock(&t->lock);
+    if (t->fd >= 0)
+        ioctl(t->fd, TUXBENCH_IOC_CANCEL);   /* ENOTTY before ABI 5 */
+    pthread_mutex_unlock(&t->lock);
+}
+
+int bench_token_cancelled(const bench_token_t *t)
+{
+    return t && atomic_load(&t->cancel);
+}
+
+double bench_token_progress(bench_token_t *t)
+{
+    if (!t) return 0.0;
+    long total = atomic_load(&t->total);
+    if (total <= 0) return 0.0;
+
+    double done = (double)atomic_load(&t->done);
+    pthread_mutex_lock(&t->lock);
+    if (t->fd >= 0) {
+        struct tuxbench_progress kp;
+        if (ioctl(t->fd, TUXBENCH_IOC_PROGRESS, &kp) == 0 && kp.total > 0)
+            done += (double)t->kspan * kp.done / kp.total;
+    }
+    pthread_mutex_unlock(&t->lock);
+
+    done /= (double)total;
+    return done < 1.0 ? done : 1.0;
+}
+
+void bench_token_begin(bench_token_t *t, long total)
+{
+    if (!t) return;
+    atomic_store(&t->done, 0);
+    atomic_store(&t->total, total);
+}
+
+void bench_token_advance(bench_token_t *t, long n)
+{
+    if (t && n > 0)
+        atomic_fetch_add(&t->done, n);
+}
+
+/* Register fd for the ioctl about to be issued; 0 if already cancelled */
+static int kernel_enter(bench_token_t *t, int fd, long span)
+{
+    int ok;
+    if (!t) return 1;
+    pthread_mutex_lock(&t->lock);
+    ok = !atomic_load(&t->cancel);
+    if (ok) {
+        t->fd    = fd;
+        t->kspan = span;
+    }
+    pthread_mutex_unlock(&t->lock);
+    return ok;
+}
+
+/* Unregister before close(); the caller credits the span on success */
+static void kernel_leave(bench_token_t *t)
+{
+    if (!t) return;
+    pthread_mutex_lock(&t->lock);
+    t->fd = -1;
+    pthread_mutex_unlock(&t->lock);
+}
+
 /* ── Huge-page-aware allocator ───────────────────────────────────────── */
 /*
  * Large buffers (≥2 MB) are mmap'd with MADV_HUGEPAGE so the kernel can
@@ -75,6 +186,55 @@ static void bench_free(void *p, size_t bytes)
         free(p);
 }
 
+/*
+ * Explicit page backing for the latency sweep.  PAGES_AUTO is the policy
+ * above; PAGES_4K forbids THP so TLB-reach cliffs stay visible; PAGES_2M
+ * rounds the mapping to 2 MB and aligns it so every page can be a THP.
+ */
+typedef enum { PAGES_AUTO, PAGES_4K, PAGES_2M } page_mode_t;
+
+static size_t pages_len(size_t bytes, page_mode_t mode)
+{
+    if (mode == PAGES_2M)
+        return (bytes + HUGEPAGE_THRESH - 1) & ~(HUGEPAGE_THRESH - 1);
+    return (bytes + 4095) & ~(size_t)4095;
+}
+
+static void *bench_alloc_pages(size_t bytes, page_mode_t mode)
+{
+    if (mode == PAGES_AUTO)
+        return bench_alloc(bytes);
+
+    size_t len = pages_len(bytes, mode);
+    size_t pad = (mode == PAGES_2M) ? HUGEPAGE_THRESH : 0;
+    uint8_t *p = mmap(NULL, len + pad, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED)
+        return NULL;
+
+    if (pad) {
+        /* Trim to a 2 MB-aligned window of exactly len bytes */
+        uintptr_t start = ((uintptr_t)p + pad - 1) & ~(uintptr_t)(pad - 1);
+        size_t    head  = start - (uintptr_t)p;
+        if (head)
+            munmap(p, head);
+        if (pad - head)
+            munmap((uint8_t *)start + len, pad - head);
+        p = (uint8_t *)start;
+    }
+    madvise(p, len, mode == PAGES_2M ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+    return p;
+}
+
+static void bench_free_pages(void *p, size_t bytes, page_mode_t mode)
+{
+    if (!p) return;
+    if (mode == PAGES_AUTO)
+        bench_free(p, bytes);
+    else
+        munmap(p, pages_len(bytes, mode));
+}
+
 /* ── Latency: random pointer chasing ─────────────────────────────────── */
 
 /*
@@ -146,6 +306,64 @@ static int cmp_double(const void *a, const void *b)
     return (da > db) - (da < db);
 }
 
+/*
+ * CV² < target² over the first n samples — shared stopping rule for the
+ * latency and bandwidth loops.
+ *
+ * Sample variance (Bessel's correction: divide by n-1, not n).  Population
+ * variance (÷n) underestimates the true spread by the factor n/(n-1).  At
+ * BW_MIN_PASSES=5 that is a 25% underestimate, meaning the check could
+ * declare convergence when the real CV is 1.25% — 25% over the 1% target.
+ * The unbiased estimator (÷(n-1)) gives the correct answer.
+ * CV² < target² avoids sqrt(); target=1% → target²=0.0001.
+ */
+static int cv_converged(const double *samples, int n, double cv_target)
+{
+    if (n < 2) return 0;
+
+    double mean = 0.0;
+    for (int i = 0; i < n; i++) mean += samples[i];
+    mean /= n;
+
+    double var = 0.0;
+    for (int i = 0; i < n; i++) {
+        double d = samples[i] - mean;
+        var += d * d;
+    }
+    double cv2 = (var / (n - 1)) / (mean * mean);
+    return cv2 < cv_target * cv_target;
+}
+
+/* Summarise n samples; scale converts to the reported unit. */
+static void fill_stats(bench_stats_t *st, const double *samples, int n, double scale)
+{
+    double tmp[BENCH_MAX_SAMPLES];
+
+    memset(st, 0, sizeof(*st));
+    if (n <= 0) return;
+    if (n > BENCH_MAX_SAMPLES) n = BENCH_MAX_SAMPLES;
+
+    for (int i = 0; i < n; i++) tmp[i] = samples[i] * scale;
+    qsort(tmp, n, sizeof(double), cmp_double);
+
+    double mean = 0.0, var = 0.0;
+    for (int i = 0; i < n; i++) mean += tmp[i];
+    mean /= n;
+    for (int i = 0; i < n; i++) var += (tmp[i] - mean) * (tmp[i] - mean);
+    if (n > 1) var /= n - 1;
+
+    int p99 = (n * 99 + 99) / 100 - 1;   /* nearest rank */
+    if (p99 >= n) p99 = n - 1;
+
+    st->nsamples = n;
+    st->min      = tmp[0];
+    st->median   = tmp[n / 2];
+    st->p99      = tmp[p99];
+    st->max      = tmp[n - 1];
+    st->mean     = mean;
+    st->stddev   = sqrt(var);
+}
+
 /* forward declaration — defined in the Cache flush section below */
 static void flush_buffer(const void *ptr, size_t bytes);
 
@@ -165,36 +383,103 @@ static void flush_buffer(const void *ptr, size_t bytes);
  */
 #define LAT_SAMPLES 9
 
+/*
+ * Chain layouts (BENCH_CHAIN_*).  Random visits every line in one shuffled
+ * order, so with 4 KB pages nearly every load also misses the TLB and the
+ * DRAM figure includes a page walk.  Page-local shuffles the PAGE_LINES
+ * lines of each 4 KB page but walks the pages in address order: one TLB
+ * miss per page, while each load within it still hits a random line.
+ */
+#define PAGE_LINES (4096 / CACHELINE)
+
+static void chain_order(size_t *perm, size_t n, int layout, uint64_t *rng)
+{
+    for (size_t i = 0; i < n; i++) perm[i] = i;
+    if (layout != BENCH_CHAIN_PAGE_LOCAL) {
+        shuffle(perm, n, rng);
+        return;
+    }
+    for (size_t i = 0; i < n; i += PAGE_LINES)
+        shuffle(perm + i, n - i < PAGE_LINES ? n - i : PAGE_LINES, rng);
+}
+
+/*
+ * Link perm into nchains disjoint cycles: chain c takes the c-th contiguous
+ * slice of the order (whole pages when page-local), heads[c] (may be NULL
+ * for one chain) its first node.  Needs n ≥ nchains × PAGE_LINES.
+ */
+static void link_chains(node_t *nodes, const size_t *perm, size_t n, int layout,
+                        int nchains, node_t **heads)
+{
+    for (int c = 0; c < nchains; c++) {
+        size_t lo = n * (size_t)c / (size_t)nchains;
+        size_t hi = n * (size_t)(c + 1) / (size_t)nchains;
+        if (layout == BENCH_CHAIN_PAGE_LOCAL) {
+            lo -= lo % PAGE_LINES;
+            if (c + 1 < nchains) hi -= hi % PAGE_LINES;
+        }
+        for (size_t i = lo; i + 1 < hi; i++)
+            nodes[perm[i]].next = &nodes[perm[i + 1]];
+        nodes[perm[hi - 1]].next = &nodes[perm[lo]];
+        if (heads) heads[c] = &nodes[perm[lo]];
+    }
+}
+
+/* Seed: mix buffer address (unique per alloc) with wall time so two
+ * back-to-back calls never produce the same permutation. */
+static uint64_t chain_seed(const void *nodes)
+{
+    uint64_t rng = (uint64_t)(uintptr_t)nodes ^ (uint64_t)time(NULL);
+    return rng ? rng : 0xdeadbeefcafe0001ULL;
+}
+
+/*
+ * Allocate n nodes and link them into one cycle laid out as layout.
+ * Returns NULL on allocation failure; free with
+ * bench_free_pages(nodes, n * sizeof(node_t)).
+ */
+static node_t *build_chain(size_t n, int layout, page_mode_t pages)
+{
+    size_t alloc_bytes = n * sizeof(node_t);
+    node_t *nodes = bench_alloc_pages(alloc_bytes, pages);
+    if (!nodes) return NULL;
+
+    size_t *perm = malloc(n * sizeof(size_t));
+    if (!perm) { bench_free_pages(nodes, alloc_bytes, pages); return NULL; }
+
+    uint64_t rng = chain_seed(nodes);
+    chain_order(perm, n, layout, &rng);
+    link_chains(nodes, perm, n, layout, 1, NULL);
+    free(perm);
+    return nodes;
+}
+
 /*
  * flush_each=1: clflushopt every node before each timed sample.
  * Required for DRAM latency — without it the warm-up pass (and previous
  * samples) leave nodes resident in L3/V-Cache, making what should be a DRAM
  * measurement look suspiciously fast.  For L1/L2/L3 the buffer already fits
  * inside the target cache level, so flushing would defeat the purpose.
+ *
+ * layout is the BENCH_CHAIN_* order of the chain.
+ *
+ * Takes between min_samples and max_samples (≤ BENCH_MAX_SAMPLES) samples,
+ * stopping early once cv_converged() or when tok is cancelled; stores them
+ * in measurement order and returns the count (0 on failure).  tok advances
+ * one unit per sample, max_samples all told.
  */
-static double measure_latency_ns(size_t buf_bytes, long long min_accesses,
-                                  int nsamples, int flush_each)
+static int measure_latency(size_t buf_bytes, long long min_accesses,
+                           int min_samples, int max_samples, double cv_target,
+                           int flush_each, int layout, page_mode_t pages,
+                           double *samples, bench_token_t *tok)
 {
     size_t n = buf_bytes / sizeof(node_t);
-    if (n < 64) return 0.0;
+    if (n < PAGE_LINES) return 0;
+    if (max_samples > BENCH_MAX_SAMPLES) max_samples = BENCH_MAX_SAMPLES;
 
     size_t alloc_bytes = n * sizeof(node_t);
-    node_t *nodes = bench_alloc(alloc_bytes);
-    if (!nodes) return 0.0;
-
-    size_t *perm = malloc(n * sizeof(size_t));
-    if (!perm) { bench_free(nodes, alloc_bytes); return 0.0; }
-
-    /* Seed: mix buffer address (unique per alloc) with wall time so two
-     * back-to-back calls never produce the same permutation. */
-    uint64_t rng = (uint64_t)(uintptr_t)nodes ^ (uint64_t)time(NULL);
-    if (!rng) rng = 0xdeadbeefcafe0001ULL;
-
-    for (size_t i = 0; i < n; i++) perm[i] = i;
-    shuffle(perm, n, &rng);
-    for (size_t i = 0; i < n; i++)
-        nodes[perm[i]].next = &nodes[perm[(i + 1) % n]];
-    free(perm);
+    node_t *nodes = build_chain(n, layout, pages);
+    if (!nodes) return 0;
 
     long long passes = (min_accesses + (long long)n - 1) / (long long)n;
     if (passes < 1) passes = 1;
@@ -203,8 +488,8 @@ static double measure_latency_ns(size_t buf_bytes, long long min_accesses,
     volatile node_t *p = nodes;
     for (size_t i = 0; i < n; i++) p = p->next;
 
-    double samples[LAT_SAMPLES]; /* LAT_SAMPLES is the max; nsamples <= LAT_SAMPLES */
-    for (int s = 0; s < nsamples; s++) {
+    int s;
+    for (s = 0; s < max_samples && !bench_token_cancelled(tok); ) {
         /* For DRAM: evict every node so the traversal truly goes to DRAM,
          * not a cache level warmed by the previous sample. */
         if (flush_each)
@@ -213,13 +498,30 @@ static double measure_latency_ns(size_t buf_bytes, long long min_accesses,
         for (long long k = 0; k < passes; k++)
             for (size_t i = 0; i < n; i++) p = p->next;
         long long t1 = now_ns();
-        samples[s] = (double)(t1 - t0) / ((double)passes * (double)n);
+        samples[s++] = (double)(t1 - t0) / ((double)passes * (double)n);
+        bench_token_advance(tok, 1);
+
+        if (s >= min_samples && cv_converged(samples, s, cv_target))
+            break;
     }
+    bench_token_advance(tok, max_samples - s);
+
+    bench_free_pages(nodes, alloc_bytes, pages);
+    return s;
+}
 
-    bench_free(nodes, alloc_bytes);
+/* Fixed nsamples, median in ns */
+static double measure_latency_ns(size_t buf_bytes, long long min_accesses,
+                                  int nsamples, int flush_each, int layout,
+                                  page_mode_t pages, bench_token_t *tok)
+{
+    double samples[BENCH_MAX_SAMPLES];
+    int n = measure_latency(buf_bytes, min_accesses, nsamples, nsamples, 0.0,
+                            flush_each, layout, pages, samples, tok);
+    if (n == 0) return 0.0;
 
-    qsort(samples, nsamples, sizeof(double), cmp_double);
-    return samples[nsamples / 2]; /* median */
+    qsort(samples, n, sizeof(double), cmp_double);
+    return samples[n / 2]; /* median */
 }
 
 /* ── Cache flush helper ───────────────────────────────────────────────── */
@@ -247,7 +549,17 @@ static void flush_buffer(const void *ptr, size_t bytes)
 #define BW_CV_TARGET   0.01       /* stop when stddev/mean < 1%             */
 #define MAX_THREADS    256
 
-typedef enum { OP_READ, OP_WRITE, OP_COPY, OP_EXIT } bw_op_t;
+typedef enum { OP_READ, OP_WRITE, OP_COPY, OP_PARK } bw_op_t;
+
+/* One run's kernels — resolved once in bw_select_kernels(), not per pass */
+typedef struct {
+    void (*read)(const uint64_t *a, size_t n, size_t pf);
+    void (*write)(uint64_t *a, size_t n);
+    void (*copy)(uint64_t *dst, const uint64_t *src, size_t n, size_t pf);
+    size_t pf;                 /* prefetch distance, uint64_t elements */
+    int    variant;            /* BENCH_BWK_* actually used            */
+    int    avx512;
+} bw_kernels_t;
 
 typedef struct {
     uint64_t          *buf_a;      /* read src / write dst / copy dst     */
@@ -255,8 +567,10 @@ typedef struct {
     size_t             n;          /* uint64_t elements for this thread   */
     int                cpu;        /* logical CPU to pin to               */
     bw_op_t            op;         /* operation to perform each pass      */
+    const bw_kernels_t *kern;      /* read/write/copy for this run        */
     pthread_barrier_t *bar_start;  /* barrier: main releases workers      */
     pthread_barrier_t *bar_end;    /* barrier: workers signal done        */
+    unsigned           gen;        /* last pool generation served         */
 } bw_arg_t;
 
 /*
@@ -301,22 +615,22 @@ typedef struct {
  */
 #define PF_DIST_U64 1024  /* uint64_t ahead to prefetch (= 8 192 bytes = 128 CL) */
 
+/*
+ * The read/copy kernels take the distance as a `pf` argument (uint64_t
+ * elements, 0 = no software prefetch) so it can be swept per run; the
+ * default stays PF_DIST_U64.
+ */
+
 /* forward declarations — AVX-512 variants defined before do_write below */
 #if defined(__GNUC__) || defined(__clang__)
-static void do_read_avx512(const uint64_t *a, size_t n);
+static void do_read_avx512(const uint64_t *a, size_t n, size_t pf);
 static void do_write_avx512(uint64_t *a, size_t n);
-static void do_copy_avx512(uint64_t *dst, const uint64_t *src, size_t n);
+static void do_copy_avx512(uint64_t *dst, const uint64_t *src, size_t n, size_t pf);
 #endif
 
 __attribute__((optimize("O3,tree-vectorize")))
-static void do_read(const uint64_t *a, size_t n)
+static void do_read(const uint64_t *a, size_t n, size_t pf)
 {
-#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
-    if (__builtin_cpu_supports("avx512f")) {
-        do_read_avx512(a, n);
-        return;
-    }
-#endif
 #if defined(__AVX2__)
     size_t n32 = n & ~(size_t)31; /* 32 uint64_t = 8 YMM per iteration */
     __m256i v0 = _mm256_setzero_si256();
@@ -329,12 +643,14 @@ static void do_read(const uint64_t *a, size_t n)
     __m256i v7 = _mm256_setzero_si256();
     for (size_t i = 0; i < n32; i += 32) {
         /* 4 prefetch hints per iteration, each covering one 64-byte cache line,
-         * issued PF_DIST_U64 elements (8 192 bytes) ahead of the current position.
+         * issued pf elements (default 8 192 bytes) ahead of the current position.
          * This keeps ~128 DRAM requests outstanding so the memory bus stays full. */
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 +  0], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 +  8], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 16], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 24], _MM_HINT_NTA);
+        if (pf) {
+            _mm_prefetch((const char *)&a[i + pf +  0], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf +  8], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 16], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 24], _MM_HINT_NTA);
+        }
         v0 = _mm256_xor_si256(v0, _mm256_loadu_si256((const __m256i *)&a[i+ 0]));
         v1 = _mm256_xor_si256(v1, _mm256_loadu_si256((const __m256i *)&a[i+ 4]));
         v2 = _mm256_xor_si256(v2, _mm256_loadu_si256((const __m256i *)&a[i+ 8]));
@@ -353,6 +669,7 @@ static void do_read(const uint64_t *a, size_t n)
     for (size_t i = n32; i < n; i++) stail ^= a[i];
     __asm__ volatile("" : "+r"(stail));
 #else
+    (void)pf;
     /* Fallback: 32 scalar accumulators */
     size_t n32 = n & ~(size_t)31;
     uint64_t s0,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13,s14,s15,
@@ -378,9 +695,9 @@ static void do_read(const uint64_t *a, size_t n)
 /* ── AVX-512 kernel variants (runtime-dispatched) ─────────────────────────
  *
  * __attribute__((target("avx512f"))) compiles each function with AVX-512
- * even when the TU is built with -mavx2 only.  __builtin_cpu_supports() in
- * the callers selects the right path at runtime so the binary still runs on
- * non-AVX-512 CPUs without SIGILL.
+ * even when the TU is built with -mavx2 only.  bw_select_kernels() checks
+ * __builtin_cpu_supports() once per run and picks the right path, so the
+ * binary still runs on non-AVX-512 CPUs without SIGILL.
  *
  * Why AVX-512 NT stores close the gap to Windows tools:
  *   _mm512_stream_si512 writes one full 64-byte cache line per instruction,
@@ -395,7 +712,7 @@ static void do_read(const uint64_t *a, size_t n)
 #if defined(__GNUC__) || defined(__clang__)
 
 __attribute__((target("avx512f")))
-static void do_read_avx512(const uint64_t *a, size_t n)
+static void do_read_avx512(const uint64_t *a, size_t n, size_t pf)
 {
     /*
      * 8 ZMM accumulators × 64 bytes = 512 bytes (8 cache lines) per iteration.
@@ -413,14 +730,16 @@ static void do_read_avx512(const uint64_t *a, size_t n)
     __m512i v6 = _mm512_setzero_si512();
     __m512i v7 = _mm512_setzero_si512();
     for (size_t i = 0; i < n64; i += 64) {
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 +  0], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 +  8], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 16], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 24], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 32], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 40], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 48], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&a[i + PF_DIST_U64 + 56], _MM_HINT_NTA);
+        if (pf) {
+            _mm_prefetch((const char *)&a[i + pf +  0], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf +  8], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 16], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 24], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 32], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 40], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 48], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&a[i + pf + 56], _MM_HINT_NTA);
+        }
         v0 = _mm512_xor_si512(v0, _mm512_loadu_si512((const __m512i *)&a[i+ 0]));
         v1 = _mm512_xor_si512(v1, _mm512_loadu_si512((const __m512i *)&a[i+ 8]));
         v2 = _mm512_xor_si512(v2, _mm512_loadu_si512((const __m512i *)&a[i+16]));
@@ -453,7 +772,7 @@ static void do_write_avx512(uint64_t *a, size_t n)
 }
 
 __attribute__((target("avx512f")))
-static void do_copy_avx512(uint64_t *dst, const uint64_t *src, size_t n)
+static void do_copy_avx512(uint64_t *dst, const uint64_t *src, size_t n, size_t pf)
 {
     /*
      * 8 ZMM loads + 8 ZMM NT stores = 512 bytes (8 cache lines) per iteration.
@@ -472,14 +791,16 @@ static void do_copy_avx512(uint64_t *dst, const uint64_t *src, size_t n)
      */
     size_t n64 = n & ~(size_t)63; /* 64 uint64_t = 8 ZMM per iteration */
     for (size_t i = 0; i < n64; i += 64) {
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 +  0], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 +  8], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 16], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 24], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 32], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 40], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 48], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 56], _MM_HINT_NTA);
+        if (pf) {
+            _mm_prefetch((const char *)&src[i + pf +  0], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf +  8], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 16], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 24], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 32], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 40], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 48], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 56], _MM_HINT_NTA);
+        }
         __m512i v0 = _mm512_loadu_si512((const __m512i *)&src[i+ 0]);
         __m512i v1 = _mm512_loadu_si512((const __m512i *)&src[i+ 8]);
         __m512i v2 = _mm512_loadu_si512((const __m512i *)&src[i+16]);
@@ -507,13 +828,6 @@ static void do_copy_avx512(uint64_t *dst, const uint64_t *src, size_t n)
 __attribute__((optimize("O3,tree-vectorize")))
 static void do_write(uint64_t *a, size_t n)
 {
-#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
-    if (__builtin_cpu_supports("avx512f")) {
-        do_write_avx512(a, n);
-        return;
-    }
-#endif
-
     static const uint64_t PAT = 0xDEADBEEFCAFEBABEULL;
 
 #if defined(__AVX2__)
@@ -569,29 +883,25 @@ static void do_write(uint64_t *a, size_t n)
  *   unroll reduces contention on the shared memory controller request queues
  *   by issuing larger, more coherent bursts from each core's thread.
  *
- *   Prefetch: 4 hints per iteration covering 4 cache lines at PF_DIST_U64
+ *   Prefetch: 4 hints per iteration covering 4 cache lines at pf
  *   ahead, matching the 4 CL of src loaded this iteration.  dst is NT-stored
  *   so needs no prefetch.
  */
 __attribute__((optimize("O3,tree-vectorize")))
-static void do_copy(uint64_t *dst, const uint64_t *src, size_t n)
+static void do_copy(uint64_t *dst, const uint64_t *src, size_t n, size_t pf)
 {
-#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
-    if (__builtin_cpu_supports("avx512f")) {
-        do_copy_avx512(dst, src, n);
-        return;
-    }
-#endif
 #if defined(__AVX2__)
     size_t n32 = n & ~(size_t)31; /* 32 uint64_t = 8 YMM per iteration */
 
     for (size_t i = 0; i < n32; i += 32) {
         /* 4 prefetch hints = 4 cache lines = one full iteration's worth of src,
-         * issued PF_DIST_U64 elements ahead so DRAM latency is hidden. */
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 +  0], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 +  8], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 16], _MM_HINT_NTA);
-        _mm_prefetch((const char *)&src[i + PF_DIST_U64 + 24], _MM_HINT_NTA);
+         * issued pf elements ahead so DRAM latency is hidden. */
+        if (pf) {
+            _mm_prefetch((const char *)&src[i + pf +  0], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf +  8], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 16], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 24], _MM_HINT_NTA);
+        }
         /* 8 loads first — all hit in L1 due to prefetch from 32 iters ago */
         __m256i v0 = _mm256_loadu_si256((const __m256i *)&src[i+ 0]);
         __m256i v1 = _mm256_loadu_si256((const __m256i *)&src[i+ 4]);
@@ -615,6 +925,91 @@ static void do_copy(uint64_t *dst, const uint64_t *src, size_t n)
     for (size_t i = n32; i < n; i++)
         dst[i] = src[i];
 #else
+    (void)pf;
+    for (size_t i = 0; i < n; i++)
+        dst[i] = src[i];
+#endif
+
+    __asm__ volatile("" ::: "memory");
+}
+
+/* ── Store-strategy variants ──────────────────────────────────────────
+ *
+ * The NT kernels above hide the write-allocate (RFO) read that a regular
+ * store pays for every line it misses on.  That is the raw DRAM write
+ * bandwidth, but it is not what ordinary code sees.  These variants measure
+ * the other two paths most code actually takes:
+ *
+ *   temporal — plain vector stores: each missed line is read (RFO), filled,
+ *              and later written back, so DRAM carries ~2× the bytes.  The
+ *              gap to the NT number is the RFO tax (large on Zen 5).
+ *   erms     — rep stosb / rep movsb, i.e. what memset/memcpy use for large
+ *              sizes on CPUs with ERMS/FSRM.  Microcode picks the protocol
+ *              (it switches to streaming-like stores past a size threshold).
+ */
+__attribute__((optimize("O3,tree-vectorize")))
+static void do_write_temporal(uint64_t *a, size_t n)
+{
+    static const uint64_t PAT = 0xDEADBEEFCAFEBABEULL;
+
+#if defined(__AVX2__)
+    __m256i vpat = _mm256_set1_epi64x((long long)PAT);
+    size_t  n32  = n & ~(size_t)31;
+
+    for (size_t i = 0; i < n32; i += 32) {
+        _mm256_storeu_si256((__m256i *)&a[i+ 0], vpat);
+        _mm256_storeu_si256((__m256i *)&a[i+ 4], vpat);
+        _mm256_storeu_si256((__m256i *)&a[i+ 8], vpat);
+        _mm256_storeu_si256((__m256i *)&a[i+12], vpat);
+        _mm256_storeu_si256((__m256i *)&a[i+16], vpat);
+        _mm256_storeu_si256((__m256i *)&a[i+20], vpat);
+        _mm256_storeu_si256((__m256i *)&a[i+24], vpat);
+        _mm256_storeu_si256((__m256i *)&a[i+28], vpat);
+    }
+    for (size_t i = n32; i < n; i++)
+        a[i] = PAT;
+#else
+    for (size_t i = 0; i < n; i++)
+        a[i] = PAT;
+#endif
+
+    __asm__ volatile("" ::: "memory");
+}
+
+__attribute__((optimize("O3,tree-vectorize")))
+static void do_copy_temporal(uint64_t *dst, const uint64_t *src, size_t n, size_t pf)
+{
+#if defined(__AVX2__)
+    size_t n32 = n & ~(size_t)31;
+
+    for (size_t i = 0; i < n32; i += 32) {
+        if (pf) {
+            _mm_prefetch((const char *)&src[i + pf +  0], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf +  8], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 16], _MM_HINT_NTA);
+            _mm_prefetch((const char *)&src[i + pf + 24], _MM_HINT_NTA);
+        }
+        __m256i v0 = _mm256_loadu_si256((const __m256i *)&src[i+ 0]);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *)&src[i+ 4]);
+        __m256i v2 = _mm256_loadu_si256((const __m256i *)&src[i+ 8]);
+        __m256i v3 = _mm256_loadu_si256((const __m256i *)&src[i+12]);
+        __m256i v4 = _mm256_loadu_si256((const __m256i *)&src[i+16]);
+        __m256i v5 = _mm256_loadu_si256((const __m256i *)&src[i+20]);
+        __m256i v6 = _mm256_loadu_si256((const __m256i *)&src[i+24]);
+        __m256i v7 = _mm256_loadu_si256((const __m256i *)&src[i+28]);
+        _mm256_storeu_si256((__m256i *)&dst[i+ 0], v0);
+        _mm256_storeu_si256((__m256i *)&dst[i+ 4], v1);
+        _mm256_storeu_si256((__m256i *)&dst[i+ 8], v2);
+        _mm256_storeu_si256((__m256i *)&dst[i+12], v3);
+        _mm256_storeu_si256((__m256i *)&dst[i+16], v4);
+        _mm256_storeu_si256((__m256i *)&dst[i+20], v5);
+        _mm256_storeu_si256((__m256i *)&dst[i+24], v6);
+        _mm256_storeu_si256((__m256i *)&dst[i+28], v7);
+    }
+    for (size_t i = n32; i < n; i++)
+        dst[i] = src[i];
+#else
+    (void)pf;
     for (size_t i = 0; i < n; i++)
         dst[i] = src[i];
 #endif
@@ -622,36 +1017,106 @@ static void do_copy(uint64_t *dst, const uint64_t *src, size_t n)
     __asm__ volatile("" ::: "memory");
 }
 
+static void do_write_erms(uint64_t *a, size_t n)
+{
+    size_t bytes = n * sizeof(uint64_t);
+    __asm__ volatile("rep stosb"
+                     : "+D"(a), "+c"(bytes)
+                     : "a"(0xBE)
+                     : "memory");
+}
+
+static void do_copy_erms(uint64_t *dst, const uint64_t *src, size_t n, size_t pf)
+{
+    (void)pf;   /* microcoded — software prefetch would only compete with it */
+    size_t bytes = n * sizeof(uint64_t);
+    __asm__ volatile("rep movsb"
+                     : "+D"(dst), "+S"(src), "+c"(bytes)
+                     :: "memory");
+}
+
 /*
- * Worker thread: pins itself to a specific logical CPU, then loops waiting
- * on bar_start.  Main sets op before releasing bar_start.  After the work,
- * the worker hits bar_end to signal completion (except OP_EXIT — it returns
- * directly so main can pthread_join without another barrier wait).
+ * pf_bytes: 0 = PF_DIST_U64, < 0 = no software prefetch.  Reads always use
+ * the widest vector kernel; the variant only changes how write/copy store.
  */
-static void *bw_worker(void *varg)
+static void bw_select_kernels(int variant, int pf_bytes, bw_kernels_t *k)
 {
-    bw_arg_t *a = varg;
+    static int avx512 = -1;
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__AVX2__)
+    if (avx512 < 0) avx512 = __builtin_cpu_supports("avx512f") ? 1 : 0;
+#else
+    avx512 = 0;
+#endif
 
-    cpu_set_t cs;
-    CPU_ZERO(&cs);
-    CPU_SET(a->cpu, &cs);
-    pthread_setaffinity_np(pthread_self(), sizeof(cs), &cs);
+    if (variant <= BENCH_BWK_DEFAULT || variant >= BENCH_BWK_COUNT)
+        variant = BENCH_BWK_NT;
+    k->variant = variant;
+    k->avx512  = avx512;
+    k->pf      = pf_bytes == 0 ? PF_DIST_U64
+               : pf_bytes < 0  ? 0 : ((size_t)pf_bytes + 7) / sizeof(uint64_t);
+
+    k->read = do_read;
+#if defined(__GNUC__) || defined(__clang__)
+    if (avx512) k->read = do_read_avx512;
+#endif
 
+    switch (variant) {
+    case BENCH_BWK_TEMPORAL:
+        k->write = do_write_temporal;
+        k->copy  = do_copy_temporal;
+        break;
+    case BENCH_BWK_ERMS:
+        k->write = do_write_erms;
+        k->copy  = do_copy_erms;
+        break;
+    default:
+        k->write = do_write;
+        k->copy  = do_copy;
+#if defined(__GNUC__) || defined(__clang__)
+        if (avx512) {
+            k->write = do_write_avx512;
+            k->copy  = do_copy_avx512;
+        }
+#endif
+        break;
+    }
+}
+
+const char *bench_bw_kernel_name(int variant)
+{
+    switch (variant) {
+    case BENCH_BWK_NT:       return "NT stores";
+    case BENCH_BWK_TEMPORAL: return "regular stores";
+    case BENCH_BWK_ERMS:     return "rep movsb/stosb";
+    default:                 return "default";
+    }
+}
+
+/*
+ * Worker pass loop: waits on bar_start; main sets op before releasing it.
+ * After the work, the worker hits bar_end to signal completion.  OP_PARK
+ * also goes through bar_end before returning to the pool, so once main is
+ * past bar_end no worker still reads its bw_arg_t and the next run may
+ * rewrite it.
+ */
+static void bw_worker(bw_arg_t *a)
+{
     for (;;) {
         pthread_barrier_wait(a->bar_start);
 
         switch (a->op) {
         case OP_READ:
-            do_read(a->buf_a, a->n);
+            a->kern->read(a->buf_a, a->n, a->kern->pf);
             break;
         case OP_WRITE:
-            do_write(a->buf_a, a->n);
+            a->kern->write(a->buf_a, a->n);
             break;
         case OP_COPY:
-            do_copy(a->buf_a, a->buf_b, a->n);
+            a->kern->copy(a->buf_a, a->buf_b, a->n, a->kern->pf);
             break;
-        case OP_EXIT:
-            return NULL;
+        case OP_PARK:
+            pthread_barrier_wait(a->bar_end);
+            return;
         }
 
         pthread_barrier_wait(a->bar_end);
@@ -685,7 +1150,8 @@ static void evict_with_sweep(uint8_t *ev, size_t bytes)
 
 /*
  * Run bandwidth passes until the coefficient of variation (CV = σ/μ) of the
- * collected samples drops below BW_CV_TARGET (1%), then return the median.
+ * collected samples drops below cv_target (BW_CV_TARGET = 1% by default),
+ * then return the median.  st receives the full distribution.
  *
  * Why CV instead of a fixed pass count:
  *   On a quiet system, 3–5 passes usually converge.  Under background load
@@ -694,8 +1160,6 @@ static void evict_with_sweep(uint8_t *ev, size_t bytes)
  *   unreliable median) and over-samples quiet ones (wasted time).  Stopping
  *   on CV < 1% gives consistent accuracy regardless of system noise.
  *
- *   CV² is compared against BW_CV_TARGET² to avoid a sqrt() in the hot path.
- *
  * stream_mult=1 for read/write, 2 for copy (STREAM convention: src read +
  * dst write = 2× bytes of memory traffic).
  */
@@ -703,12 +1167,16 @@ static double run_bw_passes(bw_arg_t *args, int nthreads,
                              pthread_barrier_t *bar_start,
                              pthread_barrier_t *bar_end,
                              bw_op_t op, size_t total_bytes, int stream_mult,
-                             uint8_t *evict_buf, size_t evict_bytes)
+                             uint8_t *evict_buf, size_t evict_bytes,
+                             int min_passes, int max_passes, double cv_target,
+                             bench_stats_t *st, bench_token_t *tok)
 {
     double samples[BW_MAX_PASSES];
-    int    npass = 0;
+    int    n = 0;
 
-    for (npass = 0; npass < BW_MAX_PASSES; npass++) {
+    if (max_passes > BW_MAX_PASSES) max_passes = BW_MAX_PASSES;
+
+    while (n < max_passes && !bench_token_cancelled(tok)) {
         /* Flush all chunks outside the timed window so every access is cold */
         for (int t = 0; t < nthreads; t++) {
             flush_buffer(args[t].buf_a, args[t].n * sizeof(uint64_t));
@@ -731,188 +1199,76 @@ static double run_bw_passes(bw_arg_t *args, int nthreads,
         pthread_barrier_wait(bar_end);
         long long t1 = now_ns();
 
-        samples[npass] = (double)((size_t)stream_mult * total_bytes) /
-                         ((double)(t1 - t0) * 1e-9) / 1e6;
+        samples[n++] = (double)((size_t)stream_mult * total_bytes) /
+                       ((double)(t1 - t0) * 1e-9) / 1e6;
+        bench_token_advance(tok, 1);
 
         /* Check convergence after the minimum number of passes */
-        if (npass + 1 >= BW_MIN_PASSES) {
-            int    n    = npass + 1;
-            double mean = 0.0;
-            for (int i = 0; i < n; i++) mean += samples[i];
-            mean /= n;
-
-            double var = 0.0;
-            for (int i = 0; i < n; i++) {
-                double d = samples[i] - mean;
-                var += d * d;
-            }
-            /*
-             * Sample variance (Bessel's correction: divide by n-1, not n).
-             * Population variance (÷n) underestimates the true spread by the
-             * factor n/(n-1).  At BW_MIN_PASSES=5 that is a 25% underestimate,
-             * meaning the check could declare convergence when the real CV is
-             * 1.25% — 25% over the 1% target.  The unbiased estimator (÷(n-1))
-             * gives the correct answer.
-             * CV² < target² avoids sqrt(); target=1% → target²=0.0001.
-             */
-            double cv2 = (var / (n - 1)) / (mean * mean);
-            if (cv2 < (BW_CV_TARGET * BW_CV_TARGET))
-                break;
-        }
+        if (n >= min_passes && cv_converged(samples, n, cv_target))
+            break;
     }
+    bench_token_advance(tok, max_passes - n);
 
-    /*
-     * When the loop exhausts all BW_MAX_PASSES without converging, the for-loop
-     * post-increment leaves npass == BW_MAX_PASSES, but only BW_MAX_PASSES
-     * samples were collected (indices 0..BW_MAX_PASSES-1).  Using npass+1 here
-     * would read samples[BW_MAX_PASSES] — one past the end of the array (UB)
-     * and a wrong median index.
-     */
-    int n = (npass < BW_MAX_PASSES) ? npass + 1 : BW_MAX_PASSES;
-    qsort(samples, n, sizeof(double), cmp_double);
-    return samples[n / 2];
+    fill_stats(st, samples, n, 1.0);
+    return st->median;
 }
 
 /* ── Physical core enumeration ────────────────────────────────────────── */
 
-typedef struct {
-    int pkg;
-    int core;
-} core_key_t;
-
 /*
- * Build a list of logical CPUs, one per physical core, by walking
- * sysfs CPU topology (physical_package_id/core_id).
+ * One logical CPU per physical core — the lowest sibling of each core in
+ * the shared topology model.
  *
  * This avoids SMT siblings running separate worker threads which can
  * otherwise contend for per-core resources (ROB, store queue, etc.) and
  * slightly depress the measured DRAM bandwidth.
- *
- * Fallback: if topology files are missing or unreadable, we just use the
- * online logical CPU count from sysconf().
  */
 static int build_cpu_list(int *cpus, int max_cpus)
 {
-    core_key_t seen[1024];
-    int        nseen = 0;
-    int        ncpus = 0;
-
-    /*
-     * Use _SC_NPROCESSORS_CONF (configured CPUs) rather than a hardcoded
-     * 1024.  On systems with CPU hotplug or cgroup CPU restrictions the
-     * numbering can have gaps (e.g. cpu0, cpu1, cpu4, cpu5 …).  Using
-     * `break` on the first missing entry would stop early and miss the
-     * remaining CPUs; `continue` skips the gap and keeps scanning.
-     */
-    long max_possible = sysconf(_SC_NPROCESSORS_CONF);
-    if (max_possible <= 0) max_possible = 1024;
-
-    for (int cpu = 0; cpu < (int)max_possible && ncpus < max_cpus; cpu++) {
-        char path[160];
-        FILE *f;
-        int   core_id = -1, pkg_id = -1;
-
-        snprintf(path, sizeof(path),
-                 "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
-        f = fopen(path, "r");
-        if (!f) {
-            /* CPU may be offline or hotplugged out — skip this slot. */
-            continue;
-        }
-        if (fscanf(f, "%d", &core_id) != 1) {
-            fclose(f);
-            continue;
-        }
-        fclose(f);
-
-        snprintf(path, sizeof(path),
-                 "/sys/devices/system/cpu/cpu%d/topology/physical_package_id",
-                 cpu);
-        f = fopen(path, "r");
-        if (!f || fscanf(f, "%d", &pkg_id) != 1) {
-            if (f) fclose(f);
-            continue;
-        }
-        fclose(f);
-
-        int duplicate = 0;
-        for (int i = 0; i < nseen; i++) {
-            if (seen[i].pkg == pkg_id && seen[i].core == core_id) {
-                duplicate = 1;
-                break;
-            }
-        }
-        if (duplicate)
-            continue;
-
-        if (nseen < (int)(sizeof(seen) / sizeof(seen[0]))) {
-            seen[nseen].pkg  = pkg_id;
-            seen[nseen].core = core_id;
-            nseen++;
-        }
-
-        cpus[ncpus++] = cpu;
-    }
-
-    if (ncpus == 0) {
-        long n = sysconf(_SC_NPROCESSORS_ONLN);
-        if (n <= 0 || n > max_cpus) n = 1;
-        for (int i = 0; i < (int)n; i++)
-            cpus[i] = i;
-        ncpus = (int)n;
-    }
-
-    return ncpus;
+    const topology_t *t = topology_get();
+    int n = t->ncores < max_cpus ? t->ncores : max_cpus;
+    for (int c = 0; c < n; c++)
+        cpus[c] = t->core_cpu[c];
+    return n;
 }
 
 /* ── Detect DRAM buffer size ─────────────────────────────────────────── */
+/*
+ * Read the size reported by sysfs for a specific cache level of cpu.
+ * sysfs reports in kB (e.g. "32K" → strtoul gives 32 → ×1024 = 32768).
+ * index mapping: 0=L1D, 1=L1I, 2=L2, 3=L3.
+ * Returns 0 if the file is absent or unparseable.
+ */
+static size_t read_cache_size(int cpu, int index)
+{
+    char path[160], buf[32] = {0};
+    snprintf(path, sizeof(path),
+             "/sys/devices/system/cpu/cpu%d/cache/index%d/size", cpu, index);
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    if (!fgets(buf, sizeof(buf), f)) { fclose(f); return 0; }
+    fclose(f);
+    return strtoul(buf, NULL, 10) * 1024UL;
+}
+
 /*
  * Sum the L3 size across all unique cache instances (one per CCD on
- * multi-CCD CPUs) then use 4× that total, with a 512 MB floor.
+ * multi-CCD CPUs) then use 4× that total, with a 512 MB floor.  Each L3
+ * domain of the topology model is counted once, through its first core.
  *
  * The separate eviction buffer in bench_run() uses 2×this value so the
  * shared caches are fully churned between passes even on 3D V-Cache parts.
  */
 static size_t dram_buf_bytes(void)
 {
+    const topology_t *t = topology_get();
     size_t total_l3 = 0;
 
-    /*
-     * Use _SC_NPROCESSORS_CONF as the bound and `continue` on missing entries
-     * for the same reason as build_cpu_list: on dual-CCD systems (e.g. 9950X3D)
-     * or systems with offline CPUs, CPU numbers can have gaps.  A `break` on
-     * the first missing sysfs entry would miss all CCDs beyond the gap and
-     * drastically under-count total L3, producing a buffer too small to force
-     * DRAM accesses and producing inflated (cache-hitting) bandwidth results.
-     */
-    long max_possible = sysconf(_SC_NPROCESSORS_CONF);
-    if (max_possible <= 0) max_possible = 1024;
-
-    for (int cpu = 0; cpu < (int)max_possible; cpu++) {
-        char path[128];
-        snprintf(path, sizeof(path),
-                 "/sys/devices/system/cpu/cpu%d/cache/index3/size", cpu);
-        FILE *f = fopen(path, "r");
-        if (!f) continue;
-        char buf[32] = {0};
-        size_t sz = 0;
-        if (fgets(buf, sizeof(buf), f))
-            sz = strtoul(buf, NULL, 10) * 1024;
-        fclose(f);
-
-        snprintf(path, sizeof(path),
-                 "/sys/devices/system/cpu/cpu%d/cache/index3/shared_cpu_list", cpu);
-        f = fopen(path, "r");
-        if (f) {
-            char list[64] = {0};
-            int first_cpu = -1;
-            if (fgets(list, sizeof(list), f))
-                first_cpu = atoi(list);
-            fclose(f);
-            if (first_cpu == cpu)
-                total_l3 += sz;
-        } else {
-            total_l3 += sz;
+    for (int d = 0; d < t->nccds; d++) {
+        for (int c = 0; c < t->ncores; c++) {
+            if (t->core_ccd[c] != d) continue;
+            total_l3 += read_cache_size(t->core_cpu[c], 3);
+            break;
         }
     }
 
@@ -923,24 +1279,6 @@ static size_t dram_buf_bytes(void)
 
 /* ── Dynamic latency buffer sizing ───────────────────────────────────── */
 
-/*
- * Read the size reported by sysfs for a specific cache level on cpu0.
- * sysfs reports in kB (e.g. "32K" → strtoul gives 32 → ×1024 = 32768).
- * index mapping: 0=L1D, 1=L1I, 2=L2, 3=L3.
- * Returns 0 if the file is absent or unparseable.
- */
-static size_t read_cache_size(int cpu, int index)
-{
-    char path[160], buf[32] = {0};
-    snprintf(path, sizeof(path),
-             "/sys/devices/system/cpu/cpu%d/cache/index%d/size", cpu, index);
-    FILE *f = fopen(path, "r");
-    if (!f) return 0;
-    if (!fgets(buf, sizeof(buf), f)) { fclose(f); return 0; }
-    fclose(f);
-    return strtoul(buf, NULL, 10) * 1024UL;
-}
-
 /*
  * Choose latency-benchmark buffer sizes based on the actual cache topology.
  *
@@ -973,8 +1311,398 @@ static void detect_lat_buf_sizes(size_t *l1, size_t *l2, size_t *l3)
     if (*l3 <= *l2) *l3 = *l2 * 4;
 }
 
+/* ── Run configuration ───────────────────────────────────────────────── */
+
+/* Resolved bench_config_t: every field has its final value */
+typedef struct {
+    unsigned ops;
+    int      lat_min, lat_max;     /* 0 = per-level default sample count */
+    int      bw_min,  bw_max;
+    double   cv_target;
+    size_t   bw_bytes;             /* per thread; 0 = auto               */
+    int      nthreads;             /* 0 = one per physical core          */
+    int      bw_kernel;            /* BENCH_BWK_*                        */
+    int      pf_dist;              /* bytes; 0 = default, < 0 = none     */
+    int      chain;                /* BENCH_CHAIN_* latency layout       */
+    bench_token_t *token;
+} run_cfg_t;
+
+static void resolve_cfg(const bench_config_t *cfg, run_cfg_t *rc)
+{
+    memset(rc, 0, sizeof(*rc));
+    rc->ops       = BENCH_OPS_ALL;
+    rc->bw_min    = BW_MIN_PASSES;
+    rc->bw_max    = BW_MAX_PASSES;
+    rc->cv_target = BW_CV_TARGET;
+    if (!cfg) return;
+
+    if (cfg->ops & BENCH_OPS_ALL) rc->ops = cfg->ops & BENCH_OPS_ALL;
+    if (cfg->max_passes > 0)
+        rc->lat_max = rc->bw_max = cfg->max_passes < BENCH_MAX_SAMPLES
+                                 ? cfg->max_passes : BENCH_MAX_SAMPLES;
+    if (cfg->min_passes > 0) rc->lat_min = rc->bw_min = cfg->min_passes;
+    if (rc->bw_min > rc->bw_max) rc->bw_min = rc->bw_max;
+    if (rc->lat_max && rc->lat_min > rc->lat_max) rc->lat_min = rc->lat_max;
+    if (cfg->cv_target > 0.0) rc->cv_target = cfg->cv_target;
+    rc->bw_bytes = cfg->bw_bytes;
+    rc->nthreads = cfg->nthreads > 0 ? cfg->nthreads : 0;
+    rc->bw_kernel = cfg->bw_kernel;
+    rc->pf_dist   = cfg->pf_dist;
+    if (cfg->chain > 0 && cfg->chain < BENCH_CHAIN_COUNT) rc->chain = cfg->chain;
+    rc->token     = cfg->token;
+}
+
+/* ── Bench context ───────────────────────────────────────────────────── */
+
+/*
+ * Every userspace bandwidth run used to mmap and fault in two
+ * dram_buf_bytes() halves plus a 2× eviction buffer and spawn one pthread
+ * per core, then tear it all down — a large share of a quick run, and all
+ * of the overhead of repeating one.  The buffers and the pinned workers now
+ * live here and are reused until the context has sat idle for
+ * BENCH_CTX_IDLE_SEC, when a reaper thread hands the memory back.
+ *
+ * s_ctx.lock is held for the whole of a run (ctx_enter/ctx_leave), so the
+ * reaper never frees anything under a benchmark and runs from different
+ * threads serialise rather than share buffers.
+ *
+ * Between runs the workers park on pool_cv.  A run fills args[] for the
+ * slots it needs, bumps gen and broadcasts; slots below active then join
+ * the pass barriers until they see OP_PARK.  A worker re-pins itself only
+ * when its CPU changes.
+ */
+static struct {
+    pthread_mutex_t   lock;          /* held for the whole of a run       */
+    pthread_cond_t    idle_cv;       /* wakes the reaper (CLOCK_MONOTONIC) */
+    pthread_once_t    once;
+    int               reaper;        /* reaper thread running             */
+    long long         last_use;      /* now_ns() at the last ctx_leave()  */
+
+    uint64_t         *buf_a, *buf_b; /* bandwidth buffers, faulted in     */
+    size_t            buf_bytes;
+    int               buf_node;      /* mbind node, -1 = first touch      */
+    uint8_t          *evict;
+    size_t            evict_bytes;
+
+    pthread_mutex_t   pool_lock;
+    pthread_cond_t    pool_cv;
+    unsigned          gen;           /* bumped once per run               */
+    int               active;        /* slots taking part in this run     */
+    int               nworkers;      /* threads spawned                   */
+    int               quit;
+    pthread_t         tids[MAX_THREADS];
+    bw_arg_t          args[MAX_THREADS];
+    pthread_barrier_t bar_start, bar_end;
+} s_ctx = {
+    .lock      = PTHREAD_MUTEX_INITIALIZER,
+    .once      = PTHREAD_ONCE_INIT,
+    .pool_lock = PTHREAD_MUTEX_INITIALIZER,
+    .pool_cv   = PTHREAD_COND_INITIALIZER,
+};
+
+static void ctx_init(void)
+{
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_ctx.idle_cv, &ca);
+    pthread_condattr_destroy(&ca);
+}
+
+static int ctx_holding(void)
+{
+    return s_ctx.nworkers || s_ctx.buf_a || s_ctx.evict;
+}
+
+static void ctx_free_bw_buffers(void)
+{
+    if (s_ctx.buf_a) bench_free(s_ctx.buf_a, s_ctx.buf_bytes);
+    if (s_ctx.buf_b) bench_free(s_ctx.buf_b, s_ctx.buf_bytes);
+    s_ctx.buf_a = s_ctx.buf_b = NULL;
+    s_ctx.buf_bytes = 0;
+}
+
+static void ctx_free_evict(void)
+{
+    if (s_ctx.evict) bench_free(s_ctx.evict, s_ctx.evict_bytes);
+    s_ctx.evict       = NULL;
+    s_ctx.evict_bytes = 0;
+}
+
+/* Join the workers and unmap everything.  Caller holds s_ctx.lock. */
+static void ctx_free_locked(void)
+{
+    pthread_mutex_lock(&s_ctx.pool_lock);
+    s_ctx.quit = 1;
+    pthread_cond_broadcast(&s_ctx.pool_cv);
+    pthread_mutex_unlock(&s_ctx.pool_lock);
+    for (int i = 0; i < s_ctx.nworkers; i++)
+        pthread_join(s_ctx.tids[i], NULL);
+    s_ctx.nworkers = 0;
+    s_ctx.quit     = 0;
+
+    ctx_free_bw_buffers();
+    ctx_free_evict();
+}
+
+static void *ctx_reaper(void *unused)
+{
+    (void)unused;
+    pthread_mutex_lock(&s_ctx.lock);
+    while (ctx_holding()) {
+        long long due = s_ctx.last_use + BENCH_CTX_IDLE_SEC * 1000000000LL;
+        if (now_ns() >= due) {
+            ctx_free_locked();
+            break;
+        }
+        struct timespec ts = { .tv_sec  = due / 1000000000LL,
+                               .tv_nsec = due % 1000000000LL };
+        pthread_cond_timedwait(&s_ctx.idle_cv, &s_ctx.lock, &ts);
+    }
+    s_ctx.reaper = 0;
+    pthread_mutex_unlock(&s_ctx.lock);
+    return NULL;
+}
+
+static void ctx_enter(void)
+{
+    pthread_once(&s_ctx.once, ctx_init);
+    pthread_mutex_lock(&s_ctx.lock);
+}
+
+static void ctx_leave(void)
+{
+    s_ctx.last_use = now_ns();
+    if (ctx_holding() && !s_ctx.reaper) {
+        pthread_t tid;
+        if (pthread_create(&tid, NULL, ctx_reaper, NULL) == 0) {
+            pthread_detach(tid);
+            s_ctx.reaper = 1;
+        } else {
+            ctx_free_locked();     /* nothing would ever release it */
+        }
+    }
+    pthread_cond_signal(&s_ctx.idle_cv);
+    pthread_mutex_unlock(&s_ctx.lock);
+}
+
+void bench_ctx_release(void)
+{
+    pthread_once(&s_ctx.once, ctx_init);
+    /* A run in flight keeps its context; process exit reclaims it anyway */
+    if (pthread_mutex_trylock(&s_ctx.lock) != 0)
+        return;
+    ctx_free_locked();
+    pthread_cond_signal(&s_ctx.idle_cv);
+    pthread_mutex_unlock(&s_ctx.lock);
+}
+
+/*
+ * Bind [p, p+bytes) to one NUMA node before first touch.  Raw syscall so
+ * the build needs no libnuma; a failure (no NUMA, node offline) just leaves
+ * the default first-touch policy in place.
+ */
+static void bind_to_node(void *p, size_t bytes, int node)
+{
+    if (node < 0 || node >= (int)(8 * sizeof(unsigned long)))
+        return;
+    unsigned long mask = 1UL << node;
+    syscall(SYS_mbind, p, bytes, MPOL_BIND, &mask,
+            (unsigned long)(8 * sizeof(mask) + 1), 0UL);
+}
+
+/*
+ * Two bandwidth buffers of at least bytes each on mem_node (-1 = first
+ * touch), already faulted in.  A cached pair is reused when it is big
+ * enough and on the same node; callers only use the first bytes.
+ */
+static int ctx_bw_buffers(size_t bytes, int mem_node, uint64_t **a, uint64_t **b)
+{
+    if (s_ctx.buf_a && (s_ctx.buf_bytes < bytes || s_ctx.buf_node != mem_node))
+        ctx_free_bw_buffers();
+
+    if (!s_ctx.buf_a) {
+        uint64_t *pa = bench_alloc(bytes);
+        uint64_t *pb = bench_alloc(bytes);
+        if (!pa || !pb) {
+            if (pa) bench_free(pa, bytes);
+            if (pb) bench_free(pb, bytes);
+            return 0;
+        }
+        bind_to_node(pa, bytes, mem_node);
+        bind_to_node(pb, bytes, mem_node);
+
+        /* Touch all pages so THP faults and TLB entries are warm before
+         * the timed passes begin. */
+        memset(pa, 0xAB, bytes);
+        memset(pb, 0xCD, bytes);
+        s_ctx.buf_a     = pa;
+        s_ctx.buf_b     = pb;
+        s_ctx.buf_bytes = bytes;
+        s_ctx.buf_node  = mem_node;
+    }
+    *a = s_ctx.buf_a;
+    *b = s_ctx.buf_b;
+    return 1;
+}
+
+/* Eviction buffer of at least bytes, dirtied once; NULL on failure */
+static uint8_t *ctx_evict(size_t bytes)
+{
+    if (s_ctx.evict && s_ctx.evict_bytes < bytes)
+        ctx_free_evict();
+    if (!s_ctx.evict) {
+        s_ctx.evict = bench_alloc(bytes);
+        if (!s_ctx.evict) return NULL;
+        s_ctx.evict_bytes = bytes;
+        memset(s_ctx.evict, 0xEF, bytes);
+    }
+    return s_ctx.evict;
+}
+
+static void *bw_pool_worker(void *varg)
+{
+    bw_arg_t *a = varg;
+    int pinned = -1;
+
+    pthread_mutex_lock(&s_ctx.pool_lock);
+    for (;;) {
+        while (a->gen == s_ctx.gen && !s_ctx.quit)
+            pthread_cond_wait(&s_ctx.pool_cv, &s_ctx.pool_lock);
+        if (s_ctx.quit) break;
+        a->gen = s_ctx.gen;
+        if (a - s_ctx.args >= s_ctx.active) continue;
+        pthread_mutex_unlock(&s_ctx.pool_lock);
+
+        if (a->cpu != pinned) {
+            cpu_set_t cs;
+            CPU_ZERO(&cs);
+            CPU_SET(a->cpu, &cs);
+            pthread_setaffinity_np(pthread_self(), sizeof(cs), &cs);
+            pinned = a->cpu;
+        }
+        bw_worker(a);
+
+        pthread_mutex_lock(&s_ctx.pool_lock);
+    }
+    pthread_mutex_unlock(&s_ctx.pool_lock);
+    return NULL;
+}
+
+/* Spawn pool workers up to n.  Caller holds pool_lock.  Returns how many exist. */
+static int ctx_pool_grow(int n)
+{
+    while (s_ctx.nworkers < n) {
+        bw_arg_t *a = &s_ctx.args[s_ctx.nworkers];
+        a->gen = s_ctx.gen;
+        if (pthread_create(&s_ctx.tids[s_ctx.nworkers], NULL, bw_pool_worker, a) != 0)
+            break;
+        s_ctx.nworkers++;
+    }
+    return s_ctx.nworkers < n ? s_ctx.nworkers : n;
+}
+
+/* ── Bandwidth on a CPU set ──────────────────────────────────────────── */
+
+/*
+ * Run the BENCH_BW_* tests selected in rc->ops with one pinned worker per
+ * entry of cpus[], splitting bw_sz bytes between them.  mem_node ≥ 0 places
+ * the buffers on that node.  Results go to stats[BENCH_BW_*]; kern_out
+ * (may be NULL) receives the kernels that ran.
+ * Returns 0 if the buffers could not be allocated.  Caller is inside
+ * ctx_enter(); buffers and workers come from the bench context.
+ *
+ * Each thread works on its own contiguous chunk of a shared buffer
+ * that exceeds the total L3 (including 3D V-Cache).  Threads are
+ * pinned to specific logical CPUs and synchronised with barriers so
+ * the wall-clock timing window covers all parallel work.
+ */
+static int bw_run_cpus(const int *cpus, int nthreads, size_t bw_sz, int mem_node,
+                       uint8_t *evict, size_t evict_bytes,
+                       const run_cfg_t *rc, bench_stats_t *stats,
+                       bw_kernels_t *kern_out)
+{
+    if (nthreads <= 0) return 0;
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+
+    uint64_t *buf_a, *buf_b;
+    if (!ctx_bw_buffers(bw_sz, mem_node, &buf_a, &buf_b))
+        return 0;
+
+    bw_kernels_t kern;
+    bw_select_kernels(rc->bw_kernel, rc->pf_dist, &kern);
+    if (kern_out) *kern_out = kern;
+
+    pthread_mutex_lock(&s_ctx.pool_lock);
+    nthreads = ctx_pool_grow(nthreads);
+    if (nthreads <= 0) {
+        pthread_mutex_unlock(&s_ctx.pool_lock);
+        return 0;
+    }
+
+    /* nthreads workers + 1 main */
+    pthread_barrier_init(&s_ctx.bar_start, NULL, (unsigned)(nthreads + 1));
+    pthread_barrier_init(&s_ctx.bar_end,   NULL, (unsigned)(nthreads + 1));
+
+    bw_arg_t *args   = s_ctx.args;
+    size_t   total_n = bw_sz / sizeof(uint64_t);
+    size_t   chunk_n = total_n / (size_t)nthreads;
+
+    for (int t = 0; t < nthreads; t++) {
+        size_t off     = (size_t)t * chunk_n;
+        /* Last thread takes any remainder so no bytes are skipped */
+        size_t this_n  = (t == nthreads - 1) ? total_n - off : chunk_n;
+        args[t].buf_a     = buf_a + off;
+        args[t].buf_b     = buf_b + off;
+        args[t].n         = this_n;
+        args[t].cpu       = cpus[t];
+        args[t].op        = OP_READ;
+        args[t].kern      = &kern;
+        args[t].bar_start = &s_ctx.bar_start;
+        args[t].bar_end   = &s_ctx.bar_end;
+    }
+    s_ctx.active = nthreads;
+    s_ctx.gen++;
+    pthread_cond_broadcast(&s_ctx.pool_cv);
+    pthread_mutex_unlock(&s_ctx.pool_lock);
+
+    static const bw_op_t bw_ops[3] = { OP_READ, OP_WRITE, OP_COPY };
+    for (int i = 0; i < 3; i++) {
+        if (!(rc->ops & BENCH_OP(BENCH_BW_READ + i))) continue;
+        run_bw_passes(args, nthreads, &s_ctx.bar_start, &s_ctx.bar_end,
+                      bw_ops[i], bw_sz, bw_ops[i] == OP_COPY ? 2 : 1,
+                      evict, evict_bytes,
+                      rc->bw_min, rc->bw_max, rc->cv_target,
+                      &stats[BENCH_BW_READ + i], rc->token);
+    }
+
+    /* Send the workers back to the pool */
+    for (int t = 0; t < nthreads; t++) args[t].op = OP_PARK;
+    pthread_barrier_wait(&s_ctx.bar_start);
+    pthread_barrier_wait(&s_ctx.bar_end);
+
+    pthread_barrier_destroy(&s_ctx.bar_start);
+    pthread_barrier_destroy(&s_ctx.bar_end);
+    return 1;
+}
+
 /* ── Public ──────────────────────────────────────────────────────────── */
 
+/* Copy the scalar medians out of stats[] */
+static void results_from_stats(bench_results_t *out)
+{
+    out->lat_l1_ns    = out->stats[BENCH_LAT_L1].median;
+    out->lat_l2_ns    = out->stats[BENCH_LAT_L2].median;
+    out->lat_l3_ns    = out->stats[BENCH_LAT_L3].median;
+    out->lat_dram_ns  = out->stats[BENCH_LAT_DRAM].median;
+    out->bw_read_mbs  = out->stats[BENCH_BW_READ].median;
+    out->bw_write_mbs = out->stats[BENCH_BW_WRITE].median;
+    out->bw_copy_mbs  = out->stats[BENCH_BW_COPY].median;
+}
+
+/* BENCH_* and TUXBENCH_RES_* index the same tests */
+_Static_assert((int)BENCH_NR_TESTS == (int)TUXBENCH_NR_RES, "bench/tuxbench test order");
+
 /*
  * Try to run via the tuxbench kernel module (/dev/tuxbench).
  * Returns 1 on success (results filled), 0 if module not loaded or ioctl failed.
@@ -984,17 +1712,100 @@ static void detect_lat_buf_sizes(size_t *l1, size_t *l2, size_t *l3)
  *   - alloc_pages_node()      — guaranteed physically contiguous NUMA-local pages
  *   - kthread_bind()          — hard CPU pin, SCHED_FIFO RT priority
  *
- * The module is loaded at startup by backend_read_summary() and unloaded on exit
+ * TUXBENCH_IOC_RUN_V2 is tried first; a module that predates it answers
+ * ENOTTY and gets the legacy full-suite TUXBENCH_IOC_RUN (medians only).
+ * A cancelled run (EINTR) also returns 1, with out->cancelled set and no
+ * results — it must not fall back to the userspace path.
+ *
+ * The module is loaded at startup by the backend's static worker and unloaded on exit
  * by backend_cleanup().
  */
-static int bench_run_kernel(bench_results_t *out)
+static int bench_run_kernel(const run_cfg_t *rc, bench_results_t *out)
 {
     int fd = open("/dev/tuxbench", O_RDWR);
     if (fd < 0)
         return 0;
 
+    struct tuxbench_req_v2 *r2 = calloc(1, sizeof(*r2));   /* ~4 KB */
+    if (!r2) { close(fd); return 0; }
+
+    r2->version    = TUXBENCH_ABI_VERSION;
+    r2->ops        = rc->ops;
+    r2->numa_node  = -1;
+    r2->nthreads   = (unsigned)rc->nthreads;
+    r2->min_passes = (unsigned)(rc->lat_min ? rc->lat_min : 0);
+    r2->max_passes = (unsigned)(rc->lat_max ? rc->lat_max : 0);
+    r2->cv_ppm     = (unsigned)(rc->cv_target * 1e6 + 0.5);
+    r2->bw_bytes   = rc->bw_bytes;
+    r2->bw_kernel  = (unsigned)rc->bw_kernel;
+    /* the module's own default is no software prefetch — send ours */
+    r2->pf_dist    = rc->pf_dist < 0 ? 0
+                   : rc->pf_dist == 0 ? PF_DIST_U64 * sizeof(uint64_t)
+                   : (unsigned)rc->pf_dist;
+    r2->lat_chain  = (unsigned)rc->chain;
+
+    /* One unit: the module reports its own pass count while it runs */
+    bench_token_begin(rc->token, 1);
+    if (!kernel_enter(rc->token, fd, 1)) {
+        free(r2);
+        close(fd);
+        out->cancelled = 1;
+        return 1;
+    }
+    int io = ioctl(fd, TUXBENCH_IOC_RUN_V2, r2);
+    /* A pre-ABI-6 module cannot lay out a page-local chain: its E2BIG
+     * (non-zero lat_chain it does not know) falls through to userspace */
+    if (io != 0 && errno == E2BIG && !r2->lat_chain) {
+        /* ABI 2 module: it refuses non-zero fields it does not know */
+        r2->bw_kernel = 0;
+        r2->pf_dist   = 0;
+        io = ioctl(fd, TUXBENCH_IOC_RUN_V2, r2);
+    }
+    int err = io == 0 ? 0 : errno;
+    kernel_leave(rc->token);
+    if (io == 0) {
+        bench_token_advance(rc->token, 1);
+        close(fd);
+        /* bw_kernel/pf_dist are only reported back from ABI 3 on */
+        if (r2->version >= 3) {
+            out->bw_kernel = (int)r2->bw_kernel;
+            out->pf_dist   = (int)r2->pf_dist;
+        }
+        if (r2->version >= 4)
+            out->bw_avx512 = r2->bw_isa == TUXBENCH_ISA_AVX512;
+        for (int t = 0; t < BENCH_NR_TESTS; t++) {
+            const struct tuxbench_stats *ks = &r2->res[t];
+            double samples[TUXBENCH_MAX_SAMPLES];
+            /* ps → ns for latency, KB/s → MB/s for bandwidth */
+            double scale = (t <= BENCH_LAT_DRAM) ? 1.0 / 1000.0 : 1.0 / 1024.0;
+            int n = ks->nsamples < TUXBENCH_MAX_SAMPLES ? (int)ks->nsamples
+                                                        : TUXBENCH_MAX_SAMPLES;
+            for (int i = 0; i < n; i++) samples[i] = (double)ks->samples[i];
+            fill_stats(&out->stats[t], samples, n, scale);
+        }
+        free(r2);
+        results_from_stats(out);
+        out->kernel = 1;
+        return 1;
+    }
+    free(r2);
+
+    if (err == EINTR) {
+        close(fd);
+        out->kernel    = 1;
+        out->cancelled = 1;
+        return 1;
+    }
+
+    /* Old module: only the full groups exist, and only medians come back */
+    if (err != ENOTTY || rc->chain != BENCH_CHAIN_RANDOM) {
+        close(fd);
+        return 0;
+    }
+
     struct tuxbench_req req = {
-        .flags = TUXBENCH_FL_LAT | TUXBENCH_FL_BW,
+        .flags = ((rc->ops & BENCH_OPS_LAT) ? TUXBENCH_FL_LAT : 0) |
+                 ((rc->ops & BENCH_OPS_BW)  ? TUXBENCH_FL_BW  : 0),
     };
 
     if (ioctl(fd, TUXBENCH_IOC_RUN, &req) != 0) {
@@ -1014,18 +1825,37 @@ static int bench_run_kernel(bench_results_t *out)
     out->bw_write_mbs = (double)req.bw_write_kbs / 1024.0;
     out->bw_copy_mbs  = (double)req.bw_copy_kbs  / 1024.0;
 
+    out->kernel = 1;
     return 1;
 }
 
 
 void bench_run(bench_results_t *out)
 {
+    bench_run_ex(NULL, out);
+}
+
+void bench_run_ex(const bench_config_t *cfg, bench_results_t *out)
+{
+    run_cfg_t rc;
+
     memset(out, 0, sizeof(*out));
+    resolve_cfg(cfg, &rc);
 
     /* Prefer kernel module path: better flush, guaranteed huge pages, hard CPU pin */
-    if (bench_run_kernel(out))
+    if (bench_run_kernel(&rc, out))
         return;
 
+    /* Progress: one unit per latency sample and bandwidth pass budgeted */
+    long units = 0;
+    for (int t = BENCH_LAT_L1; t <= BENCH_LAT_DRAM; t++)
+        if (rc.ops & BENCH_OP(t))
+            units += rc.lat_max ? rc.lat_max : (t == BENCH_LAT_DRAM ? 3 : LAT_SAMPLES);
+    for (int t = BENCH_BW_READ; t <= BENCH_BW_COPY; t++)
+        if (rc.ops & BENCH_OP(t))
+            units += rc.bw_max < BW_MAX_PASSES ? rc.bw_max : BW_MAX_PASSES;
+    bench_token_begin(rc.token, units);
+
     /* --- Latency (single-threaded random pointer chasing) ---
      *
      * Buffer sizes are derived from sysfs cache topology so the benchmark
@@ -1035,87 +1865,916 @@ void bench_run(bench_results_t *out)
      * min_accesses chosen so each test runs ~200–500 ms per sample.
      * DRAM uses dram_buf_bytes() (≥4×total L3, ≥512 MB) and flush_each=1
      * so every sample truly goes to DRAM rather than cache residue from the
-     * previous sample.  Only 3 samples because each one already traverses
-     * millions of nodes (~380 ms). */
-    size_t lat_l1, lat_l2, lat_l3;
-    detect_lat_buf_sizes(&lat_l1, &lat_l2, &lat_l3);
+     * previous sample.  Only 3 samples by default because each one already
+     * traverses millions of nodes (~380 ms). */
+    static const long long lat_accesses[4] = {
+        200000000LL, 50000000LL, 20000000LL, 1000000LL,
+    };
+    size_t lat_sz[4];
+    detect_lat_buf_sizes(&lat_sz[0], &lat_sz[1], &lat_sz[2]);
     size_t dram_sz = dram_buf_bytes(); /* computed once, shared by latency + bandwidth */
+    lat_sz[3] = dram_sz;
+
+    for (int t = BENCH_LAT_L1; t <= BENCH_LAT_DRAM; t++) {
+        if (!(rc.ops & BENCH_OP(t))) continue;
+        int    dram = (t == BENCH_LAT_DRAM);
+        int    nmax = rc.lat_max ? rc.lat_max : (dram ? 3 : LAT_SAMPLES);
+        int    nmin = rc.lat_min ? rc.lat_min : nmax;
+        double samples[BENCH_MAX_SAMPLES];
+        int n = measure_latency(lat_sz[t], lat_accesses[t], nmin, nmax,
+                                rc.cv_target, dram, rc.chain, PAGES_AUTO, samples,
+                                rc.token);
+        fill_stats(&out->stats[t], samples, n, 1.0);
+    }
 
-    out->lat_l1_ns   = measure_latency_ns(lat_l1,   200000000LL, LAT_SAMPLES, 0);
-    out->lat_l2_ns   = measure_latency_ns(lat_l2,    50000000LL, LAT_SAMPLES, 0);
-    out->lat_l3_ns   = measure_latency_ns(lat_l3,    20000000LL, LAT_SAMPLES, 0);
-    out->lat_dram_ns = measure_latency_ns(dram_sz,    1000000LL, 3,           1);
+    if (!(rc.ops & BENCH_OPS_BW) || bench_token_cancelled(rc.token)) {
+        out->cancelled = bench_token_cancelled(rc.token);
+        results_from_stats(out);
+        return;
+    }
 
-    /* --- Bandwidth (multi-threaded, one thread per physical core) ---
-     *
-     * Each thread works on its own contiguous chunk of a shared buffer
-     * that exceeds the total L3 (including 3D V-Cache).  Threads are
-     * pinned to specific logical CPUs and synchronised with barriers so
-     * the wall-clock timing window covers all parallel work. */
+    /* --- Bandwidth (multi-threaded, one thread per physical core) --- */
     int    cpu_list[MAX_THREADS];
     int    nthreads = build_cpu_list(cpu_list, MAX_THREADS);
+    if (rc.nthreads && rc.nthreads < nthreads) nthreads = rc.nthreads;
 
-    uint64_t *buf_a = bench_alloc(dram_sz);
-    uint64_t *buf_b = bench_alloc(dram_sz);
+    size_t   bw_sz = rc.bw_bytes ? rc.bw_bytes * (size_t)nthreads : dram_sz;
+    ctx_enter();
     /* Eviction buffer: 2× dram_sz so we churn well beyond total L3. */
-    uint8_t  *evict  = bench_alloc(dram_sz * 2);
-    if (!buf_a || !buf_b || !evict) {
-        bench_free(buf_a, dram_sz);
-        bench_free(buf_b, dram_sz);
-        bench_free(evict, dram_sz * 2);
+    uint8_t *evict = ctx_evict(dram_sz * 2);
+    if (evict) {
+        bw_kernels_t kern;
+        if (bw_run_cpus(cpu_list, nthreads, bw_sz, -1, evict, dram_sz * 2,
+                        &rc, out->stats, &kern)) {
+            out->bw_kernel   = kern.variant;
+            out->pf_dist     = (int)(kern.pf * sizeof(uint64_t));
+            out->bw_avx512   = kern.avx512;
+        }
+    }
+    ctx_leave();
+
+    out->cancelled = bench_token_cancelled(rc.token);
+    results_from_stats(out);
+}
+
+/* ── Latency sweep ───────────────────────────────────────────────────── */
+
+/*
+ * Accesses per sample.  Small buffers repeat the chain until this many loads
+ * are timed; once one traversal already covers more than this, a single
+ * sample is taken — the same trade-off as the DRAM point above, and what
+ * keeps a 4 KB → 2 GB sweep under a minute.
+ */
+#define SWEEP_MIN_ACCESSES 4000000LL
+#define SWEEP_SAMPLES      3
+
+/* MemAvailable from /proc/meminfo, falling back to free pages */
+static size_t avail_ram_bytes(void)
+{
+    FILE *f = fopen("/proc/meminfo", "r");
+    if (f) {
+        char line[128];
+        unsigned long kb;
+        while (fgets(line, sizeof(line), f)) {
+            if (sscanf(line, "MemAvailable: %lu kB", &kb) == 1) {
+                fclose(f);
+                return (size_t)kb * 1024;
+            }
+        }
+        fclose(f);
+    }
+    long pages = sysconf(_SC_AVPHYS_PAGES);
+    long psz   = sysconf(_SC_PAGESIZE);
+    return (pages > 0 && psz > 0) ? (size_t)pages * (size_t)psz : 0;
+}
+
+/*
+ * Pointer chase (no per-sample flush) at geometrically spaced sizes: each
+ * buffer settles in whichever level it fits after the warm-up pass, so the
+ * curve steps at L1→L2→L3(→V-Cache)→DRAM.  With 4 KB pages and a random
+ * chain the L1/L2 DTLB reach (e.g. 72 × 4 KB, 3072 × 4 KB on Zen 4) adds
+ * its own steps; 2 MB pages push those out past the L3 and isolate the
+ * cache curve.  A page-local chain on 4 KB pages keeps the page walks but
+ * pays one per 64 loads, so its gap to the random curve is the TLB cost.
+ */
+void bench_latency_sweep(size_t min_bytes, size_t max_bytes, int steps_per_octave,
+                         int huge_pages, int chain, lat_sweep_t *out,
+                         lat_sweep_progress_fn progress, void *ctx,
+                         bench_token_t *tok)
+{
+    memset(out, 0, sizeof(*out));
+    out->huge_pages     = huge_pages ? 1 : 0;
+    out->chain          = chain == BENCH_CHAIN_PAGE_LOCAL ? chain : BENCH_CHAIN_RANDOM;
+    out->cache_bytes[0] = read_cache_size(0, 0);
+    out->cache_bytes[1] = read_cache_size(0, 2);
+    out->cache_bytes[2] = read_cache_size(0, 3);
+
+    if (steps_per_octave < 1) steps_per_octave = 1;
+    if (min_bytes < 64 * sizeof(node_t)) min_bytes = 64 * sizeof(node_t);
+
+    /* Node array + permutation ≈ 1.125 × buffer; leave the rest of RAM free */
+    size_t avail = avail_ram_bytes() / 2;
+    if (avail && max_bytes > avail) max_bytes = avail;
+    if (max_bytes < min_bytes) max_bytes = min_bytes;
+
+    double octaves = log2((double)max_bytes / (double)min_bytes);
+    int total = (int)floor(octaves * steps_per_octave + 1e-9) + 1;
+    if (total > LAT_SWEEP_MAX_POINTS) total = LAT_SWEEP_MAX_POINTS;
+
+    page_mode_t pages = huge_pages ? PAGES_2M : PAGES_4K;
+
+#define SWEEP_POINT(i, bytes, nsamples) do { \
+        double sz_ = (double)min_bytes * exp2((double)(i) / steps_per_octave); \
+        (bytes) = ((size_t)(sz_ + 0.5)) & ~(size_t)(CACHELINE - 1); \
+        (nsamples) = ((long long)((bytes) / sizeof(node_t)) >= SWEEP_MIN_ACCESSES) \
+                   ? 1 : SWEEP_SAMPLES; \
+    } while (0)
+
+    /* Progress counts samples, as measure_latency() reports them */
+    long units = 0;
+    for (int i = 0; i < total; i++) {
+        size_t bytes;
+        int    nsamples;
+        SWEEP_POINT(i, bytes, nsamples);
+        units += nsamples;
+    }
+    bench_token_begin(tok, units);
+
+    for (int i = 0; i < total && !bench_token_cancelled(tok); i++) {
+        size_t bytes;
+        int    nsamples;
+        SWEEP_POINT(i, bytes, nsamples);
+
+        double ns = measure_latency_ns(bytes, SWEEP_MIN_ACCESSES, nsamples, 0,
+                                       out->chain, pages, tok);
+        if (ns <= 0.0)
+            break;   /* allocation failed (or cancelled) — larger sizes won't fit either */
+
+        out->bytes[out->count]  = bytes;
+        out->lat_ns[out->count] = ns;
+        out->count++;
+        if (progress)
+            progress(out, total, ctx);
+    }
+#undef SWEEP_POINT
+}
+
+int bench_sweep_write_csv(const lat_sweep_t *s, const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "# pages=%s chain=%s l1d=%zu l2=%zu l3=%zu\n",
+            s->huge_pages ? "2M" : "4K",
+            s->chain == BENCH_CHAIN_PAGE_LOCAL ? "page-local" : "random",
+            s->cache_bytes[0], s->cache_bytes[1], s->cache_bytes[2]);
+    fprintf(f, "bytes,kib,latency_ns\n");
+    for (int i = 0; i < s->count; i++)
+        fprintf(f, "%zu,%.2f,%.3f\n", s->bytes[i], s->bytes[i] / 1024.0, s->lat_ns[i]);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/* ── Loaded latency ──────────────────────────────────────────────────── */
+
+/*
+ * One thread (the caller, pinned to the first physical core) chases a
+ * DRAM-sized chain while every other build_cpu_list() core streams
+ * do_read/do_copy over its own chunk in LL_BLOCK_BYTES blocks, spinning
+ * delay_ns between blocks.  Bandwidth is the worker byte counter sampled
+ * over exactly the timed chase, so each level yields one (bandwidth,
+ * latency) point — the same shape as Intel MLC --loaded_latency.
+ */
+#define LL_BLOCK_BYTES (64 * 1024)
+#define LL_CHASE_HOPS  1000000LL
+#define LL_SAMPLES     3
+#define LL_WARMUP_NS   20000000LL
+
+/* Light → heavy; -1 = idle (chaser only) */
+static const int ll_delays_ns[] = { -1, 64000, 32000, 16000, 8000, 4000, 2000, 1000, 0 };
+#define LL_LEVELS ((int)(sizeof(ll_delays_ns) / sizeof(ll_delays_ns[0])))
+
+typedef struct {
+    uint64_t           *buf;
+    size_t              n;          /* uint64_t elements; copy uses halves */
+    int                 cpu;
+    int                 copy;
+    int                 delay_ns;
+    atomic_int         *stop;
+    atomic_ullong      *bytes;
+    const bw_kernels_t *kern;
+} ll_arg_t;
+
+/* Returns 0 on success */
+static int pin_to_cpu(int cpu)
+{
+    cpu_set_t cs;
+    CPU_ZERO(&cs);
+    CPU_SET(cpu, &cs);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cs), &cs);
+}
+
+static void *ll_worker(void *varg)
+{
+    ll_arg_t *a = varg;
+    pin_to_cpu(a->cpu);
+
+    size_t blk  = LL_BLOCK_BYTES / sizeof(uint64_t);
+    size_t span = a->copy ? a->n / 2 : a->n;
+    size_t off  = 0;
+
+    while (!atomic_load_explicit(a->stop, memory_order_relaxed)) {
+        if (a->copy) {
+            a->kern->copy(a->buf + off, a->buf + span + off, blk, a->kern->pf);
+            atomic_fetch_add_explicit(a->bytes, 2 * LL_BLOCK_BYTES, memory_order_relaxed);
+        } else {
+            a->kern->read(a->buf + off, blk, a->kern->pf);
+            atomic_fetch_add_explicit(a->bytes, LL_BLOCK_BYTES, memory_order_relaxed);
+        }
+        off += blk;
+        if (off + blk > span) off = 0;
+
+        if (a->delay_ns > 0) {
+            long long until = now_ns() + a->delay_ns;
+            while (now_ns() < until)
+                _mm_pause();
+        }
+    }
+    return NULL;
+}
+
+static int bench_loaded_kernel(int copy_load, loaded_lat_t *out,
+                               loaded_lat_progress_fn progress, void *ctx,
+                               bench_token_t *tok)
+{
+    int fd = open("/dev/tuxbench", O_RDWR);
+    if (fd < 0)
+        return 0;
+
+    struct tuxbench_loaded_req req;
+    memset(&req, 0, sizeof(req));
+    req.op      = copy_load ? TUXBENCH_LL_COPY : TUXBENCH_LL_READ;
+    req.nlevels = LL_LEVELS;
+    for (int i = 0; i < LL_LEVELS; i++)
+        req.delay_ns[i] = ll_delays_ns[i];
+
+    if (!kernel_enter(tok, fd, LL_LEVELS)) {
+        close(fd);
+        return 1;   /* cancelled before it started: nothing measured */
+    }
+    int rc = ioctl(fd, TUXBENCH_IOC_LOADED, &req);
+    int err = rc == 0 ? 0 : errno;
+    kernel_leave(tok);
+    close(fd);
+    if (err == EINTR)
+        return 1;   /* cancelled — keep count 0, no userspace retry */
+    if (rc != 0)
+        return 0;   /* older module without the ioctl — use userspace */
+    bench_token_advance(tok, LL_LEVELS);
+
+    /* The module trims nlevels to 1 when there is no second core */
+    int levels = (int)req.nlevels;
+    if (levels > LL_LEVELS) levels = LL_LEVELS;
+
+    out->kernel       = 1;
+    out->load_threads = (int)req.load_threads;
+    for (int i = 0; i < levels; i++) {
+        out->delay_ns[i] = ll_delays_ns[i];
+        out->lat_ns[i]   = (double)req.lat_ps[i] / 1000.0;
+        out->bw_mbs[i]   = (double)req.bw_kbs[i] / 1024.0;
+    }
+    out->count = levels;
+    if (progress)
+        progress(out, levels, ctx);
+    return 1;
+}
+
+void bench_loaded_latency(int copy_load, loaded_lat_t *out,
+                          loaded_lat_progress_fn progress, void *ctx,
+                          bench_token_t *tok)
+{
+    memset(out, 0, sizeof(*out));
+    out->copy_load = copy_load ? 1 : 0;
+
+    /* One unit per load level */
+    bench_token_begin(tok, LL_LEVELS);
+    if (bench_loaded_kernel(copy_load, out, progress, ctx, tok))
+        return;
+
+    int cpu_list[MAX_THREADS];
+    int ncpus    = build_cpu_list(cpu_list, MAX_THREADS);
+    int nworkers = ncpus - 1;
+
+    size_t dram_sz = dram_buf_bytes();
+    size_t n_nodes = dram_sz / sizeof(node_t);
+    node_t *nodes  = build_chain(n_nodes, BENCH_CHAIN_RANDOM, PAGES_AUTO);
+    if (!nodes) return;
+
+    /* Load buffer: same total as bench_run(), split into per-worker chunks
+     * sized to a whole number of (copy-pair) blocks */
+    size_t blk_pair = 2 * LL_BLOCK_BYTES;
+    size_t chunk    = nworkers > 0 ? dram_sz / (size_t)nworkers : 0;
+    chunk &= ~(blk_pair - 1);
+    if (nworkers > 0 && chunk < blk_pair) chunk = blk_pair;
+    size_t   load_sz = chunk * (size_t)(nworkers > 0 ? nworkers : 0);
+    uint64_t *load   = load_sz ? bench_alloc(load_sz) : NULL;
+    if (load_sz && !load) {
+        bench_free_pages(nodes, n_nodes * sizeof(node_t), PAGES_AUTO);
         return;
     }
+    if (load) memset(load, 0xAB, load_sz);
+
+    /* The calling thread is the chaser; it is a throwaway bench thread, so
+     * the affinity is not restored. */
+    pin_to_cpu(cpu_list[0]);
+    out->load_threads = nworkers;
+    int levels = nworkers > 0 ? LL_LEVELS : 1;   /* single core: idle only */
+
+    ll_arg_t   args[MAX_THREADS];
+    pthread_t  tids[MAX_THREADS];
+    atomic_int    stop;
+    atomic_ullong bytes;
+    bw_kernels_t  kern;
+    bw_select_kernels(BENCH_BWK_NT, 0, &kern);
+
+    for (int lvl = 0; lvl < levels && !bench_token_cancelled(tok); lvl++) {
+        int delay   = ll_delays_ns[lvl];
+        int started = 0;
+
+        atomic_store(&stop, 0);
+        atomic_store(&bytes, 0);
+        if (delay >= 0) {
+            for (int t = 0; t < nworkers; t++) {
+                args[t].buf      = load + (size_t)t * (chunk / sizeof(uint64_t));
+                args[t].n        = chunk / sizeof(uint64_t);
+                args[t].cpu      = cpu_list[t + 1];
+                args[t].copy     = out->copy_load;
+                args[t].delay_ns = delay;
+                args[t].stop     = &stop;
+                args[t].bytes    = &bytes;
+                args[t].kern     = &kern;
+                if (pthread_create(&tids[t], NULL, ll_worker, &args[t]) != 0)
+                    break;
+                started++;
+            }
+            /* Let the load reach steady state before timing */
+            long long until = now_ns() + LL_WARMUP_NS;
+            while (now_ns() < until)
+                _mm_pause();
+        }
+
+        double lat[LL_SAMPLES], bw[LL_SAMPLES];
+        for (int s = 0; s < LL_SAMPLES; s++) {
+            flush_buffer(nodes, n_nodes * sizeof(node_t));
+            volatile node_t *p = nodes;
+            unsigned long long b0 = atomic_load(&bytes);
+            long long t0 = now_ns();
+            for (long long k = 0; k < LL_CHASE_HOPS; k++) p = p->next;
+            long long t1 = now_ns();
+            unsigned long long b1 = atomic_load(&bytes);
+            lat[s] = (double)(t1 - t0) / (double)LL_CHASE_HOPS;
+            bw[s]  = (double)(b1 - b0) / ((double)(t1 - t0) * 1e-9) / (1024.0 * 1024.0);
+        }
+
+        atomic_store(&stop, 1);
+        for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+
+        qsort(lat, LL_SAMPLES, sizeof(double), cmp_double);
+        qsort(bw,  LL_SAMPLES, sizeof(double), cmp_double);
+        out->delay_ns[out->count] = delay;
+        out->lat_ns[out->count]   = lat[LL_SAMPLES / 2];
+        out->bw_mbs[out->count]   = bw[LL_SAMPLES / 2];
+        out->count++;
+        bench_token_advance(tok, lvl + 1 < levels ? 1 : LL_LEVELS - lvl);
+        if (progress)
+            progress(out, levels, ctx);
+    }
 
-    /* Touch all pages so THP faults and TLB entries are warm before
-     * the timed passes begin. */
-    memset(buf_a, 0xAB, dram_sz);
-    memset(buf_b, 0xCD, dram_sz);
-    memset(evict, 0xEF, dram_sz * 2);
+    bench_free(load, load_sz);
+    bench_free_pages(nodes, n_nodes * sizeof(node_t), PAGES_AUTO);
+}
 
-    pthread_barrier_t bar_start, bar_end;
-    /* nthreads workers + 1 main */
-    pthread_barrier_init(&bar_start, NULL, (unsigned)(nthreads + 1));
-    pthread_barrier_init(&bar_end,   NULL, (unsigned)(nthreads + 1));
+int bench_loaded_write_csv(const loaded_lat_t *l, const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "# load=%s threads=%d path=%s\n", l->copy_load ? "copy" : "read",
+            l->load_threads, l->kernel ? "kernel" : "userspace");
+    fprintf(f, "delay_ns,bandwidth_mbs,latency_ns\n");
+    for (int i = 0; i < l->count; i++)
+        fprintf(f, "%d,%.1f,%.3f\n", l->delay_ns[i], l->bw_mbs[i], l->lat_ns[i]);
+    return fclose(f) == 0 ? 0 : -1;
+}
 
-    bw_arg_t  args[MAX_THREADS];
-    pthread_t tids[MAX_THREADS];
+/* ── Memory-level parallelism ────────────────────────────────────────── */
 
-    size_t total_n  = dram_sz / sizeof(uint64_t);
-    size_t chunk_n  = total_n / (size_t)nthreads;
+/*
+ * nchains independent chases over disjoint slices of one DRAM-sized chain
+ * order, one hop of each per loop iteration — the tuxbench module runs the
+ * same loop.  A single chain has one miss in flight at a time; with N the
+ * core can overlap up to N until its miss buffers run out.  Up to that
+ * point lat_ns stays near the 1-chain latency while eff_ns = lat_ns / N
+ * falls; past it lat_ns grows with N and mlp flattens.  The order is
+ * shuffled once and only relinked per point.
+ */
+#define MLP_LOADS   2000000LL     /* loads per sample across all chains */
+#define MLP_SAMPLES 3
 
-    for (int t = 0; t < nthreads; t++) {
-        size_t off     = (size_t)t * chunk_n;
-        /* Last thread takes any remainder so no bytes are skipped */
-        size_t this_n  = (t == nthreads - 1) ? total_n - off : chunk_n;
-        args[t].buf_a     = buf_a + off;
-        args[t].buf_b     = buf_b + off;
-        args[t].n         = this_n;
-        args[t].cpu       = cpu_list[t];
-        args[t].op        = OP_READ;
-        args[t].bar_start = &bar_start;
-        args[t].bar_end   = &bar_end;
-        pthread_create(&tids[t], NULL, bw_worker, &args[t]);
-    }
-
-    out->bw_read_mbs  = run_bw_passes(args, nthreads, &bar_start, &bar_end,
-                                       OP_READ,  dram_sz, 1,
-                                       evict, dram_sz * 2);
-    out->bw_write_mbs = run_bw_passes(args, nthreads, &bar_start, &bar_end,
-                                       OP_WRITE, dram_sz, 1,
-                                       evict, dram_sz * 2);
-    out->bw_copy_mbs  = run_bw_passes(args, nthreads, &bar_start, &bar_end,
-                                       OP_COPY,  dram_sz, 2,
-                                       evict, dram_sz * 2);
-
-    /* Signal threads to exit — they return directly without hitting bar_end */
-    for (int t = 0; t < nthreads; t++) args[t].op = OP_EXIT;
-    pthread_barrier_wait(&bar_start);
-    for (int t = 0; t < nthreads; t++) pthread_join(tids[t], NULL);
-
-    pthread_barrier_destroy(&bar_start);
-    pthread_barrier_destroy(&bar_end);
-
-    bench_free(buf_a, dram_sz);
-    bench_free(buf_b, dram_sz);
-    bench_free(evict, dram_sz * 2);
+static const int mlp_chains[] = { 1, 2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 28, 32 };
+#define MLP_POINTS ((int)(sizeof(mlp_chains) / sizeof(mlp_chains[0])))
+
+/* p[] stays in memory: the store-to-load forward costs a few cycles per
+ * hop on each chain, far below a DRAM miss, and one loop serves every N. */
+__attribute__((noinline))
+static void chase_chains(node_t **p, int nchains, long long hops)
+{
+    for (long long k = 0; k < hops; k++)
+        for (int c = 0; c < nchains; c++)
+            p[c] = p[c]->next;
+}
+
+/* eff_ns and mlp of point i from its lat_ns; point 0 is the single chain */
+static void mlp_derive(bench_mlp_t *m, int i)
+{
+    m->eff_ns[i] = m->lat_ns[i] / m->chains[i];
+    m->mlp[i]    = m->eff_ns[i] > 0.0 ? m->lat_ns[0] / m->eff_ns[i] : 0.0;
+}
+
+static int bench_mlp_kernel(int chain, bench_mlp_t *out,
+                            bench_mlp_progress_fn progress, void *ctx,
+                            bench_token_t *tok)
+{
+    int fd = open("/dev/tuxbench", O_RDWR);
+    if (fd < 0)
+        return 0;
+
+    struct tuxbench_mlp_req req;
+    memset(&req, 0, sizeof(req));
+    req.chain   = (unsigned)chain;
+    req.npoints = MLP_POINTS;
+    for (int i = 0; i < MLP_POINTS; i++)
+        req.nchains[i] = (unsigned)mlp_chains[i];
+
+    if (!kernel_enter(tok, fd, MLP_POINTS)) {
+        close(fd);
+        return 1;   /* cancelled before it started: nothing measured */
+    }
+    int rc = ioctl(fd, TUXBENCH_IOC_MLP, &req);
+    int err = rc == 0 ? 0 : errno;
+    kernel_leave(tok);
+    close(fd);
+    if (err == EINTR)
+        return 1;   /* cancelled — keep count 0, no userspace retry */
+    if (rc != 0)
+        return 0;   /* pre-ABI-6 module without the ioctl — use userspace */
+    bench_token_advance(tok, MLP_POINTS);
+
+    out->kernel = 1;
+    out->bytes  = (size_t)req.bytes;
+    for (int i = 0; i < MLP_POINTS; i++) {
+        out->chains[i] = mlp_chains[i];
+        out->lat_ns[i] = (double)req.lat_ps[i] / 1000.0;
+        mlp_derive(out, i);
+    }
+    out->count = MLP_POINTS;
+    if (progress)
+        progress(out, MLP_POINTS, ctx);
+    return 1;
+}
+
+void bench_mlp(int chain, bench_mlp_t *out, bench_mlp_progress_fn progress, void *ctx,
+               bench_token_t *tok)
+{
+    memset(out, 0, sizeof(*out));
+    out->chain = chain == BENCH_CHAIN_PAGE_LOCAL ? chain : BENCH_CHAIN_RANDOM;
+
+    /* One unit per chain count */
+    bench_token_begin(tok, MLP_POINTS);
+    if (bench_mlp_kernel(out->chain, out, progress, ctx, tok))
+        return;
+
+    size_t bytes = dram_buf_bytes();
+    size_t n     = bytes / sizeof(node_t);
+    node_t *nodes = bench_alloc_pages(bytes, PAGES_AUTO);
+    size_t *perm  = malloc(n * sizeof(size_t));
+    if (!nodes || !perm) {
+        free(perm);
+        bench_free_pages(nodes, bytes, PAGES_AUTO);
+        return;
+    }
+    uint64_t rng = chain_seed(nodes);
+    chain_order(perm, n, out->chain, &rng);
+    out->bytes = bytes;
+
+    /* Throwaway bench thread, as in bench_loaded_latency(): not restored */
+    int cpu_list[MAX_THREADS];
+    if (build_cpu_list(cpu_list, MAX_THREADS) > 0)
+        pin_to_cpu(cpu_list[0]);
+
+    node_t *heads[BENCH_MLP_MAX_CHAINS], *p[BENCH_MLP_MAX_CHAINS];
+    for (int i = 0; i < MLP_POINTS && !bench_token_cancelled(tok); i++) {
+        int nc = mlp_chains[i];
+        long long hops = MLP_LOADS / nc;
+        link_chains(nodes, perm, n, out->chain, nc, heads);
+
+        double lat[MLP_SAMPLES];
+        for (int s = 0; s < MLP_SAMPLES; s++) {
+            flush_buffer(nodes, bytes);
+            memcpy(p, heads, (size_t)nc * sizeof(*p));
+            long long t0 = now_ns();
+            chase_chains(p, nc, hops);
+            long long t1 = now_ns();
+            lat[s] = (double)(t1 - t0) / (double)hops;
+        }
+
+        qsort(lat, MLP_SAMPLES, sizeof(double), cmp_double);
+        out->chains[i] = nc;
+        out->lat_ns[i] = lat[MLP_SAMPLES / 2];
+        mlp_derive(out, i);
+        out->count++;
+        bench_token_advance(tok, 1);
+        if (progress)
+            progress(out, MLP_POINTS, ctx);
+    }
+
+    free(perm);
+    bench_free_pages(nodes, bytes, PAGES_AUTO);
+}
+
+int bench_mlp_write_csv(const bench_mlp_t *m, const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "# chain=%s bytes=%zu path=%s\n",
+            m->chain == BENCH_CHAIN_PAGE_LOCAL ? "page-local" : "random",
+            m->bytes, m->kernel ? "kernel" : "userspace");
+    fprintf(f, "chains,latency_ns,effective_ns,mlp,bandwidth_mbs\n");
+    for (int i = 0; i < m->count; i++)
+        fprintf(f, "%d,%.3f,%.3f,%.2f,%.1f\n", m->chains[i], m->lat_ns[i],
+                m->eff_ns[i], m->mlp[i],
+                m->eff_ns[i] > 0.0 ? CACHELINE / (m->eff_ns[i] * 1e-9) / (1024.0 * 1024.0)
+                                   : 0.0);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/* ── Topology ────────────────────────────────────────────────────────── */
+
+/*
+ * The bandwidth cells here compare CPU subsets against each other rather
+ * than chase the absolute peak, so each uses a smaller budget than
+ * bench_run(): 64 MB per thread still dwarfs any L3, and 3–10 passes keep a
+ * 2-CCD / 2-node machine to a few seconds per cell.
+ */
+#define TOPO_BW_PER_THREAD (64UL << 20)
+#define TOPO_BW_MIN_PASSES 3
+#define TOPO_BW_MAX_PASSES 10
+
+/* Ping-pong round trips per sample; each is two cross-core line transfers */
+#define C2C_ROUND_TRIPS 20000
+#define C2C_SAMPLES     5
+
+/*
+ * Core-to-core: the caller (pinned to one core) and a responder pinned to
+ * another bounce a counter in one cache line.  The caller stores an odd
+ * value and waits for the responder's even reply, so every step is a full
+ * ownership transfer of the line; one-way latency = round trip / 2.
+ */
+typedef struct {
+    _Alignas(64) atomic_int turn;    /* odd: responder's move               */
+    _Alignas(64) atomic_int ready;   /* 1 = pinned and spinning, -1 = failed */
+    int cpu;
+    int rounds;
+} c2c_arg_t;
+
+static void *c2c_responder(void *varg)
+{
+    c2c_arg_t *a = varg;
+    if (pin_to_cpu(a->cpu) != 0) {
+        atomic_store(&a->ready, -1);
+        return NULL;
+    }
+    atomic_store(&a->ready, 1);
+
+    for (int i = 0; i < a->rounds; i++) {
+        int want = 2 * i + 1;
+        while (atomic_load_explicit(&a->turn, memory_order_acquire) != want)
+            _mm_pause();
+        atomic_store_explicit(&a->turn, want + 1, memory_order_release);
+    }
+    return NULL;
+}
+
+/* One-way latency in ns from the caller's CPU to cpu, 0 on failure */
+static double c2c_pair_ns(int cpu)
+{
+    c2c_arg_t a;
+    atomic_init(&a.turn, 0);
+    atomic_init(&a.ready, 0);
+    a.cpu    = cpu;
+    a.rounds = C2C_ROUND_TRIPS * C2C_SAMPLES;
+
+    pthread_t tid;
+    if (pthread_create(&tid, NULL, c2c_responder, &a) != 0)
+        return 0.0;
+    while (atomic_load(&a.ready) == 0)
+        _mm_pause();
+    if (atomic_load(&a.ready) < 0) {
+        pthread_join(tid, NULL);
+        return 0.0;
+    }
+
+    double samples[C2C_SAMPLES];
+    int turn = 0;
+    for (int s = 0; s < C2C_SAMPLES; s++) {
+        long long t0 = now_ns();
+        for (int i = 0; i < C2C_ROUND_TRIPS; i++) {
+            atomic_store_explicit(&a.turn, ++turn, memory_order_release);
+            ++turn;
+            while (atomic_load_explicit(&a.turn, memory_order_acquire) != turn)
+                _mm_pause();
+        }
+        long long t1 = now_ns();
+        samples[s] = (double)(t1 - t0) / (2.0 * C2C_ROUND_TRIPS);
+    }
+    pthread_join(tid, NULL);
+
+    qsort(samples, C2C_SAMPLES, sizeof(double), cmp_double);
+    return samples[C2C_SAMPLES / 2];
+}
+
+/* Read bandwidth on cpus[] via TUXBENCH_IOC_RUN_V2; 0 if unavailable or
+ * cancelled */
+static int topo_bw_kernel(const int *cpus, int n, int mem_node, double *mbs,
+                          bench_token_t *tok)
+{
+    int fd = open("/dev/tuxbench", O_RDWR);
+    if (fd < 0)
+        return 0;
+
+    struct tuxbench_req_v2 *r2 = calloc(1, sizeof(*r2));
+    if (!r2) { close(fd); return 0; }
+
+    r2->version    = TUXBENCH_ABI_VERSION;
+    r2->ops        = TUXBENCH_OP(TUXBENCH_RES_BW_READ);
+    r2->numa_node  = mem_node;
+    r2->min_passes = TOPO_BW_MIN_PASSES;
+    r2->max_passes = TOPO_BW_MAX_PASSES;
+    r2->bw_bytes   = TOPO_BW_PER_THREAD;
+    for (int i = 0; i < n; i++)
+        if (cpus[i] < TUXBENCH_CPUMASK_WORDS * 64)
+            r2->cpumask[cpus[i] / 64] |= 1ULL << (cpus[i] % 64);
+
+    int ok = kernel_enter(tok, fd, TOPO_BW_MAX_PASSES) &&
+             ioctl(fd, TUXBENCH_IOC_RUN_V2, r2) == 0 &&
+             r2->res[TUXBENCH_RES_BW_READ].nsamples > 0;
+    kernel_leave(tok);
+    if (ok) {
+        bench_token_advance(tok, TOPO_BW_MAX_PASSES);
+        *mbs = (double)r2->res[TUXBENCH_RES_BW_READ].median / 1024.0;
+    }
+    free(r2);
+    close(fd);
+    return ok;
+}
+
+typedef struct {
+    int      use_kernel;     /* -1 = not tried yet */
+    size_t   evict_bytes;    /* userspace path only, sized on first use */
+    bench_token_t *tok;
+} topo_bw_ctx_t;
+
+/* Read bandwidth of cpus[] against memory on mem_node (-1 = local) */
+static double topo_bw(topo_bw_ctx_t *tc, const int *cpus, int n, int mem_node)
+{
+    double mbs = 0.0;
+
+    if (n <= 0 || bench_token_cancelled(tc->tok)) return 0.0;
+    if (tc->use_kernel != 0) {
+        if (topo_bw_kernel(cpus, n, mem_node, &mbs, tc->tok)) {
+            tc->use_kernel = 1;
+            return mbs;
+        }
+        if (bench_token_cancelled(tc->tok))
+            return 0.0;
+        if (tc->use_kernel < 0)
+            tc->use_kernel = 0;   /* no module / pre-v2: userspace from now on */
+        else
+            return 0.0;
+    }
+
+    if (!tc->evict_bytes)
+        tc->evict_bytes = dram_buf_bytes() * 2;
+
+    run_cfg_t rc;
+    bench_stats_t stats[BENCH_NR_TESTS];
+    memset(&rc, 0, sizeof(rc));
+    memset(stats, 0, sizeof(stats));
+    rc.ops       = BENCH_OP(BENCH_BW_READ);
+    rc.bw_min    = TOPO_BW_MIN_PASSES;
+    rc.bw_max    = TOPO_BW_MAX_PASSES;
+    rc.cv_target = BW_CV_TARGET;
+    rc.token     = tc->tok;
+    ctx_enter();
+    uint8_t *evict = ctx_evict(tc->evict_bytes);
+    if (evict && bw_run_cpus(cpus, n, TOPO_BW_PER_THREAD * (size_t)n, mem_node,
+                             evict, tc->evict_bytes, &rc, stats, NULL))
+        mbs = stats[BENCH_BW_READ].median;
+    ctx_leave();
+    return mbs;
+}
+
+void bench_topology(bench_topo_t *out, bench_topo_progress_fn progress, void *ctx,
+                    bench_token_t *tok)
+{
+    memset(out, 0, sizeof(*out));
+
+    int cpu_list[MAX_THREADS];
+    int ncpus = build_cpu_list(cpu_list, MAX_THREADS);
+
+    /* Group physical cores by the topology model's L3 domain and NUMA
+     * node; cpu_list[i] is core i.  Overflow folds into the last slot. */
+    const topology_t *t = topology_get();
+    int dom_of[MAX_THREADS], node_of[MAX_THREADS];
+    for (int i = 0; i < ncpus; i++) {
+        int d = t->core_ccd[i] < BENCH_TOPO_MAX_DOMAINS ? t->core_ccd[i]
+                                                        : BENCH_TOPO_MAX_DOMAINS - 1;
+        if (d >= out->ndomains) {
+            for (int k = out->ndomains; k <= d; k++) out->domain_cpu[k] = cpu_list[i];
+            out->ndomains = d + 1;
+        }
+        if (out->domain_cores[d] == 0 || cpu_list[i] < out->domain_cpu[d])
+            out->domain_cpu[d] = cpu_list[i];
+        dom_of[i] = d;
+        out->domain_cores[d]++;
+
+        int node = t->core_node[i];
+        int k;
+        for (k = 0; k < out->nnodes; k++)
+            if (out->node_id[k] == node) break;
+        if (k == out->nnodes) {
+            if (k < BENCH_TOPO_MAX_NODES) out->node_id[out->nnodes++] = node;
+            else k = BENCH_TOPO_MAX_NODES - 1;
+        }
+        node_of[i] = k;
+    }
+
+    out->ncores = ncpus < BENCH_C2C_MAX_CORES ? ncpus : BENCH_C2C_MAX_CORES;
+    for (int i = 0; i < out->ncores; i++) {
+        out->core_cpu[i]    = cpu_list[i];
+        out->core_domain[i] = dom_of[i];
+    }
+
+    int total = (out->ncores > 1 ? out->ncores - 1 : 0) + out->ndomains + 1 +
+                (out->nnodes > 1 ? out->nnodes * out->nnodes : 0);
+    int done  = 0;
+    /* Token units: TOPO_BW_MAX_PASSES per step, the pass budget of a
+     * bandwidth step (a core-to-core row takes about as long) */
+    bench_token_begin(tok, (long)total * TOPO_BW_MAX_PASSES);
+
+    /* --- Core-to-core: the caller hops to core i and pings every j > i;
+     * the matrix is taken as symmetric.  Affinity is restored afterwards so
+     * the bandwidth coordinator below is not stuck on one worker's core. */
+    cpu_set_t saved;
+    int have_saved = pthread_getaffinity_np(pthread_self(), sizeof(saved), &saved) == 0;
+    for (int i = 0; i + 1 < out->ncores && !bench_token_cancelled(tok); i++) {
+        if (pin_to_cpu(out->core_cpu[i]) == 0) {
+            for (int j = i + 1; j < out->ncores; j++) {
+                double ns = c2c_pair_ns(out->core_cpu[j]);
+                out->c2c_ns[i][j] = out->c2c_ns[j][i] = ns;
+            }
+        }
+        bench_token_advance(tok, TOPO_BW_MAX_PASSES);
+        if (progress) progress(out, ++done, total, ctx);
+    }
+    if (have_saved)
+        pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+
+    /* --- Bandwidth: each L3 domain alone, then all of them together --- */
+    topo_bw_ctx_t tc = { .use_kernel = -1, .tok = tok };
+    int sub[MAX_THREADS];
+    for (int d = 0; d < out->ndomains; d++) {
+        int n = 0;
+        for (int i = 0; i < ncpus; i++)
+            if (dom_of[i] == d) sub[n++] = cpu_list[i];
+        out->domain_bw_mbs[d] = topo_bw(&tc, sub, n, -1);
+        if (progress) progress(out, ++done, total, ctx);
+    }
+    out->all_bw_mbs = topo_bw(&tc, cpu_list, ncpus, -1);
+    if (progress) progress(out, ++done, total, ctx);
+
+    /* --- Node × node: cores of one node reading another node's memory --- */
+    if (out->nnodes > 1) {
+        for (int r = 0; r < out->nnodes; r++) {
+            int n = 0;
+            for (int i = 0; i < ncpus; i++)
+                if (node_of[i] == r) sub[n++] = cpu_list[i];
+            for (int c = 0; c < out->nnodes; c++) {
+                out->node_bw_mbs[r][c] = topo_bw(&tc, sub, n, out->node_id[c]);
+                if (progress) progress(out, ++done, total, ctx);
+            }
+        }
+    }
+
+    out->kernel = tc.use_kernel == 1;
+}
+
+/* ── Soak ────────────────────────────────────────────────────────────── */
+
+/*
+ * Drift is the least-squares slope of a test's per-run medians against run
+ * start time, scaled to the soak's span.  It only counts when the slope is
+ * more than twice its standard error — run-to-run noise on a 2–3 run soak
+ * would otherwise look like a trend — and only in the direction that hurts:
+ * DIMMs heating up show as bandwidth decaying or latency creeping up.
+ */
+void bench_soak_stats(const bench_soak_t *s, int test, bench_soak_stat_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (test < 0 || test >= BENCH_NR_TESTS) return;
+
+    double sx = 0, sy = 0;
+    int n = 0;
+    for (int i = 0; i < s->nruns; i++) {
+        double y = s->runs[i].value[test];
+        if (y <= 0.0) continue;
+        if (n == 0 || y < out->min) out->min = y;
+        if (y > out->max) out->max = y;
+        sx += s->runs[i].t_sec;
+        sy += y;
+        n++;
+    }
+    out->n = n;
+    if (n == 0) return;
+    double mx = sx / n, my = sy / n;
+    out->mean = my;
+
+    double sxx = 0, syy = 0, sxy = 0;
+    double sum_temp = 0, sum_val = 0;              /* runs with an SPD temp */
+    int    nt = 0;
+    double t_lo = 0, t_hi = 0;
+    for (int i = 0; i < s->nruns; i++) {
+        const bench_soak_run_t *r = &s->runs[i];
+        double y = r->value[test];
+        if (y <= 0.0) continue;
+        double dx = r->t_sec - mx, dy = y - my;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+        if (nt == 0 || r->t_sec < t_lo) t_lo = r->t_sec;
+        if (r->t_sec > t_hi) t_hi = r->t_sec;
+        if (r->tele.nsamples > 0 && r->tele.spd_temp_c > 0.0f) {
+            sum_temp += r->tele.spd_temp_c;
+            sum_val  += y;
+            nt++;
+        }
+    }
+    if (n > 1) out->stddev = sqrt(syy / (n - 1));
+
+    if (n >= 3 && sxx > 0.0) {
+        double b   = sxy / sxx;
+        double res = syy - b * sxy;               /* residual sum of squares */
+        double se  = sqrt((res > 0 ? res : 0) / (n - 2) / sxx);
+        out->slope_per_hour = b * 3600.0;
+        out->drift_pct      = my > 0 ? 100.0 * b * (t_hi - t_lo) / my : 0.0;
+        int worse = (test <= BENCH_LAT_DRAM) ? b > 0 : b < 0;
+        out->drifting = worse && fabs(b) > 2.0 * se &&
+                        fabs(out->drift_pct) >= BENCH_SOAK_DRIFT_PCT;
+    }
+
+    /* Pearson r against SPD temperature over the runs that captured it */
+    if (nt >= 3) {
+        double mt = sum_temp / nt, mv = sum_val / nt;
+        double ctt = 0, cty = 0, cyy = 0;
+        for (int i = 0; i < s->nruns; i++) {
+            const bench_soak_run_t *r = &s->runs[i];
+            double y = r->value[test];
+            if (y <= 0.0 || r->tele.nsamples <= 0 || r->tele.spd_temp_c <= 0.0f)
+                continue;
+            double dt = r->tele.spd_temp_c - mt, dy = y - mv;
+            ctt += dt * dt;
+            cty += dt * dy;
+            cyy += dy * dy;
+        }
+        if (ctt > 0.0 && cyy > 0.0)
+            out->temp_corr = cty / sqrt(ctt * cyy);
+    }
+}
+
+int bench_soak_write_csv(const bench_soak_t *s, const char *path)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) return -1;
+    fprintf(f, "# soak runs=%d\n", s->nruns);
+    fprintf(f, "run,t_sec,lat_l1_ns,lat_l2_ns,lat_l3_ns,lat_dram_ns,"
+               "bw_read_mbs,bw_write_mbs,bw_copy_mbs,"
+               "tele_samples,fclk_mhz,uclk_mhz,vsoc_v,cpu_temp_c,spd_temp_c,spd_temp_max_c\n");
+    for (int i = 0; i < s->nruns; i++) {
+        const bench_soak_run_t  *r = &s->runs[i];
+        const bench_telemetry_t *m = &r->tele;
+        fprintf(f, "%d,%.1f", i + 1, r->t_sec);
+        for (int t = 0; t < BENCH_NR_TESTS; t++)
+            fprintf(f, t <= BENCH_LAT_DRAM ? ",%.3f" : ",%.0f", r->value[t]);
+        fprintf(f, ",%d,%.0f,%.0f,%.4f,%.1f,%.1f,%.1f\n", m->nsamples,
+                m->fclk_mhz, m->uclk_mhz, m->vsoc, m->cpu_temp_c,
+                m->spd_temp_c, m->spd_temp_max_c);
+    }
+    return fclose(f) == 0 ? 0 : -1;
 }
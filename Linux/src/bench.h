@@ -1,6 +1,50 @@
 #ifndef BENCH_H
 #define BENCH_H
 
+#include <stddef.h>
+
+/* Tests, in result order; BENCH_OP(t) selects one in bench_config_t.ops */
+enum {
+    BENCH_LAT_L1,
+    BENCH_LAT_L2,
+    BENCH_LAT_L3,
+    BENCH_LAT_DRAM,
+    BENCH_BW_READ,
+    BENCH_BW_WRITE,
+    BENCH_BW_COPY,
+    BENCH_NR_TESTS
+};
+#define BENCH_OP(t)    (1u << (t))
+#define BENCH_OPS_LAT  0x0fu
+#define BENCH_OPS_BW   0x70u
+#define BENCH_OPS_ALL  (BENCH_OPS_LAT | BENCH_OPS_BW)
+
+#define BENCH_MAX_SAMPLES 64
+
+/* Write/copy store strategy (reads are the same in every variant) */
+enum {
+    BENCH_BWK_DEFAULT,     /* NT in userspace; module's own default in kernel */
+    BENCH_BWK_NT,          /* streaming non-temporal stores                  */
+    BENCH_BWK_TEMPORAL,    /* regular stores — pays the RFO read             */
+    BENCH_BWK_ERMS,        /* rep stosb / rep movsb                          */
+    BENCH_BWK_COUNT
+};
+
+/* Pointer-chain layout of the latency tests */
+enum {
+    BENCH_CHAIN_RANDOM,      /* one random cycle over the whole buffer       */
+    BENCH_CHAIN_PAGE_LOCAL,  /* lines shuffled within each 4 KB page, pages
+                                in address order: ~1 TLB miss per 64 loads  */
+    BENCH_CHAIN_COUNT
+};
+
+/* Per-test distribution in the test's unit (ns or MB/s).  nsamples 0 = not
+ * run, or run by a pre-v2 tuxbench module that only reports the median. */
+typedef struct {
+    int    nsamples;
+    double min, median, p99, max, mean, stddev;
+} bench_stats_t;
+
 typedef struct {
     double lat_l1_ns;
     double lat_l2_ns;
@@ -9,10 +53,230 @@ typedef struct {
     double bw_read_mbs;
     double bw_write_mbs;
     double bw_copy_mbs;
+    bench_stats_t stats[BENCH_NR_TESTS];
+    int    kernel;                       /* 1 = via /dev/tuxbench        */
+    int    bw_kernel;                    /* BENCH_BWK_* that ran         */
+    int    pf_dist;                      /* prefetch distance used, bytes */
+    int    bw_avx512;                    /* 1 = 512-bit kernels          */
+    int    cancelled;                    /* stopped by bench_token_cancel();
+                                            tests not reached read 0     */
 } bench_results_t;
 
+/* ── Progress and cancellation ──────────────────────────────────────── */
+
+/*
+ * Optional handle on a run in flight.  The runner checks it between samples
+ * and passes (the tuxbench module between its own passes) and returns early
+ * with whatever it has; any other thread may cancel or poll it.  A kernel
+ * run is interrupted through TUXBENCH_IOC_CANCEL — a pre-v5 module only
+ * notices once its ioctl returns.  Every function accepts a NULL token.
+ */
+typedef struct bench_token bench_token_t;
+
+bench_token_t *bench_token_new(void);
+void   bench_token_free(bench_token_t *t);
+void   bench_token_cancel(bench_token_t *t);
+int    bench_token_cancelled(const bench_token_t *t);
+double bench_token_progress(bench_token_t *t);          /* 0..1 */
+
+/* For runners: size the work in arbitrary units, then report units done */
+void   bench_token_begin(bench_token_t *t, long total);
+void   bench_token_advance(bench_token_t *t, long n);
+
+/* What to run.  Zero fields keep the defaults of bench_run(). */
+typedef struct {
+    unsigned ops;          /* BENCH_OP() mask; 0 = every test            */
+    int      min_passes;   /* samples before the CV check                */
+    int      max_passes;   /* sample cap, ≤ BENCH_MAX_SAMPLES            */
+    double   cv_target;    /* stop once stddev/mean < cv_target (0 = 1%) */
+    size_t   bw_bytes;     /* per-thread bandwidth buffer; 0 = auto      */
+    int      nthreads;     /* bandwidth threads; 0 = one per core        */
+    int      bw_kernel;    /* BENCH_BWK_*                                */
+    int      pf_dist;      /* read prefetch distance, bytes; 0 = default
+                              (8 KB), < 0 = no software prefetch         */
+    int      chain;        /* BENCH_CHAIN_* of the latency tests         */
+    bench_token_t *token;  /* NULL = not cancellable                     */
+} bench_config_t;
+
 /* Run all benchmarks — blocks for ~2–4 seconds. Call from a background thread. */
 void bench_run(bench_results_t *out);
 
+/* Run the tests selected in cfg (NULL = bench_run()). Same threading rules. */
+void bench_run_ex(const bench_config_t *cfg, bench_results_t *out);
+
+/* "NT stores", "regular stores", … for a BENCH_BWK_* value */
+const char *bench_bw_kernel_name(int variant);
+
+/*
+ * The userspace bandwidth path keeps its buffers and pinned worker threads
+ * between runs.  They are released once no run has used them for
+ * BENCH_CTX_IDLE_SEC, or by bench_ctx_release() (a no-op while a run is in
+ * flight).
+ */
+#define BENCH_CTX_IDLE_SEC 30
+void bench_ctx_release(void);
+
+/* ── Latency sweep (latency vs working-set size) ────────────────────── */
+
+#define LAT_SWEEP_MAX_POINTS 128
+
+typedef struct {
+    int    count;
+    int    huge_pages;                   /* 1 = 2 MB THP backing, 0 = 4 KB */
+    int    chain;                        /* BENCH_CHAIN_* */
+    size_t cache_bytes[3];               /* L1D / L2 / L3 (cpu0), 0 = unknown */
+    size_t bytes[LAT_SWEEP_MAX_POINTS];  /* working-set size per point */
+    double lat_ns[LAT_SWEEP_MAX_POINTS]; /* median load-to-use latency */
+} lat_sweep_t;
+
+/* Called after every completed point with the partial curve. */
+typedef void (*lat_sweep_progress_fn)(const lat_sweep_t *partial, int total, void *ctx);
+
+/* Pointer-chase latency from min_bytes to max_bytes in 1/steps_per_octave
+ * octave steps. max_bytes is clamped to half of the available RAM.
+ * Blocks for tens of seconds at GB sizes — call from a background thread. */
+void bench_latency_sweep(size_t min_bytes, size_t max_bytes, int steps_per_octave,
+                         int huge_pages, int chain, lat_sweep_t *out,
+                         lat_sweep_progress_fn progress, void *ctx,
+                         bench_token_t *tok);
+
+/* Write the curve as "bytes,kib,latency_ns" CSV. Returns 0 on success. */
+int  bench_sweep_write_csv(const lat_sweep_t *s, const char *path);
+
+
+/* ── Loaded latency (latency vs injected bandwidth) ─────────────────── */
+
+#define LOADED_LAT_MAX_POINTS 16
+
+typedef struct {
+    int    count;
+    int    copy_load;                        /* 0 = read streams, 1 = copy */
+    int    load_threads;                     /* bandwidth workers          */
+    int    kernel;                           /* 1 = via /dev/tuxbench      */
+    int    delay_ns[LOADED_LAT_MAX_POINTS];  /* per-block delay; -1 = idle */
+    double bw_mbs[LOADED_LAT_MAX_POINTS];    /* injected bandwidth         */
+    double lat_ns[LOADED_LAT_MAX_POINTS];    /* chase latency under load   */
+} loaded_lat_t;
+
+typedef void (*loaded_lat_progress_fn)(const loaded_lat_t *partial, int total, void *ctx);
+
+/* DRAM pointer-chase latency at a range of throttled bandwidth loads.
+ * Uses the tuxbench module when loaded. Blocks for several seconds. */
+void bench_loaded_latency(int copy_load, loaded_lat_t *out,
+                          loaded_lat_progress_fn progress, void *ctx,
+                          bench_token_t *tok);
+
+/* Write the curve as "delay_ns,bandwidth_mbs,latency_ns" CSV. 0 on success. */
+int  bench_loaded_write_csv(const loaded_lat_t *l, const char *path);
+
+/* ── Memory-level parallelism (latency vs parallel chains) ──────────── */
+
+#define BENCH_MLP_MAX_POINTS 16
+#define BENCH_MLP_MAX_CHAINS 32
+
+typedef struct {
+    int    count;
+    int    chain;                          /* BENCH_CHAIN_* of every chain   */
+    int    kernel;                         /* 1 = via /dev/tuxbench          */
+    size_t bytes;                          /* buffer shared by the chains    */
+    int    chains[BENCH_MLP_MAX_POINTS];   /* independent chases in flight   */
+    double lat_ns[BENCH_MLP_MAX_POINTS];   /* time per hop of one chain      */
+    double eff_ns[BENCH_MLP_MAX_POINTS];   /* per load: lat_ns / chains      */
+    double mlp[BENCH_MLP_MAX_POINTS];      /* 1-chain latency / eff_ns: the
+                                              misses effectively overlapped */
+} bench_mlp_t;
+
+typedef void (*bench_mlp_progress_fn)(const bench_mlp_t *partial, int total, void *ctx);
+
+/* DRAM pointer chase with 1..BENCH_MLP_MAX_CHAINS independent chains
+ * interleaved in one loop; mlp flattens where the core runs out of miss
+ * buffers.  Uses the tuxbench module when loaded.  Blocks for several
+ * seconds — call from a background thread. */
+void bench_mlp(int chain, bench_mlp_t *out, bench_mlp_progress_fn progress, void *ctx,
+               bench_token_t *tok);
+
+/* Write "chains,latency_ns,effective_ns,mlp,bandwidth_mbs" CSV. 0 on success. */
+int  bench_mlp_write_csv(const bench_mlp_t *m, const char *path);
+
+/* ── Soak (repeated runs with telemetry, drift detection) ───────────── */
+
+#define BENCH_SOAK_MAX_RUNS  512
+#define BENCH_SOAK_DRIFT_PCT 1.0   /* flag trends worse than this over the soak */
+
+/* PM-table telemetry averaged over one run; nsamples 0 = none captured.
+ * Filled by the caller from sampler snapshots taken while the run was on. */
+typedef struct {
+    int   nsamples;
+    float fclk_mhz, uclk_mhz;
+    float vsoc;
+    float cpu_temp_c;                    /* Tdie when available            */
+    float spd_temp_c;                    /* hottest DIMM, mean over the run */
+    float spd_temp_max_c;                /* hottest DIMM, peak              */
+} bench_telemetry_t;
+
+typedef struct {
+    double            t_sec;                  /* run start, since soak start */
+    double            value[BENCH_NR_TESTS];  /* median per test, 0 = not run */
+    bench_telemetry_t tele;
+} bench_soak_run_t;
+
+typedef struct {
+    int              nruns;
+    bench_soak_run_t runs[BENCH_SOAK_MAX_RUNS];
+} bench_soak_t;
+
+/* One test across the runs of a soak */
+typedef struct {
+    int    n;
+    double mean, stddev, min, max;
+    double slope_per_hour;   /* least-squares trend, unit per hour          */
+    double drift_pct;        /* trend across the soak, % of the mean        */
+    double temp_corr;        /* Pearson r against SPD temp; 0 = unavailable */
+    int    drifting;         /* significant trend of ≥ BENCH_SOAK_DRIFT_PCT
+                                in the bad direction (bandwidth falling,
+                                latency rising)                             */
+} bench_soak_stat_t;
+
+void bench_soak_stats(const bench_soak_t *s, int test, bench_soak_stat_t *out);
+
+/* One row per run: time, every test's median and the telemetry. 0 on success. */
+int  bench_soak_write_csv(const bench_soak_t *s, const char *path);
+
+/* ── Topology (per-CCD / per-node bandwidth, core-to-core latency) ──── */
+
+#define BENCH_TOPO_MAX_DOMAINS 32
+#define BENCH_TOPO_MAX_NODES    8
+#define BENCH_C2C_MAX_CORES    64
+
+typedef struct {
+    int    kernel;                                 /* bandwidth via /dev/tuxbench */
+
+    /* Read bandwidth per L3 domain (CCD/CCX), one thread per physical core */
+    int    ndomains;
+    int    domain_cpu[BENCH_TOPO_MAX_DOMAINS];     /* lowest CPU sharing the L3 */
+    int    domain_cores[BENCH_TOPO_MAX_DOMAINS];
+    double domain_bw_mbs[BENCH_TOPO_MAX_DOMAINS];
+    double all_bw_mbs;                             /* every domain at once      */
+
+    /* Read bandwidth, row = CPU node, column = memory node; nnodes < 2 = skipped */
+    int    nnodes;
+    int    node_id[BENCH_TOPO_MAX_NODES];
+    double node_bw_mbs[BENCH_TOPO_MAX_NODES][BENCH_TOPO_MAX_NODES];
+
+    /* One-way cache-line handoff latency between physical cores; 0 = not measured */
+    int    ncores;
+    int    core_cpu[BENCH_C2C_MAX_CORES];
+    int    core_domain[BENCH_C2C_MAX_CORES];       /* index into domain_*       */
+    double c2c_ns[BENCH_C2C_MAX_CORES][BENCH_C2C_MAX_CORES];
+} bench_topo_t;
+
+/* Called as measurements land; done/total count finished steps. */
+typedef void (*bench_topo_progress_fn)(const bench_topo_t *partial, int done, int total,
+                                       void *ctx);
+
+/* Core-to-core matrix first (seconds), then per-domain and node×node
+ * bandwidth.  Blocks for tens of seconds — call from a background thread. */
+void bench_topology(bench_topo_t *out, bench_topo_progress_fn progress, void *ctx,
+                    bench_token_t *tok);
 
 #endif /* BENCH_H */
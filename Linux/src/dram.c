@@ -1,28 +1,42 @@
 #include "dram.h"
 #include "util.h"
+#include "smu.h"
 #include <string.h>
+#include <math.h>
 #include <stdio.h>
 
-#define SMN_PATH "/sys/kernel/ryzen_smu_drv/smn"
-
-static uint32_t read_smn(uint32_t address)
+/* UMC register set, in batch order. DDR4 stops after R_RFC1. */
+enum {
+    R_RATIO, R_REFRESH,
+    R_50204, R_50208, R_5020C, R_50210, R_50214, R_50218, R_5021C, R_50220,
+    R_50224, R_50228, R_50230, R_50234, R_50250, R_50254, R_50258, R_502A4,
+    R_RFC0, R_RFC1,
+    R_DDR4_COUNT,
+    R_RFC2 = R_DDR4_COUNT, R_RFC3,
+    R_RFCSB0, R_RFCSB1, R_RFCSB2, R_RFCSB3,
+    R_DDR5_COUNT
+};
+
+static const uint32_t s_umc_regs[R_DDR5_COUNT] = {
+    [R_RATIO]  = 0x50200, [R_REFRESH] = 0x5012C,
+    [R_50204]  = 0x50204, [R_50208] = 0x50208, [R_5020C] = 0x5020C,
+    [R_50210]  = 0x50210, [R_50214] = 0x50214, [R_50218] = 0x50218,
+    [R_5021C]  = 0x5021C, [R_50220] = 0x50220, [R_50224] = 0x50224,
+    [R_50228]  = 0x50228, [R_50230] = 0x50230, [R_50234] = 0x50234,
+    [R_50250]  = 0x50250, [R_50254] = 0x50254, [R_50258] = 0x50258,
+    [R_502A4]  = 0x502A4,
+    [R_RFC0]   = 0x50260, [R_RFC1]  = 0x50264, [R_RFC2]  = 0x50268,
+    [R_RFC3]   = 0x5026C,
+    [R_RFCSB0] = 0x502C0, [R_RFCSB1] = 0x502C4, [R_RFCSB2] = 0x502C8,
+    [R_RFCSB3] = 0x502CC,
+};
+
+static void read_umc_regs(uint32_t offset, uint32_t *r, int count)
 {
-    FILE *f = fopen(SMN_PATH, "r+b");
-    if (!f) return 0;
-    /* Write address (little-endian) */
-    uint8_t buf[4];
-    buf[0] = (uint8_t)(address);
-    buf[1] = (uint8_t)(address >> 8);
-    buf[2] = (uint8_t)(address >> 16);
-    buf[3] = (uint8_t)(address >> 24);
-    if (fwrite(buf, 1, 4, f) != 4) { fclose(f); return 0; }
-    fflush(f);
-    /* Read back value */
-    rewind(f);
-    if (fread(buf, 1, 4, f) != 4) { fclose(f); return 0; }
-    fclose(f);
-    return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
-           ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+    uint32_t addrs[R_DDR5_COUNT];
+    for (int i = 0; i < count; i++)
+        addrs[i] = offset | s_umc_regs[i];
+    smu_smn_read_batch(addrs, r, count);
 }
 
 static float to_nanoseconds(uint32_t cycles, float freq_mhz)
@@ -33,25 +47,17 @@ static float to_nanoseconds(uint32_t cycles, float freq_mhz)
     return ns;
 }
 
-/* Common timing extraction from SMN registers — shared between DDR4 and DDR5 */
-static void read_common_timings(uint32_t offset, dram_timings_t *d)
+/* Common timing extraction from UMC registers — shared between DDR4 and DDR5 */
+static void decode_common_timings(const uint32_t *r, dram_timings_t *d)
 {
-    uint32_t reg50204 = read_smn(offset | 0x50204);
-    uint32_t reg50208 = read_smn(offset | 0x50208);
-    uint32_t reg5020C = read_smn(offset | 0x5020C);
-    uint32_t reg50210 = read_smn(offset | 0x50210);
-    uint32_t reg50214 = read_smn(offset | 0x50214);
-    uint32_t reg50218 = read_smn(offset | 0x50218);
-    uint32_t reg5021C = read_smn(offset | 0x5021C);
-    uint32_t reg50220 = read_smn(offset | 0x50220);
-    uint32_t reg50224 = read_smn(offset | 0x50224);
-    uint32_t reg50228 = read_smn(offset | 0x50228);
-    uint32_t reg50230 = read_smn(offset | 0x50230);
-    uint32_t reg50234 = read_smn(offset | 0x50234);
-    uint32_t reg50250 = read_smn(offset | 0x50250);
-    uint32_t reg50254 = read_smn(offset | 0x50254);
-    uint32_t reg50258 = read_smn(offset | 0x50258);
-    uint32_t reg502A4 = read_smn(offset | 0x502A4);
+    const uint32_t reg50204 = r[R_50204], reg50208 = r[R_50208];
+    const uint32_t reg5020C = r[R_5020C], reg50210 = r[R_50210];
+    const uint32_t reg50214 = r[R_50214], reg50218 = r[R_50218];
+    const uint32_t reg5021C = r[R_5021C], reg50220 = r[R_50220];
+    const uint32_t reg50224 = r[R_50224], reg50228 = r[R_50228];
+    const uint32_t reg50230 = r[R_50230], reg50234 = r[R_50234];
+    const uint32_t reg50250 = r[R_50250], reg50254 = r[R_50254];
+    const uint32_t reg50258 = r[R_50258], reg502A4 = r[R_502A4];
 
     d->tcl     = bit_slice(reg50204, 5, 0);
     d->trcd_rd = bit_slice(reg50204, 21, 16);
@@ -109,9 +115,11 @@ static void read_common_timings(uint32_t offset, dram_timings_t *d)
 static void read_ddr5_timings(dram_timings_t *d)
 {
     const uint32_t offset = 0; /* UMC0 */
+    uint32_t r[R_DDR5_COUNT];
+    read_umc_regs(offset, r, R_DDR5_COUNT);
 
     /* Ratio -> frequency */
-    uint32_t ratio_reg = read_smn(offset | 0x50200);
+    uint32_t ratio_reg = r[R_RATIO];
     float ratio = bit_slice(ratio_reg, 15, 0) / 100.0f;
     float mem_freq = ratio * 200.0f;
     d->frequency_hint_mhz = mem_freq;
@@ -120,20 +128,15 @@ static void read_ddr5_timings(dram_timings_t *d)
     d->gdm_enabled = bit_slice(ratio_reg, 18, 18) == 1;
     uint32_t cmd2t_bit = bit_slice(ratio_reg, 17, 17);
     snprintf(d->cmd2t, sizeof(d->cmd2t), "%s", cmd2t_bit ? "2T" : "1T");
-    uint32_t refresh_reg = read_smn(offset | 0x5012C);
+    uint32_t refresh_reg = r[R_REFRESH];
     d->power_down_enabled = bit_slice(refresh_reg, 28, 28) == 1;
 
-    read_common_timings(offset, d);
+    decode_common_timings(r, d);
 
     /* RFC - DDR5: choose first non-default from 4 registers */
-    uint32_t trfc_regs[4];
-    trfc_regs[0] = read_smn(offset | 0x50260);
-    trfc_regs[1] = read_smn(offset | 0x50264);
-    trfc_regs[2] = read_smn(offset | 0x50268);
-    trfc_regs[3] = read_smn(offset | 0x5026C);
     uint32_t trfc_reg = 0;
     for (int i = 0; i < 4; i++) {
-        if (trfc_regs[i] != 0x00C00138) { trfc_reg = trfc_regs[i]; break; }
+        if (r[R_RFC0 + i] != 0x00C00138) { trfc_reg = r[R_RFC0 + i]; break; }
     }
     if (trfc_reg) {
         d->rfc  = bit_slice(trfc_reg, 15, 0);
@@ -141,13 +144,9 @@ static void read_ddr5_timings(dram_timings_t *d)
     }
 
     /* RFCsb */
-    uint32_t rfcsb_regs[4];
-    rfcsb_regs[0] = bit_slice(read_smn(offset | 0x502C0), 10, 0);
-    rfcsb_regs[1] = bit_slice(read_smn(offset | 0x502C4), 10, 0);
-    rfcsb_regs[2] = bit_slice(read_smn(offset | 0x502C8), 10, 0);
-    rfcsb_regs[3] = bit_slice(read_smn(offset | 0x502CC), 10, 0);
     for (int i = 0; i < 4; i++) {
-        if (rfcsb_regs[i] != 0) { d->rfcsb = rfcsb_regs[i]; break; }
+        uint32_t rfcsb = bit_slice(r[R_RFCSB0 + i], 10, 0);
+        if (rfcsb != 0) { d->rfcsb = rfcsb; break; }
     }
 
     /* Nanosecond conversions */
@@ -167,7 +166,10 @@ static void read_ddr4_timings(dram_timings_t *d)
      *   - Cmd2T: bit 10
      *   - GDM:   bit 11
      */
-    uint32_t ratio_reg = read_smn(offset | 0x50200);
+    uint32_t r[R_DDR4_COUNT];
+    read_umc_regs(offset, r, R_DDR4_COUNT);
+
+    uint32_t ratio_reg = r[R_RATIO];
     float ratio = (float)bit_slice(ratio_reg, 7, 0) / 3.0f;
     float mem_freq = ratio * 200.0f;
     d->frequency_hint_mhz = mem_freq;
@@ -175,14 +177,14 @@ static void read_ddr4_timings(dram_timings_t *d)
     uint32_t cmd2t_bit = bit_slice(ratio_reg, 10, 10);
     snprintf(d->cmd2t, sizeof(d->cmd2t), "%s", cmd2t_bit ? "2T" : "1T");
     d->gdm_enabled = bit_slice(ratio_reg, 11, 11) == 1;
-    uint32_t refresh_reg = read_smn(offset | 0x5012C);
+    uint32_t refresh_reg = r[R_REFRESH];
     d->power_down_enabled = bit_slice(refresh_reg, 28, 28) == 1;
 
-    read_common_timings(offset, d);
+    decode_common_timings(r, d);
 
     /* RFC - DDR4: first non-default from 2 registers */
-    uint32_t trfc0 = read_smn(offset | 0x50260);
-    uint32_t trfc1 = read_smn(offset | 0x50264);
+    uint32_t trfc0 = r[R_RFC0];
+    uint32_t trfc1 = r[R_RFC1];
     uint32_t trfc_reg = (trfc0 != trfc1) ? ((trfc0 != 0x21060138) ? trfc0 : trfc1) : trfc0;
     if (trfc_reg) {
         d->rfc  = bit_slice(trfc_reg, 10, 0);
@@ -215,3 +217,33 @@ void dram_read_timings(int codename_index, dram_timings_t *out)
         break;
     }
 }
+
+/* ── Cached timings ─────────────────────────────────────────────────── */
+
+static dram_timings_t s_cached;
+static int   s_cached_valid;
+static int   s_cached_codename;
+static float s_cached_mclk;
+
+int dram_read_timings_cached(int codename_index, float mclk_mhz, int force,
+                             dram_timings_t *out)
+{
+    /* MCLK jitters by a fraction of a MHz in the PM table; only a real
+     * memory clock change (P-state switch, APU power state) triggers a
+     * re-read. mclk_mhz <= 0 means "unknown" and never triggers one. */
+    int mclk_changed = mclk_mhz > 0.0f &&
+                       fabsf(mclk_mhz - s_cached_mclk) >= 1.0f;
+
+    if (!force && s_cached_valid && s_cached_codename == codename_index &&
+        !mclk_changed) {
+        *out = s_cached;
+        return 0;
+    }
+
+    dram_read_timings(codename_index, &s_cached);
+    s_cached_valid = 1;
+    s_cached_codename = codename_index;
+    if (mclk_mhz > 0.0f) s_cached_mclk = mclk_mhz;
+    *out = s_cached;
+    return 1;
+}
@@ -9,4 +9,10 @@
  */
 void dram_read_timings(int codename_index, dram_timings_t *out);
 
+/* Cached variant: the UMC registers are only re-read when force is set, on
+ * the first call, when the codename changes, or when mclk_mhz (from the PM
+ * table, 0 if unknown) moved since the last read. Returns 1 if re-read. */
+int dram_read_timings_cached(int codename_index, float mclk_mhz, int force,
+                             dram_timings_t *out);
+
 #endif
@@ -0,0 +1,342 @@
+/*
+ * exporter.c — Prometheus /metrics endpoint for the --shm telemetry segment
+ *
+ * Runs unprivileged next to `tuxtimings --shm` (GUI or --headless) and
+ * never touches the SMU: every scrape maps /dev/shm/tuxtimings, takes a
+ * seqlock-consistent copy of the latest snapshot and renders it in the
+ * Prometheus text format.  The segment is re-attached per scrape, so the
+ * tool can be restarted underneath a running exporter.
+ *
+ *   tuxtimings-exporter [--listen=ADDR:PORT] [--once]
+ *
+ *   --listen=ADDR:PORT   default 127.0.0.1:9877
+ *   --once               print the metrics to stdout and exit (textfile
+ *                        collectors, debugging)
+ *
+ * Single-threaded on purpose: a scrape is one short read of memory.
+ */
+
+#define _GNU_SOURCE
+#include "../telemetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define DEFAULT_LISTEN "127.0.0.1:9877"
+#define REQ_MAX        4096
+
+/* A snapshot older than this many sampler periods reports up 0 */
+#define STALE_PERIODS  5
+
+/* ── Rendering ──────────────────────────────────────────────────────── */
+
+typedef struct {
+    const char *name, *help;
+    size_t      offset;             /* float inside smu_metrics_t */
+} gauge_t;
+
+#define G(n, h, member) { n, h, offsetof(smu_metrics_t, member) }
+static const gauge_t s_gauges[] = {
+    G("ppt_watts",             "Package power tracking",          ppt_w),
+    G("package_power_watts",   "Package power",                   package_power_w),
+    G("package_current_amps",  "Package current",                 package_current_a),
+    G("vcore_volts",           "Core voltage",                    vcore),
+    G("vid_volts",             "Requested core voltage",          vid),
+    G("vsoc_volts",            "SoC voltage",                     vsoc),
+    G("vddp_volts",            "VDDP",                            vddp),
+    G("vddg_ccd_volts",        "VDDG CCD",                        vddg_ccd),
+    G("vddg_iod_volts",        "VDDG IOD",                        vddg_iod),
+    G("vdd_misc_volts",        "VDD misc",                        vdd_misc),
+    G("cpu_vddio_volts",       "CPU VDDIO",                       cpu_vddio),
+    G("mem_vdd_volts",         "DRAM VDD",                        mem_vdd),
+    G("mem_vddq_volts",        "DRAM VDDQ",                       mem_vddq),
+    G("mem_vpp_volts",         "DRAM VPP",                        mem_vpp),
+    G("fclk_mhz",              "Infinity Fabric clock",           fclk_mhz),
+    G("uclk_mhz",              "Memory controller clock",         uclk_mhz),
+    G("mclk_mhz",              "Memory clock",                    mclk_mhz),
+    G("cpu_temp_celsius",      "CPU temperature",                 cpu_temp_c),
+};
+#undef G
+
+/* Prometheus label values: backslash, quote and newline escaped.  Bounded
+ * by the field size — the segment is another process's memory. */
+#define put_label(f, field) put_label_n(f, field, sizeof(field))
+static void put_label_n(FILE *f, const char *s, size_t max)
+{
+    for (; max > 0 && *s; s++, max--) {
+        if (*s == '\\' || *s == '"') { fputc('\\', f); fputc(*s, f); }
+        else if (*s == '\n')         fputs("\\n", f);
+        else                         fputc(*s, f);
+    }
+}
+
+static void family(FILE *f, const char *name, const char *type, const char *help)
+{
+    fprintf(f, "# HELP tuxtimings_%s %s\n# TYPE tuxtimings_%s %s\n", name, help, name, type);
+}
+
+static void per_core(FILE *f, const char *name, const char *help,
+                     const float *v, int n, float scale)
+{
+    if (n <= 0) return;
+    if (n > MAX_CORES) n = MAX_CORES;
+    family(f, name, "gauge", help);
+    for (int i = 0; i < n; i++)
+        fprintf(f, "tuxtimings_%s{core=\"%d\"} %g\n", name, i, v[i] * scale);
+}
+
+static void render(FILE *f, const telemetry_snapshot_t *t, int up)
+{
+    family(f, "up", "gauge", "1 if a fresh snapshot was read from shared memory");
+    fprintf(f, "tuxtimings_up %d\n", up);
+    if (!t) return;
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    double age = (double)now.tv_sec + now.tv_nsec * 1e-9 - (double)t->t_unix_ms / 1000.0;
+
+    family(f, "samples_total", "counter", "Snapshots published by the sampler");
+    fprintf(f, "tuxtimings_samples_total %llu\n", (unsigned long long)t->samples);
+    family(f, "snapshot_age_seconds", "gauge", "Time since the snapshot was taken");
+    fprintf(f, "tuxtimings_snapshot_age_seconds %.3f\n", age);
+
+    const system_summary_t *s = &t->summary;
+    const smu_metrics_t    *m = &s->dyn.metrics;
+
+    family(f, "info", "gauge", "System identification");
+    fputs("tuxtimings_info{cpu=\"", f);       put_label(f, s->cpu.name);
+    fputs("\",codename=\"", f);               put_label(f, s->cpu.codename);
+    fputs("\",board=\"", f);                  put_label(f, s->board.motherboard);
+    fputs("\",bios=\"", f);                   put_label(f, s->board.bios_version);
+    fputs("\",agesa=\"", f);                  put_label(f, s->board.agesa_version);
+    fputs("\",smu=\"", f);                    put_label(f, s->cpu.smu_version);
+    fputs("\",pm_table=\"", f);               put_label(f, s->cpu.pm_table_version);
+    fputs("\"} 1\n", f);
+
+    for (size_t i = 0; i < sizeof(s_gauges) / sizeof(s_gauges[0]); i++) {
+        const gauge_t *g = &s_gauges[i];
+        family(f, g->name, "gauge", g->help);
+        fprintf(f, "tuxtimings_%s %g\n", g->name,
+                *(const float *)((const char *)m + g->offset));
+    }
+
+    family(f, "sensor_temp_celsius", "gauge", "CPU temperature sensors");
+    if (m->has_tdie)        fprintf(f, "tuxtimings_sensor_temp_celsius{sensor=\"tdie\"} %g\n", m->tdie_c);
+    if (m->has_tctl)        fprintf(f, "tuxtimings_sensor_temp_celsius{sensor=\"tctl\"} %g\n", m->tctl_c);
+    if (m->has_tccd1)       fprintf(f, "tuxtimings_sensor_temp_celsius{sensor=\"tccd1\"} %g\n", m->tccd1_c);
+    if (m->has_tccd2)       fprintf(f, "tuxtimings_sensor_temp_celsius{sensor=\"tccd2\"} %g\n", m->tccd2_c);
+    if (m->has_iod_hotspot) fprintf(f, "tuxtimings_sensor_temp_celsius{sensor=\"iod_hotspot\"} %g\n",
+                                    m->iod_hotspot_c);
+
+    per_core(f, "core_freq_mhz",   "Effective core clock", m->core_freq_mhz, m->core_freq_count, 1.0f);
+    per_core(f, "core_temp_celsius", "Core temperature",  m->core_temps_c,  m->core_temps_count, 1.0f);
+    per_core(f, "core_usage_ratio", "Core utilisation",   m->core_usage_pct, m->core_usage_count, 0.01f);
+    per_core(f, "core_voltage_volts", "Core voltage",     m->core_voltages, m->core_voltages_count, 1.0f);
+
+    if (m->spd_temps_count > 0) {
+        int n = m->spd_temps_count < MAX_MODULES ? m->spd_temps_count : MAX_MODULES;
+        family(f, "dimm_temp_celsius", "gauge", "DIMM SPD hub temperature");
+        for (int i = 0; i < n; i++) {
+            fputs("tuxtimings_dimm_temp_celsius{dimm=\"", f);
+            if (i < s->module_count) put_label(f, s->modules[i].slot_label);
+            fprintf(f, "\",index=\"%d\"} %g\n", i, m->spd_temps_c[i]);
+        }
+    }
+
+    if (s->dyn.fan_count > 0) {
+        int n = s->dyn.fan_count < MAX_FANS ? s->dyn.fan_count : MAX_FANS;
+        family(f, "fan_rpm", "gauge", "Fan speed");
+        for (int i = 0; i < n; i++) {
+            fputs("tuxtimings_fan_rpm{fan=\"", f);
+            put_label(f, s->dyn.fans[i].label);
+            fprintf(f, "\"} %d\n", s->dyn.fans[i].rpm);
+        }
+    }
+
+    /* DRAM configuration: rarely changes, but that is what an alert wants */
+    const dram_timings_t *d = &s->dram;
+    family(f, "memory_mts", "gauge", "Memory transfer rate");
+    fprintf(f, "tuxtimings_memory_mts %g\n", s->memory.frequency);
+
+    static const struct { const char *name; size_t off; } timings[] = {
+#define T(x) { #x, offsetof(dram_timings_t, x) }
+        T(tcl), T(trcd_rd), T(trcd_wr), T(trp), T(tras), T(trc),
+        T(trrds), T(trrdl), T(tfaw), T(twr), T(tcwl), T(rtp), T(wtrs), T(wtrl),
+        T(rdwr), T(wrrd), T(refi), T(rfc), T(rfc2), T(rfcsb),
+#undef T
+    };
+    family(f, "dram_timing_cycles", "gauge", "DRAM timing in memory clocks");
+    for (size_t i = 0; i < sizeof(timings) / sizeof(timings[0]); i++)
+        fprintf(f, "tuxtimings_dram_timing_cycles{timing=\"%s\"} %u\n", timings[i].name,
+                *(const uint32_t *)((const char *)d + timings[i].off));
+    family(f, "dram_timing_ns", "gauge", "DRAM refresh timings in nanoseconds");
+    fprintf(f, "tuxtimings_dram_timing_ns{timing=\"trefi\"} %g\n", d->trefi_ns);
+    fprintf(f, "tuxtimings_dram_timing_ns{timing=\"trfc\"} %g\n", d->trfc_ns);
+}
+
+/* Snapshot into buf (malloc'd, *len bytes); returns up */
+static int scrape(char **buf, size_t *len)
+{
+    telemetry_snapshot_t *t = malloc(sizeof(*t));
+    const telemetry_shm_t *shm = telemetry_attach();
+    int up = 0, have = 0;
+
+    if (t && shm && telemetry_read(shm, t) == 0) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        long long age_ms = (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000 - t->t_unix_ms;
+        int period = t->period_ms > 0 ? t->period_ms : 1000;
+        have = 1;
+        up   = age_ms < (long long)period * STALE_PERIODS;
+    }
+    telemetry_detach(shm);
+
+    FILE *f = open_memstream(buf, len);
+    if (f) {
+        render(f, have ? t : NULL, up);
+        fclose(f);
+    }
+    free(t);
+    return up;
+}
+
+/* ── HTTP ───────────────────────────────────────────────────────────── */
+
+static void send_all(int fd, const char *p, size_t n)
+{
+    while (n > 0) {
+        ssize_t w = send(fd, p, n, MSG_NOSIGNAL);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return;
+        p += w;
+        n -= (size_t)w;
+    }
+}
+
+static void respond(int fd, const char *status, const char *type, const char *body, size_t n)
+{
+    char head[256];
+    int  h = snprintf(head, sizeof(head),
+                      "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n"
+                      "Connection: close\r\n\r\n", status, type, n);
+    send_all(fd, head, (size_t)h);
+    send_all(fd, body, n);
+}
+
+static void serve(int fd)
+{
+    char   req[REQ_MAX];
+    size_t got = 0;
+
+    /* Only the request line matters; read until the header block ends */
+    while (got < sizeof(req) - 1) {
+        ssize_t r = recv(fd, req + got, sizeof(req) - 1 - got, 0);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) break;
+        got += (size_t)r;
+        req[got] = '\0';
+        if (strstr(req, "\r\n\r\n") || strstr(req, "\n\n")) break;
+    }
+    req[got] = '\0';
+
+    if (strncmp(req, "GET /metrics", 12) == 0 && (req[12] == ' ' || req[12] == '?')) {
+        char  *body = NULL;
+        size_t len  = 0;
+        scrape(&body, &len);
+        respond(fd, "200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                body ? body : "", body ? len : 0);
+        free(body);
+    } else if (strncmp(req, "GET / ", 6) == 0) {
+        static const char idx[] = "tuxtimings exporter — see /metrics\n";
+        respond(fd, "200 OK", "text/plain; charset=utf-8", idx, sizeof(idx) - 1);
+    } else {
+        static const char nf[] = "not found\n";
+        respond(fd, "404 Not Found", "text/plain", nf, sizeof(nf) - 1);
+    }
+}
+
+static int listen_on(const char *spec)
+{
+    char host[64];
+    const char *colon = strrchr(spec, ':');
+    if (!colon || (size_t)(colon - spec) >= sizeof(host)) return -1;
+    memcpy(host, spec, (size_t)(colon - spec));
+    host[colon - spec] = '\0';
+
+    struct sockaddr_in sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port   = htons((uint16_t)atoi(colon + 1));
+    if (host[0] == '\0' || strcmp(host, "*") == 0)
+        sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    else if (inet_pton(AF_INET, host, &sa.sin_addr) != 1)
+        return -1;
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ── Main ───────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv)
+{
+    const char *spec = DEFAULT_LISTEN;
+    int once = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--listen=", 9) == 0) spec = argv[i] + 9;
+        else if (strcmp(argv[i], "--once") == 0)   once = 1;
+        else {
+            fprintf(stderr, "usage: %s [--listen=ADDR:PORT] [--once]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (once) {
+        char  *body = NULL;
+        size_t len  = 0;
+        int    up   = scrape(&body, &len);
+        if (body) fwrite(body, 1, len, stdout);
+        free(body);
+        return up ? 0 : 1;
+    }
+
+    int lfd = listen_on(spec);
+    if (lfd < 0) {
+        fprintf(stderr, "tuxtimings-exporter: cannot listen on %s: %s\n", spec, strerror(errno));
+        return 1;
+    }
+    fprintf(stderr, "tuxtimings-exporter: serving http://%s/metrics\n", spec);
+
+    for (;;) {
+        int cfd = accept4(lfd, NULL, NULL, SOCK_CLOEXEC);
+        if (cfd < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            break;
+        }
+        /* A stalled client must not wedge the only thread */
+        struct timeval tv = { 2, 0 };
+        setsockopt(cfd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(cfd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        serve(cfd);
+        close(cfd);
+    }
+    close(lfd);
+    return 1;
+}
@@ -0,0 +1,366 @@
+/*
+ * headless.c — GTK-free telemetry capture
+ *
+ * PM-table fields are read fresh for every record (one pread + decode, so
+ * 100 Hz is cheap); the slow sources — hwmon temps, AOD memory voltages,
+ * /proc/stat usage — come from the background sampler's 1 Hz snapshot so a
+ * hwmon scan never stalls the record clock.
+ *
+ * Binary format (little-endian, packed):
+ *   header  "TUXTLM1\0"        char[8]
+ *           version            u32   (1)
+ *           field_count        u32
+ *           record_size        u32   (4 + 4 * field_count)
+ *           rate_hz            u32
+ *           start_unix_ms      u64
+ *           field descriptors  field_count × { char name[24]; char unit[8]; }
+ *   records t_ms               u32   (since start_unix_ms)
+ *           values             f32 × field_count
+ *
+ * CSV: one header line ("t_ms,<name>[unit],...") then one line per record.
+ */
+
+#define _GNU_SOURCE
+#include "headless.h"
+#include "backend.h"
+#include "sampler.h"
+#include "profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+
+#define HL_MAX_FIELDS  (32 + 3 * MAX_CORES)
+#define HL_NAME_LEN    24
+#define HL_UNIT_LEN    8
+#define HL_MAX_RATE    1000
+
+typedef struct {
+    char   name[HL_NAME_LEN];
+    char   unit[HL_UNIT_LEN];
+    size_t offset;      /* float inside smu_metrics_t */
+    float  scale;
+    int    pm;          /* 1 = per-record PM read, 0 = 1 Hz sampler snapshot */
+} hl_field_t;
+
+typedef struct {
+    const char *name, *unit;
+    size_t      offset;
+    int         pm;
+} hl_field_def_t;
+
+#define F(n, u, member, pm) { n, u, offsetof(smu_metrics_t, member), pm }
+static const hl_field_def_t s_scalar_fields[] = {
+    F("ppt",         "W",   ppt_w,             1),
+    F("pkg_power",   "W",   package_power_w,   1),
+    F("pkg_current", "A",   package_current_a, 1),
+    F("vcore",       "V",   vcore,             1),
+    F("vid",         "V",   vid,               1),
+    F("vsoc",        "V",   vsoc,              1),
+    F("vddp",        "V",   vddp,              1),
+    F("vddg_ccd",    "V",   vddg_ccd,          1),
+    F("vddg_iod",    "V",   vddg_iod,          1),
+    F("vdd_misc",    "V",   vdd_misc,          1),
+    F("fclk",        "MHz", fclk_mhz,          1),
+    F("uclk",        "MHz", uclk_mhz,          1),
+    F("mclk",        "MHz", mclk_mhz,          1),
+    F("core_clk",    "MHz", core_clock_mhz,    1),
+    F("cpu_temp",    "C",   cpu_temp_c,        1),
+    F("tctl",        "C",   tctl_c,            0),
+    F("tdie",        "C",   tdie_c,            0),
+    F("tccd1",       "C",   tccd1_c,           0),
+    F("tccd2",       "C",   tccd2_c,           0),
+    F("iod_hotspot", "C",   iod_hotspot_c,     0),
+    F("mem_vdd",     "V",   mem_vdd,           0),
+    F("mem_vddq",    "V",   mem_vddq,          0),
+    F("mem_vpp",     "V",   mem_vpp,           0),
+    F("cpu_vddio",   "V",   cpu_vddio,         0),
+};
+#undef F
+
+static volatile sig_atomic_t s_stop;
+
+static void on_stop_signal(int sig)
+{
+    (void)sig;
+    s_stop = 1;
+}
+
+/* ── Options ────────────────────────────────────────────────────────── */
+
+typedef struct {
+    int         rate_hz;
+    int         binary;
+    const char *output;
+    double      duration_s;
+    const char *fields;
+    int         per_core;
+} hl_opts_t;
+
+static const char *opt_value(const char *arg, const char *name)
+{
+    size_t n = strlen(name);
+    return (strncmp(arg, name, n) == 0 && arg[n] == '=') ? arg + n + 1 : NULL;
+}
+
+static int parse_opts(int argc, char **argv, hl_opts_t *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->rate_hz = 1;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i], *v;
+        if (strcmp(a, "--headless") == 0) continue;
+        if (strcmp(a, "--per-core") == 0) { o->per_core = 1; continue; }
+        if ((v = opt_value(a, "--rate")))     { o->rate_hz = atoi(v); continue; }
+        if ((v = opt_value(a, "--output")))   { o->output = v; continue; }
+        if ((v = opt_value(a, "--duration"))) { o->duration_s = strtod(v, NULL); continue; }
+        if ((v = opt_value(a, "--fields")))   { o->fields = v; continue; }
+        if ((v = opt_value(a, "--format"))) {
+            if (strcmp(v, "bin") == 0)      o->binary = 1;
+            else if (strcmp(v, "csv") != 0) {
+                fprintf(stderr, "TuxTimings: unknown format '%s' (csv|bin)\n", v);
+                return -1;
+            }
+            continue;
+        }
+        fprintf(stderr, "TuxTimings: unknown headless option '%s'\n", a);
+        return -1;
+    }
+    if (o->rate_hz < 1 || o->rate_hz > HL_MAX_RATE) {
+        fprintf(stderr, "TuxTimings: --rate must be 1..%d\n", HL_MAX_RATE);
+        return -1;
+    }
+    return 0;
+}
+
+/* Comma-separated list membership (NULL list = everything) */
+static int field_selected(const char *list, const char *name)
+{
+    if (!list) return 1;
+    size_t n = strlen(name);
+    for (const char *p = list; *p; ) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len == n && strncmp(p, name, n) == 0) return 1;
+        if (!end) break;
+        p = end + 1;
+    }
+    return 0;
+}
+
+static void add_field(hl_field_t *f, int *n, const char *name, const char *unit,
+                      size_t offset, float scale, int pm)
+{
+    if (*n >= HL_MAX_FIELDS) return;
+    hl_field_t *d = &f[(*n)++];
+    snprintf(d->name, sizeof(d->name), "%s", name);
+    snprintf(d->unit, sizeof(d->unit), "%s", unit);
+    d->offset = offset;
+    d->scale  = scale;
+    d->pm     = pm;
+}
+
+static int build_fields(const hl_opts_t *o, const smu_metrics_t *m, hl_field_t *f)
+{
+    int n = 0;
+    for (size_t i = 0; i < sizeof(s_scalar_fields) / sizeof(s_scalar_fields[0]); i++) {
+        const hl_field_def_t *d = &s_scalar_fields[i];
+        if (field_selected(o->fields, d->name))
+            add_field(f, &n, d->name, d->unit, d->offset, 1.0f, d->pm);
+    }
+    if (o->per_core) {
+        char name[HL_NAME_LEN];
+        for (int c = 0; c < m->core_clocks_count && c < MAX_CORES; c++) {
+            snprintf(name, sizeof(name), "core%d_clk", c);
+            if (field_selected(o->fields, name))
+                add_field(f, &n, name, "MHz", offsetof(smu_metrics_t, core_clocks_ghz) +
+                          (size_t)c * sizeof(float), 1000.0f, 1);
+        }
+        for (int c = 0; c < m->core_temps_count && c < MAX_CORES; c++) {
+            snprintf(name, sizeof(name), "core%d_temp", c);
+            if (field_selected(o->fields, name))
+                add_field(f, &n, name, "C", offsetof(smu_metrics_t, core_temps_c) +
+                          (size_t)c * sizeof(float), 1.0f, 0);
+        }
+        for (int c = 0; c < m->core_usage_count && c < MAX_CORES; c++) {
+            snprintf(name, sizeof(name), "core%d_usage", c);
+            if (field_selected(o->fields, name))
+                add_field(f, &n, name, "%", offsetof(smu_metrics_t, core_usage_pct) +
+                          (size_t)c * sizeof(float), 1.0f, 0);
+        }
+    }
+    return n;
+}
+
+static float field_value(const hl_field_t *f, const smu_metrics_t *m)
+{
+    float v;
+    memcpy(&v, (const char *)m + f->offset, sizeof(v));
+    return v * f->scale;
+}
+
+/* ── Writers ────────────────────────────────────────────────────────── */
+
+static void put_u32(FILE *fp, uint32_t v) { fwrite(&v, sizeof(v), 1, fp); }
+static void put_u64(FILE *fp, uint64_t v) { fwrite(&v, sizeof(v), 1, fp); }
+
+static void write_header(FILE *fp, const hl_opts_t *o, const hl_field_t *f, int n,
+                         uint64_t start_unix_ms)
+{
+    if (o->binary) {
+        static const char magic[8] = "TUXTLM1";
+        fwrite(magic, 1, sizeof(magic), fp);
+        put_u32(fp, 1);
+        put_u32(fp, (uint32_t)n);
+        put_u32(fp, (uint32_t)(4 + 4 * n));
+        put_u32(fp, (uint32_t)o->rate_hz);
+        put_u64(fp, start_unix_ms);
+        for (int i = 0; i < n; i++) {
+            char name[HL_NAME_LEN] = {0}, unit[HL_UNIT_LEN] = {0};
+            memcpy(name, f[i].name, strnlen(f[i].name, HL_NAME_LEN - 1));
+            memcpy(unit, f[i].unit, strnlen(f[i].unit, HL_UNIT_LEN - 1));
+            fwrite(name, 1, sizeof(name), fp);
+            fwrite(unit, 1, sizeof(unit), fp);
+        }
+    } else {
+        fputs("t_ms", fp);
+        for (int i = 0; i < n; i++)
+            fprintf(fp, ",%s[%s]", f[i].name, f[i].unit);
+        fputc('\n', fp);
+    }
+}
+
+static void write_record(FILE *fp, int binary, uint32_t t_ms, const float *vals, int n)
+{
+    if (binary) {
+        put_u32(fp, t_ms);
+        fwrite(vals, sizeof(float), (size_t)n, fp);
+    } else {
+        fprintf(fp, "%u", t_ms);
+        for (int i = 0; i < n; i++)
+            fprintf(fp, ",%.4g", (double)vals[i]);
+        fputc('\n', fp);
+    }
+}
+
+/* ── Run ────────────────────────────────────────────────────────────── */
+
+static long long mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void sleep_until_ns(long long t)
+{
+    struct timespec ts = { (time_t)(t / 1000000000LL), (long)(t % 1000000000LL) };
+    /* EINTR (SIGINT) falls through to the stop check in the caller */
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+int headless_requested(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+        if (strcmp(argv[i], "--headless") == 0) return 1;
+    return 0;
+}
+
+int headless_run(int argc, char **argv)
+{
+    hl_opts_t o;
+    if (parse_opts(argc, argv, &o) != 0) return 2;
+
+    /* No SA_RESTART: a signal must interrupt clock_nanosleep */
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    FILE *fp = stdout;
+    if (o.output && strcmp(o.output, "-") != 0) {
+        fp = fopen(o.output, o.binary ? "wb" : "w");
+        if (!fp) {
+            fprintf(stderr, "TuxTimings: cannot open %s: %s\n", o.output, strerror(errno));
+            return 1;
+        }
+    }
+    static char iobuf[64 * 1024];
+    setvbuf(fp, iobuf, _IOFBF, sizeof(iobuf));
+
+    /* Slow sources at 1 Hz on the sampler thread; wait for the first
+     * snapshot to learn the core counts */
+    if (sampler_start(1000, NULL, NULL) != 0) {
+        fprintf(stderr, "TuxTimings: failed to start sampler thread\n");
+        if (fp != stdout) fclose(fp);
+        return 1;
+    }
+    const system_summary_t *snap = NULL;
+    while (!s_stop && !(snap = sampler_acquire(NULL))) {
+        struct timespec ts = { 0, 10 * 1000000L };
+        nanosleep(&ts, NULL);
+    }
+
+    int status = 0;
+    if (snap) {
+        hl_field_t fields[HL_MAX_FIELDS];
+        int nfields = build_fields(&o, &snap->dyn.metrics, fields);
+        if (nfields == 0) {
+            fprintf(stderr, "TuxTimings: --fields matched no known field\n");
+            status = 2;
+            goto out;
+        }
+
+        struct timespec wall;
+        clock_gettime(CLOCK_REALTIME, &wall);
+        uint64_t start_unix_ms = (uint64_t)wall.tv_sec * 1000u + (uint64_t)(wall.tv_nsec / 1000000L);
+        write_header(fp, &o, fields, nfields, start_unix_ms);
+
+        const long long period = 1000000000LL / o.rate_hz;
+        const long long start  = mono_ns();
+        const long long end    = o.duration_s > 0 ? start + (long long)(o.duration_s * 1e9) : 0;
+        long long next = start;
+        float vals[HL_MAX_FIELDS];
+
+        while (!s_stop) {
+            long long now = mono_ns();
+            if (end && now >= end) break;
+
+            int is_new;
+            snap = sampler_acquire(&is_new);
+            smu_metrics_t pm;
+            backend_read_pm(&pm);
+            for (int i = 0; i < nfields; i++)
+                vals[i] = field_value(&fields[i], fields[i].pm ? &pm : &snap->dyn.metrics);
+            write_record(fp, o.binary, (uint32_t)((now - start) / 1000000LL), vals, nfields);
+
+            /* Flush once per slow snapshot — bounded loss if killed hard */
+            if (is_new) fflush(fp);
+
+            next += period;
+            if (next < now) next = now;     /* overran — resync, don't burst */
+            sleep_until_ns(next);
+        }
+    }
+
+out:
+    sampler_stop();
+    fflush(fp);
+    if (fp != stdout) fclose(fp);
+    if (profile_enabled()) {
+        char *rep = malloc(16 * 1024);
+        if (rep) {
+            profile_format(rep, 16 * 1024);
+            fputs(rep, stderr);
+            free(rep);
+        }
+    }
+    backend_cleanup();
+    return status;
+}
@@ -0,0 +1,19 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+/* Returns 1 if argv contains --headless. */
+int headless_requested(int argc, char **argv);
+
+/* Run the backend without GTK and stream telemetry records until SIGINT/
+ * SIGTERM or --duration expires. Returns the process exit status.
+ *
+ *   --rate=HZ        records per second (1..1000, default 1)
+ *   --format=csv|bin output format (default csv)
+ *   --output=PATH    output file (default stdout)
+ *   --duration=SEC   stop after SEC seconds (default: run until signalled)
+ *   --fields=a,b,... only these fields (names as in the CSV header)
+ *   --per-core       add per-core clock / temp / usage fields
+ */
+int headless_run(int argc, char **argv);
+
+#endif /* HEADLESS_H */
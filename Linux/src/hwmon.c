@@ -0,0 +1,384 @@
+/*
+ * hwmon.c — Cached hwmon discovery
+ *
+ * Walking /sys/class/hwmon (and every device's temp*_label) each tick is
+ * most of the refresh cost on boxes with GPUs, NVMe drives and NICs all
+ * registering hwmon devices. Instead the tree is walked once into resolved
+ * handles (one open fd per sensor, re-read with pread), and walked again only
+ * when a NETLINK_KOBJECT_UEVENT message reports a hwmon add/remove.
+ *
+ * Discovery preserves readdir order, so results match what the per-tick scan
+ * produced (first k10temp, later "Core N" labels overriding earlier ones, …).
+ */
+
+#include "hwmon.h"
+#include "sensor.h"
+#include "util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+
+#define HWMON_PATH "/sys/class/hwmon"
+
+/* See backend.c — all path buffers are 640 bytes */
+#pragma GCC diagnostic ignored "-Wformat-truncation"
+
+#define MAX_ZP_TEMPS    8
+#define MAX_SPD         8
+#define MAX_FAN_DEVS    4
+#define FAN_CHANNELS    7
+#define UEVENT_RCVBUF   (1 << 20)
+
+enum { ZP_TDIE, ZP_TCTL, ZP_TCCD1, ZP_TCCD2 };
+
+typedef struct { sensor_t s; int core; } core_temp_t;
+typedef struct { sensor_t s; int kind; } zp_temp_t;
+typedef struct { sensor_t s[FAN_CHANNELS]; } fan_dev_t;
+
+static struct {
+    int         discovered;
+    int         has_k10;
+    sensor_t    k10_tctl, k10_tccd1, k10_tccd2;
+    zp_temp_t   zp[MAX_ZP_TEMPS];
+    int         zp_count;
+    int         has_zp;
+    core_temp_t core[MAX_CORES];
+    int         core_count;
+    sensor_t    spd[MAX_SPD];
+    int         spd_count;
+    fan_dev_t   fan_dev[MAX_FAN_DEVS];
+    int         fan_dev_count;
+} s_hw;
+
+static int s_uevent_fd = -1;
+
+/* ── Helpers ────────────────────────────────────────────────────────── */
+
+static void str_lower(const char *in, char *out, size_t sz)
+{
+    size_t i = 0;
+    for (; in[i] && i < sz - 1; i++)
+        out[i] = (char)tolower((unsigned char)in[i]);
+    out[i] = '\0';
+}
+
+static int read_lower_name(const char *dir, char *out, size_t sz)
+{
+    char path[640], name[64];
+    snprintf(path, sizeof(path), "%s/name", dir);
+    if (!read_file_string(path, name, sizeof(name))) return 0;
+    str_lower(name, out, sz);
+    return 1;
+}
+
+/* Same rules as the old read_temp_input(): 0 or out of range = no reading */
+static float sensor_temp(sensor_t *s)
+{
+    int raw = sensor_read_int(s);
+    if (raw == 0) return -1.0f;
+    float c = raw / 1000.0f;
+    return (c >= 0.0f && c <= 150.0f) ? c : -1.0f;
+}
+
+static int open_attr(sensor_t *s, const char *dir, const char *fmt, int idx)
+{
+    char attr[64], path[640];
+    snprintf(attr, sizeof(attr), fmt, idx);
+    snprintf(path, sizeof(path), "%s/%s", dir, attr);
+    return sensor_open(s, path);
+}
+
+int hwmon_find_by_name(const char *match, char *buf, size_t sz)
+{
+    DIR *d = opendir(HWMON_PATH);
+    if (!d) return 0;
+    struct dirent *ent;
+    while ((ent = readdir(d))) {
+        if (ent->d_name[0] == '.') continue;
+        char dir[640], name[64];
+        snprintf(dir, sizeof(dir), HWMON_PATH "/%s", ent->d_name);
+        if (!read_lower_name(dir, name, sizeof(name))) continue;
+        if (strstr(name, match)) {
+            snprintf(buf, sz, "%s", dir);
+            closedir(d);
+            return 1;
+        }
+    }
+    closedir(d);
+    return 0;
+}
+
+/* ── Discovery ──────────────────────────────────────────────────────── */
+
+static void close_all(void)
+{
+    sensor_close(&s_hw.k10_tctl);
+    sensor_close(&s_hw.k10_tccd1);
+    sensor_close(&s_hw.k10_tccd2);
+    for (int i = 0; i < s_hw.zp_count; i++)   sensor_close(&s_hw.zp[i].s);
+    for (int i = 0; i < s_hw.core_count; i++) sensor_close(&s_hw.core[i].s);
+    for (int i = 0; i < s_hw.spd_count; i++)  sensor_close(&s_hw.spd[i]);
+    for (int d = 0; d < s_hw.fan_dev_count; d++)
+        for (int c = 0; c < FAN_CHANNELS; c++)
+            sensor_close(&s_hw.fan_dev[d].s[c]);
+    memset(&s_hw, 0, sizeof(s_hw));
+}
+
+/* temp*_label scan of one device: "Core N" labels, and zenpower's
+ * Tdie/Tctl/Tccd labels when zenpower is set */
+static void scan_labels(const char *dir, int zenpower)
+{
+    DIR *d = opendir(dir);
+    if (!d) return;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        if (strncmp(e->d_name, "temp", 4) != 0 || !strstr(e->d_name, "_label"))
+            continue;
+        int idx = 0;
+        if (sscanf(e->d_name, "temp%d_label", &idx) != 1) continue;
+        char lpath[640], label[64];
+        snprintf(lpath, sizeof(lpath), "%s/temp%d_label", dir, idx);
+        if (!read_file_string(lpath, label, sizeof(label))) continue;
+
+        if (strncmp(label, "Core ", 5) == 0 && s_hw.core_count < MAX_CORES) {
+            int core = atoi(label + 5);
+            core_temp_t *ct = &s_hw.core[s_hw.core_count];
+            if (core >= 0 && core < MAX_CORES && open_attr(&ct->s, dir, "temp%d_input", idx)) {
+                ct->core = core;
+                s_hw.core_count++;
+            }
+        }
+
+        if (zenpower && s_hw.zp_count < MAX_ZP_TEMPS) {
+            char lower[64];
+            str_lower(label, lower, sizeof(lower));
+            int kind = strstr(lower, "tdie")  ? ZP_TDIE  :
+                       strstr(lower, "tctl")  ? ZP_TCTL  :
+                       strstr(lower, "tccd1") ? ZP_TCCD1 :
+                       strstr(lower, "tccd2") ? ZP_TCCD2 : -1;
+            zp_temp_t *z = &s_hw.zp[s_hw.zp_count];
+            if (kind >= 0 && open_attr(&z->s, dir, "temp%d_input", idx)) {
+                z->kind = kind;
+                s_hw.zp_count++;
+            }
+        }
+    }
+    closedir(d);
+}
+
+static void discover(void)
+{
+    close_all();
+    s_hw.discovered = 1;
+
+    DIR *hw = opendir(HWMON_PATH);
+    if (!hw) return;
+
+    struct dirent *ent;
+    while ((ent = readdir(hw))) {
+        if (ent->d_name[0] == '.') continue;
+        char dir[640], name[64];
+        snprintf(dir, sizeof(dir), HWMON_PATH "/%s", ent->d_name);
+        if (!read_lower_name(dir, name, sizeof(name))) name[0] = '\0';
+
+        /* First k10temp wins; the zenpower fallback only matters without it */
+        int zenpower = 0;
+        if (!s_hw.has_k10 && strstr(name, "k10temp")) {
+            s_hw.has_k10 = 1;
+            open_attr(&s_hw.k10_tctl,  dir, "temp%d_input", 1);
+            open_attr(&s_hw.k10_tccd1, dir, "temp%d_input", 3);
+            open_attr(&s_hw.k10_tccd2, dir, "temp%d_input", 4);
+        } else if (!s_hw.has_zp && strstr(name, "zenpower")) {
+            s_hw.has_zp = 1;
+            zenpower = 1;
+        }
+
+        scan_labels(dir, zenpower);
+
+        /* DDR5 SPD hub, or JC-42.4 thermal sensor on DDR4 DIMMs */
+        if ((strstr(name, "spd5118") || strstr(name, "jc42")) &&
+            s_hw.spd_count < MAX_SPD) {
+            if (open_attr(&s_hw.spd[s_hw.spd_count], dir, "temp%d_input", 1))
+                s_hw.spd_count++;
+        }
+
+        if ((strncmp(name, "nct6", 4) == 0 || strstr(name, "nuvoton")) &&
+            s_hw.fan_dev_count < MAX_FAN_DEVS) {
+            fan_dev_t *fd = &s_hw.fan_dev[s_hw.fan_dev_count++];
+            for (int c = 0; c < FAN_CHANNELS; c++)
+                open_attr(&fd->s[c], dir, "fan%d_input", c + 1);
+        }
+    }
+    closedir(hw);
+}
+
+/* ── Hotplug ────────────────────────────────────────────────────────── */
+
+static void uevent_open(void)
+{
+    if (s_uevent_fd >= 0) return;
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) return;
+    /* A module load (msr: one device per CPU) is a burst of uevents; room
+     * for it keeps the hwmon add from being dropped.  FORCE needs
+     * CAP_NET_ADMIN, plain SO_RCVBUF is capped at rmem_max. */
+    int rcvbuf = UEVENT_RCVBUF;
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) != 0)
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct sockaddr_nl sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.nl_family = AF_NETLINK;
+    sa.nl_groups = 1;   /* kernel uevent multicast group */
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0) {
+        close(fd);
+        return;
+    }
+    s_uevent_fd = fd;
+}
+
+/* Drain pending uevents; 1 if any was for the hwmon subsystem, or if the
+ * socket overflowed (ENOBUFS) and some were lost */
+static int uevent_hwmon_changed(void)
+{
+    if (s_uevent_fd < 0) return 0;
+    int changed = 0;
+    char buf[4096];
+    for (;;) {
+        ssize_t n = recv(s_uevent_fd, buf, sizeof(buf) - 1, 0);
+        if (n < 0) {
+            if (errno == ENOBUFS) { changed = 1; continue; }
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (n == 0) break;
+        buf[n] = '\0';
+        /* "action@devpath\0KEY=VALUE\0..." */
+        for (char *p = buf; p < buf + n; p += strlen(p) + 1) {
+            if (strcmp(p, "SUBSYSTEM=hwmon") == 0) { changed = 1; break; }
+        }
+    }
+    return changed;
+}
+
+void hwmon_refresh(void)
+{
+    if (!s_hw.discovered) {
+        /* Socket first so nothing between discovery and bind is missed */
+        uevent_open();
+        discover();
+        return;
+    }
+    if (uevent_hwmon_changed())
+        discover();
+}
+
+void hwmon_close(void)
+{
+    close_all();
+    if (s_uevent_fd >= 0) {
+        close(s_uevent_fd);
+        s_uevent_fd = -1;
+    }
+}
+
+/* ── Readers ────────────────────────────────────────────────────────── */
+
+static void apply_core_temps(smu_metrics_t *m)
+{
+    for (int i = 0; i < s_hw.core_count; i++) {
+        float c = sensor_temp(&s_hw.core[i].s);
+        if (c < 0) continue;
+        int core = s_hw.core[i].core;
+        m->core_temps_c[core] = c;
+        if (core >= m->core_temps_count)
+            m->core_temps_count = core + 1;
+    }
+}
+
+static void apply_k10temp_tctl_tccd(smu_metrics_t *m)
+{
+    if (s_hw.has_k10) {
+        float tctl  = sensor_temp(&s_hw.k10_tctl);
+        float tccd1 = sensor_temp(&s_hw.k10_tccd1);
+        float tccd2 = sensor_temp(&s_hw.k10_tccd2);
+        if (tctl >= 0)  { m->tctl_c = tctl;   m->has_tctl = true; }
+        if (tccd1 >= 0) { m->tccd1_c = tccd1; m->has_tccd1 = true; }
+        if (tccd2 >= 0) { m->tccd2_c = tccd2; m->has_tccd2 = true; }
+
+        /* Derive Tdie from Tctl if PM table didn't provide it */
+        if (!m->has_tdie && m->has_tctl) {
+            m->tdie_c = m->tctl_c;
+            m->has_tdie = true;
+        }
+        return;
+    }
+
+    /* Fallback: zenpower Tdie/Tctl/Tccd1 from labels */
+    if (!s_hw.has_zp) return;
+    for (int i = 0; i < s_hw.zp_count; i++) {
+        float c = sensor_temp(&s_hw.zp[i].s);
+        if (c < 0) continue;
+        switch (s_hw.zp[i].kind) {
+        case ZP_TDIE:  m->tdie_c = c;  m->has_tdie = true;  break;
+        case ZP_TCTL:  m->tctl_c = c;  m->has_tctl = true;  break;
+        case ZP_TCCD1: m->tccd1_c = c; m->has_tccd1 = true; break;
+        case ZP_TCCD2: m->tccd2_c = c; m->has_tccd2 = true; break;
+        }
+    }
+
+    if (!m->has_tdie && m->has_tctl) {
+        m->tdie_c = m->tctl_c;
+        m->has_tdie = true;
+    }
+    if (!m->has_tdie && m->cpu_temp_c > 0) {
+        m->tdie_c = m->cpu_temp_c;
+        m->has_tdie = true;
+    }
+}
+
+static void read_spd_temps(smu_metrics_t *m)
+{
+    m->spd_temps_count = 0;
+    for (int i = 0; i < s_hw.spd_count && m->spd_temps_count < MAX_MODULES; i++) {
+        int raw = sensor_read_int(&s_hw.spd[i]);
+        if (raw == 0) continue;
+        float c = raw / 1000.0f;
+        if (c >= 0.0f && c <= 150.0f)
+            m->spd_temps_c[m->spd_temps_count++] = c;
+    }
+}
+
+void hwmon_apply_temps(smu_metrics_t *m)
+{
+    apply_core_temps(m);
+    apply_k10temp_tctl_tccd(m);
+    read_spd_temps(m);
+}
+
+void hwmon_read_fans(fan_reading_t *fans, int *count)
+{
+    *count = 0;
+    /* First Nuvoton device with a spinning fan wins */
+    for (int d = 0; d < s_hw.fan_dev_count; d++) {
+        int found_any = 0;
+        for (int i = 1; i <= FAN_CHANNELS && *count < MAX_FANS; i++) {
+            int rpm = sensor_read_int(&s_hw.fan_dev[d].s[i - 1]);
+            if (rpm <= 0) continue;
+            fan_reading_t *fan = &fans[(*count)++];
+            if (i == 7)
+                snprintf(fan->label, sizeof(fan->label), "Pump");
+            else
+                snprintf(fan->label, sizeof(fan->label), "Fan%d", i);
+            fan->rpm = rpm;
+            found_any = 1;
+        }
+        if (found_any) break;
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef HWMON_H
+#define HWMON_H
+
+#include "types.h"
+#include <stddef.h>
+
+/* Find a hwmon directory whose name contains match (lowercase).
+ * Writes /sys/class/hwmon/hwmonN to buf. Returns 1 if found. */
+int  hwmon_find_by_name(const char *match, char *buf, size_t sz);
+
+/* Discovery is done once (on first use) and cached as open per-sensor
+ * handles. Call once per tick: drains kernel hwmon uevents and re-runs
+ * discovery only if a hwmon device was added or removed. */
+void hwmon_refresh(void);
+
+/* Overlay per-core "Core N" temps, k10temp/zenpower Tctl/Tdie/Tccd and
+ * SPD5118/jc42 DIMM temps onto m. */
+void hwmon_apply_temps(smu_metrics_t *m);
+
+/* Nuvoton nct6xxx fan speeds (fan7 = "Pump"). */
+void hwmon_read_fans(fan_reading_t *fans, int *count);
+
+/* Close every cached handle and the uevent socket. */
+void hwmon_close(void);
+
+#endif /* HWMON_H */
@@ -1,5 +1,10 @@
 #include "ui.h"
 #include "backend.h"
+#include "sampler.h"
+#include "headless.h"
+#include "pm_analyze.h"
+#include "telemetry.h"
+#include "profile.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -10,6 +15,7 @@
 static void on_signal(int sig)
 {
     (void)sig;
+    telemetry_close();
     backend_cleanup();
     _exit(0);
 }
@@ -44,6 +50,20 @@ static int restore_env(int *argc, char ***argv)
     return 0;
 }
 
+/* Remove flag from argv; 1 if it was there.  Done after elevation so
+ * pkexec still forwards it, and before GTK sees an option it rejects. */
+static int take_flag(int *argc, char **argv, const char *flag)
+{
+    int found = 0, n = 0;
+    for (int i = 0; i < *argc; i++) {
+        if (i > 0 && strcmp(argv[i], flag) == 0) { found = 1; continue; }
+        argv[n++] = argv[i];
+    }
+    if (found) argv[n] = NULL;
+    *argc = n;
+    return found;
+}
+
 /* ── Elevate to root via pkexec if not already root ─────────────────── */
 
 static void elevate_if_necessary(int argc, char **argv)
@@ -134,9 +154,35 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    /* --shm: publish every sampler snapshot for external collectors */
+    if (take_flag(&argc, argv, "--shm") && telemetry_open(1000) != 0)
+        fprintf(stderr, "TuxTimings: shared-memory export disabled\n");
+
+    /* --profile: time every refresh stage; report in the Profile window,
+     * or on stderr at the end of a --headless run */
+    if (take_flag(&argc, argv, "--profile"))
+        profile_enable();
+
+    /* --pm-analyze: rank PM table entries across an idle → load step */
+    if (pm_analyze_requested(argc, argv)) {
+        int rc = pm_analyze_run(argc, argv);
+        telemetry_close();
+        return rc;
+    }
+
+    /* --headless: stream telemetry without GTK */
+    if (headless_requested(argc, argv)) {
+        int rc = headless_run(argc, argv);
+        telemetry_close();
+        return rc;
+    }
+
     GtkApplication *app = ui_create(argc, argv);
     int status = g_application_run(G_APPLICATION(app), argc, argv);
     g_object_unref(app);
+    sampler_stop();
+    telemetry_close();
+    bench_ctx_release();
     backend_cleanup();
     return status;
 }
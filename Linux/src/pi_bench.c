@@ -7,12 +7,23 @@
  *   large-integer multiplications, making it O(M(n) log(n)^2) overall
  *   where M(n) is the cost of an n-digit multiplication.
  *
- * Parallelisation: work queue with M = nthreads × 16 tasks.
- *   Each thread pulls tasks from the queue and processes them one at a time.
- *   Progress is updated after each completed task, giving smooth reporting
- *   throughout the run rather than a single jump at the end.
- *   After all threads finish, the coordinator merges the M task results in
- *   order and computes the final sqrt and division serially.
+ * Parallelisation: work-stealing fork/join over the binary-splitting tree.
+ *   bs_par() forks the right half of [a,b) as a task and recurses into the
+ *   left half itself; below a size cutoff the serial bs() takes over.  A
+ *   node merges as soon as both of its children are done, so subtrees
+ *   overlap instead of waiting for a whole level, and a thread waiting on
+ *   a join runs other tasks meanwhile.  Near the root, where a level has
+ *   only a handful of nodes, the four products of each merge run as tasks
+ *   as well, and sqrt(10005) is computed alongside the series.  Only the
+ *   final mpf_div is serial.
+ *
+ * Memory: a child's P,Q,T are merged into its parent and freed as soon as
+ *   both halves are done, so only the nodes on the active paths are live;
+ *   the root P is never formed, and Q,T are released as soon as they have
+ *   been converted for the division.  Small temporaries are recycled
+ *   through a per-thread cache instead of going back to malloc.  Peak
+ *   memory is roughly PI_BYTES_PER_DIGIT × digits, which is checked
+ *   against MemAvailable before starting.
  *
  * Requires: libgmp (-lgmp)
  */
@@ -22,8 +33,11 @@
 #include <gmp.h>
 #include <pthread.h>
 #include <stdatomic.h>
+#include <stdio.h>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sched.h>
 #include <unistd.h>
 
 /* 640320^3 / 24 — fits in 64-bit unsigned long on x86-64 */
@@ -36,6 +50,62 @@ static long terms_needed(int digits)
     return (long)(digits / 14.0) + 16;
 }
 
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Phase time summed over threads, in ns (leaves and products never nest) */
+static _Atomic long long s_split_ns, s_merge_ns;
+
+static void phase_add(_Atomic long long *acc, double t0)
+{
+    atomic_fetch_add_explicit(acc, (long long)((now_sec() - t0) * 1e9),
+                              memory_order_relaxed);
+}
+
+/* ── Temporary cache ──────────────────────────────────────────────────── */
+
+/*
+ * Every bs() node needs four temporaries, and the leaves run millions of
+ * times; recycling them through a small per-thread cache keeps their limb
+ * storage allocated instead of round-tripping through malloc on each node.
+ * Only small values are kept so the cache never pins the big top-level
+ * buffers — those are freed immediately.
+ */
+#define TMP_CACHE       32
+#define TMP_CACHE_LIMBS 8192    /* 64 KB */
+
+static __thread __mpz_struct tl_tmp[TMP_CACHE];
+static __thread int          tl_ntmp;
+
+static void tmp_get(mpz_t z)
+{
+    if (tl_ntmp > 0) {
+        z[0] = tl_tmp[--tl_ntmp];
+        mpz_set_ui(z, 0);
+    } else {
+        mpz_init(z);
+    }
+}
+
+static void tmp_put(mpz_t z)
+{
+    if (tl_ntmp < TMP_CACHE && z->_mp_alloc <= TMP_CACHE_LIMBS)
+        tl_tmp[tl_ntmp++] = z[0];
+    else
+        mpz_clear(z);
+}
+
+/* Free this thread's cache; call before the thread exits */
+static void tmp_drain(void)
+{
+    while (tl_ntmp > 0)
+        mpz_clear(&tl_tmp[--tl_ntmp]);
+}
+
 /* ── Serial binary splitting ──────────────────────────────────────────── */
 
 /*
@@ -79,269 +149,486 @@ static void bs(mpz_t P, mpz_t Q, mpz_t T, long a, long b)
 
     long m = (a + b) / 2;
     mpz_t Pm, Qm, Tm;
-    mpz_inits(Pm, Qm, Tm, NULL);
+    tmp_get(Pm); tmp_get(Qm); tmp_get(Tm);
 
     bs(P, Q, T, a, m);
     bs(Pm, Qm, Tm, m, b);
 
     /* T = T*Qm + P*Tm */
     mpz_t tmp;
-    mpz_init(tmp);
+    tmp_get(tmp);
     mpz_mul(T, T, Qm);
     mpz_mul(tmp, P, Tm);
     mpz_add(T, T, tmp);
-    mpz_clear(tmp);
+    tmp_put(tmp);
 
     /* P = P * Pm,  Q = Q * Qm */
     mpz_mul(P, P, Pm);
     mpz_mul(Q, Q, Qm);
 
-    mpz_clears(Pm, Qm, Tm, NULL);
+    tmp_put(Pm); tmp_put(Qm); tmp_put(Tm);
+}
+
+/* ── Work-stealing scheduler ──────────────────────────────────────────── */
+
+/*
+ * One deque per thread: the owner pushes and pops at the tail (LIFO, so a
+ * join usually finds its own task still there and runs it inline), thieves
+ * take from the head — the oldest, i.e. biggest, subtree.  Tasks here are
+ * coarse (a GMP product or a whole subtree), so a mutex per deque costs
+ * nothing measurable and keeps this simple.
+ *
+ * Tasks live in the forking frame, which cannot return before its join.
+ */
+#define WS_DEQUE_CAP  256    /* outstanding forks per thread; beyond, run inline */
+#define WS_MAX_THREADS 64
+
+typedef struct {
+    void      (*fn)(void *arg);
+    void       *arg;
+    _Atomic int done;
+} ws_task_t;
+
+typedef struct {
+    pthread_mutex_t lock;
+    ws_task_t      *slot[WS_DEQUE_CAP];
+    long            head, tail;     /* steal at head, push/pop at tail */
+} ws_deque_t;
+
+typedef struct {
+    int         nthreads;           /* deques; thread 0 is the caller  */
+    ws_deque_t  dq[WS_MAX_THREADS];
+    _Atomic int shutdown;
+    long        cutoff;             /* terms per serial leaf           */
+    bench_token_t *tok;             /* cancel / progress, may be NULL  */
+} ws_pool_t;
+
+static __thread int tl_ws_id;
+
+static int ws_push(ws_pool_t *pool, ws_task_t *t)
+{
+    ws_deque_t *d = &pool->dq[tl_ws_id];
+    int ok = 0;
+
+    atomic_init(&t->done, 0);
+    pthread_mutex_lock(&d->lock);
+    if (d->tail - d->head < WS_DEQUE_CAP) {
+        d->slot[d->tail++ % WS_DEQUE_CAP] = t;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->lock);
+    return ok;
 }
 
-/* ── Segment merge ────────────────────────────────────────────────────── */
+static ws_task_t *ws_take(ws_deque_t *d, int own)
+{
+    ws_task_t *t = NULL;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->tail > d->head)
+        t = own ? d->slot[--d->tail % WS_DEQUE_CAP]
+                : d->slot[d->head++ % WS_DEQUE_CAP];
+    pthread_mutex_unlock(&d->lock);
+    return t;
+}
 
-static void bs_merge(mpz_t P1, mpz_t Q1, mpz_t T1,
-                     const mpz_t P2, const mpz_t Q2, const mpz_t T2)
+/* Own deque first, then the others round-robin from our right neighbour */
+static ws_task_t *ws_find(ws_pool_t *pool)
 {
-    mpz_t tmp;
-    mpz_init(tmp);
-    /* T1 = T1*Q2 + P1*T2 */
-    mpz_mul(T1, T1, Q2);
-    mpz_mul(tmp, P1, T2);
-    mpz_add(T1, T1, tmp);
-    /* P1 = P1*P2,  Q1 = Q1*Q2 */
-    mpz_mul(P1, P1, P2);
-    mpz_mul(Q1, Q1, Q2);
-    mpz_clear(tmp);
+    ws_task_t *t = ws_take(&pool->dq[tl_ws_id], 1);
+
+    for (int i = 1; !t && i < pool->nthreads; i++)
+        t = ws_take(&pool->dq[(tl_ws_id + i) % pool->nthreads], 0);
+    return t;
 }
 
-/* ── Work queue ───────────────────────────────────────────────────────── */
+static void ws_run(ws_task_t *t)
+{
+    t->fn(t->arg);
+    atomic_store_explicit(&t->done, 1, memory_order_release);
+}
+
+/* Wait for t, running whatever work is available in the meantime */
+static void ws_join(ws_pool_t *pool, ws_task_t *t)
+{
+    while (!atomic_load_explicit(&t->done, memory_order_acquire)) {
+        ws_task_t *o = ws_find(pool);
+        if (o) ws_run(o);
+        else   sched_yield();
+    }
+}
+
+/* Fork fn(arg) into t, or run it right away if the deque is full */
+static void ws_fork(ws_pool_t *pool, ws_task_t *t, void (*fn)(void *), void *arg)
+{
+    t->fn  = fn;
+    t->arg = arg;
+    if (!ws_push(pool, t))
+        ws_run(t);
+}
 
 typedef struct {
-    long  a, b;
-    mpz_t P, Q, T;
-} bs_task_t;
+    ws_pool_t *pool;
+    int        id;
+} ws_worker_arg_t;
+
+static void *ws_worker(void *varg)
+{
+    ws_worker_arg_t *wa = varg;
+    ws_pool_t *pool = wa->pool;
+    int idle = 0;
+
+    tl_ws_id = wa->id;
+    while (!atomic_load(&pool->shutdown)) {
+        ws_task_t *t = ws_find(pool);
+        if (t) {
+            ws_run(t);
+            idle = 0;
+        } else if (++idle < 64) {
+            sched_yield();
+        } else {
+            /* nothing to steal for a while: back off so a serial phase
+             * does not share its core with spinning thieves */
+            struct timespec ts = { 0, 50000 };
+            nanosleep(&ts, NULL);
+        }
+    }
+    tmp_drain();
+    return NULL;
+}
+
+/* ── Parallel binary splitting ────────────────────────────────────────── */
+
+/* Merge products run as tasks once the operands reach this many limbs */
+#define PAR_MUL_LIMBS 4096
 
 typedef struct {
-    bs_task_t  *tasks;
-    int         M;           /* total number of tasks      */
-    long        N;           /* total Chudnovsky terms     */
-    _Atomic int next_task;   /* index of next unclaimed task */
-} bs_queue_t;
+    mpz_ptr       dst;
+    mpz_srcptr    a, b;
+} mul_job_t;
 
-static void *bs_queue_worker(void *arg)
+static void mul_task(void *arg)
 {
-    bs_queue_t *q = arg;
-    int t;
+    mul_job_t *j = arg;
+    double t0 = now_sec();
+    mpz_mul(j->dst, j->a, j->b);
+    phase_add(&s_merge_ns, t0);
+}
 
-    while ((t = atomic_fetch_add(&q->next_task, 1)) < q->M) {
-        bs_task_t *task = &q->tasks[t];
-        task->a = (long)t       * q->N / q->M;
-        task->b = (long)(t + 1) * q->N / q->M;
-        if (task->b > q->N) task->b = q->N;
+/*
+ * (P,Q,T) = merge((P,Q,T), (Pm,Qm,Tm)):
+ *   T = T×Qm + P×Tm,  P = P×Pm (only if need_p),  Q = Q×Qm
+ * The products read only the old values, so with P×Pm written to a
+ * temporary all of them are independent.
+ */
+static void bs_combine(ws_pool_t *pool, mpz_t P, mpz_t Q, mpz_t T,
+                       mpz_t Pm, mpz_t Qm, mpz_t Tm, int need_p)
+{
+    mpz_t tmp;
+    tmp_get(tmp);
+
+    if (mpz_size(Q) + mpz_size(Qm) < PAR_MUL_LIMBS) {
+        double t0 = now_sec();
+        mpz_mul(T, T, Qm);
+        mpz_mul(tmp, P, Tm);
+        mpz_add(T, T, tmp);
+        if (need_p) mpz_mul(P, P, Pm);
+        mpz_mul(Q, Q, Qm);
+        phase_add(&s_merge_ns, t0);
+        tmp_put(tmp);
+        return;
+    }
 
-        bs(task->P, task->Q, task->T, task->a, task->b);
+    mpz_t P2;
+    mpz_init(P2);
+    mul_job_t jt = { T,   T, Qm };
+    mul_job_t jp = { tmp, P, Tm };
+    mul_job_t jq = { P2,  P, Pm };
+    ws_task_t tt, tp, tq;
+
+    ws_fork(pool, &tt, mul_task, &jt);
+    ws_fork(pool, &tp, mul_task, &jp);
+    if (need_p) ws_fork(pool, &tq, mul_task, &jq);
+    double t0 = now_sec();
+    mpz_mul(Q, Q, Qm);
+    phase_add(&s_merge_ns, t0);
+    if (need_p) ws_join(pool, &tq);
+    ws_join(pool, &tp);
+    ws_join(pool, &tt);
+
+    mpz_add(T, T, tmp);
+    if (need_p) mpz_swap(P, P2);
+    mpz_clear(tmp);
+    mpz_clear(P2);
+}
+
+typedef struct {
+    ws_pool_t *pool;
+    mpz_ptr    P, Q, T;
+    long       a, b;
+    int        need_p;
+} bs_job_t;
+
+static void bs_par(ws_pool_t *pool, mpz_t P, mpz_t Q, mpz_t T,
+                   long a, long b, int need_p);
+
+static void bs_task(void *arg)
+{
+    bs_job_t *j = arg;
+    bs_par(j->pool, j->P, j->Q, j->T, j->a, j->b, j->need_p);
+}
+
+/*
+ * need_p: whether the caller uses P(a,b).  The root's P is never used, nor
+ * is that of any right child below a node that does not need its own —
+ * which skips the largest product of the whole computation.
+ */
+/*
+ * Progress counts terms: b - a for a leaf and again for every merge above
+ * it, so the work near the root — far bigger per merge — is not lost in
+ * the leaf count.  bs_units() sizes the same tree up front.
+ */
+static long bs_units(long cutoff, long a, long b)
+{
+    if (b - a <= cutoff) return b - a;
+    long m = (a + b) / 2;
+    return (b - a) + bs_units(cutoff, a, m) + bs_units(cutoff, m, b);
+}
+
+/* A cancelled run stops forking and merging; P,Q,T are left as garbage */
+static void bs_par(ws_pool_t *pool, mpz_t P, mpz_t Q, mpz_t T,
+                   long a, long b, int need_p)
+{
+    if (bench_token_cancelled(pool->tok))
+        return;
+    if (b - a <= pool->cutoff) {
+        double t0 = now_sec();
+        bs(P, Q, T, a, b);
+        phase_add(&s_split_ns, t0);
+        bench_token_advance(pool->tok, b - a);
+        return;
     }
-    return NULL;
+
+    long m = (a + b) / 2;
+    mpz_t Pm, Qm, Tm;
+    tmp_get(Pm); tmp_get(Qm); tmp_get(Tm);
+
+    bs_job_t  rj = { pool, Pm, Qm, Tm, m, b, need_p };
+    ws_task_t rt;
+    ws_fork(pool, &rt, bs_task, &rj);
+    bs_par(pool, P, Q, T, a, m, 1);      /* left P always feeds T */
+    ws_join(pool, &rt);
+
+    if (!bench_token_cancelled(pool->tok)) {
+        bs_combine(pool, P, Q, T, Pm, Qm, Tm, need_p);
+        bench_token_advance(pool->tok, b - a);
+    }
+    tmp_put(Pm); tmp_put(Qm); tmp_put(Tm);
 }
 
-/* ── Parallel merge (tree reduction) ─────────────────────────────────── */
+/* ── Final division ───────────────────────────────────────────────────── */
+
+typedef struct {
+    mpf_ptr    dst;
+    mpz_srcptr src;
+} mpf_job_t;
 
 typedef struct {
-    bs_task_t          *tasks;
-    _Atomic int         next_pair;
-    int                 M;          /* current number of valid tasks */
-    int                 shutdown;
-    pthread_barrier_t  *bar_start;
-    pthread_barrier_t  *bar_end;
-} merge_ctx_t;
-
-static void merge_pair(bs_task_t *dst, bs_task_t *a, bs_task_t *b)
+    mpf_ptr s;
+    double  sec;
+} sqrt_job_t;
+
+/* 426880 × sqrt(10005) */
+static void sqrt_task(void *arg)
 {
-    (void)a;
-    /* dst = merge(dst,b). We keep all mpz_t initialized; do not clear here. */
-    bs_merge(dst->P, dst->Q, dst->T, b->P, b->Q, b->T);
-    mpz_set_ui(b->P, 0);
-    mpz_set_ui(b->Q, 0);
-    mpz_set_ui(b->T, 0);
+    sqrt_job_t *j = arg;
+    double t0 = now_sec();
+    mpf_set_ui(j->s, 10005);
+    mpf_sqrt(j->s, j->s);
+    mpf_mul_ui(j->s, j->s, 426880);
+    j->sec = now_sec() - t0;
 }
 
-static void *merge_worker(void *arg)
+static void set_z_task(void *arg)
 {
-    merge_ctx_t *ctx = arg;
-    for (;;) {
-        pthread_barrier_wait(ctx->bar_start);
-        if (ctx->shutdown || ctx->M <= 1) {
-            pthread_barrier_wait(ctx->bar_end);
+    mpf_job_t *j = arg;
+    mpf_set_z(j->dst, j->src);
+}
+
+/* ── Memory accounting ────────────────────────────────────────────────── */
+
+/* MemAvailable from /proc/meminfo in kB, 0 if unknown */
+static unsigned long mem_available_kb(void)
+{
+    FILE *f = fopen("/proc/meminfo", "r");
+    char line[128];
+    unsigned long kb = 0;
+
+    if (!f) return 0;
+    while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "MemAvailable: %lu kB", &kb) == 1)
             break;
-        }
+    fclose(f);
+    return kb;
+}
 
-        int pairs = ctx->M / 2;
-        int i;
-        while ((i = atomic_fetch_add(&ctx->next_pair, 1)) < pairs) {
-            int left  = 2 * i;
-            int right = left + 1;
-            merge_pair(&ctx->tasks[left], &ctx->tasks[left], &ctx->tasks[right]);
-        }
+/* VmHWM (peak RSS) from /proc/self/status in kB, 0 if unknown */
+static unsigned long peak_rss_kb(void)
+{
+    FILE *f = fopen("/proc/self/status", "r");
+    char line[128];
+    unsigned long kb = 0;
+
+    if (!f) return 0;
+    while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "VmHWM: %lu kB", &kb) == 1)
+            break;
+    fclose(f);
+    return kb;
+}
 
-        pthread_barrier_wait(ctx->bar_end);
+/*
+ * Reset VmHWM to the current RSS so the peak reflects this run rather than
+ * an earlier bandwidth test.  "5" in clear_refs does exactly that (4.0+);
+ * on failure the reported peak is the process lifetime peak.
+ */
+static void peak_rss_reset(void)
+{
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    if (f) {
+        fputs("5", f);
+        fclose(f);
     }
-    return NULL;
 }
 
 /* ── Public entry point ───────────────────────────────────────────────── */
 
-void pi_bench_run(int n_digits, pi_results_t *out)
+int pi_bench_run(int n_digits, pi_results_t *out, bench_token_t *tok)
 {
-    struct timespec t0, t1;
     long N = terms_needed(n_digits);
 
     int nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
     if (nthreads < 1)  nthreads = 1;
-    if (nthreads > 64) nthreads = 64;
-
-    /*
-     * 16 tasks per thread: each thread processes tasks one at a time from the
-     * queue, so tasks complete continuously and progress stays smooth.
-     * More tasks = smoother progress but more overhead in the merge phase.
-     */
-    int M = nthreads * 16;
-    if (M > (int)N) M = (int)N;
+    if (nthreads > WS_MAX_THREADS) nthreads = WS_MAX_THREADS;
 
     /* GMP floating-point precision: log2(10) ≈ 3.322 bits per decimal digit */
     mp_bitcnt_t prec = (mp_bitcnt_t)((double)n_digits * 3.322 + 128);
 
-    out->n_digits = n_digits;
+    memset(out, 0, sizeof(*out));
+    out->n_digits    = n_digits;
+    out->need_kb     = (unsigned long)((double)n_digits * PI_BYTES_PER_DIGIT / 1024);
+    out->mem_avail_kb = mem_available_kb();
+    if (out->mem_avail_kb && out->need_kb > out->mem_avail_kb)
+        return -1;
 
-    clock_gettime(CLOCK_MONOTONIC, &t0);
-
-    bs_task_t *tasks = calloc((size_t)M, sizeof(bs_task_t));
-    pthread_t *tids  = calloc((size_t)nthreads, sizeof(pthread_t));
-    if (!tasks || !tids) { free(tasks); free(tids); return; }
-
-    /* Initialize GMP integers once (safe for swaps/sets in parallel merge). */
-    for (int i = 0; i < M; i++) {
-        mpz_inits(tasks[i].P, tasks[i].Q, tasks[i].T, NULL);
-        mpz_set_ui(tasks[i].P, 0);
-        mpz_set_ui(tasks[i].Q, 0);
-        mpz_set_ui(tasks[i].T, 0);
-    }
-
-    bs_queue_t q;
-    q.tasks = tasks;
-    q.M     = M;
-    q.N     = N;
-    atomic_init(&q.next_task, 0);
+    ws_pool_t *pool = calloc(1, sizeof(*pool));
+    pthread_t tids[WS_MAX_THREADS];
+    ws_worker_arg_t wargs[WS_MAX_THREADS];
+    if (!pool) return -1;
 
+    /*
+     * ~64 serial leaves per thread: enough slack for stealing to even out
+     * the cost gradient (terms near N are much bigger than terms near 0),
+     * while each leaf still does real work.
+     */
+    pool->nthreads = nthreads;
+    pool->cutoff   = N / ((long)nthreads * 64);
+    if (pool->cutoff < 64) pool->cutoff = 64;
+    pool->tok      = tok;
+    atomic_init(&pool->shutdown, 0);
+    for (int i = 0; i < nthreads; i++)
+        pthread_mutex_init(&pool->dq[i].lock, NULL);
+    atomic_store(&s_split_ns, 0);
+    atomic_store(&s_merge_ns, 0);
+
+    /* The conversion and division count as one more pass over the terms */
+    long units = bs_units(pool->cutoff, 0, N);
+    bench_token_begin(tok, units + N);
+
+    peak_rss_reset();
+    double t0 = now_sec();
+
+    /* One worker set for the whole run; the caller is thread 0 */
+    tl_ws_id = 0;
     int nstarted = 0;
-    for (int i = 0; i < nthreads; i++) {
-        if (pthread_create(&tids[i], NULL, bs_queue_worker, &q) == 0)
+    for (int i = 1; i < nthreads; i++) {
+        wargs[nstarted].pool = pool;
+        wargs[nstarted].id   = i;
+        if (pthread_create(&tids[nstarted], NULL, ws_worker, &wargs[nstarted]) == 0)
             nstarted++;
     }
-    for (int i = 0; i < nstarted; i++)
-        pthread_join(tids[i], NULL);
 
-    /* Merge all M task results with a parallel tree reduction. */
-    if (M > 1 && nthreads > 1) {
-        pthread_barrier_t bar_start, bar_end;
-        pthread_barrier_init(&bar_start, NULL, (unsigned)(nthreads + 1));
-        pthread_barrier_init(&bar_end,   NULL, (unsigned)(nthreads + 1));
-
-        merge_ctx_t mctx;
-        mctx.tasks     = tasks;
-        mctx.M         = M;
-        mctx.shutdown  = 0;
-        mctx.bar_start = &bar_start;
-        mctx.bar_end   = &bar_end;
-        atomic_init(&mctx.next_pair, 0);
-
-        pthread_t *mtids = calloc((size_t)nthreads, sizeof(pthread_t));
-        int mnstarted = 0;
-        if (mtids) {
-            for (int i = 0; i < nthreads; i++) {
-                if (pthread_create(&mtids[i], NULL, merge_worker, &mctx) == 0)
-                    mnstarted++;
-            }
-        }
+    /* Explicit precision: mpf_set_default_prec() is process-global */
+    mpf_t sqrt_part, fQ, fT;
+    mpf_init2(sqrt_part, prec);
 
-        while (mctx.M > 1) {
-            atomic_store(&mctx.next_pair, 0);
-            pthread_barrier_wait(&bar_start);
-            pthread_barrier_wait(&bar_end);
-
-            int pairs = mctx.M / 2;
-            int newM  = pairs + (mctx.M & 1);
-
-            /* Compact: move merged results from even slots [0,2,4,...] into [0..pairs-1]. */
-            for (int i = 0; i < pairs; i++) {
-                int src = 2 * i;
-                if (i != src) {
-                    mpz_swap(tasks[i].P, tasks[src].P);
-                    mpz_swap(tasks[i].Q, tasks[src].Q);
-                    mpz_swap(tasks[i].T, tasks[src].T);
-                }
-            }
-            /* If odd: move last element into the new tail slot (index = pairs). */
-            if (mctx.M & 1) {
-                int last = mctx.M - 1;
-                int tail = pairs;
-                if (tail != last) {
-                    mpz_swap(tasks[tail].P, tasks[last].P);
-                    mpz_swap(tasks[tail].Q, tasks[last].Q);
-                    mpz_swap(tasks[tail].T, tasks[last].T);
-                }
-            }
-
-            mctx.M = newM;
-        }
+    sqrt_job_t js = { sqrt_part, 0 };
+    ws_task_t ts;
+    ws_fork(pool, &ts, sqrt_task, &js);
 
-        /* Shut down merge workers */
-        mctx.shutdown = 1;
-        pthread_barrier_wait(&bar_start);
-        pthread_barrier_wait(&bar_end);
-        for (int i = 0; i < mnstarted; i++)
-            pthread_join(mtids[i], NULL);
-        free(mtids);
-        pthread_barrier_destroy(&bar_start);
-        pthread_barrier_destroy(&bar_end);
-    } else {
-        /* Fallback: serial merge */
-        for (int i = 1; i < M; i++) {
-            bs_merge(tasks[0].P, tasks[0].Q, tasks[0].T,
-                     tasks[i].P, tasks[i].Q, tasks[i].T);
-            mpz_set_ui(tasks[i].P, 0);
-            mpz_set_ui(tasks[i].Q, 0);
-            mpz_set_ui(tasks[i].T, 0);
-        }
+    mpz_t P, Q, T;
+    mpz_inits(P, Q, T, NULL);
+    bs_par(pool, P, Q, T, 0, N, 0);
+    mpz_clear(P);                 /* left half's P, unused from here on */
+    double t_series = now_sec();
+
+    /* Cancelled: the series stopped early; nothing left worth finishing */
+    if (bench_token_cancelled(tok)) {
+        mpz_clears(Q, T, NULL);
+        ws_join(pool, &ts);
+        atomic_store(&pool->shutdown, 1);
+        for (int i = 0; i < nstarted; i++)
+            pthread_join(tids[i], NULL);
+        tmp_drain();
+        mpf_clear(sqrt_part);
+        for (int i = 0; i < nthreads; i++)
+            pthread_mutex_destroy(&pool->dq[i].lock);
+        free(pool);
+        out->cancelled = 1;
+        return -1;
     }
 
     /*
      * pi = 426880 × sqrt(10005) × Q / T
      * (derived from 12/640320^(3/2) = 426880/sqrt(10005)/640320^3)
+     *
+     * fQ/fT are only allocated now, and each mpz goes as soon as it has
+     * been converted, so the series and division peaks do not stack.
      */
-    mpf_set_default_prec(prec);
-    mpf_t sqrt_part, fQ, fT;
-    mpf_inits(sqrt_part, fQ, fT, NULL);
-
-    mpf_set_ui(sqrt_part, 10005);
-    mpf_sqrt(sqrt_part, sqrt_part);
-    mpf_mul_ui(sqrt_part, sqrt_part, 426880);
+    mpf_init2(fQ, prec);
+    mpf_init2(fT, prec);
+    mpf_job_t jt = { fT, T };
+    ws_task_t tt;
+    ws_fork(pool, &tt, set_z_task, &jt);
+    mpf_set_z(fQ, Q);
+    mpz_clear(Q);
+    ws_join(pool, &tt);
+    mpz_clear(T);
+    ws_join(pool, &ts);
+
+    atomic_store(&pool->shutdown, 1);
+    for (int i = 0; i < nstarted; i++)
+        pthread_join(tids[i], NULL);
+    tmp_drain();
 
-    mpf_set_z(fQ, tasks[0].Q);
-    mpf_set_z(fT, tasks[0].T);
+    double t_div = now_sec();
     mpf_mul(fQ, fQ, sqrt_part);   /* fQ = Q × 426880 × sqrt(10005) */
     mpf_div(fQ, fQ, fT);          /* fQ = pi                        */
+    double t1 = now_sec();
+    bench_token_advance(tok, N);
 
-    clock_gettime(CLOCK_MONOTONIC, &t1);
-
-    out->time_sec       = (t1.tv_sec - t0.tv_sec)
-                        + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    out->time_sec       = t1 - t0;
     out->digits_per_sec = (double)n_digits / out->time_sec;
+    out->series_sec     = t_series - t0;
+    out->split_sec      = atomic_load(&s_split_ns) * 1e-9;
+    out->merge_sec      = atomic_load(&s_merge_ns) * 1e-9;
+    out->sqrt_sec       = js.sec;
+    out->div_sec        = t1 - t_div;
+    out->peak_rss_kb    = peak_rss_kb();
 
     mpf_clears(sqrt_part, fQ, fT, NULL);
-    for (int i = 0; i < M; i++)
-        mpz_clears(tasks[i].P, tasks[i].Q, tasks[i].T, NULL);
-    free(tasks);
-    free(tids);
+    for (int i = 0; i < nthreads; i++)
+        pthread_mutex_destroy(&pool->dq[i].lock);
+    free(pool);
+    return 0;
 }
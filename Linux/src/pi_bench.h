@@ -1,18 +1,46 @@
 #ifndef PI_BENCH_H
 #define PI_BENCH_H
 
+#include "bench.h"
+
+/*
+ * Estimated peak memory per decimal digit (measured peak RSS of a run,
+ * with some headroom); pi_bench_run() refuses runs that would not fit
+ * in MemAvailable.
+ */
+#define PI_BYTES_PER_DIGIT 12.0
+
 typedef struct {
     double time_sec;
     double digits_per_sec;
     int    n_digits;
+
+    /* Phases.  series/sqrt/div are wall-clock; split (serial leaves) and
+     * merge (products above them) are summed over threads, so they can
+     * exceed series_sec on a multi-core run. */
+    double series_sec;
+    double split_sec, merge_sec;
+    double sqrt_sec;              /* overlaps the series */
+    double div_sec;               /* final mul + division, single-threaded */
+
+    unsigned long peak_rss_kb;    /* VmHWM after the run, 0 if unknown */
+    unsigned long need_kb;        /* estimate checked before starting */
+    unsigned long mem_avail_kb;   /* MemAvailable at start, 0 if unknown */
+    int           cancelled;      /* stopped by bench_token_cancel()      */
 } pi_results_t;
 
 /*
  * Compute pi to n_digits decimal digits using the Chudnovsky algorithm
  * with binary splitting, parallelised across all online logical CPUs.
  *
+ * Returns 0 on success, or -1 without computing anything when the memory
+ * estimate (need_kb) exceeds MemAvailable or allocation fails.  tok (may be
+ * NULL) reports progress and can cancel the run from another thread: it
+ * then stops within one serial leaf or merge, frees everything and returns
+ * -1 with cancelled set.  The final division is not interruptible.
+ *
  * Requires: libgmp (-lgmp)
  */
-void pi_bench_run(int n_digits, pi_results_t *out);
+int pi_bench_run(int n_digits, pi_results_t *out, bench_token_t *tok);
 
 #endif /* PI_BENCH_H */
@@ -0,0 +1,503 @@
+/*
+ * pm_analyze.c — PM table index discovery for unknown table versions
+ *
+ * Samples the raw table at a fixed rate through a scripted step: an idle
+ * phase, then every core running the bandwidth workers.  Alongside each
+ * row it records reference signals the kernel already exposes — mean
+ * cpufreq, k10temp Tctl, mean CPU usage — plus the step itself (0/1).
+ *
+ * Nothing is stored per sample: each row is folded into per-index running
+ * sums (per-phase Σx and Σx², Σx·ref for every reference, min/max), one
+ * pass over contiguous arrays the compiler vectorises.  Values are
+ * shifted by the first row so the sums stay well-conditioned for large
+ * entries.  From those, each index gets per-phase mean/stddev, a step
+ * z-score and its Pearson r against every reference, and indices whose
+ * value range and correlation fit a class (power, temperature, voltage,
+ * clock) are proposed in order of r.
+ */
+
+#define _GNU_SOURCE
+#include "pm_analyze.h"
+#include "backend.h"
+#include "bench.h"
+#include "smu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <signal.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+
+#define PA_MAX_RATE    200
+#define PA_MAX_ENTRIES 4096     /* floats; the largest tables are ~0x1000 */
+#define PA_TOP         6        /* proposals per class         */
+#define PA_MIN_R       0.30     /* weakest correlation listed  */
+#define PA_STEP_Z      3.0      /* "moved at the step" cut-off */
+
+enum { REF_FREQ, REF_TEMP, REF_USAGE, REF_STEP, PA_NREFS };
+static const char *const s_ref_names[PA_NREFS] = { "cpufreq", "Tctl", "usage", "step" };
+
+typedef struct {
+    const char *name, *unit;
+    int         ref;         /* expected to rise with this reference */
+    float       lo, hi;      /* plausible values in either phase     */
+} pa_class_t;
+
+static const pa_class_t s_classes[] = {
+    { "Power / current", "W|A", REF_USAGE,   1.0f,  500.0f },
+    { "Temperature",     "C",   REF_TEMP,   15.0f,  115.0f },
+    { "Voltage",         "V",   REF_FREQ,    0.2f,    1.8f },
+    { "Clock",           "MHz", REF_FREQ,  300.0f, 7000.0f },
+};
+#define PA_NCLASSES ((int)(sizeof(s_classes) / sizeof(s_classes[0])))
+
+static volatile sig_atomic_t s_stop;
+
+static void on_stop_signal(int sig)
+{
+    (void)sig;
+    s_stop = 1;
+}
+
+/* ── Options ────────────────────────────────────────────────────────── */
+
+typedef struct {
+    int         rate_hz;
+    double      idle_s, load_s;
+    const char *output;
+    const char *csv;
+} pa_opts_t;
+
+static const char *opt_value(const char *arg, const char *name)
+{
+    size_t n = strlen(name);
+    return (strncmp(arg, name, n) == 0 && arg[n] == '=') ? arg + n + 1 : NULL;
+}
+
+static int parse_opts(int argc, char **argv, pa_opts_t *o)
+{
+    memset(o, 0, sizeof(*o));
+    o->rate_hz = 20;
+    o->idle_s  = 3.0;
+    o->load_s  = 6.0;
+    for (int i = 1; i < argc; i++) {
+        const char *a = argv[i], *v;
+        if (strcmp(a, "--pm-analyze") == 0) continue;
+        if ((v = opt_value(a, "--rate")))   { o->rate_hz = atoi(v); continue; }
+        if ((v = opt_value(a, "--idle")))   { o->idle_s = strtod(v, NULL); continue; }
+        if ((v = opt_value(a, "--load")))   { o->load_s = strtod(v, NULL); continue; }
+        if ((v = opt_value(a, "--output"))) { o->output = v; continue; }
+        if ((v = opt_value(a, "--csv")))    { o->csv = v; continue; }
+        fprintf(stderr, "TuxTimings: unknown --pm-analyze option '%s'\n", a);
+        return -1;
+    }
+    if (o->rate_hz < 1 || o->rate_hz > PA_MAX_RATE) {
+        fprintf(stderr, "TuxTimings: --rate must be 1..%d\n", PA_MAX_RATE);
+        return -1;
+    }
+    if (o->idle_s < 1.0 || o->load_s < 1.0) {
+        fprintf(stderr, "TuxTimings: --idle and --load must be at least 1 second\n");
+        return -1;
+    }
+    return 0;
+}
+
+/* ── Accumulators ───────────────────────────────────────────────────── */
+
+typedef struct {
+    int     n;                     /* table entries tracked            */
+    int     cnt[2];                /* samples per phase (0 idle, 1 load) */
+    float  *base;                  /* first row, subtracted from all   */
+    float  *row;                   /* scratch copy of the current row  */
+    float  *lo, *hi;
+    double *sum[2], *sumsq[2];
+    double *sxy[PA_NREFS];
+    double  ref_base[PA_NREFS];
+    double  rsum[2][PA_NREFS], rsumsq[PA_NREFS];
+    double  rmean_raw[2][PA_NREFS];
+    double *block;
+} pa_acc_t;
+
+static int acc_init(pa_acc_t *a, const float *first, int n)
+{
+    memset(a, 0, sizeof(*a));
+    const int ndbl = 4 + PA_NREFS;
+    a->block = calloc((size_t)n * ndbl, sizeof(double));
+    float *f = malloc((size_t)n * 4 * sizeof(float));
+    if (!a->block || !f) {
+        free(a->block);
+        free(f);
+        return -1;
+    }
+    a->n = n;
+    for (int p = 0; p < 2; p++) {
+        a->sum[p]   = a->block + (size_t)n * (2 * p);
+        a->sumsq[p] = a->block + (size_t)n * (2 * p + 1);
+    }
+    for (int k = 0; k < PA_NREFS; k++)
+        a->sxy[k] = a->block + (size_t)n * (4 + k);
+    a->base = f;
+    a->row  = f + n;
+    a->lo   = f + 2 * n;
+    a->hi   = f + 3 * n;
+    memcpy(a->base, first, (size_t)n * sizeof(float));
+    memcpy(a->lo, first, (size_t)n * sizeof(float));
+    memcpy(a->hi, first, (size_t)n * sizeof(float));
+    return 0;
+}
+
+static void acc_free(pa_acc_t *a)
+{
+    free(a->block);
+    free(a->base);
+    memset(a, 0, sizeof(*a));
+}
+
+/* The hot loop: one row into every per-index sum */
+__attribute__((optimize("O3,tree-vectorize")))
+static void acc_row(pa_acc_t *a, int phase, const double *ref)
+{
+    const int n = a->n;
+    const float *restrict row  = a->row;
+    const float *restrict base = a->base;
+    float  *restrict lo = a->lo, *restrict hi = a->hi;
+    double *restrict s  = a->sum[phase], *restrict q = a->sumsq[phase];
+    double *restrict x0 = a->sxy[0], *restrict x1 = a->sxy[1];
+    double *restrict x2 = a->sxy[2], *restrict x3 = a->sxy[3];
+    const double r0 = ref[0], r1 = ref[1], r2 = ref[2], r3 = ref[3];
+
+    for (int i = 0; i < n; i++) {
+        double x = (double)row[i] - (double)base[i];
+        s[i]  += x;
+        q[i]  += x * x;
+        x0[i] += x * r0;
+        x1[i] += x * r1;
+        x2[i] += x * r2;
+        x3[i] += x * r3;
+        lo[i] = row[i] < lo[i] ? row[i] : lo[i];
+        hi[i] = row[i] > hi[i] ? row[i] : hi[i];
+    }
+}
+
+static void acc_sample(pa_acc_t *a, int phase, const double *raw_ref)
+{
+    double ref[PA_NREFS];
+    if (a->cnt[0] + a->cnt[1] == 0)
+        memcpy(a->ref_base, raw_ref, sizeof(a->ref_base));
+    for (int k = 0; k < PA_NREFS; k++) {
+        ref[k] = raw_ref[k] - a->ref_base[k];
+        a->rsum[phase][k] += ref[k];
+        a->rsumsq[k]      += ref[k] * ref[k];
+    }
+    acc_row(a, phase, ref);
+    a->cnt[phase]++;
+}
+
+/* ── Per-index statistics ───────────────────────────────────────────── */
+
+typedef struct {
+    double mean[2], sd[2];
+    double r[PA_NREFS];          /* NAN = reference or entry constant */
+    double step_z;
+} pa_index_t;
+
+static double pearson(double n, double sx, double sxx, double sy, double syy, double sxy)
+{
+    double vx = n * sxx - sx * sx, vy = n * syy - sy * sy;
+    if (vx <= 1e-12 * n * n || vy <= 1e-12 * n * n) return NAN;
+    return (n * sxy - sx * sy) / sqrt(vx * vy);
+}
+
+static void index_stats(const pa_acc_t *a, int i, pa_index_t *st)
+{
+    for (int p = 0; p < 2; p++) {
+        double c = a->cnt[p] > 0 ? a->cnt[p] : 1;
+        double m = a->sum[p][i] / c;
+        double v = a->sumsq[p][i] / c - m * m;
+        st->mean[p] = m + a->base[i];
+        st->sd[p]   = v > 0 ? sqrt(v) : 0;
+    }
+    double d = st->sd[0] * st->sd[0] + st->sd[1] * st->sd[1];
+    double step = st->mean[1] - st->mean[0];
+    st->step_z = d > 0 ? step / sqrt(d) : (step != 0 ? copysign(INFINITY, step) : 0);
+
+    double n   = a->cnt[0] + a->cnt[1];
+    double sx  = a->sum[0][i] + a->sum[1][i];
+    double sxx = a->sumsq[0][i] + a->sumsq[1][i];
+    for (int k = 0; k < PA_NREFS; k++)
+        st->r[k] = pearson(n, sx, sxx, a->rsum[0][k] + a->rsum[1][k], a->rsumsq[k],
+                           a->sxy[k][i]);
+}
+
+static int ref_varies(const pa_acc_t *a, int k)
+{
+    double n  = a->cnt[0] + a->cnt[1];
+    double sy = a->rsum[0][k] + a->rsum[1][k];
+    return n * a->rsumsq[k] - sy * sy > 1e-12 * n * n;
+}
+
+/* ── Sampling ───────────────────────────────────────────────────────── */
+
+static long long mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void sleep_until_ns(long long t)
+{
+    struct timespec ts = { (time_t)(t / 1000000000LL), (long)(t % 1000000000LL) };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+static double mean_of(const float *v, int n)
+{
+    double s = 0;
+    for (int i = 0; i < n; i++) s += v[i];
+    return n > 0 ? s / n : 0;
+}
+
+/* Fresh raw table into a->row (or the first row into buf when a is not
+ * set up yet), then the reference signals.  The decoded read inside
+ * backend_read_dynamic() is coalesced onto the same SMU read. */
+static int take_sample(float *dst, int cap, int *count, double *ref)
+{
+    const float *t;
+    int n;
+    if (!smu_pm_acquire(0, &t, &n, NULL)) return -1;
+    if (n > cap) n = cap;
+    memcpy(dst, t, (size_t)n * sizeof(float));
+    smu_pm_release();
+    *count = n;
+
+    system_dynamic_t dyn;
+    backend_read_dynamic(&dyn);
+    const smu_metrics_t *m = &dyn.metrics;
+    ref[REF_FREQ]  = mean_of(m->core_freq_mhz, m->core_freq_count);
+    ref[REF_TEMP]  = m->has_tctl ? m->tctl_c : m->has_tdie ? m->tdie_c : 0;
+    ref[REF_USAGE] = mean_of(m->core_usage_pct, m->core_usage_count);
+    return 0;
+}
+
+static void *load_thread(void *arg)
+{
+    bench_token_t *tok = arg;
+    bench_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.ops        = BENCH_OP(BENCH_BW_READ);
+    cfg.min_passes = BENCH_MAX_SAMPLES;
+    cfg.max_passes = BENCH_MAX_SAMPLES;
+    cfg.token      = tok;
+
+    bench_results_t r;
+    while (!bench_token_cancelled(tok))
+        bench_run_ex(&cfg, &r);
+    return NULL;
+}
+
+/* ── Report ─────────────────────────────────────────────────────────── */
+
+typedef struct {
+    int    idx;
+    double score;
+} pa_pick_t;
+
+static void report(FILE *fp, const pa_acc_t *a, const system_summary_t *st, int rate_hz)
+{
+    const double *ri = a->rmean_raw[0], *rl = a->rmean_raw[1];
+
+    fprintf(fp, "TuxTimings PM table analysis\n");
+    fprintf(fp, "  CPU:        %s, %s, %d entries\n",
+            st->cpu.codename[0] ? st->cpu.codename : "unknown",
+            st->cpu.pm_table_version[0] ? st->cpu.pm_table_version : "PM table version unknown",
+            a->n);
+    fprintf(fp, "  Samples:    idle %d, load %d at %d Hz\n", a->cnt[0], a->cnt[1], rate_hz);
+    fprintf(fp, "  References: cpufreq %.0f -> %.0f MHz, Tctl %.1f -> %.1f C, usage %.0f -> %.0f %%\n",
+            ri[REF_FREQ], rl[REF_FREQ], ri[REF_TEMP], rl[REF_TEMP], ri[REF_USAGE], rl[REF_USAGE]);
+
+    int n_static = 0, n_moved = 0;
+    for (int i = 0; i < a->n; i++) {
+        if (a->lo[i] == a->hi[i]) { n_static++; continue; }
+        pa_index_t s;
+        index_stats(a, i, &s);
+        if (fabs(s.step_z) > PA_STEP_Z) n_moved++;
+    }
+    fprintf(fp, "  Entries:    %d constant, %d moved at the load step (|z| > %.0f)\n",
+            n_static, n_moved, PA_STEP_Z);
+
+    for (int c = 0; c < PA_NCLASSES; c++) {
+        const pa_class_t *cl = &s_classes[c];
+        int ref = ref_varies(a, cl->ref) ? cl->ref : REF_STEP;
+        pa_pick_t top[PA_TOP];
+        int ntop = 0;
+
+        for (int i = 0; i < a->n; i++) {
+            if (a->lo[i] == a->hi[i]) continue;
+            pa_index_t s;
+            index_stats(a, i, &s);
+            double r = s.r[ref];
+            if (!isfinite(r) || r < PA_MIN_R) continue;
+            if (!(s.mean[0] >= cl->lo && s.mean[0] <= cl->hi &&
+                  s.mean[1] >= cl->lo && s.mean[1] <= cl->hi))
+                continue;
+
+            /* Insertion into the small sorted top list */
+            int pos = ntop < PA_TOP ? ntop++ : PA_TOP;
+            while (pos > 0 && top[pos - 1].score < r) {
+                if (pos < PA_TOP) top[pos] = top[pos - 1];
+                pos--;
+            }
+            if (pos < PA_TOP) top[pos] = (pa_pick_t){ i, r };
+        }
+
+        fprintf(fp, "\n== %s (%s), ranked by r vs %s%s ==\n", cl->name, cl->unit,
+                s_ref_names[ref], ref != cl->ref ? " (no varying reference)" : "");
+        if (ntop == 0) {
+            fprintf(fp, "  (no candidates)\n");
+            continue;
+        }
+        fprintf(fp, "  %-7s %12s %12s %7s %8s\n", "Index", "Idle", "Load", "r", "step z");
+        for (int j = 0; j < ntop; j++) {
+            pa_index_t s;
+            index_stats(a, top[j].idx, &s);
+            fprintf(fp, "  [%4d]  %12.4f %12.4f %7.3f %8.1f\n", top[j].idx,
+                    s.mean[0], s.mean[1], top[j].score, s.step_z);
+        }
+    }
+    fprintf(fp, "\nCandidates are statistical guesses — confirm against a known "
+                "reading before adding them to the decoder.\n");
+}
+
+static int write_csv(const pa_acc_t *a, const char *path)
+{
+    FILE *fp = fopen(path, "w");
+    if (!fp) return -1;
+    fprintf(fp, "index,idle_mean,load_mean,idle_sd,load_sd,min,max");
+    for (int k = 0; k < PA_NREFS; k++) fprintf(fp, ",r_%s", s_ref_names[k]);
+    fprintf(fp, ",step_z\n");
+    for (int i = 0; i < a->n; i++) {
+        pa_index_t s;
+        index_stats(a, i, &s);
+        fprintf(fp, "%d,%.6g,%.6g,%.6g,%.6g,%.6g,%.6g", i, s.mean[0], s.mean[1],
+                s.sd[0], s.sd[1], (double)a->lo[i], (double)a->hi[i]);
+        for (int k = 0; k < PA_NREFS; k++) fprintf(fp, ",%.4f", s.r[k]);
+        fprintf(fp, ",%.2f\n", s.step_z);
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/* ── Run ────────────────────────────────────────────────────────────── */
+
+int pm_analyze_requested(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+        if (strcmp(argv[i], "--pm-analyze") == 0) return 1;
+    return 0;
+}
+
+int pm_analyze_run(int argc, char **argv)
+{
+    pa_opts_t o;
+    if (parse_opts(argc, argv, &o) != 0) return 2;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    /* PM table version and codename; the rest loads in the background */
+    static system_summary_t st;
+    backend_read_static(&st);
+
+    static float first[PA_MAX_ENTRIES];
+    double ref[PA_NREFS] = { 0 };
+    int n = 0, status = 0;
+    pa_acc_t acc;
+    memset(&acc, 0, sizeof(acc));
+
+    if (take_sample(first, PA_MAX_ENTRIES, &n, ref) != 0 || n < 4) {
+        fprintf(stderr, "TuxTimings: PM table unavailable\n");
+        backend_cleanup();
+        return 1;
+    }
+    if (acc_init(&acc, first, n) != 0) {
+        backend_cleanup();
+        return 1;
+    }
+    fprintf(stderr, "TuxTimings: analysing %d PM table entries — %.0f s idle, then %.0f s load\n",
+            n, o.idle_s, o.load_s);
+
+    bench_token_t *tok = bench_token_new();
+    pthread_t load;
+    int loading = 0;
+
+    double rsum_raw[2][PA_NREFS] = { { 0 } };
+    const long long period = 1000000000LL / o.rate_hz;
+    const long long start  = mono_ns();
+    const long long step   = start + (long long)(o.idle_s * 1e9);
+    const long long end    = step + (long long)(o.load_s * 1e9);
+    long long next = start;
+
+    while (!s_stop) {
+        long long now = mono_ns();
+        if (now >= end) break;
+        int phase = now >= step;
+        if (phase && !loading && tok) {
+            if (pthread_create(&load, NULL, load_thread, tok) == 0) loading = 1;
+            else {
+                fprintf(stderr, "TuxTimings: failed to start load workers\n");
+                status = 1;
+                break;
+            }
+        }
+
+        int got;
+        if (take_sample(acc.row, acc.n, &got, ref) == 0 && got == acc.n) {
+            ref[REF_STEP] = phase;
+            acc_sample(&acc, phase, ref);
+            for (int k = 0; k < PA_NREFS; k++) rsum_raw[phase][k] += ref[k];
+        }
+
+        next += period;
+        if (next < now) next = now;
+        sleep_until_ns(next);
+    }
+
+    if (loading) {
+        bench_token_cancel(tok);
+        pthread_join(load, NULL);
+    }
+    bench_token_free(tok);
+    bench_ctx_release();
+
+    if (status == 0 && acc.cnt[0] > 1 && acc.cnt[1] > 1) {
+        for (int p = 0; p < 2; p++)
+            for (int k = 0; k < PA_NREFS; k++)
+                acc.rmean_raw[p][k] = rsum_raw[p][k] / acc.cnt[p];
+
+        FILE *fp = stdout;
+        if (o.output && strcmp(o.output, "-") != 0 && !(fp = fopen(o.output, "w"))) {
+            fprintf(stderr, "TuxTimings: cannot open %s: %s\n", o.output, strerror(errno));
+            status = 1;
+        } else {
+            report(fp, &acc, &st, o.rate_hz);
+            if (fp != stdout) fclose(fp);
+        }
+        if (o.csv && write_csv(&acc, o.csv) != 0) {
+            fprintf(stderr, "TuxTimings: cannot write %s: %s\n", o.csv, strerror(errno));
+            status = 1;
+        }
+    } else if (status == 0) {
+        fprintf(stderr, "TuxTimings: analysis interrupted before both phases were sampled\n");
+        status = 1;
+    }
+
+    acc_free(&acc);
+    backend_cleanup();
+    return status;
+}
@@ -0,0 +1,21 @@
+#ifndef PM_ANALYZE_H
+#define PM_ANALYZE_H
+
+/* Returns 1 if argv contains --pm-analyze. */
+int pm_analyze_requested(int argc, char **argv);
+
+/* Sample the raw PM table through an idle → all-core load step and rank
+ * every table index against cpufreq, k10temp Tctl, CPU usage and the step
+ * itself, to propose likely power / temperature / voltage / clock indices
+ * for a table version the decoder does not know. GTK-free; prints a text
+ * report and returns the process exit status.
+ *
+ *   --rate=HZ        samples per second (1..200, default 20)
+ *   --idle=SEC       idle phase (default 3)
+ *   --load=SEC       load phase, bandwidth workers on every core (default 6)
+ *   --output=PATH    report file (default stdout)
+ *   --csv=PATH       also write per-index statistics as CSV
+ */
+int pm_analyze_run(int argc, char **argv);
+
+#endif /* PM_ANALYZE_H */
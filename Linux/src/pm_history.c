@@ -0,0 +1,121 @@
+/*
+ * pm_history.c — Ring buffer of high-rate PM table samples
+ *
+ * Each sample is the handful of PM fields worth watching for transients
+ * (PPT, current, Vcore/VID/VSOC, temp, clocks) plus a timestamp — 40 bytes,
+ * so 30 s at 100 Hz is ~120 KB of static storage and nothing is allocated
+ * per sample. Stats are computed on demand by walking back from the newest
+ * sample, which at one query per second is far cheaper than maintaining
+ * running min/max over a sliding window.
+ */
+
+#include "pm_history.h"
+#include <string.h>
+#include <math.h>
+
+#define PMH_CAPACITY (PMH_MAX_HZ * PMH_MAX_WINDOW_S)
+
+typedef struct {
+    long long t_ns;
+    float     v[PMH_FIELD_COUNT];
+} pm_sample_t;
+
+static pm_sample_t s_ring[PMH_CAPACITY];
+static int         s_head;     /* next write slot */
+static int         s_count;
+
+void pm_history_reset(void)
+{
+    s_head = 0;
+    s_count = 0;
+}
+
+/* Peak effective core clock: per-core clocks when the family maps them,
+ * else the single package-level value. */
+static float peak_core_clock_mhz(const smu_metrics_t *m)
+{
+    float peak = 0;
+    for (int i = 0; i < m->core_clocks_count && i < MAX_CORES; i++) {
+        if (m->core_clocks_ghz[i] * 1000.0f > peak)
+            peak = m->core_clocks_ghz[i] * 1000.0f;
+    }
+    return peak > 0 ? peak : m->core_clock_mhz;
+}
+
+void pm_history_push(long long t_ns, const smu_metrics_t *m)
+{
+    pm_sample_t *p = &s_ring[s_head];
+    p->t_ns = t_ns;
+    p->v[PMH_PPT]      = m->ppt_w;
+    p->v[PMH_CURRENT]  = m->package_current_a;
+    p->v[PMH_VCORE]    = m->vcore;
+    p->v[PMH_VID]      = m->vid;
+    p->v[PMH_VSOC]     = m->vsoc;
+    p->v[PMH_CPU_TEMP] = m->cpu_temp_c;
+    p->v[PMH_CORE_CLK] = peak_core_clock_mhz(m);
+    p->v[PMH_FCLK]     = m->fclk_mhz;
+
+    s_head = (s_head + 1) % PMH_CAPACITY;
+    if (s_count < PMH_CAPACITY) s_count++;
+}
+
+void pm_history_stats(long long now_ns, float window_s, pm_hist_stats_t *out)
+{
+    out->window_s   = window_s;
+    out->samples    = 0;
+    out->rate_hz    = 0;
+    out->jitter_ms  = 0;
+    out->max_gap_ms = 0;
+    out->update_hz  = 0;
+    for (int f = 0; f < PMH_FIELD_COUNT; f++)
+        out->min[f] = out->max[f] = out->avg[f] = 0;
+    if (s_count == 0) return;
+
+    const long long cutoff = now_ns - (long long)(window_s * 1e9f);
+    double sum[PMH_FIELD_COUNT] = {0};
+    double dt_sum = 0, dt_sq = 0;
+    int    n = 0, updates = 0;
+    long long newest = 0, oldest = 0;
+    const pm_sample_t *next = NULL;   /* the newer neighbour of p */
+
+    for (int k = 0; k < s_count; k++) {
+        const pm_sample_t *p = &s_ring[(s_head - 1 - k + PMH_CAPACITY) % PMH_CAPACITY];
+        if (p->t_ns < cutoff) break;
+
+        if (n == 0) {
+            newest = p->t_ns;
+            memcpy(out->min, p->v, sizeof(out->min));
+            memcpy(out->max, p->v, sizeof(out->max));
+        }
+        for (int f = 0; f < PMH_FIELD_COUNT; f++) {
+            if (p->v[f] < out->min[f]) out->min[f] = p->v[f];
+            if (p->v[f] > out->max[f]) out->max[f] = p->v[f];
+            sum[f] += p->v[f];
+        }
+        if (next) {
+            double dt_ms = (double)(next->t_ns - p->t_ns) / 1e6;
+            dt_sum += dt_ms;
+            dt_sq  += dt_ms * dt_ms;
+            if (dt_ms > out->max_gap_ms) out->max_gap_ms = (float)dt_ms;
+            if (memcmp(next->v, p->v, sizeof(p->v)) != 0) updates++;
+        }
+        oldest = p->t_ns;
+        next = p;
+        n++;
+    }
+
+    out->samples = n;
+    if (n == 0) return;
+    for (int f = 0; f < PMH_FIELD_COUNT; f++)
+        out->avg[f] = (float)(sum[f] / n);
+
+    if (n >= 2 && newest > oldest) {
+        double span_s = (double)(newest - oldest) / 1e9;
+        int    gaps   = n - 1;
+        double mean   = dt_sum / gaps;
+        double var    = dt_sq / gaps - mean * mean;
+        out->rate_hz   = (float)(gaps / span_s);
+        out->update_hz = (float)(updates / span_s);
+        out->jitter_ms = var > 0 ? (float)sqrt(var) : 0.0f;
+    }
+}
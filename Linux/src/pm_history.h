@@ -0,0 +1,20 @@
+#ifndef PM_HISTORY_H
+#define PM_HISTORY_H
+
+#include "types.h"
+
+/* Ring capacity: PMH_MAX_HZ samples/s for PMH_MAX_WINDOW_S seconds */
+#define PMH_MAX_HZ       100
+#define PMH_MAX_WINDOW_S 30
+
+/* Fixed-size, preallocated ring of compact PM samples. Single-threaded —
+ * owned by the sampler thread; the UI only sees pm_hist_stats_t copies. */
+void pm_history_reset(void);
+
+/* Append the PMH_* fields of m, timestamped t_ns (CLOCK_MONOTONIC). */
+void pm_history_push(long long t_ns, const smu_metrics_t *m);
+
+/* Stats over samples newer than now_ns - window_s. */
+void pm_history_stats(long long now_ns, float window_s, pm_hist_stats_t *out);
+
+#endif /* PM_HISTORY_H */
@@ -1,6 +1,8 @@
 #include "pm_table.h"
 #include <string.h>
+#include <stddef.h>
 #include <math.h>
+#include <pthread.h>
 
 /* Named PM table index entry */
 typedef struct { int index; int field_offset; } pm_entry_t;
@@ -193,73 +195,202 @@ static inline float safe_get(const float *t, int count, int idx)
     return (idx >= 0 && idx < count) ? t[idx] : 0.0f;
 }
 
-static void apply_named(const pm_family_map_t *map, const float *t, int count, smu_metrics_t *m)
+/* ── Resolved decoder ───────────────────────────────────────────────── */
+
+/*
+ * The family map, Granite Ridge offsets and fixed per-core ranges are
+ * resolved once per (version, codename, table size) into a flat gather list
+ * of PM index → byte offset in smu_metrics_t; each tick is then a straight
+ * copy loop plus the few range-checked fields. Out-of-range indices are
+ * simply left out: the output is memset, which is what safe_get() gave.
+ *
+ * The plausibility scans are not cached: a low-priority candidate (index 1
+ * also reads as a temperature) may be in range while a better one is not
+ * yet, so every read walks the candidates in priority order.
+ */
+
+#define PM_GATHER_MAX 96
+#define MOFF(member)  ((uint16_t)offsetof(smu_metrics_t, member))
+
+typedef struct {
+    uint16_t index;     /* float index into the PM table */
+    uint16_t offset;    /* byte offset of a float in smu_metrics_t */
+} pm_gather_t;
+
+typedef struct {
+    const int *cands;
+    int        n;
+    float      lo, hi;
+} pm_scan_t;
+
+static const int PWR_CANDS[]  = {29, 1, 13, 38, 5, 220, 187, 42, 0};
+static const int CUR_CANDS[]  = {41, 46, 3, 10, 11, 4};
+static const int TEMP_CANDS[] = {1, 448, 449};
+static const int PPT_CANDS[]  = {3, 1, 13, 29, 5, 38};
+
+#define SCAN_INIT(c, lo, hi) { c, (int)(sizeof(c) / sizeof(c[0])), lo, hi }
+
+typedef struct {
+    /* key */
+    int      valid;
+    uint32_t version;
+    int      codename_index;
+    int      count;
+
+    int         granite_ridge;
+    pm_gather_t gather[PM_GATHER_MAX];
+    int         gather_count;
+    int         core_temps_count, core_voltages_count, core_clocks_count;
+
+    /* range-checked single fields, -1 = not present */
+    int iod_idx;
+    int vid_idx, ppt_idx, socket_power_idx;   /* generic families */
+    int tdie_a_idx, tdie_b_idx;               /* Granite Ridge */
+
+    pm_scan_t power, current, temp, ppt;
+} pm_decoder_t;
+
+/* Rebuilt on a layout change; pm_table_read() holds the lock throughout */
+static pm_decoder_t    s_dec;
+static pthread_mutex_t s_dec_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const uint16_t NAMED_OFFSETS[] = {
+    [F_FCLK]     = MOFF(fclk_mhz),  [F_UCLK]     = MOFF(uclk_mhz),
+    [F_MCLK]     = MOFF(mclk_mhz),  [F_VSOC]     = MOFF(vsoc),
+    [F_VDDP]     = MOFF(vddp),      [F_VDDG_IOD] = MOFF(vddg_iod),
+    [F_VDDG_CCD] = MOFF(vddg_ccd),  [F_VDD_MISC] = MOFF(vdd_misc),
+    [F_VCORE]    = MOFF(vcore),
+};
+
+static void gather_add(pm_decoder_t *d, int idx, size_t offset)
 {
-    for (int i = 0; i < map->named_count; i++) {
-        float v = safe_get(t, count, map->named[i].index);
-        switch (map->named[i].field_offset) {
-        case F_FCLK:        m->fclk_mhz = v; break;
-        case F_UCLK:        m->uclk_mhz = v; break;
-        case F_MCLK:        m->mclk_mhz = v; break;
-        case F_VSOC:        m->vsoc = v; break;
-        case F_VDDP:        m->vddp = v; break;
-        case F_VDDG_IOD:    m->vddg_iod = v; break;
-        case F_VDDG_CCD:    m->vddg_ccd = v; break;
-        case F_VDD_MISC:    m->vdd_misc = v; break;
-        case F_VCORE:       m->vcore = v; break;
-        case F_IOD_HOTSPOT: {
-            if (v >= 1.0f && v <= 150.0f) {
-                m->iod_hotspot_c = v;
-                m->has_iod_hotspot = true;
-            }
-            break;
-        }
-        }
-    }
+    if (idx < 0 || idx >= d->count || d->gather_count >= PM_GATHER_MAX) return;
+    d->gather[d->gather_count].index  = (uint16_t)idx;
+    d->gather[d->gather_count].offset = (uint16_t)offset;
+    d->gather_count++;
 }
 
-/* Granite Ridge specific: byte-offset based reading */
-static void read_granite_ridge_offsets(const float *t, int count, smu_metrics_t *m)
+/* count contiguous floats from PM index start into the array at offset */
+static void gather_range(pm_decoder_t *d, int start, int n, size_t offset)
 {
-    /* Byte offsets -> float index = offset / 4 */
-    m->fclk_mhz  = safe_get(t, count, 0x11C / 4);
-    m->uclk_mhz  = safe_get(t, count, 0x12C / 4);
-    m->mclk_mhz  = safe_get(t, count, 0x13C / 4);
-    m->vsoc       = safe_get(t, count, 0x14C / 4);
-    m->vddp       = safe_get(t, count, 0x434 / 4);
-    m->vddg_iod   = safe_get(t, count, 0x40C / 4);
-    m->vddg_ccd   = safe_get(t, count, 0x414 / 4);
-    m->vdd_misc   = safe_get(t, count, 0xE8 / 4);
-    m->vcore      = safe_get(t, count, 0x43C / 4);
+    for (int i = 0; i < n; i++)
+        gather_add(d, start + i, offset + (size_t)i * sizeof(float));
 }
 
-/* Try plausible PM table indices for power */
-static float try_plausible_power(const float *t, int count)
+static void resolve_granite_ridge(pm_decoder_t *d)
 {
-    int candidates[] = {29, 1, 13, 38, 5, 220, 187, 42, 0};
-    for (int i = 0; i < 9; i++) {
-        float v = safe_get(t, count, candidates[i]);
-        if (v >= 0.5f && v <= 400.0f) return v;
+    const int count = d->count;
+    d->granite_ridge = 1;
+
+    /* Byte offsets -> float index = offset / 4 */
+    gather_add(d, 0x11C / 4, MOFF(fclk_mhz));
+    gather_add(d, 0x12C / 4, MOFF(uclk_mhz));
+    gather_add(d, 0x13C / 4, MOFF(mclk_mhz));
+    gather_add(d, 0x14C / 4, MOFF(vsoc));
+    gather_add(d, 0x434 / 4, MOFF(vddp));
+    gather_add(d, 0x40C / 4, MOFF(vddg_iod));
+    gather_add(d, 0x414 / 4, MOFF(vddg_ccd));
+    gather_add(d, 0xE8  / 4, MOFF(vdd_misc));
+    gather_add(d, 0x43C / 4, MOFF(vcore));
+
+    /* Core temps (indices 317-324) */
+    if (count > 324) {
+        d->core_temps_count = 8;
+        gather_range(d, 317, 8, MOFF(core_temps_c));
     }
-    return 0.0f;
+    /* Tdie (indices 448-449) */
+    if (count > 449) {
+        d->tdie_a_idx = 448;
+        d->tdie_b_idx = 449;
+    }
+    /* Core clocks GHz (indices 325-340) */
+    if (count > 340) {
+        d->core_clocks_count = 16;
+        gather_range(d, 325, 16, MOFF(core_clocks_ghz));
+    }
+    /* VID (index 275) */
+    if (count > 275)
+        gather_add(d, 275, MOFF(vid));
+    /* Core voltages (indices 309-316) */
+    if (count > 316) {
+        d->core_voltages_count = 8;
+        gather_range(d, 309, 8, MOFF(core_voltages));
+    }
+    /* IOD hotspot (index 11) */
+    if (count > 11)
+        d->iod_idx = 11;
 }
 
-static float try_plausible_current(const float *t, int count)
+static void resolve_family(pm_decoder_t *d, uint32_t version)
 {
-    int candidates[] = {41, 46, 3, 10, 11, 4};
-    for (int i = 0; i < 6; i++) {
-        float v = safe_get(t, count, candidates[i]);
-        if (v >= 0.5f && v <= 200.0f) return v;
+    const int count = d->count;
+    const pm_family_map_t *map = get_family_map(version);
+
+    for (int i = 0; i < map->named_count; i++) {
+        int f = map->named[i].field_offset;
+        if (f == F_IOD_HOTSPOT) d->iod_idx = map->named[i].index;
+        else gather_add(d, map->named[i].index, NAMED_OFFSETS[f]);
     }
-    return 0.0f;
+
+    /* Per-family core temps and voltages */
+    int nc = map->max_cores;
+    if (nc > MAX_CORES) nc = MAX_CORES;
+    if (map->core_temp_start + nc <= count) {
+        d->core_temps_count = nc;
+        gather_range(d, map->core_temp_start, nc, MOFF(core_temps_c));
+    }
+    if (map->core_voltage_start + nc <= count) {
+        d->core_voltages_count = nc;
+        gather_range(d, map->core_voltage_start, nc, MOFF(core_voltages));
+    }
+
+    d->vid_idx          = map->vid_idx;
+    d->ppt_idx          = map->ppt_idx;
+    d->socket_power_idx = map->socket_power_idx;
+
+    /* Raphael per-core clocks */
+    if (version == 0x540104 && count > 324) {
+        d->core_clocks_count = 8;
+        gather_range(d, 317, 8, MOFF(core_clocks_ghz));
+    } else if (version == 0x540004 && count > 356) {
+        d->core_clocks_count = 16;
+        gather_range(d, 341, 16, MOFF(core_clocks_ghz));
+    }
+}
+
+static pm_decoder_t *get_decoder(uint32_t version, int codename_index, int count)
+{
+    pm_decoder_t *d = &s_dec;
+    if (d->valid && d->version == version && d->codename_index == codename_index &&
+        d->count == count)
+        return d;
+
+    memset(d, 0, sizeof(*d));
+    d->version = version;
+    d->codename_index = codename_index;
+    d->count = count;
+    d->iod_idx = d->vid_idx = d->ppt_idx = d->socket_power_idx = -1;
+    d->tdie_a_idx = d->tdie_b_idx = -1;
+    d->power   = (pm_scan_t)SCAN_INIT(PWR_CANDS,  0.5f, 400.0f);
+    d->current = (pm_scan_t)SCAN_INIT(CUR_CANDS,  0.5f, 200.0f);
+    d->temp    = (pm_scan_t)SCAN_INIT(TEMP_CANDS, 1.0f, 150.0f);
+    d->ppt     = (pm_scan_t)SCAN_INIT(PPT_CANDS,  0.5f, 400.0f);
+
+    if (codename_index == 23)
+        resolve_granite_ridge(d);
+    else
+        resolve_family(d, version);
+
+    d->valid = 1;
+    return d;
 }
 
-static float try_plausible_temp(const float *t, int count)
+/* First in-range candidate in priority order */
+static float scan_plausible(const pm_scan_t *s, const float *t, int count)
 {
-    int candidates[] = {1, 448, 449};
-    for (int i = 0; i < 3; i++) {
-        float v = safe_get(t, count, candidates[i]);
-        if (v >= 1.0f && v <= 150.0f) return v;
+    for (int i = 0; i < s->n; i++) {
+        float v = safe_get(t, count, s->cands[i]);
+        if (v >= s->lo && v <= s->hi) return v;
     }
     return 0.0f;
 }
@@ -279,122 +410,66 @@ static void compute_core_clock_from_clocks(smu_metrics_t *m)
         m->core_clock_mhz = max_ghz * 1000.0f;
 }
 
-/* Read known PM table indices for PPT, core temps, core clocks, VID, core voltages */
-static void read_known_indices(const float *t, int count, smu_metrics_t *m)
+void pm_table_read(uint32_t version, const float *table, int count,
+                   int codename_index, smu_metrics_t *out)
 {
-    /* PPT: try several candidates */
-    int ppt_cands[] = {3, 1, 13, 29, 5, 38};
-    for (int i = 0; i < 6; i++) {
-        float v = safe_get(t, count, ppt_cands[i]);
-        if (v >= 0.5f && v <= 400.0f) { m->ppt_w = v; break; }
-    }
-
-    /* Core temps (indices 317-324) */
-    if (count > 324) {
-        m->core_temps_count = 8;
-        for (int i = 0; i < 8; i++)
-            m->core_temps_c[i] = t[317 + i];
-    }
-
-    /* Tdie (indices 448-449) */
-    if (count > 449) {
-        float a = t[448], b = t[449];
-        if (a >= 1.0f && a <= 150.0f) { m->tdie_c = a; m->has_tdie = true; }
-        else if (b >= 1.0f && b <= 150.0f) { m->tdie_c = b; m->has_tdie = true; }
-        else if (a > 0 && b > 0) { m->tdie_c = (a + b) * 0.5f; m->has_tdie = true; }
-    }
-
-    /* Core clocks GHz (indices 325-340) */
-    if (count > 340) {
-        m->core_clocks_count = 16;
-        for (int i = 0; i < 16; i++)
-            m->core_clocks_ghz[i] = t[325 + i];
-    }
+    memset(out, 0, sizeof(*out));
+    if (!table || count < 4) return;
 
-    /* VID (index 275) */
-    if (count > 275)
-        m->vid = t[275];
+    pthread_mutex_lock(&s_dec_lock);
+    pm_decoder_t *d = get_decoder(version, codename_index, count);
 
-    /* Core voltages (indices 309-316) */
-    if (count > 316) {
-        m->core_voltages_count = 8;
-        for (int i = 0; i < 8; i++)
-            m->core_voltages[i] = t[309 + i];
-    }
+    /* Straight gather of every unconditional field */
+    char *base = (char *)out;
+    for (int i = 0; i < d->gather_count; i++)
+        memcpy(base + d->gather[i].offset, &table[d->gather[i].index], sizeof(float));
+    out->core_temps_count    = d->core_temps_count;
+    out->core_voltages_count = d->core_voltages_count;
+    out->core_clocks_count   = d->core_clocks_count;
 
-    /* IOD hotspot (index 11) */
-    if (count > 11) {
-        float v = t[11];
+    /* IOD hotspot — only plausible readings */
+    if (d->iod_idx >= 0) {
+        float v = safe_get(table, count, d->iod_idx);
         if (v >= 1.0f && v <= 150.0f) {
-            m->iod_hotspot_c = v;
-            m->has_iod_hotspot = true;
+            out->iod_hotspot_c = v;
+            out->has_iod_hotspot = true;
         }
     }
-}
 
-void pm_table_read(uint32_t version, const float *table, int count,
-                   int codename_index, smu_metrics_t *out)
-{
-    memset(out, 0, sizeof(*out));
-    if (!table || count < 4) return;
+    if (d->granite_ridge) {
+        out->ppt_w = scan_plausible(&d->ppt, table, count);
 
-    if (codename_index == 23) {
-        /* Granite Ridge: use byte-offset based reading */
-        read_granite_ridge_offsets(table, count, out);
-        read_known_indices(table, count, out);
+        if (d->tdie_a_idx >= 0) {
+            float a = table[d->tdie_a_idx], b = table[d->tdie_b_idx];
+            if (a >= 1.0f && a <= 150.0f) { out->tdie_c = a; out->has_tdie = true; }
+            else if (b >= 1.0f && b <= 150.0f) { out->tdie_c = b; out->has_tdie = true; }
+            else if (a > 0 && b > 0) { out->tdie_c = (a + b) * 0.5f; out->has_tdie = true; }
+        }
 
-        out->package_power_w = try_plausible_power(table, count);
-        out->package_current_a = try_plausible_current(table, count);
+        out->package_power_w = scan_plausible(&d->power, table, count);
+        out->package_current_a = scan_plausible(&d->current, table, count);
 
         if (out->has_tdie && out->tdie_c > 0)
             out->cpu_temp_c = out->tdie_c;
         else
-            out->cpu_temp_c = try_plausible_temp(table, count);
+            out->cpu_temp_c = scan_plausible(&d->temp, table, count);
     } else {
-        /* Generic: use version-based family map for named entries,
-         * plus fallback heuristics for power/temp/clock */
-        const pm_family_map_t *map = get_family_map(version);
-        apply_named(map, table, count, out);
-
-        /* Per-family core temps and voltages */
-        int nc = map->max_cores;
-        if (nc > MAX_CORES) nc = MAX_CORES;
-        if (map->core_temp_start + nc <= count) {
-            out->core_temps_count = nc;
-            for (int i = 0; i < nc; i++)
-                out->core_temps_c[i] = table[map->core_temp_start + i];
-        }
-        if (map->core_voltage_start + nc <= count) {
-            out->core_voltages_count = nc;
-            for (int i = 0; i < nc; i++)
-                out->core_voltages[i] = table[map->core_voltage_start + i];
-        }
-
-        float v = safe_get(table, count, map->vid_idx);
+        float v = safe_get(table, count, d->vid_idx);
         if (v > 0) out->vid = v;
 
-        float ppt_v = safe_get(table, count, map->ppt_idx);
+        float ppt_v = safe_get(table, count, d->ppt_idx);
         if (ppt_v >= 0.5f && ppt_v <= 400.0f) out->ppt_w = ppt_v;
 
-        float sp = safe_get(table, count, map->socket_power_idx);
+        float sp = safe_get(table, count, d->socket_power_idx);
         if (sp >= 0.5f && sp <= 400.0f) out->package_power_w = sp;
-        else out->package_power_w = try_plausible_power(table, count);
-
-        out->package_current_a = try_plausible_current(table, count);
-        out->cpu_temp_c = try_plausible_temp(table, count);
-
-        /* Raphael per-core clocks */
-        if (version == 0x540104 && count > 324) {
-            out->core_clocks_count = 8;
-            for (int i = 0; i < 8; i++)
-                out->core_clocks_ghz[i] = table[317 + i];
-        } else if (version == 0x540004 && count > 356) {
-            out->core_clocks_count = 16;
-            for (int i = 0; i < 16; i++)
-                out->core_clocks_ghz[i] = table[341 + i];
-        }
+        else out->package_power_w = scan_plausible(&d->power, table, count);
+
+        out->package_current_a = scan_plausible(&d->current, table, count);
+        out->cpu_temp_c = scan_plausible(&d->temp, table, count);
     }
 
+    pthread_mutex_unlock(&s_dec_lock);
+
     /* Shared aggregation: derive core_clock_mhz from per-core clocks for all families */
     compute_core_clock_from_clocks(out);
 }
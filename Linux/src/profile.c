@@ -0,0 +1,282 @@
+/*
+ * profile.c — Stage timers, per-tick syscall and allocation counters
+ */
+
+#define _GNU_SOURCE
+#include "profile.h"
+#include "smu.h"
+#include "util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static atomic_int      s_on;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+    uint32_t ns[PROF_WINDOW];           /* durations, saturated at ~4.3 s */
+    uint32_t sys[PROF_WINDOW];          /* tick stages only */
+    uint32_t alloc[PROF_WINDOW];
+    unsigned head, n;
+    uint64_t total;                     /* samples ever recorded */
+    int      counted;                   /* tick stage with syscall counts */
+} prof_ring_t;
+
+static prof_ring_t s_ring[PROF_COUNT];  /* guarded by s_lock */
+
+static const char *const s_names[PROF_COUNT] = {
+    [PROF_PM_READ]   = "PM table read",
+    [PROF_PM_DECODE] = "PM decode",
+    [PROF_SMN]       = "SMN timings",
+    [PROF_HWMON]     = "hwmon",
+    [PROF_PROC_STAT] = "/proc/stat",
+    [PROF_CPUFREQ]   = "cpufreq",
+    [PROF_AOD]       = "AOD voltages",
+    [PROF_TICK]      = "sampler tick",
+    [PROF_UI]        = "UI refresh",
+};
+
+static long long mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/* ── Allocation counter ─────────────────────────────────────────────── */
+
+/* The app links with -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc, so
+ * only calls from its own objects land here; the allocator itself (glibc,
+ * musl, ASan, jemalloc) and the allocations GLib/GTK make internally are
+ * untouched.  Counted only once profile_enable() has run. */
+void *__real_malloc(size_t n);
+void *__real_calloc(size_t n, size_t sz);
+void *__real_realloc(void *p, size_t n);
+
+static __thread unsigned long t_allocs;
+
+static inline void count_alloc(void)
+{
+    if (atomic_load_explicit(&s_on, memory_order_relaxed)) t_allocs++;
+}
+
+void *__wrap_malloc(size_t n)            { count_alloc(); return __real_malloc(n); }
+void *__wrap_calloc(size_t n, size_t sz) { count_alloc(); return __real_calloc(n, sz); }
+void *__wrap_realloc(void *p, size_t n)  { count_alloc(); return __real_realloc(p, n); }
+
+/* ── Syscall counter ────────────────────────────────────────────────── */
+
+enum { SYS_NONE, SYS_TRACEPOINT, SYS_PROC_IO };
+
+static atomic_int  s_sys_mode = SYS_NONE;   /* best mode any thread got */
+static __thread int t_sys_fd  = -2;         /* -2 = not opened yet */
+static __thread int t_sys_how = SYS_NONE;
+
+static int tracepoint_id(void)
+{
+    static const char *const paths[] = {
+        "/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+        "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id",
+        NULL
+    };
+    for (int i = 0; paths[i]; i++) {
+        int id = read_int_file(paths[i]);
+        if (id > 0) return id;
+    }
+    return -1;
+}
+
+static void sys_counter_open(void)
+{
+    int id = tracepoint_id();
+    if (id > 0) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type   = PERF_TYPE_TRACEPOINT;
+        attr.size   = sizeof(attr);
+        attr.config = (uint64_t)id;
+        int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (fd >= 0) {
+            t_sys_fd  = fd;
+            t_sys_how = SYS_TRACEPOINT;
+            atomic_store(&s_sys_mode, SYS_TRACEPOINT);
+            return;
+        }
+    }
+    t_sys_fd = open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
+    if (t_sys_fd >= 0) {
+        t_sys_how = SYS_PROC_IO;
+        int expect = SYS_NONE;
+        atomic_compare_exchange_strong(&s_sys_mode, &expect, SYS_PROC_IO);
+    }
+}
+
+/* Syscalls made by the calling thread so far, counting this read itself;
+ * -1 if unavailable.  Deltas of two reads include exactly one read. */
+static long long sys_count(void)
+{
+    if (t_sys_fd == -2) sys_counter_open();
+    if (t_sys_fd < 0) return -1;
+
+    if (t_sys_how == SYS_TRACEPOINT) {
+        uint64_t v;
+        return read(t_sys_fd, &v, sizeof(v)) == (ssize_t)sizeof(v) ? (long long)v : -1;
+    }
+    char buf[512];
+    ssize_t n = pread(t_sys_fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    long long r = 0, w = 0;
+    const char *p = strstr(buf, "syscr:");
+    if (p) r = strtoll(p + 6, NULL, 10);
+    p = strstr(buf, "syscw:");
+    if (p) w = strtoll(p + 6, NULL, 10);
+    return r + w;
+}
+
+/* ── Recording ──────────────────────────────────────────────────────── */
+
+void profile_enable(void)  { atomic_store(&s_on, 1); }
+int  profile_enabled(void) { return atomic_load_explicit(&s_on, memory_order_relaxed); }
+
+long long prof_begin(void)
+{
+    return profile_enabled() ? mono_ns() : 0;
+}
+
+static uint32_t sat32(long long v)
+{
+    return v <= 0 ? 0 : v >= UINT32_MAX ? UINT32_MAX : (uint32_t)v;
+}
+
+static void record(prof_stage_t stage, long long ns, long long sys, long long allocs)
+{
+    prof_ring_t *r = &s_ring[stage];
+    pthread_mutex_lock(&s_lock);
+    r->ns[r->head]    = sat32(ns);
+    r->sys[r->head]   = sat32(sys);
+    r->alloc[r->head] = sat32(allocs);
+    r->head = (r->head + 1) % PROF_WINDOW;
+    if (r->n < PROF_WINDOW) r->n++;
+    r->total++;
+    if (sys >= 0) r->counted = 1;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void prof_end(prof_stage_t stage, long long t0)
+{
+    if (!t0 || stage >= PROF_COUNT) return;
+    record(stage, mono_ns() - t0, -1, 0);
+}
+
+void prof_tick_begin(prof_tick_t *t)
+{
+    t->t0 = 0;
+    if (!profile_enabled()) return;
+    t->sys0   = sys_count();
+    t->alloc0 = t_allocs;
+    t->t0     = mono_ns();
+}
+
+void prof_tick_end(prof_stage_t stage, const prof_tick_t *t)
+{
+    if (!t->t0 || stage >= PROF_COUNT) return;
+    long long ns     = mono_ns() - t->t0;
+    long long allocs = (long long)(t_allocs - t->alloc0);
+    long long sys    = -1;
+    if (t->sys0 >= 0) {
+        long long now = sys_count();
+        if (now >= t->sys0) sys = now - t->sys0 - 1;   /* minus our own read */
+    }
+    record(stage, ns, sys, allocs);
+}
+
+/* ── Report ─────────────────────────────────────────────────────────── */
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of a sorted window */
+static uint32_t pct(const uint32_t *sorted, unsigned n, unsigned p)
+{
+    unsigned k = (n * p + 99) / 100;
+    return sorted[k ? k - 1 : 0];
+}
+
+static double mean_u32(const uint32_t *v, unsigned n)
+{
+    double s = 0;
+    for (unsigned i = 0; i < n; i++) s += v[i];
+    return n ? s / n : 0;
+}
+
+size_t profile_format(char *buf, size_t sz)
+{
+    size_t off = 0;
+#define OUT(fmt, ...) \
+    do { if (off < sz) off += (size_t)snprintf(buf + off, sz - off, fmt, ##__VA_ARGS__); } while (0)
+
+    if (sz) buf[0] = '\0';
+    if (!profile_enabled()) {
+        OUT("Profiling is off — start with --profile\n");
+        return off < sz ? off : sz;
+    }
+
+    int mode = atomic_load(&s_sys_mode);
+    OUT("Refresh pipeline, last %d samples per stage (CLOCK_MONOTONIC)\n", PROF_WINDOW);
+    OUT("syscalls: %s\n\n",
+        mode == SYS_TRACEPOINT ? "raw_syscalls:sys_enter, all syscalls" :
+        mode == SYS_PROC_IO    ? "/proc/thread-self/io, read/write family only" :
+                                 "unavailable");
+    OUT("%-15s %8s %10s %10s %10s %10s %11s\n",
+        "Stage", "samples", "p50 µs", "p99 µs", "max µs", "sys/tick", "alloc/tick");
+
+    for (int s = 0; s < PROF_COUNT; s++) {
+        uint32_t sorted[PROF_WINDOW];
+        prof_ring_t r;
+        pthread_mutex_lock(&s_lock);
+        r = s_ring[s];
+        pthread_mutex_unlock(&s_lock);
+
+        if (r.n == 0) {
+            OUT("%-15s %8s\n", s_names[s], "—");
+            continue;
+        }
+        memcpy(sorted, r.ns, r.n * sizeof(uint32_t));
+        qsort(sorted, r.n, sizeof(uint32_t), cmp_u32);
+        OUT("%-15s %8llu %10.1f %10.1f %10.1f",
+            s_names[s], (unsigned long long)r.total,
+            pct(sorted, r.n, 50) / 1e3, pct(sorted, r.n, 99) / 1e3,
+            sorted[r.n - 1] / 1e3);
+        if (s == PROF_TICK || s == PROF_UI) {
+            if (r.counted) OUT(" %10.1f", mean_u32(r.sys, r.n));
+            else           OUT(" %10s", "—");
+            OUT(" %11.1f\n", mean_u32(r.alloc, r.n));
+        } else {
+            OUT("\n");
+        }
+    }
+
+    smu_stats_t st;
+    smu_get_stats(&st);
+    OUT("\nSMU access\n");
+    OUT("  pm_table requests  %llu\n", (unsigned long long)st.pm_requests);
+    OUT("  pm_table reads     %llu (%.0f%% coalesced)\n", (unsigned long long)st.pm_reads,
+        st.pm_requests ? 100.0 * (double)(st.pm_requests - st.pm_reads) / (double)st.pm_requests : 0.0);
+    OUT("  unchanged tables   %llu\n", (unsigned long long)st.pm_unchanged);
+    OUT("  SMN batches        %llu (%llu registers)\n",
+        (unsigned long long)st.smn_batches, (unsigned long long)st.smn_regs);
+#undef OUT
+    return off < sz ? off : sz;
+}
@@ -0,0 +1,61 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stddef.h>
+
+/*
+ * Self-profiling of the refresh pipeline (--profile).
+ *
+ * Each stage keeps its last PROF_WINDOW CLOCK_MONOTONIC durations; a report
+ * gives rolling p50/p99/max per stage.  Tick stages (a whole sampler tick,
+ * one UI refresh) also count the syscalls and allocations made by the
+ * calling thread between prof_tick_begin() and prof_tick_end():
+ *
+ *   syscalls     raw_syscalls:sys_enter as a per-thread perf counter when
+ *                tracefs is available, else /proc/thread-self/io syscr +
+ *                syscw (read/write-family calls only)
+ *   allocations  malloc/calloc/realloc calls from the app's own code on
+ *                the thread (wrapped at link time; GLib/GTK-internal
+ *                allocations are not seen)
+ *
+ * Everything is a no-op until profile_enable().
+ */
+
+typedef enum {
+    PROF_PM_READ,       /* smu_pm_acquire: coalesced pread of pm_table */
+    PROF_PM_DECODE,     /* pm_table_read decode (only when the table changed) */
+    PROF_SMN,           /* DRAM timing SMN batch (only when re-read) */
+    PROF_HWMON,         /* hwmon rediscovery, temps and fans */
+    PROF_PROC_STAT,     /* /proc/stat per-CPU usage */
+    PROF_CPUFREQ,       /* scaling_cur_freq per CPU */
+    PROF_AOD,           /* aod_voltages snapshot */
+    PROF_TICK,          /* whole full-snapshot sampler tick */
+    PROF_UI,            /* refresh_ui() on the GTK thread */
+    PROF_COUNT
+} prof_stage_t;
+
+#define PROF_WINDOW 256
+
+typedef struct {
+    long long t0;
+    long long sys0;     /* -1 if syscalls cannot be counted */
+    unsigned long alloc0;
+} prof_tick_t;
+
+/* Turn the counters on; call before any thread that is profiled starts. */
+void profile_enable(void);
+int  profile_enabled(void);
+
+/* Time one stage: t0 = prof_begin(), then prof_end(stage, t0). */
+long long prof_begin(void);
+void      prof_end(prof_stage_t stage, long long t0);
+
+/* Time a tick stage and count its syscalls and allocations. */
+void prof_tick_begin(prof_tick_t *t);
+void prof_tick_end(prof_stage_t stage, const prof_tick_t *t);
+
+/* Text report: one row per stage, then the SMU access counters.  Returns
+ * the length written (truncated to sz). */
+size_t profile_format(char *buf, size_t sz);
+
+#endif /* PROFILE_H */
@@ -0,0 +1,682 @@
+/*
+ * results.c — Saved benchmark results and baseline comparison
+ *
+ * A record is written as JSON from the field tables below and read back
+ * through the same tables: the parser flattens the document into dotted
+ * keys ("dram.tcl", "bench.stats.lat_dram.p99") and each field looks
+ * itself up, so adding a field is one table row.
+ */
+
+#define _GNU_SOURCE
+#include "results.h"
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RESULTS_FORMAT "tuxtimings-results"
+
+/* ── Field tables ───────────────────────────────────────────────────── */
+
+enum { F_STR, F_INT, F_U32, F_ULONG, F_BOOL, F_FLOAT, F_DOUBLE };
+
+typedef struct {
+    const char *key;
+    const char *label;    /* name in the comparison view */
+    int         type;
+    size_t      off;      /* into results_record_t */
+    size_t      size;     /* F_STR buffer size     */
+} rfield_t;
+
+#define RF(sec, t, f, lbl) \
+    { #f, lbl, t, offsetof(results_record_t, sec f), sizeof(((results_record_t *)0)->sec f) }
+
+static const rfield_t sys_fields[] = {
+    RF(, F_STR,   cpu,          "CPU"),
+    RF(, F_STR,   board,        "Board"),
+    RF(, F_STR,   bios,         "BIOS"),
+    RF(, F_STR,   agesa,        "AGESA"),
+    RF(, F_FLOAT, mem_mts,      "Memory MT/s"),
+    RF(, F_FLOAT, fclk_mhz,     "FCLK"),
+    RF(, F_FLOAT, uclk_mhz,     "UCLK"),
+    RF(, F_FLOAT, mclk_mhz,     "MCLK"),
+    RF(, F_FLOAT, vsoc,         "VSOC"),
+    RF(, F_FLOAT, mem_vdd,      "MEM VDD"),
+    RF(, F_FLOAT, mem_vddq,     "MEM VDDQ"),
+    RF(, F_INT,   module_count, "DIMMs"),
+};
+
+static const rfield_t dram_fields[] = {
+    RF(dram., F_U32,   tcl,      "tCL"),
+    RF(dram., F_U32,   trcd_rd,  "tRCDRD"),
+    RF(dram., F_U32,   trcd_wr,  "tRCDWR"),
+    RF(dram., F_U32,   trp,      "tRP"),
+    RF(dram., F_U32,   tras,     "tRAS"),
+    RF(dram., F_U32,   trc,      "tRC"),
+    RF(dram., F_U32,   trrds,    "tRRDS"),
+    RF(dram., F_U32,   trrdl,    "tRRDL"),
+    RF(dram., F_U32,   tfaw,     "tFAW"),
+    RF(dram., F_U32,   twr,      "tWR"),
+    RF(dram., F_U32,   tcwl,     "tCWL"),
+    RF(dram., F_U32,   rfc,      "tRFC"),
+    RF(dram., F_U32,   rfc2,     "tRFC2"),
+    RF(dram., F_U32,   rfcsb,    "tRFCsb"),
+    RF(dram., F_U32,   rtp,      "tRTP"),
+    RF(dram., F_U32,   wtrs,     "tWTRS"),
+    RF(dram., F_U32,   wtrl,     "tWTRL"),
+    RF(dram., F_U32,   rdwr,     "tRDWR"),
+    RF(dram., F_U32,   wrrd,     "tWRRD"),
+    RF(dram., F_U32,   rdrd_sc,  "tRDRDSC"),
+    RF(dram., F_U32,   rdrd_sd,  "tRDRDSD"),
+    RF(dram., F_U32,   rdrd_dd,  "tRDRDDD"),
+    RF(dram., F_U32,   wrwr_sc,  "tWRWRSC"),
+    RF(dram., F_U32,   wrwr_sd,  "tWRWRSD"),
+    RF(dram., F_U32,   wrwr_dd,  "tWRWRDD"),
+    RF(dram., F_U32,   refi,     "tREFI"),
+    RF(dram., F_U32,   wrpre,    "tWRPRE"),
+    RF(dram., F_U32,   rdpre,    "tRDPRE"),
+    RF(dram., F_U32,   rdrd_scl, "tRDRDSCL"),
+    RF(dram., F_U32,   wrwr_scl, "tWRWRSCL"),
+    RF(dram., F_U32,   cke,      "tCKE"),
+    RF(dram., F_U32,   xp,       "tXP"),
+    RF(dram., F_U32,   trc_page, "tTRCPAGE"),
+    RF(dram., F_U32,   mod,      "tMOD"),
+    RF(dram., F_U32,   mod_pda,  "tMODPDA"),
+    RF(dram., F_U32,   mrd,      "tMRD"),
+    RF(dram., F_U32,   mrd_pda,  "tMRDPDA"),
+    RF(dram., F_U32,   stag,     "tSTAG"),
+    RF(dram., F_U32,   stag_sb,  "tSTAGsb"),
+    RF(dram., F_U32,   phy_wrl,  "tPHYWRL"),
+    RF(dram., F_U32,   phy_rdl,  "tPHYRDL"),
+    RF(dram., F_U32,   phy_wrd,  "tPHYWRD"),
+    RF(dram., F_FLOAT, trfc_ns,  "tRFC (ns)"),
+    RF(dram., F_FLOAT, trefi_ns, "tREFI (ns)"),
+    RF(dram., F_BOOL,  gdm_enabled,        "GDM"),
+    RF(dram., F_BOOL,  power_down_enabled, "Power down"),
+    RF(dram., F_STR,   cmd2t,    "Cmd2T"),
+};
+
+static const rfield_t bench_fields[] = {
+    RF(bench., F_DOUBLE, lat_l1_ns,    "L1 latency"),
+    RF(bench., F_DOUBLE, lat_l2_ns,    "L2 latency"),
+    RF(bench., F_DOUBLE, lat_l3_ns,    "L3 latency"),
+    RF(bench., F_DOUBLE, lat_dram_ns,  "DRAM latency"),
+    RF(bench., F_DOUBLE, bw_read_mbs,  "Read"),
+    RF(bench., F_DOUBLE, bw_write_mbs, "Write"),
+    RF(bench., F_DOUBLE, bw_copy_mbs,  "Copy"),
+};
+
+/* How the suite ran — reported as changes, not deltas */
+static const rfield_t bench_cfg_fields[] = {
+    RF(bench., F_INT,    kernel,       "Kernel module"),
+    RF(bench., F_INT,    bw_kernel,    "Store strategy"),
+    RF(bench., F_INT,    pf_dist,      "Prefetch"),
+    RF(bench., F_INT,    bw_avx512,    "AVX-512"),
+};
+
+static const rfield_t pi_fields[] = {
+    RF(pi., F_INT,    n_digits,       "Pi digits"),
+    RF(pi., F_DOUBLE, time_sec,       "Pi time"),
+    RF(pi., F_DOUBLE, digits_per_sec, "Pi digits/s"),
+    RF(pi., F_DOUBLE, series_sec,     "Pi series"),
+    RF(pi., F_DOUBLE, split_sec,      "Pi split"),
+    RF(pi., F_DOUBLE, merge_sec,      "Pi merge"),
+    RF(pi., F_DOUBLE, sqrt_sec,       "Pi sqrt"),
+    RF(pi., F_DOUBLE, div_sec,        "Pi division"),
+    RF(pi., F_ULONG,  peak_rss_kb,    "Pi peak RSS"),
+};
+
+#define NFIELDS(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+/* JSON keys of bench_results_t.stats[] */
+static const char *test_keys[BENCH_NR_TESTS] = {
+    "lat_l1", "lat_l2", "lat_l3", "lat_dram", "bw_read", "bw_write", "bw_copy"
+};
+
+/* ── Snapshot ───────────────────────────────────────────────────────── */
+
+#define COPY_STR(dst, src) snprintf(dst, sizeof(dst), "%s", src)
+
+void results_snapshot(results_record_t *r, const system_summary_t *s)
+{
+    const smu_metrics_t *m = &s->dyn.metrics;
+
+    COPY_STR(r->cpu,   s->cpu.name);
+    COPY_STR(r->board, s->board.motherboard);
+    COPY_STR(r->bios,  s->board.bios_version);
+    COPY_STR(r->agesa, s->board.agesa_version);
+    r->mem_mts  = s->memory.frequency;
+    r->fclk_mhz = m->fclk_mhz;
+    r->uclk_mhz = m->uclk_mhz;
+    r->mclk_mhz = m->mclk_mhz;
+    r->vsoc     = m->vsoc;
+    r->mem_vdd  = m->mem_vdd;
+    r->mem_vddq = m->mem_vddq;
+
+    r->module_count = s->module_count < MAX_MODULES ? s->module_count : MAX_MODULES;
+    for (int i = 0; i < r->module_count; i++)
+        COPY_STR(r->part_number[i], s->modules[i].part_number);
+    r->dram = s->dram;
+}
+
+/* ── Writer ─────────────────────────────────────────────────────────── */
+
+static void json_str(FILE *f, const char *s)
+{
+    fputc('"', f);
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\')  fprintf(f, "\\%c", c);
+        else if (c == '\n')         fputs("\\n", f);
+        else if (c < 0x20)          fprintf(f, "\\u%04x", c);
+        else                        fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+static void json_num(FILE *f, double v, int prec)
+{
+    if (isfinite(v)) fprintf(f, "%.*g", prec, v);
+    else             fputs("null", f);
+}
+
+static void write_field(FILE *f, const rfield_t *fd, const results_record_t *r)
+{
+    const char *p = (const char *)r + fd->off;
+
+    fprintf(f, "\"%s\": ", fd->key);
+    switch (fd->type) {
+    case F_STR:    json_str(f, p);                                   break;
+    case F_INT:    fprintf(f, "%d", *(const int *)p);                break;
+    case F_U32:    fprintf(f, "%u", *(const uint32_t *)p);           break;
+    case F_ULONG:  fprintf(f, "%lu", *(const unsigned long *)p);     break;
+    case F_BOOL:   fputs(*(const bool *)p ? "true" : "false", f);    break;
+    case F_FLOAT:  json_num(f, *(const float *)p, 7);                break;
+    case F_DOUBLE: json_num(f, *(const double *)p, 10);              break;
+    }
+}
+
+static void write_fields(FILE *f, const rfield_t *fd, int n, const results_record_t *r)
+{
+    for (int i = 0; i < n; i++) {
+        fputs(i ? ",\n    " : "    ", f);
+        write_field(f, &fd[i], r);
+    }
+}
+
+int results_write(const results_record_t *r, const char *path)
+{
+    /* Write beside the target and rename, so a crash never leaves a
+     * truncated baseline behind */
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "w");
+    if (!f) return -1;
+
+    fprintf(f, "{\n  \"format\": \"%s\",\n  \"version\": %d,\n  \"time\": %lld,\n",
+            RESULTS_FORMAT, RESULTS_VERSION, r->time);
+
+    fputs("  \"system\": {\n", f);
+    write_fields(f, sys_fields, NFIELDS(sys_fields), r);
+    fputs(",\n    \"dimms\": [", f);
+    for (int i = 0; i < r->module_count; i++) {
+        if (i) fputs(", ", f);
+        json_str(f, r->part_number[i]);
+    }
+    fputs("]\n  },\n", f);
+
+    fputs("  \"dram\": {\n", f);
+    write_fields(f, dram_fields, NFIELDS(dram_fields), r);
+    fputs("\n  }", f);
+
+    if (r->has_bench) {
+        fputs(",\n  \"bench\": {\n", f);
+        write_fields(f, bench_fields, NFIELDS(bench_fields), r);
+        fputs(",\n", f);
+        write_fields(f, bench_cfg_fields, NFIELDS(bench_cfg_fields), r);
+        fputs(",\n    \"stats\": {", f);
+        for (int t = 0; t < BENCH_NR_TESTS; t++) {
+            const bench_stats_t *st = &r->bench.stats[t];
+            fprintf(f, "%s\n      \"%s\": { \"n\": %d, \"min\": ", t ? "," : "",
+                    test_keys[t], st->nsamples);
+            json_num(f, st->min, 10);     fputs(", \"median\": ", f);
+            json_num(f, st->median, 10);  fputs(", \"p99\": ", f);
+            json_num(f, st->p99, 10);     fputs(", \"max\": ", f);
+            json_num(f, st->max, 10);     fputs(", \"mean\": ", f);
+            json_num(f, st->mean, 10);    fputs(", \"stddev\": ", f);
+            json_num(f, st->stddev, 10);  fputs(" }", f);
+        }
+        fputs("\n    }\n  }", f);
+    }
+    if (r->has_pi) {
+        fputs(",\n  \"pi\": {\n", f);
+        write_fields(f, pi_fields, NFIELDS(pi_fields), r);
+        fputs("\n  }", f);
+    }
+    fputs("\n}\n", f);
+
+    if (fclose(f) != 0 || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
+
+/* ── Reader ─────────────────────────────────────────────────────────── */
+
+#define JSON_MAX_BYTES (1 << 20)
+#define JSON_MAX_DEPTH 8
+
+typedef struct {
+    char key[128];
+    char val[STR_LEN];
+} jkv_t;
+
+typedef struct {
+    const char *p;
+    jkv_t      *kv;
+    int         n, cap;
+} jparse_t;
+
+static void j_ws(jparse_t *j)
+{
+    while (*j->p == ' ' || *j->p == '\t' || *j->p == '\n' || *j->p == '\r')
+        j->p++;
+}
+
+/* Decodes into out (truncating); \u escapes outside ASCII become '?' */
+static int j_string(jparse_t *j, char *out, size_t sz)
+{
+    size_t n = 0;
+
+    if (*j->p != '"') return -1;
+    j->p++;
+    while (*j->p && *j->p != '"') {
+        char c = *j->p++;
+        if (c == '\\') {
+            c = *j->p++;
+            switch (c) {
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case 'b': c = '\b'; break;
+            case 'f': c = '\f'; break;
+            case 'u': {
+                unsigned v = 0;
+                if (sscanf(j->p, "%4x", &v) != 1) return -1;
+                j->p += 4;
+                c = v < 0x80 ? (char)v : '?';
+                break;
+            }
+            case '\0': return -1;
+            default: break;               /* \" \\ \/ */
+            }
+        }
+        if (n + 1 < sz) out[n++] = c;
+    }
+    if (*j->p != '"') return -1;
+    j->p++;
+    out[n] = '\0';
+    return 0;
+}
+
+static int j_put(jparse_t *j, const char *key, const char *val)
+{
+    if (j->n == j->cap) {
+        int cap = j->cap ? j->cap * 2 : 256;
+        jkv_t *kv = realloc(j->kv, cap * sizeof(*kv));
+        if (!kv) return -1;
+        j->kv = kv;
+        j->cap = cap;
+    }
+    snprintf(j->kv[j->n].key, sizeof(j->kv[j->n].key), "%s", key);
+    snprintf(j->kv[j->n].val, sizeof(j->kv[j->n].val), "%s", val);
+    j->n++;
+    return 0;
+}
+
+static int j_value(jparse_t *j, const char *key, int depth)
+{
+    char sub[128], buf[STR_LEN];
+
+    if (depth > JSON_MAX_DEPTH) return -1;
+    j_ws(j);
+
+    if (*j->p == '{' || *j->p == '[') {
+        int obj = *j->p == '{';
+        char close = obj ? '}' : ']';
+        j->p++;
+        j_ws(j);
+        for (int i = 0; *j->p != close; i++) {
+            if (obj) {
+                char name[32];
+                if (j_string(j, name, sizeof(name)) < 0) return -1;
+                j_ws(j);
+                if (*j->p++ != ':') return -1;
+                snprintf(sub, sizeof(sub), "%s%s%s", key, *key ? "." : "", name);
+            } else {
+                snprintf(sub, sizeof(sub), "%s.%d", key, i);
+            }
+            if (j_value(j, sub, depth + 1) < 0) return -1;
+            j_ws(j);
+            if (*j->p == ',') { j->p++; j_ws(j); }
+            else if (*j->p != close) return -1;
+        }
+        j->p++;
+        return 0;
+    }
+
+    if (*j->p == '"') {
+        if (j_string(j, buf, sizeof(buf)) < 0) return -1;
+        return j_put(j, key, buf);
+    }
+
+    /* number, true, false, null */
+    size_t n = strspn(j->p, "+-.0123456789eEtrufalsn");
+    if (n == 0 || n >= sizeof(buf)) return -1;
+    memcpy(buf, j->p, n);
+    buf[n] = '\0';
+    j->p += n;
+    return strcmp(buf, "null") == 0 ? 0 : j_put(j, key, buf);
+}
+
+static const char *j_get(const jparse_t *j, const char *key)
+{
+    for (int i = 0; i < j->n; i++)
+        if (strcmp(j->kv[i].key, key) == 0)
+            return j->kv[i].val;
+    return NULL;
+}
+
+static int j_has_prefix(const jparse_t *j, const char *prefix)
+{
+    size_t n = strlen(prefix);
+    for (int i = 0; i < j->n; i++)
+        if (strncmp(j->kv[i].key, prefix, n) == 0)
+            return 1;
+    return 0;
+}
+
+static void read_fields(const jparse_t *j, const char *sec, const rfield_t *fd, int n,
+                        results_record_t *r)
+{
+    char key[96];
+
+    for (int i = 0; i < n; i++) {
+        snprintf(key, sizeof(key), "%s.%s", sec, fd[i].key);
+        const char *v = j_get(j, key);
+        char *p = (char *)r + fd[i].off;
+        if (!v) continue;
+        switch (fd[i].type) {
+        case F_STR:    snprintf(p, fd[i].size, "%s", v);                 break;
+        case F_INT:    *(int *)p = (int)strtol(v, NULL, 10);             break;
+        case F_U32:    *(uint32_t *)p = (uint32_t)strtoul(v, NULL, 10);  break;
+        case F_ULONG:  *(unsigned long *)p = strtoul(v, NULL, 10);       break;
+        case F_BOOL:   *(bool *)p = strcmp(v, "true") == 0 || atoi(v);   break;
+        case F_FLOAT:  *(float *)p = strtof(v, NULL);                    break;
+        case F_DOUBLE: *(double *)p = strtod(v, NULL);                   break;
+        }
+    }
+}
+
+int results_read(const char *path, results_record_t *r)
+{
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    char *text = malloc(JSON_MAX_BYTES + 1);
+    size_t len = text ? fread(text, 1, JSON_MAX_BYTES, f) : 0;
+    fclose(f);
+    if (!text) return -1;
+    text[len] = '\0';
+
+    jparse_t j = { .p = text };
+    int rc = j_value(&j, "", 0);
+    const char *fmt = j_get(&j, "format");
+    const char *ver = j_get(&j, "version");
+    if (rc < 0 || !fmt || strcmp(fmt, RESULTS_FORMAT) != 0 ||
+        !ver || atoi(ver) < 1 || atoi(ver) > RESULTS_VERSION) {
+        free(j.kv);
+        free(text);
+        return -1;
+    }
+
+    memset(r, 0, sizeof(*r));
+    const char *t = j_get(&j, "time");
+    if (t) r->time = strtoll(t, NULL, 10);
+
+    read_fields(&j, "system", sys_fields, NFIELDS(sys_fields), r);
+    if (r->module_count > MAX_MODULES) r->module_count = MAX_MODULES;
+    if (r->module_count < 0)           r->module_count = 0;
+    for (int i = 0; i < r->module_count; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "system.dimms.%d", i);
+        const char *v = j_get(&j, key);
+        if (v) COPY_STR(r->part_number[i], v);
+    }
+    read_fields(&j, "dram", dram_fields, NFIELDS(dram_fields), r);
+
+    r->has_bench = j_has_prefix(&j, "bench.");
+    if (r->has_bench) {
+        read_fields(&j, "bench", bench_fields, NFIELDS(bench_fields), r);
+        read_fields(&j, "bench", bench_cfg_fields, NFIELDS(bench_cfg_fields), r);
+        for (int i = 0; i < BENCH_NR_TESTS; i++) {
+            bench_stats_t *st = &r->bench.stats[i];
+            static const char *names[] = { "n", "min", "median", "p99", "max", "mean", "stddev" };
+            double *dst[] = { NULL, &st->min, &st->median, &st->p99, &st->max,
+                              &st->mean, &st->stddev };
+            for (int k = 0; k < 7; k++) {
+                char key[96];
+                snprintf(key, sizeof(key), "bench.stats.%s.%s", test_keys[i], names[k]);
+                const char *v = j_get(&j, key);
+                if (!v) continue;
+                if (k == 0) st->nsamples = atoi(v);
+                else        *dst[k] = strtod(v, NULL);
+            }
+        }
+    }
+    r->has_pi = j_has_prefix(&j, "pi.");
+    if (r->has_pi)
+        read_fields(&j, "pi", pi_fields, NFIELDS(pi_fields), r);
+
+    free(j.kv);
+    free(text);
+    return 0;
+}
+
+/* ── Storage ────────────────────────────────────────────────────────── */
+
+/*
+ * We usually run as root through pkexec with the user's HOME forwarded;
+ * hand what we create under it back to the owner of HOME, or the next
+ * unprivileged edit of ~/.config fails.
+ */
+static void chown_like_home(const char *path)
+{
+    const char *home = getenv("HOME");
+    struct stat st;
+
+    if (geteuid() != 0 || !home || stat(home, &st) != 0 || st.st_uid == 0)
+        return;
+    if (chown(path, st.st_uid, st.st_gid) != 0) {
+        /* not fatal: the file is still usable by root */
+    }
+}
+
+static int mkdir_owned(const char *path)
+{
+    if (mkdir(path, 0755) == 0) {
+        chown_like_home(path);
+        return 0;
+    }
+    return errno == EEXIST ? 0 : -1;
+}
+
+int results_dir(char *buf, size_t sz)
+{
+    const char *xdg  = getenv("XDG_CONFIG_HOME");
+    const char *home = getenv("HOME");
+    char base[2048];
+
+    if (xdg && *xdg)
+        snprintf(base, sizeof(base), "%s", xdg);
+    else if (home && *home)
+        snprintf(base, sizeof(base), "%s/.config", home);
+    else
+        return -1;
+
+    if (mkdir_owned(base) < 0) return -1;
+    if ((size_t)snprintf(buf, sz, "%s/tuxtimings", base) >= sz) return -1;
+    return mkdir_owned(buf);
+}
+
+int results_save(const results_record_t *r, char *path, size_t sz)
+{
+    char dir[2560], stamp[32];
+    time_t t = r->time ? (time_t)r->time : time(NULL);
+    struct tm tm;
+
+    if (results_dir(dir, sizeof(dir)) < 0) return -1;
+    strncat(dir, "/results", sizeof(dir) - strlen(dir) - 1);
+    if (mkdir_owned(dir) < 0) return -1;
+
+    localtime_r(&t, &tm);
+    strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    snprintf(path, sz, "%s/%s.json", dir, stamp);
+    for (int i = 2; access(path, F_OK) == 0 && i < 100; i++)
+        snprintf(path, sz, "%s/%s-%d.json", dir, stamp, i);
+
+    if (results_write(r, path) < 0) return -1;
+    chown_like_home(path);
+    return 0;
+}
+
+static int baseline_path(char *path, size_t sz)
+{
+    char dir[2560];
+    if (results_dir(dir, sizeof(dir)) < 0) return -1;
+    return (size_t)snprintf(path, sz, "%s/baseline.json", dir) < sz ? 0 : -1;
+}
+
+int results_set_baseline(const results_record_t *r)
+{
+    char path[4096];
+    if (baseline_path(path, sizeof(path)) < 0 || results_write(r, path) < 0)
+        return -1;
+    chown_like_home(path);
+    return 0;
+}
+
+int results_load_baseline(results_record_t *r)
+{
+    char path[4096];
+    if (baseline_path(path, sizeof(path)) < 0) return -1;
+    return results_read(path, r);
+}
+
+/* ── Comparison ─────────────────────────────────────────────────────── */
+
+static void add_delta(results_diff_t *d, const char *name, const char *unit,
+                      double base, double cur, int higher_better)
+{
+    if (d->ndeltas >= RESULTS_MAX_DIFFS || base <= 0.0 || cur <= 0.0) return;
+
+    results_delta_t *e = &d->deltas[d->ndeltas++];
+    e->name      = name;
+    e->unit      = unit;
+    e->base      = base;
+    e->cur       = cur;
+    e->delta_pct = (cur - base) / base * 100.0;
+    e->better    = fabs(e->delta_pct) < RESULTS_NOISE_PCT ? 0
+                 : (e->delta_pct > 0) == higher_better ? 1 : -1;
+}
+
+static void add_change(results_diff_t *d, const char *name, const char *base, const char *cur)
+{
+    if (d->nchanges >= RESULTS_MAX_DIFFS) return;
+    results_change_t *c = &d->changes[d->nchanges++];
+    c->name = name;
+    snprintf(c->base, sizeof(c->base), "%s", base);
+    snprintf(c->cur,  sizeof(c->cur),  "%s", cur);
+}
+
+/* Settings that differ; floats within tol count as equal (clock jitter) */
+static void diff_fields(results_diff_t *d, const rfield_t *fd, int n,
+                        const results_record_t *a, const results_record_t *b)
+{
+    for (int i = 0; i < n; i++) {
+        const char *pa = (const char *)a + fd[i].off;
+        const char *pb = (const char *)b + fd[i].off;
+        char sa[48], sb[48];
+
+        switch (fd[i].type) {
+        case F_STR:
+            if (strcmp(pa, pb) == 0) continue;
+            snprintf(sa, sizeof(sa), "%s", pa);
+            snprintf(sb, sizeof(sb), "%s", pb);
+            break;
+        case F_INT:
+            if (*(const int *)pa == *(const int *)pb) continue;
+            snprintf(sa, sizeof(sa), "%d", *(const int *)pa);
+            snprintf(sb, sizeof(sb), "%d", *(const int *)pb);
+            break;
+        case F_U32:
+            if (*(const uint32_t *)pa == *(const uint32_t *)pb) continue;
+            snprintf(sa, sizeof(sa), "%u", *(const uint32_t *)pa);
+            snprintf(sb, sizeof(sb), "%u", *(const uint32_t *)pb);
+            break;
+        case F_BOOL:
+            if (*(const bool *)pa == *(const bool *)pb) continue;
+            snprintf(sa, sizeof(sa), "%s", *(const bool *)pa ? "on" : "off");
+            snprintf(sb, sizeof(sb), "%s", *(const bool *)pb ? "on" : "off");
+            break;
+        case F_FLOAT: {
+            float fa = *(const float *)pa, fb = *(const float *)pb;
+            float tol = fa < 10.0f ? 0.005f : 1.0f;   /* volts vs MHz / ns */
+            if (fabsf(fa - fb) < tol) continue;
+            snprintf(sa, sizeof(sa), fa < 10.0f ? "%.3f" : "%.0f", fa);
+            snprintf(sb, sizeof(sb), fb < 10.0f ? "%.3f" : "%.0f", fb);
+            break;
+        }
+        default:
+            continue;
+        }
+        add_change(d, fd[i].label, sa, sb);
+    }
+}
+
+void results_diff(const results_record_t *base, const results_record_t *cur,
+                  results_diff_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    if (base->has_bench && cur->has_bench) {
+        const bench_results_t *a = &base->bench, *b = &cur->bench;
+        add_delta(out, "L1",    "ns",   a->lat_l1_ns,    b->lat_l1_ns,    0);
+        add_delta(out, "L2",    "ns",   a->lat_l2_ns,    b->lat_l2_ns,    0);
+        add_delta(out, "L3",    "ns",   a->lat_l3_ns,    b->lat_l3_ns,    0);
+        add_delta(out, "DRAM",  "ns",   a->lat_dram_ns,  b->lat_dram_ns,  0);
+        add_delta(out, "Read",  "MB/s", a->bw_read_mbs,  b->bw_read_mbs,  1);
+        add_delta(out, "Write", "MB/s", a->bw_write_mbs, b->bw_write_mbs, 1);
+        add_delta(out, "Copy",  "MB/s", a->bw_copy_mbs,  b->bw_copy_mbs,  1);
+        /* A different method explains a delta better than any timing */
+        diff_fields(out, bench_cfg_fields, NFIELDS(bench_cfg_fields), base, cur);
+    }
+    if (base->has_pi && cur->has_pi && base->pi.n_digits == cur->pi.n_digits) {
+        add_delta(out, "Pi", "s", base->pi.time_sec, cur->pi.time_sec, 0);
+        add_delta(out, "Pi RSS", "MB", base->pi.peak_rss_kb / 1024.0,
+                  cur->pi.peak_rss_kb / 1024.0, 0);
+    }
+
+    diff_fields(out, sys_fields, NFIELDS(sys_fields), base, cur);
+    int nmod = base->module_count > cur->module_count ? base->module_count
+                                                      : cur->module_count;
+    for (int i = 0; i < nmod; i++)
+        if (strcmp(base->part_number[i], cur->part_number[i]) != 0)
+            add_change(out, "DIMM", base->part_number[i], cur->part_number[i]);
+    diff_fields(out, dram_fields, NFIELDS(dram_fields), base, cur);
+}
@@ -0,0 +1,89 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include "types.h"
+#include "bench.h"
+#include "pi_bench.h"
+#include <stddef.h>
+
+/*
+ * Saved benchmark results: the last memory-suite and pi runs of a session
+ * plus the system they ran on, as a versioned JSON file.  Files live in
+ * $XDG_CONFIG_HOME/tuxtimings (~/.config/tuxtimings): one per saved run
+ * under results/, and the comparison baseline in baseline.json.
+ *
+ * Readers accept any version up to RESULTS_VERSION; unknown keys are
+ * ignored and missing ones read as zero, so fields can be added without
+ * a bump — bump only when an existing key changes meaning.
+ */
+#define RESULTS_VERSION 1
+
+typedef struct {
+    long long time;                       /* unix seconds of the last run */
+
+    /* System snapshot */
+    char  cpu[STR_LEN];
+    char  board[STR_LEN];
+    char  bios[STR_LEN];
+    char  agesa[STR_LEN];
+    float mem_mts, fclk_mhz, uclk_mhz, mclk_mhz;
+    float vsoc, mem_vdd, mem_vddq;
+    int   module_count;
+    char  part_number[MAX_MODULES][STR_LEN];
+    dram_timings_t dram;
+
+    int             has_bench;
+    bench_results_t bench;
+    int             has_pi;
+    pi_results_t    pi;
+} results_record_t;
+
+/* Copy the system and DRAM configuration out of a sampler snapshot */
+void results_snapshot(results_record_t *r, const system_summary_t *s);
+
+/* JSON I/O.  0 on success, -1 on I/O error or an unreadable/newer file. */
+int  results_write(const results_record_t *r, const char *path);
+int  results_read(const char *path, results_record_t *r);
+
+/* Config directory (created if needed).  0 on success. */
+int  results_dir(char *buf, size_t sz);
+
+/* Save r as results/<YYYYmmdd-HHMMSS>.json; path gets the file name written */
+int  results_save(const results_record_t *r, char *path, size_t sz);
+
+int  results_set_baseline(const results_record_t *r);
+int  results_load_baseline(results_record_t *r);
+
+/* ── Comparison ─────────────────────────────────────────────────────── */
+
+#define RESULTS_MAX_DIFFS 64
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    double base, cur;
+    double delta_pct;                     /* (cur - base) / base × 100     */
+    int    better;                        /* +1 improved, -1 worse, 0 same
+                                             within RESULTS_NOISE_PCT      */
+} results_delta_t;
+
+/* Configuration changes: timings, clocks, voltages, DIMMs */
+typedef struct {
+    const char *name;
+    char base[48], cur[48];
+} results_change_t;
+
+typedef struct {
+    int              ndeltas;
+    results_delta_t  deltas[RESULTS_MAX_DIFFS];
+    int              nchanges;
+    results_change_t changes[RESULTS_MAX_DIFFS];
+} results_diff_t;
+
+#define RESULTS_NOISE_PCT 0.5
+
+/* Metrics present in both records, and every setting that differs */
+void results_diff(const results_record_t *base, const results_record_t *cur,
+                  results_diff_t *out);
+
+#endif /* RESULTS_H */
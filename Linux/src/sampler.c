@@ -0,0 +1,244 @@
+/*
+ * sampler.c — Background sampling thread with a lock-free snapshot handoff
+ *
+ * The sampler owns all backend reads. Each tick it refreshes a private
+ * working summary, copies it into the back slot of a triple buffer and
+ * publishes it with one atomic exchange. The consumer (GTK main thread)
+ * swaps the freshest slot into its front slot the same way, so neither side
+ * ever blocks on the other and a slow sysfs/SMN read can only delay the
+ * next snapshot — never a frame.
+ *
+ *   s_latest  = index of the most recently published slot | FRESH bit
+ *   writer    owns s_back, reader owns s_front, s_latest holds the third
+ *
+ * Optionally the same thread also samples the PM table alone at 10–100 Hz
+ * into pm_history's ring; each full snapshot carries the window stats.
+ * With --shm every snapshot is also copied out to the telemetry segment.
+ */
+
+#define _GNU_SOURCE
+#include "sampler.h"
+#include "backend.h"
+#include "pm_history.h"
+#include "telemetry.h"
+#include "profile.h"
+#include <stdatomic.h>
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <locale.h>
+
+#define SLOT_FRESH 4u
+#define SLOT_MASK  3u
+
+static system_summary_t s_slots[3];
+static system_summary_t s_work;        /* sampler-thread private */
+
+static atomic_uint s_latest = 2;       /* slot 2, nothing published yet */
+static unsigned    s_back   = 0;       /* writer-owned */
+static unsigned    s_front  = 1;       /* reader-owned */
+static atomic_int  s_have_snapshot;
+
+static pthread_t         s_thread;
+static int               s_running;
+static pthread_mutex_t   s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t    s_cond;
+static int               s_stop;       /* guarded by s_lock */
+static int               s_timings;    /* guarded by s_lock */
+static int               s_pm_hz;      /* guarded by s_lock; 0 = off */
+static float             s_pm_window_s = 5.0f;
+static int               s_pm_changed; /* guarded by s_lock */
+
+static int               s_period_ms;
+static sampler_notify_fn s_notify;
+static void             *s_notify_ctx;
+
+/* ── Publish / acquire ──────────────────────────────────────────────── */
+
+static void publish(void)
+{
+    memcpy(&s_slots[s_back], &s_work, sizeof(s_work));
+    unsigned prev = atomic_exchange_explicit(&s_latest, s_back | SLOT_FRESH,
+                                             memory_order_acq_rel);
+    s_back = prev & SLOT_MASK;
+    atomic_store_explicit(&s_have_snapshot, 1, memory_order_release);
+}
+
+const system_summary_t *sampler_acquire(int *is_new)
+{
+    if (is_new) *is_new = 0;
+    if (!atomic_load_explicit(&s_have_snapshot, memory_order_acquire))
+        return NULL;
+
+    if (atomic_load_explicit(&s_latest, memory_order_relaxed) & SLOT_FRESH) {
+        unsigned prev = atomic_exchange_explicit(&s_latest, s_front,
+                                                 memory_order_acq_rel);
+        s_front = prev & SLOT_MASK;
+        if (is_new) *is_new = 1;
+    }
+    return &s_slots[s_front];
+}
+
+/* ── Thread ─────────────────────────────────────────────────────────── */
+
+static long long mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void ns_to_timespec(long long ns, struct timespec *ts)
+{
+    ts->tv_sec  = (time_t)(ns / 1000000000LL);
+    ts->tv_nsec = (long)(ns % 1000000000LL);
+}
+
+static void *sampler_thread(void *arg)
+{
+    (void)arg;
+
+    /* GTK resets the process LC_NUMERIC; pin this thread to C so strtof()
+     * in the backend parsers stays dot-decimal regardless. */
+    locale_t c_loc = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+    if (c_loc) uselocale(c_loc);
+
+    memset(&s_work, 0, sizeof(s_work));
+    backend_read_static(&s_work);
+
+    const long long full_period = (long long)s_period_ms * 1000000LL;
+    long long next_full = mono_ns();
+    long long next_pm   = next_full;
+    long long pm_period = 0;
+    int       pm_hz     = 0;
+    float     window_s  = s_pm_window_s;
+
+    pthread_mutex_lock(&s_lock);
+    while (!s_stop) {
+        int force = s_timings;
+        s_timings = 0;
+        if (s_pm_changed) {
+            s_pm_changed = 0;
+            pm_hz     = s_pm_hz;
+            window_s  = s_pm_window_s;
+            pm_period = pm_hz > 0 ? 1000000000LL / pm_hz : 0;
+            pm_history_reset();
+            next_pm = mono_ns();
+        }
+        pthread_mutex_unlock(&s_lock);
+
+        long long now = mono_ns();
+
+        /* High-rate PM sample. Absolute deadlines keep the rate exact;
+         * after an overrun, resync instead of bursting to catch up. */
+        if (pm_hz > 0 && now >= next_pm) {
+            smu_metrics_t pm;
+            backend_read_pm(&pm);
+            pm_history_push(mono_ns(), &pm);
+            next_pm += pm_period;
+            if (next_pm < now) next_pm = now;
+        }
+
+        /* Full snapshot */
+        if (force || now >= next_full) {
+            prof_tick_t tick;
+            prof_tick_begin(&tick);
+            backend_read_dynamic(&s_work.dyn);
+            backend_refresh_static(&s_work);
+            backend_refresh_timings(&s_work, force);
+            if (pm_hz > 0)
+                pm_history_stats(mono_ns(), window_s, &s_work.dyn.pm_hist);
+            s_work.dyn.pm_hist.target_hz = pm_hz;
+            publish();
+            telemetry_publish(&s_work);
+            prof_tick_end(PROF_TICK, &tick);
+            if (s_notify) s_notify(s_notify_ctx);
+
+            if (now >= next_full) {
+                next_full += full_period;
+                if (next_full < now) next_full = now + full_period;
+            }
+        }
+
+        long long wake = next_full;
+        if (pm_hz > 0 && next_pm < wake) wake = next_pm;
+        struct timespec ts;
+        ns_to_timespec(wake, &ts);
+
+        pthread_mutex_lock(&s_lock);
+        while (!s_stop && !s_timings && !s_pm_changed) {
+            if (pthread_cond_timedwait(&s_cond, &s_lock, &ts) == ETIMEDOUT)
+                break;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    if (c_loc) {
+        uselocale(LC_GLOBAL_LOCALE);
+        freelocale(c_loc);
+    }
+    return NULL;
+}
+
+/* ── Public API ─────────────────────────────────────────────────────── */
+
+int sampler_start(int period_ms, sampler_notify_fn notify, void *ctx)
+{
+    if (s_running) return 0;
+
+    s_period_ms  = period_ms > 0 ? period_ms : 1000;
+    s_notify     = notify;
+    s_notify_ctx = ctx;
+    s_stop       = 0;
+
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setclock(&ca, CLOCK_MONOTONIC);
+    pthread_cond_init(&s_cond, &ca);
+    pthread_condattr_destroy(&ca);
+
+    if (pthread_create(&s_thread, NULL, sampler_thread, NULL) != 0) {
+        pthread_cond_destroy(&s_cond);
+        return -1;
+    }
+    s_running = 1;
+    return 0;
+}
+
+void sampler_stop(void)
+{
+    if (!s_running) return;
+
+    pthread_mutex_lock(&s_lock);
+    s_stop = 1;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+
+    pthread_join(s_thread, NULL);
+    pthread_cond_destroy(&s_cond);
+    s_running = 0;
+}
+
+void sampler_request_timings(void)
+{
+    pthread_mutex_lock(&s_lock);
+    s_timings = 1;
+    if (s_running) pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+}
+
+void sampler_set_pm_rate(int hz, float window_s)
+{
+    if (hz < 0) hz = 0;
+    if (hz > PMH_MAX_HZ) hz = PMH_MAX_HZ;
+    if (window_s < 1.0f) window_s = 1.0f;
+    if (window_s > (float)PMH_MAX_WINDOW_S) window_s = (float)PMH_MAX_WINDOW_S;
+
+    pthread_mutex_lock(&s_lock);
+    s_pm_hz = hz;
+    s_pm_window_s = window_s;
+    s_pm_changed = 1;
+    if (s_running) pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+}
@@ -0,0 +1,33 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include "types.h"
+
+/* Called on the sampler thread after each new snapshot is published.
+ * Must be thread-safe (e.g. g_idle_add into the GTK main loop). */
+typedef void (*sampler_notify_fn)(void *ctx);
+
+/* Start the background sampler. The thread reads the static snapshot once
+ * (SMU identity, timings), then the dynamic half every period_ms; board and
+ * DIMM info join the snapshots when the backend's static worker has them.
+ * Returns 0 on success, -1 if the thread could not be created. */
+int  sampler_start(int period_ms, sampler_notify_fn notify, void *ctx);
+
+/* Stop and join the sampler thread. Safe to call if it never started. */
+void sampler_stop(void);
+
+/* Latest published snapshot, or NULL before the first one is ready.
+ * Single consumer: the pointer stays valid (and unchanged) until the next
+ * sampler_acquire() call from the same thread. *is_new is set to 1 if the
+ * snapshot was published since the previous call. */
+const system_summary_t *sampler_acquire(int *is_new);
+
+/* Force a DRAM timing re-read on the next sample (and wake the sampler). */
+void sampler_request_timings(void);
+
+/* High-rate PM table sampling: hz in 0..PMH_MAX_HZ (0 = off), stats over
+ * the last window_s seconds (1..PMH_MAX_WINDOW_S) land in dyn.pm_hist of
+ * every published snapshot. Resets the history. */
+void sampler_set_pm_rate(int hz, float window_s);
+
+#endif /* SAMPLER_H */
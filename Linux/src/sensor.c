@@ -0,0 +1,66 @@
+#include "sensor.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+int sensor_open(sensor_t *s, const char *path)
+{
+    if (s->valid) return 1;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return 0;
+    s->fd = fd;
+    s->valid = 1;
+    return 1;
+}
+
+void sensor_close(sensor_t *s)
+{
+    if (!s->valid) return;
+    close(s->fd);
+    s->fd = -1;
+    s->valid = 0;
+}
+
+ssize_t sensor_read(sensor_t *s, void *buf, size_t sz)
+{
+    if (!s->valid) return -1;
+    ssize_t n;
+    do {
+        n = pread(s->fd, buf, sz, 0);
+    } while (n < 0 && errno == EINTR);
+    /* Attribute went away (module unloaded) — drop the fd so the next
+     * sensor_open() can pick up a fresh instance */
+    if (n < 0 && (errno == ENODEV || errno == ENOENT || errno == EBADF))
+        sensor_close(s);
+    return n;
+}
+
+int sensor_read_string(sensor_t *s, char *buf, size_t sz)
+{
+    if (sz == 0) return 0;
+    ssize_t n = sensor_read(s, buf, sz - 1);
+    if (n <= 0) { buf[0] = '\0'; return 0; }
+    buf[n] = '\0';
+    /* first line only, strip trailing whitespace */
+    char *nl = strchr(buf, '\n');
+    if (nl) *nl = '\0';
+    size_t len = strlen(buf);
+    while (len > 0 && (buf[len-1] == '\r' || buf[len-1] == ' '))
+        buf[--len] = '\0';
+    return 1;
+}
+
+int sensor_read_int(sensor_t *s)
+{
+    char buf[64];
+    if (!sensor_read_string(s, buf, sizeof(buf))) return 0;
+    return (int)strtol(buf, NULL, 10);
+}
+
+int sensor_read_int_path(sensor_t *s, const char *path)
+{
+    if (!sensor_open(s, path)) return 0;
+    return sensor_read_int(s);
+}
@@ -0,0 +1,32 @@
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/* Persistent handle to a sysfs/procfs file.
+ * The path is opened once and re-read with pread(fd, buf, n, 0) on every
+ * sample, so the refresh path does no open/close and no heap allocation.
+ * A zero-initialised sensor_t is valid and simply not open yet. */
+typedef struct {
+    int fd;
+    int valid;
+} sensor_t;
+
+/* Open path if the handle is not open yet. Returns 1 if the handle is usable.
+ * A failed open is retried on the next call (e.g. module loaded later). */
+int     sensor_open(sensor_t *s, const char *path);
+void    sensor_close(sensor_t *s);
+
+/* pread from offset 0 into buf. Returns bytes read, or -1 on error. */
+ssize_t sensor_read(sensor_t *s, void *buf, size_t sz);
+
+/* Same semantics as read_file_string()/read_int_file() in util.h:
+ * first line, trailing whitespace stripped; 0 on failure. */
+int     sensor_read_string(sensor_t *s, char *buf, size_t sz);
+int     sensor_read_int(sensor_t *s);
+
+/* Convenience: open on first use, then read. */
+int     sensor_read_int_path(sensor_t *s, const char *path);
+
+#endif
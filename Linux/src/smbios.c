@@ -0,0 +1,175 @@
+/*
+ * smbios.c — SMBIOS structures from the raw sysfs DMI table
+ */
+
+#include "smbios.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define DMI_TABLE "/sys/firmware/dmi/tables/DMI"
+
+static uint8_t *read_table(size_t *len_out)
+{
+    int fd = open(DMI_TABLE, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return NULL;
+
+    size_t cap = 16384, len = 0;
+    uint8_t *buf = malloc(cap);
+    while (buf) {
+        if (len == cap) {
+            uint8_t *nb = cap < (1u << 20) ? realloc(buf, cap * 2) : NULL;
+            if (!nb) break;
+            buf = nb;
+            cap *= 2;
+        }
+        ssize_t n = read(fd, buf + len, cap - len);
+        if (n <= 0) break;
+        len += (size_t)n;
+    }
+    close(fd);
+    if (buf && len < 4) { free(buf); buf = NULL; }
+    *len_out = len;
+    return buf;
+}
+
+static uint16_t le16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/* String number idx (1-based) of the structure whose string set starts at
+ * strs, trimmed of the space padding vendors like; "" for 0 or missing. */
+static void get_string(const uint8_t *strs, const uint8_t *end, uint8_t idx,
+                       char *out, size_t sz)
+{
+    out[0] = '\0';
+    if (idx == 0) return;
+    const uint8_t *p = strs;
+    for (uint8_t i = 1; i < idx && p < end; i++) {
+        while (p < end && *p) p++;
+        if (++p >= end || *p == 0) return;
+    }
+    while (p < end && *p == ' ') p++;
+    size_t n = 0;
+    while (p + n < end && p[n] && n + 1 < sz) {
+        unsigned char c = p[n];
+        out[n] = (c < 0x20 || c > 0x7e) ? '.' : (char)c;
+        n++;
+    }
+    while (n > 0 && out[n - 1] == ' ') n--;
+    out[n] = '\0';
+}
+
+/* Type 17 size: WORD at 0x0C (bit 15 = KiB granularity), 0x7FFF means
+ * the DWORD Extended Size at 0x1C (MiB).  0 = empty slot or unknown. */
+static uint64_t module_size(const uint8_t *s, uint8_t len)
+{
+    uint16_t size = le16(s + 0x0C);
+    if (size == 0 || size == 0xFFFF) return 0;
+    if (size == 0x7FFF && len >= 0x20)
+        return (uint64_t)(le32(s + 0x1C) & 0x7FFFFFFFu) << 20;
+    if (size & 0x8000)
+        return (uint64_t)(size & 0x7FFF) << 10;
+    return (uint64_t)size << 20;
+}
+
+static int placeholder(const char *v)
+{
+    return !strcmp(v, "Unknown") || !strcmp(v, "Not Specified") ||
+           !strcmp(v, "NO DIMM") || !strcmp(v, "00000000");
+}
+
+static void parse_memory_device(const uint8_t *s, uint8_t len,
+                                const uint8_t *strs, const uint8_t *end,
+                                smbios_info_t *out)
+{
+    if (len < 0x15 || out->module_count >= MAX_MODULES) return;
+    uint64_t cap = module_size(s, len);
+    if (cap == 0 || cap > (1ULL << 40)) return;
+
+    memory_module_t *m = &out->modules[out->module_count++];
+    memset(m, 0, sizeof(*m));
+    m->capacity_bytes = cap;
+    get_string(strs, end, s[0x10], m->device_locator, sizeof(m->device_locator));
+    get_string(strs, end, s[0x11], m->bank_label, sizeof(m->bank_label));
+    if (len >= 0x1B) {
+        get_string(strs, end, s[0x17], m->manufacturer, sizeof(m->manufacturer));
+        get_string(strs, end, s[0x18], m->serial_number, sizeof(m->serial_number));
+        get_string(strs, end, s[0x1A], m->part_number, sizeof(m->part_number));
+        if (placeholder(m->manufacturer))  m->manufacturer[0]  = '\0';
+        if (placeholder(m->serial_number)) m->serial_number[0] = '\0';
+        if (placeholder(m->part_number))   m->part_number[0]   = '\0';
+    }
+    if (len >= 0x1C) {
+        int r = s[0x1B] & 0x0F;
+        m->rank = r == 4 ? RANK_QR : r == 2 ? RANK_DR : RANK_SR;
+    }
+    if (len >= 0x22) {
+        /* Configured Memory Speed, MT/s; 0xFFFF → Extended (SMBIOS 3.3) */
+        uint32_t speed = le16(s + 0x20);
+        if (speed == 0xFFFF)
+            speed = len >= 0x5C ? le32(s + 0x58) & 0x7FFFFFFFu : 0;
+        m->clock_speed_mhz = speed;
+    }
+}
+
+int smbios_read(smbios_info_t *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    size_t total;
+    uint8_t *buf = read_table(&total);
+    if (!buf) return 0;
+
+    int have_cpu = 0;
+    size_t i = 0;
+    while (i + 4 <= total) {
+        const uint8_t *s = buf + i;
+        uint8_t type = s[0], len = s[1];
+        if (len < 4 || i + len > total) break;
+
+        /* String set: from the end of the formatted area to a double NUL */
+        const uint8_t *strs = s + len;
+        size_t next = i + len;
+        while (next + 1 < total && !(buf[next] == 0 && buf[next + 1] == 0))
+            next++;
+        next += 2;
+        const uint8_t *end = buf + (next <= total ? next : total);
+
+        switch (type) {
+        case 0:
+            if (len >= 0x09) {
+                get_string(strs, end, s[0x05], out->bios_version, sizeof(out->bios_version));
+                get_string(strs, end, s[0x08], out->bios_date, sizeof(out->bios_date));
+            }
+            break;
+        case 2:
+            if (len >= 0x06 && !out->board_product[0])
+                get_string(strs, end, s[0x05], out->board_product, sizeof(out->board_product));
+            break;
+        case 4:
+            /* First socket only, like the rest of the app */
+            if (!have_cpu && len >= 0x14) {
+                have_cpu = 1;
+                get_string(strs, end, s[0x10], out->processor_version,
+                           sizeof(out->processor_version));
+                uint16_t ext_clk = le16(s + 0x12);
+                if (ext_clk >= 80 && ext_clk <= 200)
+                    out->ext_clock_mhz = (float)ext_clk;
+            }
+            break;
+        case 17:
+            parse_memory_device(s, len, strs, end, out);
+            break;
+        }
+        if (type == 127) break;     /* end-of-table */
+        i = next;
+    }
+    free(buf);
+    return 1;
+}
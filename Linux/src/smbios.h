@@ -0,0 +1,33 @@
+#ifndef SMBIOS_H
+#define SMBIOS_H
+
+#include "types.h"
+
+/*
+ * SMBIOS parsed straight from /sys/firmware/dmi/tables/DMI — the same
+ * structures dmidecode decodes, without forking it.  Requires root.
+ *
+ *   Type 0   BIOS version and release date
+ *   Type 2   baseboard product name
+ *   Type 4   processor version string, External Clock (BCLK)
+ *   Type 17  memory devices: only populated slots are returned
+ *
+ * Modules carry the raw fields only (locators, manufacturer, part and
+ * serial number, capacity, rank, configured speed); the slot_* and
+ * capacity_display strings are left for the caller to build.
+ */
+typedef struct {
+    char  bios_version[STR_LEN];
+    char  bios_date[STR_SHORT];
+    char  board_product[STR_LEN];
+    char  processor_version[STR_LEN];
+    float ext_clock_mhz;            /* 0 if missing or implausible */
+    memory_module_t modules[MAX_MODULES];
+    int   module_count;
+} smbios_info_t;
+
+/* Parse the table into out (zeroed first). Returns 1 if the table was
+ * read, 0 if it is unavailable. */
+int smbios_read(smbios_info_t *out);
+
+#endif /* SMBIOS_H */
@@ -0,0 +1,219 @@
+/*
+ * smu.c — Coalescing access to ryzen_smu's pm_table and smn attributes
+ *
+ * PM table: two buffers.  The consumer-visible one (s_pm_cur) is guarded
+ * by a rwlock so any number of consumers decode it at once; the refresher
+ * preads into the private one with no lock held and swaps them under a
+ * brief write lock.  s_pm_lock/s_pm_cond only arbitrate who refreshes:
+ * the first stale request claims s_pm_busy, later ones wait for its
+ * result instead of queueing a second mailbox transfer behind it.
+ *
+ * Both buffers are page-aligned and sized once from the attribute, and
+ * the table is pread straight into them.  ryzen_smu has no mmap for
+ * pm_table (each read is what triggers the SMU's transfer-to-DRAM), so
+ * one pread per refresh is the floor.  A refresh whose bytes equal the
+ * current table is not swapped in and keeps its generation, which lets
+ * consumers skip decoding a table the SMU has not updated.
+ *
+ * SMN: the attribute is one register per transaction (write a 4-byte
+ * address, read back the value), so a batch is a tight pwrite/pread loop
+ * on one persistent fd and must not interleave with another thread's.
+ */
+
+#define _GNU_SOURCE
+#include "smu.h"
+#include "sensor.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define SMU_PATH           "/sys/kernel/ryzen_smu_drv"
+#define PM_TABLE_MAX_BYTES 0x4000
+
+/* ── PM table ───────────────────────────────────────────────────────── */
+
+static sensor_t         s_pm_sensor;
+static float           *s_pm_cur, *s_pm_next;
+static size_t           s_pm_cap;
+static int              s_pm_count;       /* floats in s_pm_cur, 0 = none */
+static uint64_t         s_pm_gen;         /* bumps when s_pm_cur changes  */
+static pthread_rwlock_t s_pm_rw = PTHREAD_RWLOCK_INITIALIZER;
+
+static pthread_mutex_t  s_pm_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   s_pm_cond = PTHREAD_COND_INITIALIZER;
+static int              s_pm_busy;        /* a refresh is in flight     */
+static int              s_pm_done;        /* at least one attempt made  */
+static long long        s_pm_t_ns;        /* when the last attempt ended */
+
+static smu_stats_t      s_stats;          /* pm_* under s_pm_lock, smn_* under s_smn_lock */
+
+static long long mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static int pm_alloc(void)
+{
+    if (s_pm_cur) return 1;
+    struct stat st;
+    size_t cap = PM_TABLE_MAX_BYTES;
+    if (fstat(s_pm_sensor.fd, &st) == 0 && st.st_size >= 4)
+        cap = (size_t)st.st_size;
+
+    long pg = sysconf(_SC_PAGESIZE);
+    size_t align = pg > 0 ? (size_t)pg : 4096;
+    size_t alloc = (cap + align - 1) & ~(align - 1);
+    void *a = NULL, *b = NULL;
+    if (posix_memalign(&a, align, alloc) != 0) return 0;
+    if (posix_memalign(&b, align, alloc) != 0) {
+        free(a);
+        return 0;
+    }
+    s_pm_next = b;
+    s_pm_cap  = cap;
+    s_pm_cur  = a;
+    return 1;
+}
+
+/* Caller owns s_pm_busy, so s_pm_next and the fd are exclusively ours.
+ * Returns 0 if the SMU handed back the same table as last time. */
+static int pm_refresh(void)
+{
+    int count = 0;
+    if (sensor_open(&s_pm_sensor, SMU_PATH "/pm_table") && pm_alloc()) {
+        ssize_t rd = sensor_read(&s_pm_sensor, s_pm_next, s_pm_cap);
+        if (rd >= 4) count = (int)(rd / 4);
+    }
+
+    /* s_pm_cur only changes under the write lock, so reading it here
+     * while other threads hold read locks is safe */
+    if (count > 0 && count == s_pm_count &&
+        memcmp(s_pm_next, s_pm_cur, (size_t)count * sizeof(float)) == 0) {
+        return 0;
+    }
+
+    pthread_rwlock_wrlock(&s_pm_rw);
+    if (count > 0) {
+        float *t = s_pm_cur;
+        s_pm_cur  = s_pm_next;
+        s_pm_next = t;
+    }
+    s_pm_count = count;
+    s_pm_gen++;
+    pthread_rwlock_unlock(&s_pm_rw);
+    return 1;
+}
+
+int smu_pm_acquire(long long max_age_ns, const float **floats, int *count,
+                   uint64_t *gen)
+{
+    *floats = NULL;
+    *count = 0;
+
+    pthread_mutex_lock(&s_pm_lock);
+    s_stats.pm_requests++;
+    if (s_pm_busy) {
+        /* Someone else's read is in flight — its result is fresher than
+         * anything we could start now */
+        while (s_pm_busy)
+            pthread_cond_wait(&s_pm_cond, &s_pm_lock);
+    } else if (!s_pm_done || mono_ns() - s_pm_t_ns > max_age_ns) {
+        s_pm_busy = 1;
+        s_stats.pm_reads++;
+        pthread_mutex_unlock(&s_pm_lock);
+        int changed = pm_refresh();
+        pthread_mutex_lock(&s_pm_lock);
+        if (!changed) s_stats.pm_unchanged++;
+        s_pm_busy = 0;
+        s_pm_done = 1;
+        s_pm_t_ns = mono_ns();
+        pthread_cond_broadcast(&s_pm_cond);
+    }
+
+    /* Taken before dropping s_pm_lock so the next refresh cannot swap the
+     * buffer between our freshness check and the borrow */
+    pthread_rwlock_rdlock(&s_pm_rw);
+    pthread_mutex_unlock(&s_pm_lock);
+
+    if (s_pm_count <= 0) {
+        pthread_rwlock_unlock(&s_pm_rw);
+        return 0;
+    }
+    *floats = s_pm_cur;
+    *count  = s_pm_count;
+    if (gen) *gen = s_pm_gen;
+    return 1;
+}
+
+void smu_pm_release(void)
+{
+    pthread_rwlock_unlock(&s_pm_rw);
+}
+
+/* ── SMN ────────────────────────────────────────────────────────────── */
+
+static int             s_smn_fd = -1;
+static pthread_mutex_t s_smn_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int smu_smn_read_batch(const uint32_t *addrs, uint32_t *vals, int n)
+{
+    memset(vals, 0, (size_t)n * sizeof(*vals));
+
+    pthread_mutex_lock(&s_smn_lock);
+    if (s_smn_fd < 0)
+        s_smn_fd = open(SMU_PATH "/smn", O_RDWR | O_CLOEXEC);
+    if (s_smn_fd < 0) {
+        pthread_mutex_unlock(&s_smn_lock);
+        return 0;
+    }
+    s_stats.smn_batches++;
+
+    int ok = 0;
+    for (int i = 0; i < n; i++) {
+        /* Write address (little-endian) */
+        uint8_t buf[4];
+        buf[0] = (uint8_t)(addrs[i]);
+        buf[1] = (uint8_t)(addrs[i] >> 8);
+        buf[2] = (uint8_t)(addrs[i] >> 16);
+        buf[3] = (uint8_t)(addrs[i] >> 24);
+        if (pwrite(s_smn_fd, buf, 4, 0) != 4) continue;
+        /* Read back value */
+        if (pread(s_smn_fd, buf, 4, 0) != 4) continue;
+        vals[i] = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+                  ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+        ok++;
+    }
+    s_stats.smn_regs += (uint64_t)ok;
+    pthread_mutex_unlock(&s_smn_lock);
+    return ok;
+}
+
+/* ── Stats / teardown ───────────────────────────────────────────────── */
+
+void smu_get_stats(smu_stats_t *out)
+{
+    pthread_mutex_lock(&s_pm_lock);
+    out->pm_requests  = s_stats.pm_requests;
+    out->pm_reads     = s_stats.pm_reads;
+    out->pm_unchanged = s_stats.pm_unchanged;
+    pthread_mutex_unlock(&s_pm_lock);
+    pthread_mutex_lock(&s_smn_lock);
+    out->smn_batches = s_stats.smn_batches;
+    out->smn_regs    = s_stats.smn_regs;
+    pthread_mutex_unlock(&s_smn_lock);
+}
+
+void smu_close(void)
+{
+    sensor_close(&s_pm_sensor);
+    if (s_smn_fd >= 0) {
+        close(s_smn_fd);
+        s_smn_fd = -1;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SMU_H
+#define SMU_H
+
+#include <stdint.h>
+
+/*
+ * Single owner of the ryzen_smu pm_table and smn attributes.
+ *
+ * ryzen_smu serialises SMU mailbox access internally, so independent
+ * readers (sampler tick, high-rate PM sampling, debug dump, headless
+ * records) only stall one another.  All of them go through here instead:
+ *
+ *   pm_table  one read is in flight at a time; a request that arrives
+ *             while it is outstanding, or within max_age_ns after it
+ *             completed, is served from that same table.
+ *   smn       each batch of address/value transactions runs whole on the
+ *             one descriptor; concurrent batches queue behind it rather
+ *             than interleaving their address writes.
+ */
+
+/* Default staleness a consumer accepts: well under a sampler tick, so a
+ * shared read is never older than a private one would have been */
+#define SMU_PM_COALESCE_NS 1000000LL
+
+typedef struct {
+    uint64_t pm_requests;    /* smu_pm_acquire() calls                 */
+    uint64_t pm_reads;       /* ...that actually read the attribute     */
+    uint64_t pm_unchanged;   /* ...and got back the same bytes          */
+    uint64_t smn_batches;
+    uint64_t smn_regs;
+} smu_stats_t;
+
+/* Borrow the current PM table, re-reading it unless the last read is at
+ * most max_age_ns old.  Returns 1 with floats/count valid until
+ * smu_pm_release(), 0 if the table is unavailable (then do not release).
+ * *gen (may be NULL) only changes when the table contents did, so a
+ * consumer that saw the same gen before can reuse its decode. */
+int  smu_pm_acquire(long long max_age_ns, const float **floats, int *count,
+                    uint64_t *gen);
+void smu_pm_release(void);
+
+/* Read n SMN registers; vals[i] is 0 for any register that failed.
+ * Returns the number of registers read successfully. */
+int  smu_smn_read_batch(const uint32_t *addrs, uint32_t *vals, int n);
+
+void smu_get_stats(smu_stats_t *out);
+
+/* Close both descriptors (before ryzen_smu is unloaded).  Takes no locks,
+ * so it is safe from the signal handler. */
+void smu_close(void);
+
+#endif /* SMU_H */
@@ -0,0 +1,159 @@
+/*
+ * telemetry.c — Seqlock-protected snapshot in POSIX shared memory
+ *
+ * One writer (the sampler thread) and any number of readers in other
+ * processes.  The writer never waits on a reader: it bumps seq to odd,
+ * memcpy()s the snapshot and bumps it back to even with release order.
+ * Readers retry while seq is odd or changed across their copy, so a
+ * reader that is preempted mid-copy only costs itself a retry.
+ *
+ * The segment is created 0644 so unprivileged collectors can read what
+ * the (root) tool samples; an exclusive flock() on it keeps a second
+ * instance from interleaving its writes.
+ */
+
+#define _GNU_SOURCE
+#include "telemetry.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sched.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+#define READ_RETRIES 64
+
+static telemetry_shm_t *s_shm;
+static int              s_fd = -1;
+
+/* ── Writer ─────────────────────────────────────────────────────────── */
+
+int telemetry_open(int period_ms)
+{
+    if (s_shm) return 0;
+
+    int fd = shm_open(TELEMETRY_SHM_NAME, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "TuxTimings: shm_open %s: %s\n", TELEMETRY_SHM_NAME, strerror(errno));
+        return -1;
+    }
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+        fprintf(stderr, "TuxTimings: %s is exported by another instance\n", TELEMETRY_SHM_NAME);
+        close(fd);
+        return -1;
+    }
+    fchmod(fd, 0644);   /* O_CREAT mode is subject to the umask */
+    if (ftruncate(fd, sizeof(telemetry_shm_t)) != 0) {
+        fprintf(stderr, "TuxTimings: ftruncate %s: %s\n", TELEMETRY_SHM_NAME, strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    telemetry_shm_t *m = mmap(NULL, sizeof(*m), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (m == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+
+    /* Readers of a leftover segment see a retry until the header is
+     * valid again: seq odd first, magic last. */
+    atomic_store_explicit(&m->seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    m->magic = 0;
+    memset(&m->snap, 0, sizeof(m->snap));
+    m->version        = TELEMETRY_VERSION;
+    m->size           = sizeof(*m);
+    m->writer_pid     = (int32_t)getpid();
+    m->snap.period_ms = period_ms;
+    atomic_thread_fence(memory_order_release);
+    m->magic = TELEMETRY_MAGIC;
+    atomic_store_explicit(&m->seq, 2, memory_order_release);
+
+    s_shm = m;
+    s_fd  = fd;
+    return 0;
+}
+
+void telemetry_publish(const system_summary_t *s)
+{
+    telemetry_shm_t *m = s_shm;
+    if (!m) return;
+
+    struct timespec wall, mono;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    clock_gettime(CLOCK_MONOTONIC, &mono);
+
+    uint64_t seq = atomic_load_explicit(&m->seq, memory_order_relaxed);
+    atomic_store_explicit(&m->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    m->snap.samples++;
+    m->snap.t_unix_ms = (int64_t)wall.tv_sec * 1000 + wall.tv_nsec / 1000000;
+    m->snap.t_mono_ns = (int64_t)mono.tv_sec * 1000000000LL + mono.tv_nsec;
+    memcpy(&m->snap.summary, s, sizeof(*s));
+
+    atomic_store_explicit(&m->seq, seq + 2, memory_order_release);
+}
+
+void telemetry_close(void)
+{
+    if (!s_shm) return;
+    munmap(s_shm, sizeof(*s_shm));
+    s_shm = NULL;
+    shm_unlink(TELEMETRY_SHM_NAME);
+    close(s_fd);        /* drops the flock */
+    s_fd = -1;
+}
+
+/* ── Reader ─────────────────────────────────────────────────────────── */
+
+const telemetry_shm_t *telemetry_attach(void)
+{
+    int fd = shm_open(TELEMETRY_SHM_NAME, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(telemetry_shm_t)) {
+        close(fd);
+        return NULL;
+    }
+    const telemetry_shm_t *m = mmap(NULL, sizeof(*m), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) return NULL;
+
+    if (m->magic != TELEMETRY_MAGIC || m->version != TELEMETRY_VERSION ||
+        m->size < sizeof(*m)) {
+        munmap((void *)m, sizeof(*m));
+        return NULL;
+    }
+    return m;
+}
+
+void telemetry_detach(const telemetry_shm_t *shm)
+{
+    if (shm) munmap((void *)shm, sizeof(*shm));
+}
+
+int telemetry_read(const telemetry_shm_t *shm, telemetry_snapshot_t *out)
+{
+    /* The mapping is read-only; an atomic load is a plain load on x86 */
+    _Atomic uint64_t *seqp = (_Atomic uint64_t *)&shm->seq;
+
+    for (int i = 0; i < READ_RETRIES; i++) {
+        uint64_t s1 = atomic_load_explicit(seqp, memory_order_acquire);
+        if (s1 & 1) {
+            sched_yield();
+            continue;
+        }
+        memcpy(out, &shm->snap, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t s2 = atomic_load_explicit(seqp, memory_order_relaxed);
+        if (s1 == s2)
+            return out->samples > 0 ? 0 : -1;
+    }
+    return -1;
+}
@@ -0,0 +1,65 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "types.h"
+#include <stdint.h>
+#include <stdatomic.h>
+
+/*
+ * Shared-memory telemetry export.  With --shm the sampler copies every
+ * snapshot it publishes into the POSIX shared-memory segment
+ * /dev/shm/tuxtimings, so external collectors get the same data without
+ * touching ryzen_smu / SMN / hwmon themselves.
+ *
+ * Layout is fixed per TELEMETRY_VERSION: a header, then one snapshot
+ * guarded by a seqlock.  The writer makes seq odd, copies the snapshot
+ * and makes it even again; a reader copies between two equal, even reads
+ * of seq and retries otherwise.  Readers must check magic, version and
+ * size (the segment may be larger than what they know) before use.  Bump
+ * TELEMETRY_VERSION whenever types.h changes the snapshot layout.
+ */
+#define TELEMETRY_SHM_NAME "/tuxtimings"
+#define TELEMETRY_MAGIC    0x4d4c5454u       /* "TTLM" */
+#define TELEMETRY_VERSION  2
+
+typedef struct {
+    uint64_t         samples;                /* snapshots published so far */
+    int64_t          t_unix_ms;              /* wall clock of this one     */
+    int64_t          t_mono_ns;              /* CLOCK_MONOTONIC            */
+    int32_t          period_ms;              /* sampler period             */
+    int32_t          _pad;
+    system_summary_t summary;
+} telemetry_snapshot_t;
+
+typedef struct {
+    uint32_t         magic;
+    uint32_t         version;
+    uint32_t         size;                   /* sizeof(telemetry_shm_t)    */
+    int32_t          writer_pid;
+    _Atomic uint64_t seq;                    /* odd = write in progress    */
+    telemetry_snapshot_t snap;
+} telemetry_shm_t;
+
+/* ── Writer (the sampler) ───────────────────────────────────────────── */
+
+/* Create and map the segment.  0 on success, -1 on error or when another
+ * instance already exports (the segment is flock()ed while open). */
+int  telemetry_open(int period_ms);
+
+/* Copy s into the segment.  No-op unless telemetry_open() succeeded. */
+void telemetry_publish(const system_summary_t *s);
+
+/* Unmap and remove the segment */
+void telemetry_close(void);
+
+/* ── Reader ─────────────────────────────────────────────────────────── */
+
+/* Map the segment read-only; NULL if absent or of another version */
+const telemetry_shm_t *telemetry_attach(void);
+void telemetry_detach(const telemetry_shm_t *shm);
+
+/* Consistent copy of the current snapshot.  0 on success, -1 if no
+ * snapshot was published yet or the writer kept it busy. */
+int  telemetry_read(const telemetry_shm_t *shm, telemetry_snapshot_t *out);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,187 @@
+/*
+ * topology.c — CPU topology from sysfs, built once
+ */
+
+#include "topology.h"
+#include "util.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+
+#define CPU_SYSFS "/sys/devices/system/cpu"
+
+static topology_t     s_topo;
+static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+
+/* First (lowest) CPU of a sysfs cpulist such as "3,19" or "0-7,16-23";
+ * the lists are ascending.  -1 if the file is missing or empty. */
+static int read_list_first(int cpu, const char *attr)
+{
+    char path[160], buf[256];
+    snprintf(path, sizeof(path), CPU_SYSFS "/cpu%d/%s", cpu, attr);
+    if (!read_file_string(path, buf, sizeof(buf))) return -1;
+    char *end;
+    long v = strtol(buf, &end, 10);
+    return end != buf && v >= 0 ? (int)v : -1;
+}
+
+static int read_id(int cpu, const char *attr)
+{
+    char path[160], buf[32];
+    snprintf(path, sizeof(path), CPU_SYSFS "/cpu%d/%s", cpu, attr);
+    if (!read_file_string(path, buf, sizeof(buf))) return -1;
+    return (int)strtol(buf, NULL, 10);
+}
+
+/* NUMA node of cpu from its cpuN/nodeM link; 0 without NUMA */
+static int read_node(int cpu)
+{
+    char path[96];
+    snprintf(path, sizeof(path), CPU_SYSFS "/cpu%d", cpu);
+    DIR *d = opendir(path);
+    if (!d) return 0;
+    int node = 0;
+    struct dirent *e;
+    while ((e = readdir(d))) {
+        char *end;
+        if (strncmp(e->d_name, "node", 4) != 0) continue;
+        long v = strtol(e->d_name + 4, &end, 10);
+        if (end != e->d_name + 4 && *end == '\0' && v >= 0) { node = (int)v; break; }
+    }
+    closedir(d);
+    return node;
+}
+
+static int cpu_online(int cpu)
+{
+    char path[96], buf[8];
+    snprintf(path, sizeof(path), CPU_SYSFS "/cpu%d/online", cpu);
+    if (read_file_string(path, buf, sizeof(buf)))
+        return buf[0] == '1';
+    /* The boot CPU usually has no online file — it cannot go offline */
+    snprintf(path, sizeof(path), CPU_SYSFS "/cpu%d/topology", cpu);
+    return dir_exists(path);
+}
+
+static void build(void)
+{
+    topology_t *t = &s_topo;
+    long conf = sysconf(_SC_NPROCESSORS_CONF);
+    int  n = conf > 0 ? (int)conf : 1;
+
+    /* One allocation: three per-CPU scratch arrays, cpu_core, six
+     * per-core arrays (at most n cores) and n thread slots */
+    int *block = malloc(sizeof(int) * (size_t)n * 11);
+    if (!block) {
+        static int one[8] = { 0, 0, 0, 0, 1, 0, 0, 0 };
+        t->ncpus = t->nonline = t->ncores = t->nccds = t->npackages = 1;
+        t->cpu_core = &one[0];
+        t->core_cpu = &one[1]; t->core_ccd = &one[2]; t->core_pkg = &one[3];
+        t->core_nthreads = &one[4]; t->core_thread0 = &one[5];
+        t->thread_cpu = &one[6]; t->core_node = &one[7];
+        return;
+    }
+    int *lead    = block;               /* [n] first sibling, -1 offline */
+    int *l3      = block + n;           /* [n] first CPU of the L3       */
+    int *ccd_of  = block + 2 * n;       /* [n] L3 lead → domain index    */
+    t->cpu_core      = block + 3 * n;
+    t->core_cpu      = block + 4 * n;
+    t->core_ccd      = block + 5 * n;
+    t->core_pkg      = block + 6 * n;
+    t->core_nthreads = block + 7 * n;
+    t->core_thread0  = block + 8 * n;
+    t->thread_cpu    = block + 9 * n;
+    t->core_node     = block + 10 * n;
+    t->ncpus = n;
+
+    int have_topo = 0;
+    for (int cpu = 0; cpu < n; cpu++) {
+        lead[cpu] = l3[cpu] = ccd_of[cpu] = t->cpu_core[cpu] = -1;
+        if (!cpu_online(cpu)) continue;
+        int first = read_list_first(cpu, "topology/thread_siblings_list");
+        if (first >= 0 && first <= cpu) have_topo = 1;
+        else first = cpu;
+        lead[cpu] = first;
+        int l = read_list_first(cpu, "cache/index3/shared_cpu_list");
+        l3[cpu] = l >= 0 && l < n ? l : 0;
+    }
+    if (!have_topo) {
+        /* No sysfs topology: treat every online CPU as a core */
+        for (int cpu = 0; cpu < n; cpu++)
+            if (lead[cpu] >= 0) lead[cpu] = cpu;
+    }
+
+    /* Cores in order of their lead CPU; CCDs in order of their L3 lead */
+    int max_pkg = -1;
+    for (int cpu = 0; cpu < n; cpu++) {
+        if (lead[cpu] != cpu) continue;
+        int c = t->ncores++;
+        t->core_cpu[c]      = cpu;
+        t->core_nthreads[c] = 0;
+        if (ccd_of[l3[cpu]] < 0) ccd_of[l3[cpu]] = t->nccds++;
+        t->core_ccd[c] = ccd_of[l3[cpu]];
+        int pkg = read_id(cpu, "topology/physical_package_id");
+        t->core_pkg[c] = pkg >= 0 ? pkg : 0;
+        if (t->core_pkg[c] > max_pkg) max_pkg = t->core_pkg[c];
+        t->core_node[c] = read_node(cpu);
+        t->cpu_core[cpu] = c;
+    }
+    for (int cpu = 0; cpu < n; cpu++) {
+        if (lead[cpu] < 0) continue;
+        int c = t->cpu_core[lead[cpu]];
+        if (c < 0) {
+            /* Lowest sibling is offline: this CPU leads the core.  The
+             * offline lead's slot remembers it for the other siblings
+             * and is cleared again below. */
+            c = t->ncores++;
+            t->core_cpu[c] = cpu;
+            t->core_nthreads[c] = 0;
+            if (ccd_of[l3[cpu]] < 0) ccd_of[l3[cpu]] = t->nccds++;
+            t->core_ccd[c] = ccd_of[l3[cpu]];
+            int pkg = read_id(cpu, "topology/physical_package_id");
+            t->core_pkg[c] = pkg >= 0 ? pkg : 0;
+            if (t->core_pkg[c] > max_pkg) max_pkg = t->core_pkg[c];
+            t->core_node[c] = read_node(cpu);
+            t->cpu_core[lead[cpu]] = c;
+        }
+        t->cpu_core[cpu] = c;
+        t->core_nthreads[c]++;
+        t->nonline++;
+    }
+    for (int cpu = 0; cpu < n; cpu++)
+        if (lead[cpu] < 0) t->cpu_core[cpu] = -1;
+
+    /* Flatten the siblings, grouped by core */
+    int off = 0;
+    for (int c = 0; c < t->ncores; c++) {
+        t->core_thread0[c] = off;
+        off += t->core_nthreads[c];
+        t->core_nthreads[c] = 0;
+    }
+    for (int cpu = 0; cpu < n; cpu++) {
+        int c = t->cpu_core[cpu];
+        if (c < 0) continue;
+        t->thread_cpu[t->core_thread0[c] + t->core_nthreads[c]++] = cpu;
+    }
+
+    if (t->ncores == 0) {
+        /* Nothing readable at all — cpu0 alone */
+        t->ncores = t->nonline = 1;
+        t->cpu_core[0] = 0;
+        t->core_cpu[0] = 0;
+        t->core_ccd[0] = t->core_pkg[0] = t->core_node[0] = t->core_thread0[0] = 0;
+        t->core_nthreads[0] = 1;
+        t->thread_cpu[0] = 0;
+    }
+    if (t->nccds == 0) t->nccds = 1;
+    t->npackages = max_pkg >= 0 ? max_pkg + 1 : 1;
+}
+
+const topology_t *topology_get(void)
+{
+    pthread_once(&s_once, build);
+    return &s_topo;
+}
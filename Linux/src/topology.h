@@ -0,0 +1,44 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+/*
+ * CPU topology, built once from sysfs on first use and immutable after.
+ *
+ * Cores are numbered in order of their lowest logical CPU, which is also
+ * the SMU's per-core order on every supported part.  Siblings come from
+ * thread_siblings_list, so nothing assumes a numbering scheme — Linux on
+ * AMD enumerates SMT siblings as N and N + ncores, not 2N and 2N + 1.
+ * CCDs are the L3 domains (cache/index3/shared_cpu_list).  NUMA nodes come
+ * from the cpuN/nodeM links and are independent of the package: one socket
+ * in NPS2/NPS4 mode has several.
+ *
+ * Every array is sized from the running system and laid out contiguously,
+ * one array per attribute, so per-core loops scale with the core count.
+ * If sysfs topology is unavailable, every online CPU is its own core.
+ */
+typedef struct {
+    int  ncpus;             /* logical CPU index space (configured)          */
+    int  nonline;           /* online logical CPUs = length of thread_cpu    */
+    int  ncores;
+    int  nccds;             /* L3 domains                                    */
+    int  npackages;
+
+    /* [ncpus] */
+    int *cpu_core;          /* core of each logical CPU, -1 = offline        */
+
+    /* [ncores] */
+    int *core_cpu;          /* lowest logical CPU of the core                */
+    int *core_ccd;          /* L3 domain index, 0..nccds-1                   */
+    int *core_pkg;          /* physical package                              */
+    int *core_node;         /* NUMA node id (cpuN/nodeM), 0 without NUMA     */
+    int *core_nthreads;
+    int *core_thread0;      /* first entry of the core in thread_cpu         */
+
+    /* [nonline]: logical CPUs grouped by core, ascending within a core */
+    int *thread_cpu;
+} topology_t;
+
+/* The system topology; never NULL.  Thread-safe. */
+const topology_t *topology_get(void);
+
+#endif /* TOPOLOGY_H */
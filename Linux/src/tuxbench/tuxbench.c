@@ -23,6 +23,11 @@
  * Interface:
  *   open /dev/tuxbench
  *   ioctl(fd, TUXBENCH_IOC_RUN, &req)   // fills req with results
+ *   ioctl(fd, TUXBENCH_IOC_LOADED, &lr) // latency under bandwidth load
+ *   ioctl(fd, TUXBENCH_IOC_RUN_V2, &r2) // chosen tests/sizes/CPUs + samples
+ *   ioctl(fd, TUXBENCH_IOC_MLP, &mr)    // latency vs. parallel chains
+ *   ioctl(fd, TUXBENCH_IOC_CANCEL)      // from another thread: stop the run
+ *   ioctl(fd, TUXBENCH_IOC_PROGRESS, &p)
  *   close fd
  *
  * The char device is created at module load; no udev rule needed (uses
@@ -41,10 +46,15 @@
 #include <linux/numa.h>
 #include <linux/kthread.h>
 #include <linux/sched.h>
+#include <linux/sched/signal.h>
 #include <linux/cpumask.h>
 #include <linux/completion.h>
 #include <linux/sort.h>
 #include <linux/topology.h>
+#include <linux/delay.h>
+#include <linux/atomic.h>
+#include <linux/int_sqrt.h>
+#include <linux/minmax.h>
 #include <asm/special_insns.h>
 #include <asm/fpu/api.h>
 #include <asm/cpufeature.h>
@@ -54,12 +64,10 @@
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("TuxTimings");
 MODULE_DESCRIPTION("Kernel-mode memory latency and bandwidth benchmark");
-MODULE_VERSION("0.4");
+MODULE_VERSION("0.9");
 
-/* AVX2 vector type — 4×u64 = 256 bits, unaligned-safe */
-typedef unsigned long long v4u64 __attribute__((vector_size(32), aligned(1)));
-
-static bool tb_avx2;
+/* Widest vector ISA for the bandwidth kernels (TUXBENCH_ISA_*), set at init */
+static int tb_isa;
 
 /* ── Constants ──────────────────────────────────────────────────────────── */
 
@@ -69,22 +77,48 @@ static bool tb_avx2;
 /* Latency: one pointer-chase node per cache line */
 #define CACHELINE       64
 #define LAT_SAMPLES_MIN 5          /* minimum samples before CV² check */
-#define LAT_SAMPLES_MAX 32         /* hard cap                         */
+#define LAT_SAMPLES_MAX 32         /* default cap                      */
 
 /* Bandwidth */
-#define BW_PASSES_MAX   64
+#define BW_PASSES_MIN   5
+#define BW_PASSES_MAX   TUXBENCH_MAX_SAMPLES
 
-/* Buffer sizing — override via module params */
+/* Default stopping rule: CV < 1/CV_INV_DEFAULT = 1% */
+#define CV_INV_DEFAULT  100
+
+/* Default buffer sizing — override via module params or tuxbench_req_v2 */
 static ulong bw_buf_mb = 512;
 module_param(bw_buf_mb, ulong, 0444);
 MODULE_PARM_DESC(bw_buf_mb, "Bandwidth buffer size in MB per thread (default 512)");
 
+static int max_isa = -1;
+module_param(max_isa, int, 0444);
+MODULE_PARM_DESC(max_isa, "Cap the bandwidth kernel ISA: 0 scalar, 1 AVX2, 2 AVX-512 (default -1 = widest available)");
+
 /* ── Char device globals ─────────────────────────────────────────────── */
 
 static dev_t         tb_dev;
 static struct cdev   tb_cdev;
 static struct class *tb_class;
 
+/* Per open file: lets a second thread cancel or poll the run on this fd */
+struct tb_file {
+    atomic_t cancel;        /* TUXBENCH_IOC_CANCEL seen; never cleared */
+    atomic_t done, total;   /* struct tuxbench_progress               */
+};
+
+/* Checked between passes: -EINTR on an explicit cancel or any signal */
+static bool tb_stopped(struct tb_file *tf)
+{
+    return signal_pending(current) || (tf && atomic_read(&tf->cancel));
+}
+
+static void tb_progress(struct tb_file *tf, int passes)
+{
+    if (tf && passes > 0)
+        atomic_add(passes, &tf->done);
+}
+
 /* ── Page allocation helpers ─────────────────────────────────────────── */
 
 /*
@@ -99,13 +133,16 @@ static struct class *tb_class;
  * entries, which fit comfortably in the L2 TLB.
  *
  * Falls back to vmalloc_node if vmalloc_huge is unavailable or fails.
+ * vmalloc_huge takes no node and allocates near the calling CPU, so a
+ * remote node (the node×node bandwidth matrix) always uses vmalloc_node.
  */
 static void *tb_alloc_node(size_t bytes, int node)
 {
-    void *p;
+    void *p = NULL;
 
     /* vmalloc_huge: added in 5.15, uses PMD-level (2 MB) mappings */
-    p = vmalloc_huge(bytes, GFP_KERNEL | __GFP_NORETRY | __GFP_NOWARN);
+    if (node == numa_node_id())
+        p = vmalloc_huge(bytes, GFP_KERNEL | __GFP_NORETRY | __GFP_NOWARN);
     if (!p)
         p = vmalloc_node(bytes, node);
     if (p)
@@ -155,6 +192,90 @@ static void tb_shuffle(size_t *arr, size_t n, u64 *rng)
     }
 }
 
+/* ── Run configuration ────────────────────────────────────────────────── */
+
+/*
+ * Everything a run can vary — built from tuxbench_req_v2, or from the module
+ * defaults for the legacy TUXBENCH_IOC_RUN.
+ */
+struct tb_run_cfg {
+    int                   node;
+    const struct cpumask *bw_mask;   /* bandwidth CPUs                      */
+    int                   nthreads;  /* ≤ weight(bw_mask); 0 = all of them  */
+    int                   lat_min, lat_max;
+    int                   bw_min,  bw_max;
+    u64                   cv_inv;    /* stop once CV < 1 / cv_inv           */
+    size_t                bw_bytes;  /* per-thread buffer                   */
+    int                   bwk;       /* TUXBENCH_BWK_* write/copy kernels   */
+    size_t                pf;        /* read/copy prefetch bytes, 0 = off   */
+    int                   lat_chain; /* TUXBENCH_CHAIN_* latency layout     */
+    struct tb_file       *tf;        /* cancel flag / progress of the fd    */
+};
+
+/*
+ * Integer CV check shared by latency and bandwidth:
+ *   CV < 1/cv_inv  ↔  var < mean² / cv_inv²
+ * Dividing mean² (rather than multiplying var) cannot overflow for any
+ * cv_inv; mean² itself stays below 1e18 for both ps and KB/s samples.
+ */
+static bool tb_converged(const u64 *samples, int n, u64 cv_inv)
+{
+    s64 isum = 0;
+    u64 imean, ivar;
+    int i;
+
+    for (i = 0; i < n; i++) isum += (s64)samples[i];
+    imean = (u64)(isum / n);
+
+    ivar = 0;
+    for (i = 0; i < n; i++) {
+        s64 d = (s64)samples[i] - (s64)imean;
+        ivar += (u64)(d * d);
+    }
+    if (n > 1) ivar /= (u64)(n - 1);   /* Bessel */
+
+    return ivar < imean * imean / (cv_inv * cv_inv);
+}
+
+static int cmp_u64(const void *a, const void *b);
+
+/* Summarise n raw samples (kept in measurement order) into st */
+static void tb_fill_stats(struct tuxbench_stats *st, const u64 *samples, int n)
+{
+    u64 tmp[TUXBENCH_MAX_SAMPLES];
+    u64 sum = 0, var = 0;
+    int i, p99;
+
+    memset(st, 0, sizeof(*st));
+    if (n <= 0)
+        return;
+    if (n > TUXBENCH_MAX_SAMPLES)
+        n = TUXBENCH_MAX_SAMPLES;
+
+    st->nsamples = n;
+    memcpy(st->samples, samples, n * sizeof(u64));
+    memcpy(tmp, samples, n * sizeof(u64));
+    sort(tmp, n, sizeof(u64), cmp_u64, NULL);
+
+    for (i = 0; i < n; i++) sum += tmp[i];
+    st->mean = sum / n;
+    for (i = 0; i < n; i++) {
+        s64 d = (s64)tmp[i] - (s64)st->mean;
+        var += (u64)(d * d);
+    }
+    if (n > 1) var /= (u64)(n - 1);
+
+    /* nearest-rank p99 */
+    p99 = (n * 99 + 99) / 100 - 1;
+    if (p99 >= n) p99 = n - 1;
+
+    st->min    = tmp[0];
+    st->median = tmp[n / 2];
+    st->p99    = tmp[p99];
+    st->max    = tmp[n - 1];
+    st->stddev = int_sqrt64(var);
+}
+
 /* ── Latency measurement ─────────────────────────────────────────────── */
 
 typedef struct tb_node {
@@ -168,6 +289,58 @@ static int cmp_u64(const void *a, const void *b)
     return (x > y) - (x < y);
 }
 
+#define TB_PAGE_LINES (4096 / CACHELINE)
+
+/*
+ * Traversal order into indices: one shuffle of all n_nodes, or (page-local)
+ * a shuffle within each 4 KB page with the pages left in address order.
+ */
+static void tb_chain_order(size_t *indices, size_t n_nodes, int layout, u64 *rng)
+{
+    size_t i;
+    for (i = 0; i < n_nodes; i++) indices[i] = i;
+    if (layout != TUXBENCH_CHAIN_PAGE_LOCAL) {
+        tb_shuffle(indices, n_nodes, rng);
+        return;
+    }
+    for (i = 0; i < n_nodes; i += TB_PAGE_LINES)
+        tb_shuffle(indices + i, min_t(size_t, n_nodes - i, TB_PAGE_LINES), rng);
+}
+
+/*
+ * Link the order into nchains disjoint cycles: chain c takes the c-th
+ * contiguous slice (whole pages when page-local), heads[c] its first node.
+ * Needs n_nodes ≥ nchains × TB_PAGE_LINES.
+ */
+static void tb_link_chains(tb_node_t *nodes, const size_t *indices, size_t n_nodes,
+                           int layout, int nchains, tb_node_t **heads)
+{
+    int c;
+    for (c = 0; c < nchains; c++) {
+        size_t lo = n_nodes * c / nchains;
+        size_t hi = n_nodes * (c + 1) / nchains;
+        size_t i;
+
+        if (layout == TUXBENCH_CHAIN_PAGE_LOCAL) {
+            lo -= lo % TB_PAGE_LINES;
+            if (c + 1 < nchains) hi -= hi % TB_PAGE_LINES;
+        }
+        for (i = lo; i < hi - 1; i++)
+            nodes[indices[i]].next = &nodes[indices[i + 1]];
+        nodes[indices[hi - 1]].next = &nodes[indices[lo]];
+        if (heads)
+            heads[c] = &nodes[indices[lo]];
+    }
+}
+
+/* One cycle through every node; indices is n_nodes of scratch. */
+static void tb_build_chain(tb_node_t *nodes, size_t *indices, size_t n_nodes,
+                           int layout, u64 *rng)
+{
+    tb_chain_order(indices, n_nodes, layout, rng);
+    tb_link_chains(nodes, indices, n_nodes, layout, 1, NULL);
+}
+
 /*
  * Measure pointer-chase latency for a buffer of buf_bytes.
  *
@@ -175,28 +348,31 @@ static int cmp_u64(const void *a, const void *b)
  *   L1: 200000000, L2: 50000000, L3: 5000000, DRAM: 1000000
  *   More iters = later samples hit warm cache = measures cache-resident latency.
  *
+ * cfg->lat_chain picks the layout: random, or page-local (TUXBENCH_CHAIN_*).
+ *
  * flush_each: if non-zero, call wbinvd before every sample (cold access).
  *   Use 1 only for DRAM (to ensure data is never cached).
  *   L1/L2/L3 use 0 — data warms up in the cache after the first traversal,
  *   and the median of LAT_SAMPLES then reflects the true cache-resident latency,
  *   matching what the userspace benchmark reports.
  *
- * Returns latency in picoseconds.
+ * Stores per-sample latency in picoseconds in samples[] (cfg->lat_max
+ * entries) and returns the sample count, 0 on failure.
  */
-static u64 tb_measure_latency_ps(size_t buf_bytes, long long min_iters,
-                                  int flush_each, int node)
+static int tb_measure_latency(size_t buf_bytes, long long min_iters,
+                              int flush_each, const struct tb_run_cfg *cfg,
+                              u64 *samples)
 {
     size_t n_nodes = buf_bytes / sizeof(tb_node_t);
     tb_node_t *nodes;
     size_t *indices;
-    u64 samples[LAT_SAMPLES_MAX];
     u64 rng;
     int s, n;
 
-    if (n_nodes < 2)
+    if (n_nodes < TB_PAGE_LINES)
         return 0;
 
-    nodes = tb_alloc_node(buf_bytes, node);
+    nodes = tb_alloc_node(buf_bytes, cfg->node);
     if (!nodes)
         return 0;
 
@@ -213,14 +389,7 @@ static u64 tb_measure_latency_ps(size_t buf_bytes, long long min_iters,
     /* Build the random permutation once.  All samples chase the same chain
      * so DRAM row-hit patterns are identical across samples, eliminating
      * the inter-sample variance caused by different access patterns. */
-    {
-        size_t i;
-        for (i = 0; i < n_nodes; i++) indices[i] = i;
-        tb_shuffle(indices, n_nodes, &rng);
-        for (i = 0; i < n_nodes - 1; i++)
-            nodes[indices[i]].next = &nodes[indices[i + 1]];
-        nodes[indices[n_nodes - 1]].next = &nodes[indices[0]];
-    }
+    tb_build_chain(nodes, indices, n_nodes, cfg->lat_chain, &rng);
 
     /* Warm-up pass: one full traversal before any timing begins.
      * Ensures the chain is resident in the target cache level so that
@@ -234,11 +403,13 @@ static u64 tb_measure_latency_ps(size_t buf_bytes, long long min_iters,
     }
 
     n = 0;
-    for (s = 0; s < LAT_SAMPLES_MAX; s++) {
+    for (s = 0; s < cfg->lat_max; s++) {
         tb_node_t *p;
         u64 t0, t1, iters;
         long long elapsed_ns;
 
+        if (tb_stopped(cfg->tf))
+            break;
         if (flush_each)
             tb_flush_all();
 
@@ -265,38 +436,21 @@ static u64 tb_measure_latency_ps(size_t buf_bytes, long long min_iters,
         elapsed_ns = (long long)(t1 - t0);
         samples[s] = (u64)elapsed_ns * 1000ULL / (iters * (u64)n_nodes);
         n++;
+        tb_progress(cfg->tf, 1);
 
-        if (n < LAT_SAMPLES_MIN) continue;
-
-        /* CV² < 0.0001  ↔  var*10000 < mean²  (same criterion as bandwidth) */
-        {
-            s64 isum = 0;
-            u64 imean, ivar, imean2;
-            int i;
-
-            for (i = 0; i < n; i++) isum += (s64)samples[i];
-            imean = (u64)(isum / n);
+        if (n < cfg->lat_min) continue;
 
-            ivar = 0;
-            for (i = 0; i < n; i++) {
-                s64 d = (s64)samples[i] - (s64)imean;
-                ivar += (u64)(d * d);
-            }
-            if (n > 1) ivar /= (u64)(n - 1);
-
-            imean2 = imean * imean;
-            if (ivar * 10000ULL < imean2)
-                break;
-        }
+        /* same criterion as bandwidth */
+        if (tb_converged(samples, n, cfg->cv_inv))
+            break;
     }
 
     sched_set_normal(current, 0);
+    tb_progress(cfg->tf, cfg->lat_max - n);   /* passes CV made unnecessary */
 
     kvfree(indices);
     tb_free(nodes, buf_bytes);
-
-    sort(samples, n, sizeof(u64), cmp_u64, NULL);
-    return samples[n / 2];
+    return n;
 }
 
 /* ── Cache sizing via sysfs ───────────────────────────────────────────── */
@@ -417,12 +571,16 @@ static void tb_detect_lat_sizes(size_t *l1, size_t *l2, size_t *l3)
 
 /* ── Per-thread bandwidth state ──────────────────────────────────────── */
 
+struct tb_bw_kernels;
+
 struct bw_thread {
     /* inputs */
     u64    *buf_a;        /* read / write / copy dst   */
     u64    *buf_b;        /* copy src                  */
     size_t  n64;          /* elements                  */
     int     op;           /* 0=read 1=write 2=copy     */
+    const struct tb_bw_kernels *kern;
+    size_t  pf;           /* read prefetch bytes, 0=off */
 
     /* synchronisation */
     struct completion  ready;   /* thread signals it has started */
@@ -462,50 +620,23 @@ struct bw_thread {
  * units of (N * 8) u64 offsets.
  */
 
-static void do_read_kernel(u64 *a, size_t n)
+/*
+ * pf: prefetch distance in bytes, 0 = none (the historical default —
+ * the hardware prefetchers alone).
+ */
+static void do_read_scalar(u64 *a, size_t n, size_t pf)
 {
-    u64 sink;
+    u64 s0 = 0, s1 = 0, s2 = 0, s3 = 0,
+        s4 = 0, s5 = 0, s6 = 0, s7 = 0;
+    size_t i;
 
-    if (tb_avx2) {
-        /*
-         * AVX2 path: 8 independent 256-bit accumulators, 256 bytes per
-         * iteration.  kernel_fpu_begin/end saves/restores YMM state.
-         * GCC vector extensions compile to vmovdqu + vpxor without
-         * requiring immintrin.h.
-         */
-        const char *p    = (const char *)a;
-        const char *stop = p + ((n * sizeof(u64)) & ~255UL);
-        v4u64 s0 = {}, s1 = {}, s2 = {}, s3 = {},
-              s4 = {}, s5 = {}, s6 = {}, s7 = {};
-
-        kernel_fpu_begin();
-        for (; p < stop; p += 256) {
-            s0 ^= *(const v4u64 *)(p +   0);
-            s1 ^= *(const v4u64 *)(p +  32);
-            s2 ^= *(const v4u64 *)(p +  64);
-            s3 ^= *(const v4u64 *)(p +  96);
-            s4 ^= *(const v4u64 *)(p + 128);
-            s5 ^= *(const v4u64 *)(p + 160);
-            s6 ^= *(const v4u64 *)(p + 192);
-            s7 ^= *(const v4u64 *)(p + 224);
-        }
-        s0 ^= s1; s2 ^= s3; s4 ^= s5; s6 ^= s7;
-        s0 ^= s2; s4 ^= s6; s0 ^= s4;
-        sink = s0[0] ^ s0[1] ^ s0[2] ^ s0[3];
-        kernel_fpu_end();
-    } else {
-        /* Scalar fallback for CPUs without AVX2 */
-        u64 s0 = 0, s1 = 0, s2 = 0, s3 = 0,
-            s4 = 0, s5 = 0, s6 = 0, s7 = 0;
-        size_t i;
-        for (i = 0; i + 7 < n; i += 8) {
-            s0 ^= a[i+0]; s1 ^= a[i+1]; s2 ^= a[i+2]; s3 ^= a[i+3];
-            s4 ^= a[i+4]; s5 ^= a[i+5]; s6 ^= a[i+6]; s7 ^= a[i+7];
-        }
-        sink = s0 ^ s1 ^ s2 ^ s3 ^ s4 ^ s5 ^ s6 ^ s7;
+    for (i = 0; i + 7 < n; i += 8) {
+        if (pf)
+            __builtin_prefetch((const char *)&a[i] + pf, 0, 0);
+        s0 ^= a[i+0]; s1 ^= a[i+1]; s2 ^= a[i+2]; s3 ^= a[i+3];
+        s4 ^= a[i+4]; s5 ^= a[i+5]; s6 ^= a[i+6]; s7 ^= a[i+7];
     }
-
-    WRITE_ONCE(*(u64 *)a, sink);
+    WRITE_ONCE(*(u64 *)a, s0 ^ s1 ^ s2 ^ s3 ^ s4 ^ s5 ^ s6 ^ s7);
 }
 
 static void do_write_kernel(u64 *a, size_t n)
@@ -526,7 +657,7 @@ static void do_write_kernel(u64 *a, size_t n)
     asm volatile("sfence" ::: "memory");
 }
 
-static void do_copy_kernel(u64 *dst, const u64 *src, size_t n)
+static void do_copy_kernel(u64 *dst, const u64 *src, size_t n, size_t pf)
 {
     size_t bytes = n * sizeof(u64);
     asm volatile("rep movsb"
@@ -534,6 +665,272 @@ static void do_copy_kernel(u64 *dst, const u64 *src, size_t n)
                  :: "memory");
 }
 
+/*
+ * Store-strategy variants, selectable per run through tuxbench_req_v2:
+ *   NT       — copy with movnti stores too (rep movsb above is temporal
+ *              below the microcode's streaming threshold)
+ *   temporal — plain stores; each missed line costs an RFO read first, so
+ *              the gap to NT is the write-allocate tax
+ *   ERMS     — rep stosb for writes as well, i.e. what memset() does
+ * READ_ONCE/WRITE_ONCE keep the compiler from turning the loops into
+ * memcpy/memset calls, which would just be rep movsb/stosb again.
+ */
+static void do_copy_nt(u64 *dst, const u64 *src, size_t n, size_t pf)
+{
+    size_t i;
+
+    for (i = 0; i + 7 < n; i += 8) {
+        u64 v0, v1, v2, v3, v4, v5, v6, v7;
+
+        if (pf)
+            __builtin_prefetch((const char *)&src[i] + pf, 0, 0);
+        v0 = READ_ONCE(src[i+0]); v1 = READ_ONCE(src[i+1]);
+        v2 = READ_ONCE(src[i+2]); v3 = READ_ONCE(src[i+3]);
+        v4 = READ_ONCE(src[i+4]); v5 = READ_ONCE(src[i+5]);
+        v6 = READ_ONCE(src[i+6]); v7 = READ_ONCE(src[i+7]);
+        asm volatile("movnti %1, %0" : "=m"(dst[i+0]) : "r"(v0));
+        asm volatile("movnti %1, %0" : "=m"(dst[i+1]) : "r"(v1));
+        asm volatile("movnti %1, %0" : "=m"(dst[i+2]) : "r"(v2));
+        asm volatile("movnti %1, %0" : "=m"(dst[i+3]) : "r"(v3));
+        asm volatile("movnti %1, %0" : "=m"(dst[i+4]) : "r"(v4));
+        asm volatile("movnti %1, %0" : "=m"(dst[i+5]) : "r"(v5));
+        asm volatile("movnti %1, %0" : "=m"(dst[i+6]) : "r"(v6));
+        asm volatile("movnti %1, %0" : "=m"(dst[i+7]) : "r"(v7));
+    }
+    asm volatile("sfence" ::: "memory");
+}
+
+static void do_write_temporal(u64 *a, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i + 7 < n; i += 8) {
+        WRITE_ONCE(a[i+0], 0); WRITE_ONCE(a[i+1], 0);
+        WRITE_ONCE(a[i+2], 0); WRITE_ONCE(a[i+3], 0);
+        WRITE_ONCE(a[i+4], 0); WRITE_ONCE(a[i+5], 0);
+        WRITE_ONCE(a[i+6], 0); WRITE_ONCE(a[i+7], 0);
+    }
+}
+
+static void do_copy_temporal(u64 *dst, const u64 *src, size_t n, size_t pf)
+{
+    size_t i;
+
+    for (i = 0; i + 7 < n; i += 8) {
+        if (pf)
+            __builtin_prefetch((const char *)&src[i] + pf, 0, 0);
+        WRITE_ONCE(dst[i+0], READ_ONCE(src[i+0]));
+        WRITE_ONCE(dst[i+1], READ_ONCE(src[i+1]));
+        WRITE_ONCE(dst[i+2], READ_ONCE(src[i+2]));
+        WRITE_ONCE(dst[i+3], READ_ONCE(src[i+3]));
+        WRITE_ONCE(dst[i+4], READ_ONCE(src[i+4]));
+        WRITE_ONCE(dst[i+5], READ_ONCE(src[i+5]));
+        WRITE_ONCE(dst[i+6], READ_ONCE(src[i+6]));
+        WRITE_ONCE(dst[i+7], READ_ONCE(src[i+7]));
+    }
+}
+
+static void do_write_erms(u64 *a, size_t n)
+{
+    size_t bytes = n * sizeof(u64);
+    asm volatile("rep stosb"
+                 : "+D"(a), "+c"(bytes)
+                 : "a"(0)
+                 : "memory");
+}
+
+/* ── AVX2 / AVX-512 kernels ──────────────────────────────────────────── */
+
+/*
+ * Same loop shape as the scalar kernels — 8 independent accumulators or
+ * 8 stores per iteration — with only the register width changing: 256
+ * bytes per iteration for AVX2, 512 for AVX-512.  The module is built
+ * without any vector flags; only the noinline target() bodies may emit
+ * YMM/ZMM code, so the scalar row of the dispatch table runs on any x86-64
+ * CPU.  The plain wrappers bracket each body with kernel_fpu_begin/end, so
+ * no vector register is touched outside the saved region — inlined into
+ * one function, the compiler could materialise the zeroed accumulators
+ * before kernel_fpu_begin().
+ *
+ * Stores go through asm so a constant-store loop cannot be folded into
+ * memset().  vmovntdq needs natural alignment; every buffer is vmalloc'd
+ * and a whole number of pages.
+ */
+#define TB_VST8(ins, vt, p, v0, v1, v2, v3, v4, v5, v6, v7)                  \
+    do {                                                                    \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 0 * sizeof(vt))) : "v"(v0)); \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 1 * sizeof(vt))) : "v"(v1)); \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 2 * sizeof(vt))) : "v"(v2)); \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 3 * sizeof(vt))) : "v"(v3)); \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 4 * sizeof(vt))) : "v"(v4)); \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 5 * sizeof(vt))) : "v"(v5)); \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 6 * sizeof(vt))) : "v"(v6)); \
+        asm volatile(ins " %1, %0" : "=m"(*(vt *)((p) + 7 * sizeof(vt))) : "v"(v7)); \
+    } while (0)
+
+#define TB_VEC_KERNELS(isa, vt, tgt, st, nt)                                  \
+static noinline __attribute__((target(tgt))) u64                            \
+tb_read_body_##isa(const u64 *a, size_t n, size_t pf)                       \
+{                                                                           \
+    const size_t step = 8 * sizeof(vt);                                     \
+    const char *p     = (const char *)a;                                    \
+    const char *stop  = p + ((n * sizeof(u64)) & ~(step - 1));              \
+    vt s0 = {}, s1 = {}, s2 = {}, s3 = {}, s4 = {}, s5 = {}, s6 = {}, s7 = {}; \
+    u64 sink = 0;                                                           \
+    size_t k;                                                               \
+                                                                            \
+    for (; p < stop; p += step) {                                           \
+        if (pf)                                                             \
+            for (k = 0; k < step; k += CACHELINE)                           \
+                __builtin_prefetch(p + pf + k, 0, 0);                       \
+        s0 ^= *(const vt *)(p + 0 * sizeof(vt));                            \
+        s1 ^= *(const vt *)(p + 1 * sizeof(vt));                            \
+        s2 ^= *(const vt *)(p + 2 * sizeof(vt));                            \
+        s3 ^= *(const vt *)(p + 3 * sizeof(vt));                            \
+        s4 ^= *(const vt *)(p + 4 * sizeof(vt));                            \
+        s5 ^= *(const vt *)(p + 5 * sizeof(vt));                            \
+        s6 ^= *(const vt *)(p + 6 * sizeof(vt));                            \
+        s7 ^= *(const vt *)(p + 7 * sizeof(vt));                            \
+    }                                                                       \
+    s0 ^= s1; s2 ^= s3; s4 ^= s5; s6 ^= s7;                                 \
+    s0 ^= s2; s4 ^= s6; s0 ^= s4;                                           \
+    for (k = 0; k < sizeof(vt) / sizeof(u64); k++)                          \
+        sink ^= s0[k];                                                      \
+    return sink;                                                            \
+}                                                                           \
+                                                                            \
+static noinline __attribute__((target(tgt))) void                           \
+tb_write_body_##isa(u64 *a, size_t n, bool nt_store)                        \
+{                                                                           \
+    const size_t step = 8 * sizeof(vt);                                     \
+    char *p    = (char *)a;                                                 \
+    char *stop = p + ((n * sizeof(u64)) & ~(step - 1));                     \
+    const vt z = {};                                                        \
+                                                                            \
+    if (nt_store) {                                                         \
+        for (; p < stop; p += step)                                         \
+            TB_VST8(nt, vt, p, z, z, z, z, z, z, z, z);                     \
+        asm volatile("sfence" ::: "memory");                                \
+    } else {                                                                \
+        for (; p < stop; p += step)                                         \
+            TB_VST8(st, vt, p, z, z, z, z, z, z, z, z);                     \
+    }                                                                       \
+}                                                                           \
+                                                                            \
+static noinline __attribute__((target(tgt))) void                           \
+tb_copy_body_##isa(u64 *dst, const u64 *src, size_t n, size_t pf, bool nt_store) \
+{                                                                           \
+    const size_t step = 8 * sizeof(vt);                                     \
+    char       *d    = (char *)dst;                                         \
+    const char *s    = (const char *)src;                                   \
+    const char *stop = s + ((n * sizeof(u64)) & ~(step - 1));               \
+    size_t k;                                                               \
+                                                                            \
+    for (; s < stop; s += step, d += step) {                                \
+        vt v0, v1, v2, v3, v4, v5, v6, v7;                                  \
+                                                                            \
+        if (pf)                                                             \
+            for (k = 0; k < step; k += CACHELINE)                           \
+                __builtin_prefetch(s + pf + k, 0, 0);                       \
+        v0 = *(const vt *)(s + 0 * sizeof(vt));                             \
+        v1 = *(const vt *)(s + 1 * sizeof(vt));                             \
+        v2 = *(const vt *)(s + 2 * sizeof(vt));                             \
+        v3 = *(const vt *)(s + 3 * sizeof(vt));                             \
+        v4 = *(const vt *)(s + 4 * sizeof(vt));                             \
+        v5 = *(const vt *)(s + 5 * sizeof(vt));                             \
+        v6 = *(const vt *)(s + 6 * sizeof(vt));                             \
+        v7 = *(const vt *)(s + 7 * sizeof(vt));                             \
+        if (nt_store)                                                       \
+            TB_VST8(nt, vt, d, v0, v1, v2, v3, v4, v5, v6, v7);             \
+        else                                                                \
+            TB_VST8(st, vt, d, v0, v1, v2, v3, v4, v5, v6, v7);             \
+    }                                                                       \
+    if (nt_store)                                                           \
+        asm volatile("sfence" ::: "memory");                                \
+}                                                                           \
+                                                                            \
+static void do_read_##isa(u64 *a, size_t n, size_t pf)                      \
+{                                                                           \
+    u64 sink;                                                               \
+                                                                            \
+    kernel_fpu_begin();                                                     \
+    sink = tb_read_body_##isa(a, n, pf);                                    \
+    kernel_fpu_end();                                                       \
+    WRITE_ONCE(*(u64 *)a, sink);                                            \
+}                                                                           \
+static void do_write_nt_##isa(u64 *a, size_t n)                             \
+{                                                                           \
+    kernel_fpu_begin();                                                     \
+    tb_write_body_##isa(a, n, true);                                        \
+    kernel_fpu_end();                                                       \
+}                                                                           \
+static void do_write_temporal_##isa(u64 *a, size_t n)                       \
+{                                                                           \
+    kernel_fpu_begin();                                                     \
+    tb_write_body_##isa(a, n, false);                                       \
+    kernel_fpu_end();                                                       \
+}                                                                           \
+static void do_copy_nt_##isa(u64 *dst, const u64 *src, size_t n, size_t pf) \
+{                                                                           \
+    kernel_fpu_begin();                                                     \
+    tb_copy_body_##isa(dst, src, n, pf, true);                              \
+    kernel_fpu_end();                                                       \
+}                                                                           \
+static void do_copy_temporal_##isa(u64 *dst, const u64 *src, size_t n, size_t pf) \
+{                                                                           \
+    kernel_fpu_begin();                                                     \
+    tb_copy_body_##isa(dst, src, n, pf, false);                             \
+    kernel_fpu_end();                                                       \
+}
+
+/* AVX2 vector type — 4×u64 = 256 bits, unaligned-safe */
+typedef unsigned long long v4u64 __attribute__((vector_size(32), aligned(1)));
+/* AVX-512 vector type — 8×u64 = 512 bits; only touched in avx512f code */
+typedef unsigned long long v8u64 __attribute__((vector_size(64), aligned(1)));
+
+TB_VEC_KERNELS(avx2,   v4u64, "avx2",    "vmovdqu",   "vmovntdq")
+TB_VEC_KERNELS(avx512, v8u64, "avx512f", "vmovdqu64", "vmovntdq")
+
+/*
+ * Kernel table, resolved once per run (tb_run_cfg.bwk): the row is the
+ * widest ISA the CPU has (tb_isa, set at init), the column the store
+ * strategy asked for.  DEFAULT and ERMS copy stay on rep movsb whatever
+ * the ISA; everything else uses full-width registers, which is what the
+ * userspace kernels do, so the two paths measure the same thing.
+ */
+struct tb_bw_kernels {
+    void (*read)(u64 *a, size_t n, size_t pf);
+    void (*write)(u64 *a, size_t n);
+    void (*copy)(u64 *dst, const u64 *src, size_t n, size_t pf);
+};
+
+static const struct tb_bw_kernels tb_bwk[TUXBENCH_ISA_COUNT][TUXBENCH_BWK_COUNT] = {
+    [TUXBENCH_ISA_SCALAR] = {
+        [TUXBENCH_BWK_DEFAULT]  = { do_read_scalar, do_write_kernel,   do_copy_kernel   },
+        [TUXBENCH_BWK_NT]       = { do_read_scalar, do_write_kernel,   do_copy_nt       },
+        [TUXBENCH_BWK_TEMPORAL] = { do_read_scalar, do_write_temporal, do_copy_temporal },
+        [TUXBENCH_BWK_ERMS]     = { do_read_scalar, do_write_erms,     do_copy_kernel   },
+    },
+    [TUXBENCH_ISA_AVX2] = {
+        [TUXBENCH_BWK_DEFAULT]  = { do_read_avx2, do_write_nt_avx2,       do_copy_kernel        },
+        [TUXBENCH_BWK_NT]       = { do_read_avx2, do_write_nt_avx2,       do_copy_nt_avx2       },
+        [TUXBENCH_BWK_TEMPORAL] = { do_read_avx2, do_write_temporal_avx2, do_copy_temporal_avx2 },
+        [TUXBENCH_BWK_ERMS]     = { do_read_avx2, do_write_erms,          do_copy_kernel        },
+    },
+    [TUXBENCH_ISA_AVX512] = {
+        [TUXBENCH_BWK_DEFAULT]  = { do_read_avx512, do_write_nt_avx512,       do_copy_kernel          },
+        [TUXBENCH_BWK_NT]       = { do_read_avx512, do_write_nt_avx512,       do_copy_nt_avx512       },
+        [TUXBENCH_BWK_TEMPORAL] = { do_read_avx512, do_write_temporal_avx512, do_copy_temporal_avx512 },
+        [TUXBENCH_BWK_ERMS]     = { do_read_avx512, do_write_erms,            do_copy_kernel          },
+    },
+};
+
+static const char *const tb_isa_name[TUXBENCH_ISA_COUNT] = {
+    [TUXBENCH_ISA_SCALAR] = "scalar (8x64-bit accumulators)",
+    [TUXBENCH_ISA_AVX2]   = "AVX2 (8x256-bit accumulators)",
+    [TUXBENCH_ISA_AVX512] = "AVX-512 (8x512-bit accumulators)",
+};
+
 /* ── kthread worker ──────────────────────────────────────────────────── */
 
 static int bw_thread_fn(void *arg)
@@ -547,9 +944,9 @@ static int bw_thread_fn(void *arg)
 
     t0 = ktime_get_ns();
     switch (t->op) {
-    case 0: do_read_kernel (t->buf_a,           t->n64); break;
-    case 1: do_write_kernel(t->buf_a,           t->n64); break;
-    case 2: do_copy_kernel (t->buf_a, t->buf_b, t->n64); break;
+    case 0: t->kern->read (t->buf_a, t->n64, t->pf);                break;
+    case 1: t->kern->write(t->buf_a, t->n64);                       break;
+    case 2: t->kern->copy (t->buf_a, t->buf_b, t->n64, t->pf);      break;
     }
     t1 = ktime_get_ns();
 
@@ -561,54 +958,53 @@ static int bw_thread_fn(void *arg)
 /* ── Bandwidth measurement ───────────────────────────────────────────── */
 
 /*
- * Run one bandwidth pass (op: 0=read 1=write 2=copy) across all online
- * physical cores.  Returns bandwidth in KB/s.
+ * One CPU per physical core on node — skip HT siblings.
+ * topology_sibling_cpumask() gives the HT set; keep only the
+ * lowest-numbered sibling per core.  Matches userspace build_cpu_list()
+ * and avoids overcounting bytes_total when SMT is enabled.
+ */
+static void tb_phys_mask(int node, struct cpumask *mask)
+{
+    int cpu;
+
+    for_each_cpu(cpu, cpumask_of_node(node)) {
+        const cpumask_t *siblings = topology_sibling_cpumask(cpu);
+        if (cpu == cpumask_first(siblings))
+            cpumask_set_cpu(cpu, mask);
+    }
+}
+
+/*
+ * Run bandwidth passes (op: 0=read 1=write 2=copy) on the CPUs in
+ * cfg->bw_mask.  Stores per-pass KB/s in samples[] (cfg->bw_max entries)
+ * and returns the pass count, 0 on failure.
  *
  * Strategy:
- *   - one kthread per online CPU (pinned via kthread_bind)
+ *   - one kthread per selected CPU (pinned via kthread_bind)
  *   - coordinator calls wbinvd_on_all_cpus() before each pass
  *   - all threads started simultaneously via completion; elapsed = max(elapsed)
- *   - repeat until CV² < BW_CV2_TARGET or BW_PASSES_MAX
+ *   - repeat until CV < 1/cfg->cv_inv or cfg->bw_max passes
  */
-static u64 tb_measure_bw(int op, int node)
+static int tb_measure_bw(int op, const struct tb_run_cfg *cfg, u64 *samples)
 {
-    cpumask_var_t phys_mask;
-    const cpumask_t *node_mask;
-    bool phys_mask_alloc = false;
+    const struct cpumask *node_mask = cfg->bw_mask;
+    int node = cfg->node;
     int ncpus;
     size_t buf_bytes;
-    u64 samples[BW_PASSES_MAX];
-    int npass, n;
+    int npass, n = 0;
     int cpu_idx;
     int cpu;
     struct bw_thread *threads;
     struct task_struct **tasks;
     u64 **bufs_a, **bufs_b;
-    u64 result = 0;
-
-    /*
-     * One thread per physical core — skip HT siblings.
-     * topology_sibling_cpumask() gives the HT set; keep only the
-     * lowest-numbered sibling per core.  Matches userspace build_cpu_list()
-     * and avoids overcounting bytes_total when SMT is enabled.
-     */
-    if (zalloc_cpumask_var(&phys_mask, GFP_KERNEL)) {
-        phys_mask_alloc = true;
-        for_each_cpu(cpu, cpumask_of_node(node)) {
-            const cpumask_t *siblings = topology_sibling_cpumask(cpu);
-            if (cpu == cpumask_first(siblings))
-                cpumask_set_cpu(cpu, phys_mask);
-        }
-        node_mask = phys_mask;
-    } else {
-        node_mask = cpumask_of_node(node);
-    }
 
     ncpus = cpumask_weight(node_mask);
+    if (cfg->nthreads > 0 && cfg->nthreads < ncpus)
+        ncpus = cfg->nthreads;
     if (ncpus <= 0)
-        ncpus = num_online_cpus();
+        return 0;
 
-    buf_bytes = (size_t)bw_buf_mb << 20;
+    buf_bytes = cfg->bw_bytes;
 
     threads = kcalloc(ncpus, sizeof(*threads), GFP_KERNEL);
     tasks   = kcalloc(ncpus, sizeof(*tasks),   GFP_KERNEL);
@@ -633,12 +1029,15 @@ static u64 tb_measure_bw(int op, int node)
         cpu_idx++;
     }
 
-    for (npass = 0; npass < BW_PASSES_MAX; npass++) {
+    for (npass = 0; npass < cfg->bw_max; npass++) {
         u64 max_elapsed = 0;
         size_t bytes_total;
         u64 bw_kbs;
         int i;
 
+        if (tb_stopped(cfg->tf))
+            break;
+
         /* global cache flush before each pass */
         wbinvd_on_all_cpus();
 
@@ -654,6 +1053,8 @@ static u64 tb_measure_bw(int op, int node)
             t->buf_b         = (op == 2) ? bufs_b[cpu_idx] : NULL;
             t->n64           = buf_bytes / sizeof(u64);
             t->op            = op;
+            t->kern          = &tb_bwk[tb_isa][cfg->bwk];
+            t->pf            = cfg->pf;
             init_completion(&t->ready);
             init_completion(&t->go);
             init_completion(&t->done);
@@ -697,36 +1098,18 @@ static u64 tb_measure_bw(int op, int node)
             bw_kbs = kb_total * 1000000000ULL / elapsed;
         }
 
-        samples[npass] = bw_kbs;
+        samples[n++] = bw_kbs;
+        tb_progress(cfg->tf, 1);
 
-        if (npass < 4) continue; /* need at least 5 samples */
+        if (n < cfg->bw_min) continue;
 
         /*
-         * Integer CV² check: CV² < 0.0001  ↔  var*10000 < mean²
-         * Using s64 to handle (sample - mean) differences safely.
-         * mean and samples are in KB/s (~70,000,000); mean² ~ 4.9e15 — fits u64.
-         * var/n ~ (700,000)²/64 ~ 7.6e9; *10000 ~ 7.6e13 — fits u64.
+         * KB/s samples (~70,000,000): mean² ~ 4.9e15 — fits u64, see
+         * tb_converged().
          */
-        {
-            s64 isum = 0;
-            u64 imean, ivar, imean2;
-            int nn = npass + 1;
-
-            for (i = 0; i < nn; i++) isum += (s64)samples[i];
-            imean = (u64)(isum / nn);
-
-            ivar = 0;
-            for (i = 0; i < nn; i++) {
-                s64 d = (s64)samples[i] - (s64)imean;
-                ivar += (u64)(d * d);
-            }
-            /* Bessel: divide by n-1 = npass */
-            if (npass > 0) ivar /= (u64)npass;
-
-            imean2 = imean * imean;
-            /* CV² < 0.0001  →  ivar * 10000 < imean² */
-            if (ivar * 10000ULL < imean2)
-                break;
+        if (tb_converged(samples, n, cfg->cv_inv)) {
+            tb_progress(cfg->tf, cfg->bw_max - n);
+            break;
         }
 
         continue;
@@ -739,17 +1122,10 @@ cleanup_threads:
                 wait_for_completion(&threads[i].done);
             }
         }
+        n = 0;   /* incomplete pass — report nothing */
         goto cleanup_bufs;
     }
 
-    n = (npass < BW_PASSES_MAX) ? npass + 1 : BW_PASSES_MAX;
-    {
-        u64 tmp[BW_PASSES_MAX];
-        memcpy(tmp, samples, n * sizeof(u64));
-        sort(tmp, n, sizeof(u64), cmp_u64, NULL);
-        result = tmp[n / 2];
-    }
-
 cleanup_bufs:
     for (cpu_idx = 0; cpu_idx < ncpus; cpu_idx++) {
         if (bufs_a[cpu_idx]) tb_free(bufs_a[cpu_idx], buf_bytes);
@@ -760,9 +1136,7 @@ cleanup_meta:
     kfree(tasks);
     kfree(bufs_a);
     kfree(bufs_b);
-    if (phys_mask_alloc)
-        free_cpumask_var(phys_mask);
-    return result;
+    return n;
 }
 
 /* ── DRAM buffer size ────────────────────────────────────────────────── */
@@ -781,53 +1155,619 @@ static size_t tb_dram_buf_bytes(void)
     return target;
 }
 
+/* ── Loaded latency ───────────────────────────────────────────────────── */
+
+/*
+ * Chaser runs in the ioctl task, pinned to the first physical core of the
+ * node; one kthread per remaining physical core generates load.  Workers
+ * stream LL_BLOCK_BYTES at a time and spin delay_ns between blocks, so the
+ * injected bandwidth falls as the delay grows.  Bandwidth is sampled from a
+ * shared byte counter over exactly the timed chase window.
+ */
+#define LL_BLOCK_BYTES  (64 * 1024)
+#define LL_CHASE_HOPS   1000000ULL
+#define LL_SAMPLES      3
+#define LL_WARMUP_MS    20
+
+struct ll_worker {
+    u64        *buf;
+    size_t      n64;          /* whole buffer; copy uses two halves  */
+    int         op;           /* TUXBENCH_LL_READ / _COPY            */
+    s32         delay_ns;
+    int        *stop;
+    atomic64_t *bytes;
+    struct completion done;
+};
+
+static int ll_worker_fn(void *arg)
+{
+    struct ll_worker *w = arg;
+    size_t blk  = LL_BLOCK_BYTES / sizeof(u64);
+    size_t span = (w->op == TUXBENCH_LL_COPY) ? w->n64 / 2 : w->n64;
+    size_t off  = 0;
+
+    while (!READ_ONCE(*w->stop)) {
+        if (w->op == TUXBENCH_LL_COPY) {
+            do_copy_kernel(w->buf + off, w->buf + span + off, blk, 0);
+            atomic64_add(2 * LL_BLOCK_BYTES, w->bytes);
+        } else {
+            tb_bwk[tb_isa][TUXBENCH_BWK_DEFAULT].read(w->buf + off, blk, 0);
+            atomic64_add(LL_BLOCK_BYTES, w->bytes);
+        }
+        off += blk;
+        if (off + blk > span)
+            off = 0;
+
+        if (w->delay_ns > 0) {
+            u64 until = ktime_get_ns() + (u64)w->delay_ns;
+            while (ktime_get_ns() < until)
+                cpu_relax();
+        }
+        cond_resched();   /* RCU quiescent point; FIFO keeps the CPU */
+    }
+
+    complete(&w->done);
+    return 0;
+}
+
+static long tb_loaded_latency(struct tuxbench_loaded_req *req, int node,
+                              struct tb_file *tf)
+{
+    cpumask_var_t phys_mask, saved_mask;
+    size_t chain_bytes, n_nodes, worker_bytes;
+    tb_node_t *nodes = NULL;
+    size_t *indices;
+    struct ll_worker *workers = NULL;
+    u64 **bufs = NULL;
+    int nworkers, chaser_cpu, cpu, i, lvl;
+    atomic64_t bytes;
+    int stop;
+    u64 rng;
+    long ret = -ENOMEM;
+
+    if (req->nlevels == 0 || req->nlevels > TUXBENCH_LL_MAX ||
+        req->op > TUXBENCH_LL_COPY)
+        return -EINVAL;
+
+    if (!zalloc_cpumask_var(&phys_mask, GFP_KERNEL))
+        return -ENOMEM;
+    if (!alloc_cpumask_var(&saved_mask, GFP_KERNEL)) {
+        free_cpumask_var(phys_mask);
+        return -ENOMEM;
+    }
+    tb_phys_mask(node, phys_mask);
+    chaser_cpu = cpumask_first(phys_mask);
+    if (chaser_cpu >= nr_cpu_ids)
+        chaser_cpu = cpumask_first(cpu_online_mask);
+    cpumask_clear_cpu(chaser_cpu, phys_mask);
+    nworkers = cpumask_weight(phys_mask);
+
+    /* Chain and load buffers both sized like the DRAM latency point */
+    chain_bytes  = tb_dram_buf_bytes();
+    n_nodes      = chain_bytes / sizeof(tb_node_t);
+    worker_bytes = nworkers ? chain_bytes / nworkers : 0;
+    if (worker_bytes < 32UL << 20)
+        worker_bytes = 32UL << 20;
+    worker_bytes &= ~((size_t)(2 * LL_BLOCK_BYTES) - 1);
+
+    nodes   = tb_alloc_node(chain_bytes, node);
+    indices = kvmalloc_array(n_nodes, sizeof(size_t), GFP_KERNEL);
+    if (!nodes || !indices) {
+        kvfree(indices);
+        goto out_free;
+    }
+    rng = (u64)(uintptr_t)nodes ^ (u64)ktime_get_ns();
+    tb_build_chain(nodes, indices, n_nodes, TUXBENCH_CHAIN_RANDOM, &rng);
+    kvfree(indices);
+
+    workers = kcalloc(nworkers ? nworkers : 1, sizeof(*workers), GFP_KERNEL);
+    bufs    = kcalloc(nworkers ? nworkers : 1, sizeof(*bufs),    GFP_KERNEL);
+    if (!workers || !bufs)
+        goto out_free;
+    for (i = 0; i < nworkers; i++) {
+        bufs[i] = tb_alloc_node(worker_bytes, node);
+        if (!bufs[i])
+            goto out_free;
+    }
+
+    cpumask_copy(saved_mask, current->cpus_ptr);
+    set_cpus_allowed_ptr(current, cpumask_of(chaser_cpu));
+    sched_set_fifo(current);
+
+    req->load_threads = nworkers;
+    if (nworkers == 0)
+        req->nlevels = 1;   /* single core: only the idle point is meaningful */
+    atomic_set(&tf->done, 0);
+    atomic_set(&tf->total, (int)req->nlevels);
+    ret = 0;
+    for (lvl = 0; lvl < (int)req->nlevels; lvl++) {
+        u64 lat[LL_SAMPLES], bw[LL_SAMPLES];
+        bool loaded = req->delay_ns[lvl] >= 0 && nworkers > 0;
+        int started = 0, s;
+
+        /* between levels only: no load workers are running here */
+        if (tb_stopped(tf)) {
+            ret = -EINTR;
+            break;
+        }
+
+        atomic64_set(&bytes, 0);
+        stop = 0;
+
+        if (loaded) {
+            i = 0;
+            for_each_cpu(cpu, phys_mask) {
+                struct ll_worker *w = &workers[i];
+                struct task_struct *task;
+
+                if (i >= nworkers) break;
+                w->buf      = bufs[i];
+                w->n64      = worker_bytes / sizeof(u64);
+                w->op       = req->op;
+                w->delay_ns = req->delay_ns[lvl];
+                w->stop     = &stop;
+                w->bytes    = &bytes;
+                init_completion(&w->done);
+
+                task = kthread_create(ll_worker_fn, w, "tuxbench-ll/%d", cpu);
+                if (IS_ERR(task)) break;
+                kthread_bind(task, cpu);
+                sched_set_fifo(task);
+                wake_up_process(task);
+                started = ++i;
+            }
+            msleep(LL_WARMUP_MS);   /* let the load reach steady state */
+        }
+
+        for (s = 0; s < LL_SAMPLES; s++) {
+            tb_node_t *p = &nodes[0];
+            u64 t0, t1, b0, b1, k;
+
+            tb_flush_all();
+            b0 = (u64)atomic64_read(&bytes);
+            t0 = ktime_get_ns();
+            for (k = 0; k < LL_CHASE_HOPS; k++)
+                p = p->next;
+            t1 = ktime_get_ns();
+            b1 = (u64)atomic64_read(&bytes);
+            WRITE_ONCE(nodes[0].pad[0], (char)(uintptr_t)p);
+
+            if (t1 <= t0) t1 = t0 + 1;
+            lat[s] = (t1 - t0) * 1000ULL / LL_CHASE_HOPS;
+            bw[s]  = ((b1 - b0) / 1024ULL) * 1000000000ULL / (t1 - t0);
+        }
+
+        WRITE_ONCE(stop, 1);
+        for (i = 0; i < started; i++)
+            wait_for_completion(&workers[i].done);
+
+        sort(lat, LL_SAMPLES, sizeof(u64), cmp_u64, NULL);
+        sort(bw,  LL_SAMPLES, sizeof(u64), cmp_u64, NULL);
+        req->lat_ps[lvl] = lat[LL_SAMPLES / 2];
+        req->bw_kbs[lvl] = bw[LL_SAMPLES / 2];
+        tb_progress(tf, 1);
+    }
+
+    sched_set_normal(current, 0);
+    set_cpus_allowed_ptr(current, saved_mask);
+
+out_free:
+    if (bufs) {
+        for (i = 0; i < nworkers; i++)
+            if (bufs[i]) tb_free(bufs[i], worker_bytes);
+    }
+    kfree(bufs);
+    kfree(workers);
+    if (nodes) tb_free(nodes, chain_bytes);
+    free_cpumask_var(saved_mask);
+    free_cpumask_var(phys_mask);
+    return ret;
+}
+
+/* ── Memory-level parallelism ─────────────────────────────────────────── */
+
+/*
+ * nchains chases share one DRAM-sized buffer, each cycling through its own
+ * slice, and advance one hop each per loop iteration.  The chains have no
+ * data dependence on each other, so the core can overlap up to nchains
+ * misses; once the time per iteration starts to grow with nchains, the
+ * miss-handling resources are saturated.  The order is shuffled once and
+ * only relinked per point.
+ */
+#define MLP_LOADS    2000000ULL     /* loads per sample across all chains */
+#define MLP_SAMPLES  3
+
+/* p[] lives on the stack: the store-to-load forward costs a few cycles
+ * per hop on each chain, far below a DRAM miss. */
+static noinline void tb_chase_chains(tb_node_t **p, int nchains, u64 hops)
+{
+    u64 k;
+    int c;
+    for (k = 0; k < hops; k++)
+        for (c = 0; c < nchains; c++)
+            p[c] = p[c]->next;
+}
+
+static long tb_mlp(struct tuxbench_mlp_req *req, int node, struct tb_file *tf)
+{
+    tb_node_t *heads[TUXBENCH_MLP_CHAINS], *p[TUXBENCH_MLP_CHAINS];
+    size_t bytes, n_nodes;
+    tb_node_t *nodes;
+    size_t *indices;
+    u64 rng;
+    int i, c;
+    long ret = 0;
+
+    if (req->npoints == 0 || req->npoints > TUXBENCH_MLP_MAX ||
+        req->chain >= TUXBENCH_CHAIN_COUNT)
+        return -EINVAL;
+    for (i = 0; i < (int)req->npoints; i++)
+        if (req->nchains[i] < 1 || req->nchains[i] > TUXBENCH_MLP_CHAINS)
+            return -EINVAL;
+
+    bytes   = tb_dram_buf_bytes();
+    n_nodes = bytes / sizeof(tb_node_t);
+    nodes   = tb_alloc_node(bytes, node);
+    if (!nodes)
+        return -ENOMEM;
+    indices = kvmalloc_array(n_nodes, sizeof(size_t), GFP_KERNEL);
+    if (!indices) {
+        tb_free(nodes, bytes);
+        return -ENOMEM;
+    }
+    rng = (u64)(uintptr_t)nodes ^ (u64)ktime_get_ns();
+    tb_chain_order(indices, n_nodes, req->chain, &rng);
+    req->bytes = bytes;
+
+    sched_set_fifo(current);
+    atomic_set(&tf->done, 0);
+    atomic_set(&tf->total, (int)req->npoints);
+
+    for (i = 0; i < (int)req->npoints; i++) {
+        int nc = (int)req->nchains[i];
+        u64 hops = MLP_LOADS / nc;
+        u64 lat[MLP_SAMPLES];
+        int s;
+
+        if (tb_stopped(tf)) {
+            ret = -EINTR;
+            break;
+        }
+        tb_link_chains(nodes, indices, n_nodes, req->chain, nc, heads);
+
+        for (s = 0; s < MLP_SAMPLES; s++) {
+            u64 t0, t1;
+
+            tb_flush_all();
+            for (c = 0; c < nc; c++)
+                p[c] = heads[c];
+            migrate_disable();
+            t0 = ktime_get_ns();
+            tb_chase_chains(p, nc, hops);
+            t1 = ktime_get_ns();
+            migrate_enable();
+            for (c = 0; c < nc; c++)
+                WRITE_ONCE(heads[c]->pad[0], (char)(uintptr_t)p[c]);
+
+            if (t1 <= t0) t1 = t0 + 1;
+            lat[s] = (t1 - t0) * 1000ULL / hops;
+        }
+        sort(lat, MLP_SAMPLES, sizeof(u64), cmp_u64, NULL);
+        req->lat_ps[i] = lat[MLP_SAMPLES / 2];
+        tb_progress(tf, 1);
+    }
+
+    sched_set_normal(current, 0);
+    kvfree(indices);
+    tb_free(nodes, bytes);
+    return ret;
+}
+
 /* ── ioctl handler ────────────────────────────────────────────────────── */
 
-static long tb_ioctl(struct file *f, unsigned int cmd, unsigned long arg)
+static long tb_ioctl_loaded(struct tb_file *tf, unsigned long arg)
 {
-    struct tuxbench_req req;
-    int node;
+    struct tuxbench_loaded_req *req;
+    long ret;
+
+    /* ~300 bytes — keep it off the kernel stack */
+    req = kmalloc(sizeof(*req), GFP_KERNEL);
+    if (!req)
+        return -ENOMEM;
+    if (copy_from_user(req, (void __user *)arg, sizeof(*req))) {
+        kfree(req);
+        return -EFAULT;
+    }
+
+    req->load_threads = 0;
+    memset(req->lat_ps, 0, sizeof(req->lat_ps));
+    memset(req->bw_kbs, 0, sizeof(req->bw_kbs));
 
-    if (cmd != TUXBENCH_IOC_RUN)
-        return -ENOTTY;
+    ret = tb_loaded_latency(req, numa_node_id(), tf);
+    if (ret == 0 && copy_to_user((void __user *)arg, req, sizeof(*req)))
+        ret = -EFAULT;
+    kfree(req);
+    return ret;
+}
+
+static long tb_ioctl_mlp(struct tb_file *tf, unsigned long arg)
+{
+    struct tuxbench_mlp_req req;
+    long ret;
 
     if (copy_from_user(&req, (void __user *)arg, sizeof(req)))
         return -EFAULT;
+    req.bytes = 0;
+    memset(req.lat_ps, 0, sizeof(req.lat_ps));
 
-    node = numa_node_id();
-    /* zero only the result fields, preserving flags */
-    req.lat_l1_ps = req.lat_l2_ps = req.lat_l3_ps = req.lat_dram_ps = 0;
-    req.bw_read_kbs = req.bw_write_kbs = req.bw_copy_kbs = 0;
+    ret = tb_mlp(&req, numa_node_id(), tf);
+    if (ret == 0 && copy_to_user((void __user *)arg, &req, sizeof(req)))
+        ret = -EFAULT;
+    return ret;
+}
 
-    if (req.flags & TUXBENCH_FL_LAT) {
-        size_t l1, l2, l3;
-        size_t dram_buf;
+/* Module defaults; bw_mask is filled with one CPU per physical core */
+static void tb_default_cfg(struct tb_run_cfg *cfg, int node, struct cpumask *mask,
+                           struct tb_file *tf)
+{
+    tb_phys_mask(node, mask);
+    cfg->node     = node;
+    cfg->bw_mask  = mask;
+    cfg->nthreads = 0;
+    cfg->lat_min  = LAT_SAMPLES_MIN;
+    cfg->lat_max  = LAT_SAMPLES_MAX;
+    cfg->bw_min   = BW_PASSES_MIN;
+    cfg->bw_max   = BW_PASSES_MAX;
+    cfg->cv_inv   = CV_INV_DEFAULT;
+    cfg->bw_bytes = (size_t)bw_buf_mb << 20;
+    cfg->bwk      = TUXBENCH_BWK_DEFAULT;
+    cfg->pf       = 0;
+    cfg->lat_chain = TUXBENCH_CHAIN_RANDOM;
+    cfg->tf       = tf;
+}
 
-        tb_detect_lat_sizes(&l1, &l2, &l3);
-        dram_buf = tb_dram_buf_bytes();
+/*
+ * Run every test selected in ops; res[] is indexed by TUXBENCH_RES_*.
+ * lat_bytes (may be NULL) overrides the topology-derived chain sizes.
+ * Returns 0, or -EINTR when cancelled (res[] then partly filled).
+ */
+static int tb_run(const struct tb_run_cfg *cfg, u32 ops, const u64 *lat_bytes,
+                  struct tuxbench_stats *res)
+{
+    static const long long lat_iters[4] = {
+        200000000LL, 50000000LL, 20000000LL, 1000000LL,
+    };
+    u64 samples[TUXBENCH_MAX_SAMPLES];
+    size_t sizes[4] = { 0 };
+    int i, n, total = 0;
+
+    if (ops & TUXBENCH_OPS_LAT) {
+        tb_detect_lat_sizes(&sizes[0], &sizes[1], &sizes[2]);
+        sizes[3] = tb_dram_buf_bytes();
+    }
+    for (i = 0; i < TUXBENCH_NR_RES; i++)
+        if (ops & TUXBENCH_OP(i))
+            total += i <= TUXBENCH_RES_LAT_DRAM ? cfg->lat_max : cfg->bw_max;
+    atomic_set(&cfg->tf->done, 0);
+    atomic_set(&cfg->tf->total, total);
+
+    for (i = 0; i < 4; i++) {
+        if (!(ops & TUXBENCH_OP(TUXBENCH_RES_LAT_L1 + i)))
+            continue;
+        if (lat_bytes && lat_bytes[i])
+            sizes[i] = lat_bytes[i];
+        /* only the DRAM chain is wbinvd-flushed between samples */
+        n = tb_measure_latency(sizes[i], lat_iters[i], i == 3, cfg, samples);
+        tb_fill_stats(&res[TUXBENCH_RES_LAT_L1 + i], samples, n);
+        if (tb_stopped(cfg->tf))
+            return -EINTR;
+    }
 
-        req.lat_l1_ps   = tb_measure_latency_ps(l1,       200000000LL, 0, node);
-        req.lat_l2_ps   = tb_measure_latency_ps(l2,        50000000LL, 0, node);
-        req.lat_l3_ps   = tb_measure_latency_ps(l3,        20000000LL, 0, node);
-        req.lat_dram_ps = tb_measure_latency_ps(dram_buf,   1000000LL, 1, node);
+    for (i = 0; i < 3; i++) {
+        if (!(ops & TUXBENCH_OP(TUXBENCH_RES_BW_READ + i)))
+            continue;
+        n = tb_measure_bw(i, cfg, samples);
+        tb_fill_stats(&res[TUXBENCH_RES_BW_READ + i], samples, n);
+        if (tb_stopped(cfg->tf))
+            return -EINTR;
     }
+    return 0;
+}
 
-    if (req.flags & TUXBENCH_FL_BW) {
-        req.bw_read_kbs  = tb_measure_bw(0, node);
-        req.bw_write_kbs = tb_measure_bw(1, node);
-        req.bw_copy_kbs  = tb_measure_bw(2, node);
+/* Legacy TUXBENCH_IOC_RUN: full suite with module defaults, medians only */
+static long tb_ioctl_run(struct tb_file *tf, unsigned long arg)
+{
+    struct tuxbench_req req;
+    struct tuxbench_stats *res;
+    struct tb_run_cfg cfg;
+    cpumask_var_t mask;
+    u32 ops = 0;
+    int ret;
+
+    if (copy_from_user(&req, (void __user *)arg, sizeof(req)))
+        return -EFAULT;
+
+    if (req.flags & TUXBENCH_FL_LAT) ops |= TUXBENCH_OPS_LAT;
+    if (req.flags & TUXBENCH_FL_BW)  ops |= TUXBENCH_OPS_BW;
+
+    /* 7 × ~570 bytes — keep it off the kernel stack */
+    res = kcalloc(TUXBENCH_NR_RES, sizeof(*res), GFP_KERNEL);
+    if (!res)
+        return -ENOMEM;
+    if (!zalloc_cpumask_var(&mask, GFP_KERNEL)) {
+        kfree(res);
+        return -ENOMEM;
     }
 
+    tb_default_cfg(&cfg, numa_node_id(), mask, tf);
+    ret = tb_run(&cfg, ops, NULL, res);
+
+    req.lat_l1_ps    = res[TUXBENCH_RES_LAT_L1].median;
+    req.lat_l2_ps    = res[TUXBENCH_RES_LAT_L2].median;
+    req.lat_l3_ps    = res[TUXBENCH_RES_LAT_L3].median;
+    req.lat_dram_ps  = res[TUXBENCH_RES_LAT_DRAM].median;
+    req.bw_read_kbs  = res[TUXBENCH_RES_BW_READ].median;
+    req.bw_write_kbs = res[TUXBENCH_RES_BW_WRITE].median;
+    req.bw_copy_kbs  = res[TUXBENCH_RES_BW_COPY].median;
+
+    free_cpumask_var(mask);
+    kfree(res);
+
+    if (ret)
+        return ret;
     if (copy_to_user((void __user *)arg, &req, sizeof(req)))
         return -EFAULT;
+    return 0;
+}
+
+/* TUXBENCH_IOC_RUN_V2: usize is the caller's struct size from the ioctl number */
+static long tb_ioctl_run_v2(struct tb_file *tf, unsigned long arg, size_t usize)
+{
+    struct tuxbench_req_v2 *req;
+    struct tb_run_cfg cfg;
+    cpumask_var_t mask;
+    int node, w, b;
+    bool user_mask = false;
+    long ret;
+
+    /* Every input field must be present */
+    if (usize < offsetofend(struct tuxbench_req_v2, cpumask))
+        return -EINVAL;
+
+    req = kzalloc(sizeof(*req), GFP_KERNEL);
+    if (!req)
+        return -ENOMEM;
+    ret = copy_struct_from_user(req, sizeof(*req), (void __user *)arg, usize);
+    if (ret)
+        goto out_req;
+
+    ret = -EINVAL;
+    if (req->ops & ~(TUXBENCH_OPS_LAT | TUXBENCH_OPS_BW))
+        goto out_req;
+    node = req->numa_node < 0 ? numa_node_id() : req->numa_node;
+    if (node >= MAX_NUMNODES || !node_online(node))
+        goto out_req;
+
+    ret = -ENOMEM;
+    if (!zalloc_cpumask_var(&mask, GFP_KERNEL))
+        goto out_req;
+    tb_default_cfg(&cfg, node, mask, tf);
+
+    /* Explicit CPU list replaces the physical-core default (SMT allowed) */
+    for (w = 0; w < TUXBENCH_CPUMASK_WORDS; w++)
+        if (req->cpumask[w])
+            user_mask = true;
+    if (user_mask) {
+        cpumask_clear(mask);
+        for (w = 0; w < TUXBENCH_CPUMASK_WORDS; w++) {
+            for (b = 0; b < 64; b++) {
+                int cpu = w * 64 + b;
+                if ((req->cpumask[w] >> b) & 1 &&
+                    cpu < nr_cpu_ids && cpu_online(cpu))
+                    cpumask_set_cpu(cpu, mask);
+            }
+        }
+        ret = -EINVAL;
+        if (cpumask_empty(mask))
+            goto out_mask;
+    }
+
+    if (req->nthreads)
+        cfg.nthreads = req->nthreads;
+    if (req->min_passes)
+        cfg.lat_min = cfg.bw_min = clamp_t(int, req->min_passes, 1, TUXBENCH_MAX_SAMPLES);
+    if (req->max_passes)
+        cfg.lat_max = cfg.bw_max = clamp_t(int, req->max_passes, 1, TUXBENCH_MAX_SAMPLES);
+    cfg.lat_min = min(cfg.lat_min, cfg.lat_max);
+    cfg.bw_min  = min(cfg.bw_min,  cfg.bw_max);
+    if (req->cv_ppm)
+        cfg.cv_inv = 1000000U / clamp_t(u32, req->cv_ppm, 100, 1000000);
+    if (req->bw_bytes)   /* whole 4 KB pages; kernels stride ≤ 512 bytes */
+        cfg.bw_bytes = max_t(u64, req->bw_bytes, 1ULL << 20) & ~4095ULL;
+    ret = -EINVAL;
+    if (req->bw_kernel >= TUXBENCH_BWK_COUNT)
+        goto out_mask;
+    cfg.bwk = req->bw_kernel;
+    /* whole cache lines, at most 64 KB ahead */
+    cfg.pf  = min_t(u32, req->pf_dist, 65536) & ~63U;
+    if (req->lat_chain >= TUXBENCH_CHAIN_COUNT)
+        goto out_mask;
+    cfg.lat_chain = req->lat_chain;
+
+    req->threads_used = 0;
+    if (req->ops & TUXBENCH_OPS_BW) {
+        int wt = cpumask_weight(mask);
+        req->threads_used = (cfg.nthreads && cfg.nthreads < wt) ? cfg.nthreads : wt;
+    }
+    memset(req->res, 0, sizeof(req->res));
+    ret = tb_run(&cfg, req->ops, req->lat_bytes, req->res);
+    if (ret)
+        goto out_mask;
+    req->version   = TUXBENCH_ABI_VERSION;
+    req->bw_kernel = cfg.bwk;
+    req->pf_dist   = (u32)cfg.pf;
+    req->bw_isa    = tb_isa;
+
+    ret = 0;
+    if (copy_to_user((void __user *)arg, req, min(usize, sizeof(*req))))
+        ret = -EFAULT;
+
+out_mask:
+    free_cpumask_var(mask);
+out_req:
+    kfree(req);
+    return ret;
+}
 
+static long tb_ioctl_progress(struct tb_file *tf, unsigned long arg)
+{
+    struct tuxbench_progress p = {
+        .done  = (u32)atomic_read(&tf->done),
+        .total = (u32)atomic_read(&tf->total),
+    };
+
+    if (copy_to_user((void __user *)arg, &p, sizeof(p)))
+        return -EFAULT;
     return 0;
 }
 
+static long tb_ioctl(struct file *f, unsigned int cmd, unsigned long arg)
+{
+    struct tb_file *tf = f->private_data;
+
+    /* v2 matches on type/nr only — the size field varies with the caller */
+    if (_IOC_TYPE(cmd) == TUXBENCH_MAGIC &&
+        _IOC_NR(cmd) == _IOC_NR(TUXBENCH_IOC_RUN_V2) &&
+        _IOC_DIR(cmd) == (_IOC_READ | _IOC_WRITE))
+        return tb_ioctl_run_v2(tf, arg, _IOC_SIZE(cmd));
+
+    switch (cmd) {
+    case TUXBENCH_IOC_RUN:      return tb_ioctl_run(tf, arg);
+    case TUXBENCH_IOC_LOADED:   return tb_ioctl_loaded(tf, arg);
+    case TUXBENCH_IOC_MLP:      return tb_ioctl_mlp(tf, arg);
+    case TUXBENCH_IOC_CANCEL:   atomic_set(&tf->cancel, 1); return 0;
+    case TUXBENCH_IOC_PROGRESS: return tb_ioctl_progress(tf, arg);
+    default:                    return -ENOTTY;
+    }
+}
+
 /* ── File operations ─────────────────────────────────────────────────── */
 
-static int tb_open(struct inode *i, struct file *f)  { return 0; }
-static int tb_release(struct inode *i, struct file *f) { return 0; }
+static int tb_open(struct inode *i, struct file *f)
+{
+    struct tb_file *tf = kzalloc(sizeof(*tf), GFP_KERNEL);
+
+    if (!tf)
+        return -ENOMEM;
+    f->private_data = tf;
+    return 0;
+}
+
+static int tb_release(struct inode *i, struct file *f)
+{
+    kfree(f->private_data);
+    return 0;
+}
 
 static const struct file_operations tb_fops = {
     .owner          = THIS_MODULE,
@@ -843,6 +1783,15 @@ static int __init tuxbench_init(void)
     int ret;
     struct device *dev;
 
+    /* Pick the bandwidth kernels before /dev/tuxbench can be opened */
+    tb_isa = TUXBENCH_ISA_SCALAR;
+    if (boot_cpu_has(X86_FEATURE_AVX2))
+        tb_isa = TUXBENCH_ISA_AVX2;
+    if (boot_cpu_has(X86_FEATURE_AVX512F))
+        tb_isa = TUXBENCH_ISA_AVX512;
+    if (max_isa >= 0 && max_isa < tb_isa)
+        tb_isa = max_isa;
+
     ret = alloc_chrdev_region(&tb_dev, 0, 1, DEVICE_NAME);
     if (ret < 0) {
         pr_err("tuxbench: alloc_chrdev_region failed: %d\n", ret);
@@ -870,11 +1819,9 @@ static int __init tuxbench_init(void)
         goto err_class;
     }
 
-    tb_avx2 = boot_cpu_has(X86_FEATURE_AVX2);
     pr_info("tuxbench: ready at /dev/%s (major %d)\n",
             DEVICE_NAME, MAJOR(tb_dev));
-    pr_info("tuxbench: read path = %s\n",
-            tb_avx2 ? "AVX2 (8x256-bit accumulators)" : "scalar (8x64-bit accumulators)");
+    pr_info("tuxbench: bandwidth kernels = %s\n", tb_isa_name[tb_isa]);
     return 0;
 
 err_class:
@@ -2,7 +2,10 @@
 /*
  * tuxbench.h — shared ABI between the tuxbench kernel module and bench.c
  *
- * Userspace opens /dev/tuxbench and calls ioctl(fd, TUXBENCH_IOC_RUN, &req).
+ * Userspace opens /dev/tuxbench and calls ioctl(fd, TUXBENCH_IOC_RUN, &req)
+ * (TUXBENCH_IOC_RUN_V2 / TUXBENCH_IOC_LOADED / TUXBENCH_IOC_MLP for the
+ * configurable runs).
+ * TUXBENCH_IOC_RUN and struct tuxbench_req are kept as-is for old callers.
  * The kernel module runs the benchmark with guaranteed huge pages, hard CPU
  * pinning (kthread_bind), and wbinvd for full cache hierarchy flush, then
  * copies results back.
@@ -34,7 +37,157 @@ struct tuxbench_req {
     __u64 bw_copy_kbs;    /* copy  bandwidth, KB/s                */
 };
 
-#define TUXBENCH_MAGIC   'T'
-#define TUXBENCH_IOC_RUN _IOWR(TUXBENCH_MAGIC, 1, struct tuxbench_req)
+/*
+ * v2 request: caller picks the tests, sizes, CPUs and pass budget, and gets
+ * the raw per-pass samples plus summary statistics back.  The struct size
+ * is taken from the ioctl number, so a caller built against an older
+ * (shorter) or newer (longer, zero-tailed) struct still works: missing
+ * input fields read as zero and output is truncated to the caller's size.
+ */
+#define TUXBENCH_ABI_VERSION   6
+#define TUXBENCH_MAX_SAMPLES   64
+#define TUXBENCH_CPUMASK_WORDS 16           /* 1024 CPUs */
+
+/* Result slots / op bits */
+enum {
+    TUXBENCH_RES_LAT_L1,
+    TUXBENCH_RES_LAT_L2,
+    TUXBENCH_RES_LAT_L3,
+    TUXBENCH_RES_LAT_DRAM,
+    TUXBENCH_RES_BW_READ,
+    TUXBENCH_RES_BW_WRITE,
+    TUXBENCH_RES_BW_COPY,
+    TUXBENCH_NR_RES
+};
+#define TUXBENCH_OP(res)      (1U << (res))
+#define TUXBENCH_OPS_LAT      0x0fU
+#define TUXBENCH_OPS_BW       0x70U
+
+struct tuxbench_stats {
+    __u32 nsamples;                         /* valid entries in samples[]   */
+    __u32 pad;
+    __u64 min, median, p99, max, mean;      /* ps (latency) or KB/s (bw)    */
+    __u64 stddev;                           /* sample stddev, same unit     */
+    __u64 samples[TUXBENCH_MAX_SAMPLES];    /* in measurement order         */
+};
+
+struct tuxbench_req_v2 {
+    __u32 version;          /* in: caller's ABI; out: TUXBENCH_ABI_VERSION    */
+    __u32 ops;              /* TUXBENCH_OP(TUXBENCH_RES_*) mask               */
+    __s32 numa_node;        /* -1 = node of the calling CPU                   */
+    __u32 nthreads;         /* 0 = every bandwidth CPU                        */
+    __u32 min_passes;       /* 0 = 5                                          */
+    __u32 max_passes;       /* 0 = 32 latency / 64 bandwidth; ≤ MAX_SAMPLES   */
+    __u32 cv_ppm;           /* stop once stddev/mean < cv_ppm / 1e6; 0 = 1%   */
+    __u32 pad0;
+    __u64 lat_bytes[4];     /* L1/L2/L3/DRAM chain size; 0 = from topology    */
+    __u64 bw_bytes;         /* per-thread bandwidth buffer; 0 = bw_buf_mb     */
+    __u64 cpumask[TUXBENCH_CPUMASK_WORDS]; /* bandwidth CPUs; all 0 = one per
+                                              physical core on numa_node     */
+
+    /* results — filled by kernel on return */
+    __u32 threads_used;
+    __u32 pad;
+    struct tuxbench_stats res[TUXBENCH_NR_RES];
+
+    /* ABI 3 — appended, so ABI 2 callers read as zero */
+    __u32 bw_kernel;        /* in: TUXBENCH_BWK_*; out: variant that ran      */
+    __u32 pf_dist;          /* in: read prefetch bytes, 0 = none; out: used   */
+
+    /* ABI 4 */
+    __u32 bw_isa;           /* out: TUXBENCH_ISA_* of the bandwidth kernels   */
+    __u32 pad1;
+
+    /* ABI 6 */
+    __u32 lat_chain;        /* TUXBENCH_CHAIN_* of the latency chains         */
+    __u32 pad2;
+};
+
+/*
+ * Latency chain layout — same values as BENCH_CHAIN_* in bench.h.  Page-local
+ * shuffles the 64 lines of each 4 KB page and visits the pages in address
+ * order: with 4 KB mappings that is one TLB miss per 64 loads instead of
+ * nearly one per load, so random minus page-local is the page-walk share.
+ */
+#define TUXBENCH_CHAIN_RANDOM       0
+#define TUXBENCH_CHAIN_PAGE_LOCAL   1
+#define TUXBENCH_CHAIN_COUNT        2
+
+/* Write/copy store strategy — same values as BENCH_BWK_* in bench.h */
+#define TUXBENCH_BWK_DEFAULT   0    /* NT writes, rep movsb copy            */
+#define TUXBENCH_BWK_NT        1    /* NT writes and copy stores            */
+#define TUXBENCH_BWK_TEMPORAL  2    /* regular (write-allocate) stores      */
+#define TUXBENCH_BWK_ERMS      3    /* rep stosb / rep movsb                */
+#define TUXBENCH_BWK_COUNT     4
+
+/* Register width of the bandwidth kernels, widest the CPU has (max_isa param caps it) */
+#define TUXBENCH_ISA_SCALAR    0    /* 64-bit GPRs, movnti                  */
+#define TUXBENCH_ISA_AVX2      1    /* 256-bit YMM, vmovntdq                */
+#define TUXBENCH_ISA_AVX512    2    /* 512-bit ZMM, vmovntdq                */
+#define TUXBENCH_ISA_COUNT     3
+
+/*
+ * Loaded latency: one pinned thread pointer-chases a DRAM-sized chain while
+ * every other physical core streams reads (or copies) in 64 KB blocks with
+ * delay_ns of spinning between blocks.  One result pair per level; a
+ * negative delay is the idle point (chaser only).
+ */
+#define TUXBENCH_LL_MAX   16
+#define TUXBENCH_LL_READ  0
+#define TUXBENCH_LL_COPY  1
+
+struct tuxbench_loaded_req {
+    __u32 op;                         /* TUXBENCH_LL_READ / _COPY             */
+    __u32 nlevels;                    /* ≤ TUXBENCH_LL_MAX                    */
+    __s32 delay_ns[TUXBENCH_LL_MAX];  /* per level; < 0 = no load             */
+
+    /* results — filled by kernel on return */
+    __u32 load_threads;               /* bandwidth workers used               */
+    __u32 pad;
+    __u64 lat_ps[TUXBENCH_LL_MAX];    /* median chase latency, picoseconds    */
+    __u64 bw_kbs[TUXBENCH_LL_MAX];    /* injected bandwidth over the chase    */
+};
+
+/*
+ * Memory-level parallelism (ABI 6): per point, nchains independent chases
+ * over disjoint slices of a DRAM-sized buffer, interleaved one hop each per
+ * iteration so up to nchains misses can be in flight.  lat_ps is the time
+ * per iteration — the latency each chain sees; the effective latency per
+ * load is lat_ps / nchains.
+ */
+#define TUXBENCH_MLP_MAX      16
+#define TUXBENCH_MLP_CHAINS   32
+
+struct tuxbench_mlp_req {
+    __u32 chain;                      /* TUXBENCH_CHAIN_* of every chain      */
+    __u32 npoints;                    /* ≤ TUXBENCH_MLP_MAX                   */
+    __u32 nchains[TUXBENCH_MLP_MAX];  /* 1..TUXBENCH_MLP_CHAINS per point     */
+
+    /* results — filled by kernel on return */
+    __u64 bytes;                      /* whole buffer, split between chains   */
+    __u64 lat_ps[TUXBENCH_MLP_MAX];   /* median time per hop of one chain     */
+};
+
+/*
+ * Cancellation and progress (ABI 5).  A run blocked in RUN / RUN_V2 /
+ * LOADED / MLP stops between passes with -EINTR — buffers freed, no results
+ * copied out — when TUXBENCH_IOC_CANCEL is issued on the same fd from
+ * another thread, or when a signal is pending for the running thread.
+ * Cancel is sticky for the life of the fd: open a fresh one per run.
+ * TUXBENCH_IOC_PROGRESS reads the pass count of the run in flight.
+ * Older modules answer both with ENOTTY.
+ */
+struct tuxbench_progress {
+    __u32 done;     /* passes taken (early CV stops count the rest as done) */
+    __u32 total;    /* pass budget of the current run; 0 = none yet         */
+};
+
+#define TUXBENCH_MAGIC        'T'
+#define TUXBENCH_IOC_RUN      _IOWR(TUXBENCH_MAGIC, 1, struct tuxbench_req)
+#define TUXBENCH_IOC_LOADED   _IOWR(TUXBENCH_MAGIC, 2, struct tuxbench_loaded_req)
+#define TUXBENCH_IOC_RUN_V2   _IOWR(TUXBENCH_MAGIC, 3, struct tuxbench_req_v2)
+#define TUXBENCH_IOC_CANCEL   _IO(TUXBENCH_MAGIC, 4)
+#define TUXBENCH_IOC_PROGRESS _IOR(TUXBENCH_MAGIC, 5, struct tuxbench_progress)
+#define TUXBENCH_IOC_MLP      _IOWR(TUXBENCH_MAGIC, 6, struct tuxbench_mlp_req)
 
 #endif /* TUXBENCH_H */
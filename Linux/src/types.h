@@ -4,8 +4,13 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-#define MAX_CORES       16
-#define MAX_MODULES     4
+/* Capacities of the fixed-layout snapshot arrays below.  The snapshot is
+ * copied by value (sampler triple buffer, --shm export), so these stay
+ * compile-time; how many entries are live comes from topology.h and the
+ * *_count fields.  MAX_CORES covers 96-core Threadripper / 128-core EPYC
+ * sockets, MAX_MODULES 8 channels at 2 DIMMs per channel. */
+#define MAX_CORES       128
+#define MAX_MODULES     16
 #define MAX_FANS        8
 #define STR_LEN         256
 #define STR_SHORT       64
@@ -119,16 +124,55 @@ typedef struct {
     int rpm;
 } fan_reading_t;
 
+/* High-rate PM table sampling (see pm_history.c). Fields tracked per sample: */
+enum {
+    PMH_PPT,        /* W   */
+    PMH_CURRENT,    /* A   */
+    PMH_VCORE,      /* V   */
+    PMH_VID,        /* V   */
+    PMH_VSOC,       /* V   */
+    PMH_CPU_TEMP,   /* °C  */
+    PMH_CORE_CLK,   /* MHz — peak effective core clock */
+    PMH_FCLK,       /* MHz */
+    PMH_FIELD_COUNT
+};
+
+/* min/max/avg over the last window_s seconds, plus sampler health */
+typedef struct {
+    int   target_hz;        /* 0 = high-rate sampling off */
+    float window_s;
+    int   samples;          /* samples inside the window */
+    float min[PMH_FIELD_COUNT];
+    float max[PMH_FIELD_COUNT];
+    float avg[PMH_FIELD_COUNT];
+    float rate_hz;          /* achieved sample rate */
+    float jitter_ms;        /* stddev of the sample interval */
+    float max_gap_ms;       /* longest sample interval */
+    float update_hz;        /* samples that differed from the previous one —
+                             * when this is below rate_hz the SMU refresh,
+                             * not the sampler, is the limit */
+} pm_hist_stats_t;
+
+/* Hot half of the summary — everything that changes tick to tick.
+ * Filled by backend_read_dynamic(); kept separate so the per-tick path never
+ * touches the (large, effectively constant) static data. */
 typedef struct {
+    smu_metrics_t metrics;
+    fan_reading_t fans[MAX_FANS];
+    int fan_count;
+    pm_hist_stats_t pm_hist;
+} system_dynamic_t;
+
+typedef struct {
+    /* Static — filled once by backend_read_static() */
     cpu_info_t cpu;
     memory_config_t memory;
     board_info_t board;
     memory_module_t modules[MAX_MODULES];
     int module_count;
-    smu_metrics_t metrics;
     dram_timings_t dram;
-    fan_reading_t fans[MAX_FANS];
-    int fan_count;
+    /* Dynamic — refreshed every tick by backend_read_dynamic() */
+    system_dynamic_t dyn;
 } system_summary_t;
 
 #endif /* TYPES_H */
@@ -2,9 +2,15 @@
 #include "backend.h"
 #include "bench.h"
 #include "pi_bench.h"
+#include "results.h"
+#include "sampler.h"
+#include "topology.h"
+#include "profile.h"
 #include <stdio.h>
 #include <string.h>
 #include <locale.h>
+#include <math.h>
+#include <time.h>
 
 /* ── CSS theme (GitHub dark) ────────────────────────────────────────── */
 
@@ -21,6 +27,7 @@ static const char *css_data =
     ".section-title { color: #C9D1D9; font-size: 13px; font-weight: bold; }\n"
     ".label { color: #8B949E; font-size: 12px; min-height: 18px; }\n"
     ".value-highlight { color: #3FB950; font-size: 12px; min-height: 18px; }\n"
+    ".value-mono { color: #3FB950; font-family: monospace; font-size: 12px; }\n"
     ".section-box { background-color: #161B22; border-radius: 6px; padding: 6px; }\n"
     "notebook { background: transparent; }\n"
     "notebook > header { background: transparent; border-bottom: 1px solid #30363D; }\n"
@@ -74,8 +81,12 @@ static void grid_row(GtkWidget *grid, int row, const char *label_text, GtkWidget
     gtk_grid_attach(GTK_GRID(grid), *out_val, 1, row, 1, 1);
 }
 
+/* Dirty-checked: the label's own text is the cache, so an unchanged value
+ * costs a strcmp instead of a relayout. */
 static void set_label_text(GtkWidget *label, const char *text)
 {
+    const char *cur = gtk_label_get_text(GTK_LABEL(label));
+    if (cur && strcmp(cur, text) == 0) return;
     gtk_label_set_text(GTK_LABEL(label), text);
 }
 
@@ -86,7 +97,7 @@ static void set_label_fmt(GtkWidget *label, const char *fmt, ...)
     va_start(ap, fmt);
     vsnprintf(buf, sizeof(buf), fmt, ap);
     va_end(ap);
-    gtk_label_set_text(GTK_LABEL(label), buf);
+    set_label_text(label, buf);
 }
 
 static GtkWidget *make_section_box(void)
@@ -302,6 +313,21 @@ static GtkWidget *build_ram_tab(app_widgets_t *w)
 
 /* ── Build CPU tab ──────────────────────────────────────────────────── */
 
+static const int   s_pm_rates[]   = { 0, 10, 25, 50, 100 };
+static const float s_pm_windows[] = { 5.0f, 10.0f, 30.0f };
+
+/* PM sampling rate / window dropdown changed */
+static void on_pm_rate_changed(GtkDropDown *dropdown, GParamSpec *pspec, gpointer user_data)
+{
+    (void)dropdown; (void)pspec;
+    app_widgets_t *w = (app_widgets_t *)user_data;
+    guint ri = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_pm_rate));
+    guint wi = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_pm_window));
+    if (ri >= G_N_ELEMENTS(s_pm_rates))   ri = 0;
+    if (wi >= G_N_ELEMENTS(s_pm_windows)) wi = 0;
+    sampler_set_pm_rate(s_pm_rates[ri], s_pm_windows[wi]);
+}
+
 static GtkWidget *build_cpu_tab(app_widgets_t *w)
 {
     GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
@@ -324,7 +350,10 @@ static GtkWidget *build_cpu_tab(app_widgets_t *w)
         gtk_grid_set_column_spacing(GTK_GRID(g), 8);
         int r = 0;
         grid_row(g, r++, "VID:", &w->lbl_vid);
-        for (int i = 0; i < MAX_CORES; i++) {
+        /* One row per physical core of this system */
+        int rows = topology_get()->ncores;
+        if (rows > MAX_CORES) rows = MAX_CORES;
+        for (int i = 0; i < rows; i++) {
             char lbl[8];
             snprintf(lbl, sizeof(lbl), "C%d:", i);
             grid_row(g, r++, lbl, &w->lbl_core_volt[i]);
@@ -332,7 +361,7 @@ static GtkWidget *build_cpu_tab(app_widgets_t *w)
             gtk_widget_set_visible(w->lbl_core_volt[i],     FALSE);
             gtk_widget_set_visible(w->lbl_core_volt_lbl[i], FALSE);
         }
-        w->cpu_core_volt_rows = 0;
+        w->cpu_core_volt_rows = rows;
         gtk_box_append(GTK_BOX(volt_box), g);
     }
     gtk_box_append(GTK_BOX(top), volt_box);
@@ -362,18 +391,49 @@ static GtkWidget *build_cpu_tab(app_widgets_t *w)
     gtk_box_append(GTK_BOX(top), temp_box);
     gtk_box_append(GTK_BOX(vbox), top);
 
+    /* Bottom: high-rate PM sampling (min / avg / max over the window) */
+    GtkWidget *pmh_box = make_section_box();
+    {
+        GtkWidget *hdr = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+        GtkWidget *title = make_label("PM Sampling  (min / avg / max)", "section-title");
+        gtk_widget_set_hexpand(title, TRUE);
+        gtk_widget_set_valign(title, GTK_ALIGN_CENTER);
+        gtk_box_append(GTK_BOX(hdr), title);
+
+        static const char *rate_opts[]   = { "Off", "10 Hz", "25 Hz", "50 Hz", "100 Hz", NULL };
+        static const char *window_opts[] = { "5 s", "10 s", "30 s", NULL };
+        w->combo_pm_rate   = gtk_drop_down_new_from_strings(rate_opts);
+        w->combo_pm_window = gtk_drop_down_new_from_strings(window_opts);
+        g_signal_connect(w->combo_pm_rate,   "notify::selected", G_CALLBACK(on_pm_rate_changed), w);
+        g_signal_connect(w->combo_pm_window, "notify::selected", G_CALLBACK(on_pm_rate_changed), w);
+        gtk_box_append(GTK_BOX(hdr), w->combo_pm_rate);
+        gtk_box_append(GTK_BOX(hdr), w->combo_pm_window);
+        gtk_box_append(GTK_BOX(pmh_box), hdr);
+
+        GtkWidget *g = gtk_grid_new();
+        gtk_grid_set_row_spacing(GTK_GRID(g), 2);
+        gtk_grid_set_column_spacing(GTK_GRID(g), 8);
+        int r = 0;
+        grid_row(g, r++, "PPT:",      &w->lbl_pm_hist[PMH_PPT]);
+        grid_row(g, r++, "Current:",  &w->lbl_pm_hist[PMH_CURRENT]);
+        grid_row(g, r++, "Vcore:",    &w->lbl_pm_hist[PMH_VCORE]);
+        grid_row(g, r++, "VID:",      &w->lbl_pm_hist[PMH_VID]);
+        grid_row(g, r++, "VSOC:",     &w->lbl_pm_hist[PMH_VSOC]);
+        grid_row(g, r++, "CPU Temp:", &w->lbl_pm_hist[PMH_CPU_TEMP]);
+        grid_row(g, r++, "Core Clk:", &w->lbl_pm_hist[PMH_CORE_CLK]);
+        grid_row(g, r++, "FCLK:",     &w->lbl_pm_hist[PMH_FCLK]);
+        grid_row(g, r++, "Sampler:",  &w->lbl_pm_rate);
+        gtk_box_append(GTK_BOX(pmh_box), g);
+    }
+    gtk_box_append(GTK_BOX(vbox), pmh_box);
+
     return vbox;
 }
 
 /* ── Refresh data → UI ──────────────────────────────────────────────── */
 
-static void refresh_ui(app_widgets_t *w)
+static void refresh_header(app_widgets_t *w, const system_summary_t *s)
 {
-    backend_read_summary(&w->summary);
-    const system_summary_t *s = &w->summary;
-    const smu_metrics_t *m = &s->metrics;
-    const dram_timings_t *d = &s->dram;
-
     /* Header */
     set_label_text(w->lbl_cpu_name, s->cpu.processor_name[0] ? s->cpu.processor_name : s->cpu.name);
     set_label_fmt(w->lbl_codename, "%s  ·  SMU %s  ·  PM %s",
@@ -382,6 +442,8 @@ static void refresh_ui(app_widgets_t *w)
 
     /* Module dropdown — populate once */
     if (s->module_count > 0 && !w->modules_populated) {
+        /* Set first: editing the model fires notify::selected → refresh */
+        w->modules_populated = 1;
         GtkStringList *model = GTK_STRING_LIST(gtk_drop_down_get_model(GTK_DROP_DOWN(w->combo_modules)));
         /* Remove placeholder */
         guint n = g_list_model_get_n_items(G_LIST_MODEL(model));
@@ -391,9 +453,15 @@ static void refresh_ui(app_widgets_t *w)
             gtk_string_list_append(model, s->modules[i].slot_display);
         gtk_drop_down_set_selected(GTK_DROP_DOWN(w->combo_modules), 0);
         w->selected_module = 0;
-        w->modules_populated = 1;
     }
+}
 
+static void refresh_timings(app_widgets_t *w, const dram_timings_t *d, int mi);
+
+static void refresh_ram_tab(app_widgets_t *w, const system_summary_t *s)
+{
+    const smu_metrics_t *m = &s->dyn.metrics;
+    const dram_timings_t *d = &s->dram;
     int mi = w->selected_module;
 
     /* DIMM speeds */
@@ -443,6 +511,25 @@ static void refresh_ui(app_widgets_t *w)
     SET_VOLT(w->lbl_vcore,    m->vcore);
     set_label_fmt(w->lbl_ppt, "%.1fW", m->ppt_w);
 
+    /* Timings only change on an MCLK change or re-read — skip ~50 labels
+     * unless the decoded set (or the selected DIMM) differs from the last
+     * one shown */
+    if (!w->timings_shown || w->timings_shown_module != mi ||
+        memcmp(&w->timings_shown_dram, d, sizeof(*d)) != 0) {
+        refresh_timings(w, d, mi);
+        w->timings_shown_dram = *d;
+        w->timings_shown_module = mi;
+        w->timings_shown = 1;
+    }
+
+    /* Footer mem type */
+    const char *mem_str = s->memory.type == MEM_DDR5 ? "DDR5" :
+                          s->memory.type == MEM_DDR4 ? "DDR4" : "—";
+    set_label_text(w->lbl_footer_type, mem_str);
+}
+
+static void refresh_timings(app_widgets_t *w, const dram_timings_t *d, int mi)
+{
     /* Primary timings */
     set_label_fmt(w->lbl_tcl, "%u", d->tcl);
     set_label_fmt(w->lbl_trcd_rd, "%u", d->trcd_rd);
@@ -496,17 +583,17 @@ static void refresh_ui(app_widgets_t *w)
     else
         set_label_fmt(w->lbl_phy_rdl, "%u", d->phy_rdl);
     set_label_fmt(w->lbl_phy_wrd, "%u", d->phy_wrd);
+}
 
-    /* Footer mem type */
-    const char *mem_str = s->memory.type == MEM_DDR5 ? "DDR5" :
-                          s->memory.type == MEM_DDR4 ? "DDR4" : "—";
-    set_label_text(w->lbl_footer_type, mem_str);
+static void refresh_cpu_tab(app_widgets_t *w, const system_summary_t *s)
+{
+    const smu_metrics_t *m = &s->dyn.metrics;
 
     /* CPU tab — VID & per-core voltages */
     SET_VOLT(w->lbl_vid, m->vid);
     {
-        int count = m->core_voltages_count < MAX_CORES ? m->core_voltages_count : MAX_CORES;
-        for (int i = 0; i < MAX_CORES; i++) {
+        int count = m->core_voltages_count;
+        for (int i = 0; i < w->cpu_core_volt_rows; i++) {
             gboolean vis = (i < count);
             gtk_widget_set_visible(w->lbl_core_volt[i],     vis);
             gtk_widget_set_visible(w->lbl_core_volt_lbl[i], vis);
@@ -535,40 +622,127 @@ static void refresh_ui(app_widgets_t *w)
         if (count == 0) {
             set_label_text(w->lbl_core_temps, "—");
         } else {
-            char buf[2048];
-            int  off = 0;
-            for (int i = 0; i < count; i++) {
+            /* Grouped by CCD on multi-CCD parts */
+            const topology_t *t = topology_get();
+            char buf[64 * MAX_CORES + 256];
+            int  off = 0, ccd = -1;
+            for (int i = 0; i < count && off < (int)sizeof(buf); i++) {
                 float temp  = (i < m->core_temps_count) ? m->core_temps_c[i]  : 0;
                 float usage = (i < m->core_usage_count) ? m->core_usage_pct[i]: 0;
                 float freq  = (i < m->core_freq_count)  ? m->core_freq_mhz[i] : 0;
+                if (t->nccds > 1 && i < t->ncores && t->core_ccd[i] != ccd) {
+                    ccd = t->core_ccd[i];
+                    off += snprintf(buf+off, sizeof(buf)-off, "CCD%d\n", ccd);
+                    if (off >= (int)sizeof(buf)) break;
+                }
                 off += snprintf(buf+off, sizeof(buf)-off,
                                 "C%d: %.1f\xC2\xB0""C  %.0f%%  %.0fMHz\n",
                                 i, temp, usage, freq);
             }
+            if (off >= (int)sizeof(buf)) off = (int)sizeof(buf) - 1;
             /* trim trailing newline */
             if (off > 0 && buf[off-1] == '\n') buf[off-1] = '\0';
             set_label_text(w->lbl_core_temps, buf);
         }
     }
 
+    /* CPU tab — high-rate PM sampling */
+    {
+        const pm_hist_stats_t *h = &s->dyn.pm_hist;
+        static const char *const fmt[PMH_FIELD_COUNT] = {
+            [PMH_PPT]      = "%.1f / %.1f / %.1f W",
+            [PMH_CURRENT]  = "%.1f / %.1f / %.1f A",
+            [PMH_VCORE]    = "%.4f / %.4f / %.4f V",
+            [PMH_VID]      = "%.4f / %.4f / %.4f V",
+            [PMH_VSOC]     = "%.4f / %.4f / %.4f V",
+            [PMH_CPU_TEMP] = "%.1f / %.1f / %.1f \xC2\xB0""C",
+            [PMH_CORE_CLK] = "%.0f / %.0f / %.0f MHz",
+            [PMH_FCLK]     = "%.0f / %.0f / %.0f MHz",
+        };
+        for (int f = 0; f < PMH_FIELD_COUNT; f++) {
+            if (h->target_hz > 0 && h->samples > 0)
+                set_label_fmt(w->lbl_pm_hist[f], fmt[f], h->min[f], h->avg[f], h->max[f]);
+            else
+                set_label_text(w->lbl_pm_hist[f], "—");
+        }
+        if (h->target_hz > 0)
+            set_label_fmt(w->lbl_pm_rate,
+                          "%.1f/%d Hz  jitter %.2f ms  max gap %.1f ms  SMU %.1f Hz",
+                          h->rate_hz, h->target_hz, h->jitter_ms, h->max_gap_ms, h->update_hz);
+        else
+            set_label_text(w->lbl_pm_rate, "Off");
+    }
+
     /* Fans */
     {
         char buf[1024];
         int off = 0;
-        for (int i = 0; i < s->fan_count; i++)
-            off += snprintf(buf + off, sizeof(buf) - off, "%s: %d RPM  ", s->fans[i].label, s->fans[i].rpm);
+        for (int i = 0; i < s->dyn.fan_count; i++)
+            off += snprintf(buf + off, sizeof(buf) - off, "%s: %d RPM  ",
+                            s->dyn.fans[i].label, s->dyn.fans[i].rpm);
         if (off == 0) snprintf(buf, sizeof(buf), "—");
         set_label_text(w->lbl_fans, buf);
     }
 }
 
-/* Timer callback */
-static gboolean on_refresh(gpointer user_data)
+/* Header plus the visible tab only; hidden tabs catch up on switch-page */
+static void refresh_ui(app_widgets_t *w)
 {
-    setlocale(LC_NUMERIC, "C");
+    /* Latest sampler snapshot — no backend reads on the GTK thread */
+    const system_summary_t *s = w->summary;
+    if (!s) return;
+
+    prof_tick_t tick;
+    prof_tick_begin(&tick);
+    refresh_header(w, s);
+    switch (w->current_page) {
+    case PAGE_RAM: refresh_ram_tab(w, s); break;
+    case PAGE_CPU: refresh_cpu_tab(w, s); break;
+    default:       break;   /* Benchmark tab has no live labels */
+    }
+    prof_tick_end(PROF_UI, &tick);
+}
+
+/* Notebook page about to change — refresh the incoming page right away */
+static void on_switch_page(GtkNotebook *nb, GtkWidget *page, guint page_num, gpointer user_data)
+{
+    (void)nb; (void)page;
     app_widgets_t *w = (app_widgets_t *)user_data;
+    w->current_page = (int)page_num;
+    setlocale(LC_NUMERIC, "C");
     refresh_ui(w);
-    return G_SOURCE_CONTINUE;
+}
+
+static void soak_sample(app_widgets_t *w, const system_summary_t *s);
+
+/* New sampler snapshot — runs on the main loop via g_idle_add */
+static gboolean on_snapshot(gpointer user_data)
+{
+    app_widgets_t *w = (app_widgets_t *)user_data;
+    int is_new;
+    const system_summary_t *s = sampler_acquire(&is_new);
+    if (s && is_new) {
+        setlocale(LC_NUMERIC, "C");
+        w->summary = s;
+        refresh_ui(w);
+        if (w->soak_active)
+            soak_sample(w, s);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/* Sampler-thread callback: hand the snapshot over to the main loop */
+static void notify_snapshot(void *ctx)
+{
+    g_idle_add(on_snapshot, ctx);
+}
+
+/* Re-read timings button clicked — the sampler wakes and forces an SMN read */
+static void on_timings_reread(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    (void)user_data;
+    sampler_request_timings();
 }
 
 /* Debug dump button clicked */
@@ -608,29 +782,301 @@ static void on_debug_dump(GtkButton *btn, gpointer user_data)
     gtk_window_present(GTK_WINDOW(win));
 }
 
+/* Profile window (--profile only) — the report is rebuilt once a second
+ * while the window is open */
+#define PROFILE_TEXT_CAP (16 * 1024)
+
+static gboolean profile_tick(gpointer user_data)
+{
+    GtkTextBuffer *tbuf = GTK_TEXT_BUFFER(user_data);
+    char *text = malloc(PROFILE_TEXT_CAP);
+    if (!text) return G_SOURCE_CONTINUE;
+    profile_format(text, PROFILE_TEXT_CAP);
+    gtk_text_buffer_set_text(tbuf, text, -1);
+    free(text);
+    return G_SOURCE_CONTINUE;
+}
+
+static void on_profile_destroy(GtkWidget *win, gpointer user_data)
+{
+    (void)win;
+    g_source_remove(GPOINTER_TO_UINT(user_data));
+}
+
+static void on_profile(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    GtkWidget *parent = GTK_WIDGET(user_data);
+
+    GtkWidget *win = gtk_window_new();
+    gtk_window_set_title(GTK_WINDOW(win), "Refresh Profile");
+    gtk_window_set_default_size(GTK_WINDOW(win), 760, 420);
+    gtk_window_set_transient_for(GTK_WINDOW(win), GTK_WINDOW(gtk_widget_get_root(parent)));
+    gtk_window_set_modal(GTK_WINDOW(win), FALSE);
+
+    GtkWidget *tv = gtk_text_view_new();
+    gtk_text_view_set_editable(GTK_TEXT_VIEW(tv), FALSE);
+    gtk_text_view_set_monospace(GTK_TEXT_VIEW(tv), TRUE);
+    gtk_text_view_set_left_margin(GTK_TEXT_VIEW(tv), 8);
+    gtk_text_view_set_right_margin(GTK_TEXT_VIEW(tv), 8);
+    gtk_text_view_set_top_margin(GTK_TEXT_VIEW(tv), 8);
+    GtkTextBuffer *tbuf = gtk_text_view_get_buffer(GTK_TEXT_VIEW(tv));
+    profile_tick(tbuf);
+
+    guint id = g_timeout_add_seconds(1, profile_tick, tbuf);
+    g_signal_connect(win, "destroy", G_CALLBACK(on_profile_destroy), GUINT_TO_POINTER(id));
+
+    GtkWidget *scroll = gtk_scrolled_window_new();
+    gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(scroll),
+                                   GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+    gtk_scrolled_window_set_child(GTK_SCROLLED_WINDOW(scroll), tv);
+    gtk_window_set_child(GTK_WINDOW(win), scroll);
+    gtk_window_present(GTK_WINDOW(win));
+}
+
 /* ── Benchmark tab ──────────────────────────────────────────────────── */
 
+/*
+ * The memory benchmarks would skew each other — only one runs at a time.
+ * Going busy hands out the token the run checks; Stop cancels it, and it is
+ * freed going idle again, from the run's done callback.
+ */
+static void mem_bench_set_idle(app_widgets_t *w, gboolean idle)
+{
+    gtk_widget_set_sensitive(w->btn_bench_run, idle);
+    gtk_widget_set_sensitive(w->btn_sweep_run, idle);
+    gtk_widget_set_sensitive(w->btn_loaded_run, idle);
+    gtk_widget_set_sensitive(w->btn_mlp_run, idle);
+    gtk_widget_set_sensitive(w->btn_topo_run, idle);
+    gtk_widget_set_sensitive(w->btn_bench_stop, !idle);
+
+    if (w->bench_progress_id) {
+        g_source_remove(w->bench_progress_id);
+        w->bench_progress_id = 0;
+    }
+    bench_token_free(w->bench_token);
+    w->bench_token = idle ? NULL : bench_token_new();
+}
+
+/* "Running… 42%" while a token is live; stops itself once it is gone */
+static gboolean progress_tick(GtkWidget *lbl, bench_token_t *tok)
+{
+    if (!tok) return G_SOURCE_REMOVE;
+    if (!bench_token_cancelled(tok))
+        set_label_fmt(lbl, "Running… %.0f%%", 100.0 * bench_token_progress(tok));
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean bench_progress_tick(gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    if (progress_tick(w->lbl_bench_status, w->bench_token) == G_SOURCE_REMOVE) {
+        w->bench_progress_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+/* ── Results (saved runs, baseline comparison) ──────────────────────── */
+
+static void results_text(const results_record_t *base, const results_record_t *cur,
+                         char *buf, size_t sz)
+{
+    results_diff_t d;
+    char when[32];
+    time_t t = (time_t)base->time;
+    struct tm tm;
+
+    localtime_r(&t, &tm);
+    strftime(when, sizeof(when), "%Y-%m-%d %H:%M", &tm);
+    results_diff(base, cur, &d);
+
+    int off = snprintf(buf, sz, "Baseline %s\n", when);
+    if (d.ndeltas > 0 && off < (int)sz)
+        off += snprintf(buf + off, sz - off, "%-7s %10s %10s %8s\n",
+                        "", "baseline", "now", "delta");
+    for (int i = 0; i < d.ndeltas && off < (int)sz; i++) {
+        const results_delta_t *e = &d.deltas[i];
+        int prec = e->base < 1000.0 ? 1 : 0;
+        off += snprintf(buf + off, sz - off, "%-7s %10.*f %10.*f %+7.2f%% %s\n",
+                        e->name, prec, e->base, prec, e->cur, e->delta_pct,
+                        e->better > 0 ? "better" : e->better < 0 ? "worse" : "");
+    }
+    if (d.ndeltas == 0 && off < (int)sz)
+        off += snprintf(buf + off, sz - off, "No results in common yet\n");
+    for (int i = 0; i < d.nchanges && off < (int)sz; i++)
+        off += snprintf(buf + off, sz - off, "%s%s %s → %s", i ? " · " : "Changed: ",
+                        d.changes[i].name, d.changes[i].base, d.changes[i].cur);
+    if (d.nchanges == 0 && off < (int)sz)
+        snprintf(buf + off, sz - off, "Same configuration");
+}
+
+static void results_refresh(app_widgets_t *w)
+{
+    char text[4096];
+
+    gtk_widget_set_sensitive(w->btn_results_baseline,
+                             w->record.has_bench || w->record.has_pi);
+    if (!w->has_baseline) {
+        set_label_text(w->lbl_results,
+                       w->record.has_bench || w->record.has_pi
+                           ? "No baseline — set one to compare later runs"
+                           : "—");
+        return;
+    }
+    results_text(&w->baseline, &w->record, text, sizeof(text));
+    set_label_text(w->lbl_results, text);
+}
+
+/* A run finished: stamp the session record with the system it ran on,
+ * save it and compare against the baseline */
+static void results_record_run(app_widgets_t *w)
+{
+    char path[4096];
+
+    w->record.time = (long long)time(NULL);
+    if (w->summary)
+        results_snapshot(&w->record, w->summary);
+    if (results_save(&w->record, path, sizeof(path)) < 0)
+        set_label_text(w->lbl_results_status, "Could not save results");
+    else
+        set_label_fmt(w->lbl_results_status, "Saved %s", strrchr(path, '/') + 1);
+    results_refresh(w);
+}
+
+static void on_results_baseline(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    app_widgets_t *w = user_data;
+
+    w->baseline     = w->record;
+    w->has_baseline = 1;
+    set_label_text(w->lbl_results_status,
+                   results_set_baseline(&w->record) == 0 ? "Baseline set"
+                                                         : "Could not save baseline");
+    results_refresh(w);
+}
+
+static void on_results_open_done(GObject *src, GAsyncResult *res, gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    GFile *file = gtk_file_dialog_open_finish(GTK_FILE_DIALOG(src), res, NULL);
+    if (!file) return;   /* cancelled */
+
+    char *path = g_file_get_path(file);
+    results_record_t r;
+    if (path && results_read(path, &r) == 0) {
+        w->baseline     = r;
+        w->has_baseline = 1;
+        set_label_fmt(w->lbl_results_status, "Comparing with %s", strrchr(path, '/') + 1);
+        results_refresh(w);
+    } else {
+        set_label_text(w->lbl_results_status, "Not a TuxTimings results file");
+    }
+    g_free(path);
+    g_object_unref(file);
+}
+
+/* Compare against any saved run for this session (baseline.json is unchanged) */
+static void on_results_open(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    app_widgets_t *w = user_data;
+    GtkFileDialog *dlg = gtk_file_dialog_new();
+    char dir[4096];
+
+    if (results_dir(dir, sizeof(dir)) == 0) {
+        strncat(dir, "/results", sizeof(dir) - strlen(dir) - 1);
+        GFile *folder = g_file_new_for_path(dir);
+        gtk_file_dialog_set_initial_folder(dlg, folder);
+        g_object_unref(folder);
+    }
+    gtk_file_dialog_open(dlg, GTK_WINDOW(w->window), NULL, on_results_open_done, w);
+    g_object_unref(dlg);
+}
+
 typedef struct {
     app_widgets_t  *w;
+    bench_config_t  cfg;
     bench_results_t results;
 } bench_job_t;
 
+/* Run modes, in combo_bench_mode order */
+static const bench_config_t bench_modes[] = {
+    { 0 },                                                    /* full suite */
+    { .ops = BENCH_OP(BENCH_LAT_DRAM) | BENCH_OP(BENCH_BW_READ),
+      .min_passes = 3, .max_passes = 5 },                     /* quick      */
+    { .min_passes = BENCH_MAX_SAMPLES,
+      .max_passes = BENCH_MAX_SAMPLES },                      /* precise    */
+};
+
+/* combo_bench_pf order; 0 = default (8 KB), -1 = no software prefetch */
+static const int bench_pf_bytes[] = { 0, -1, 2048, 32768 };
+
+/* Median in the label, distribution in its tooltip; "—" when not run */
+static void set_bench_label(GtkWidget *label, const bench_stats_t *st,
+                            double median, const char *fmt, const char *unit)
+{
+    char text[64], tip[192];
+
+    if (median <= 0.0) {
+        set_label_text(label, "—");
+        gtk_widget_set_tooltip_text(label, NULL);
+        return;
+    }
+
+    snprintf(text, sizeof(text), fmt, median);
+    set_label_fmt(label, "%s %s", text, unit);
+
+    if (st->nsamples == 0) {
+        gtk_widget_set_tooltip_text(label, "Median only (tuxbench module predates per-pass stats)");
+        return;
+    }
+    int prec = strcmp(unit, "ns") == 0 ? 1 : 0;
+    snprintf(tip, sizeof(tip),
+             "min %.*f · median %.*f · p99 %.*f · max %.*f %s\n"
+             "stddev %.*f (%.2f%%) · %d samples",
+             prec, st->min, prec, st->median, prec, st->p99, prec, st->max, unit,
+             prec, st->stddev, st->mean > 0 ? 100.0 * st->stddev / st->mean : 0.0,
+             st->nsamples);
+    gtk_widget_set_tooltip_text(label, tip);
+}
+
+static void show_bench_results(app_widgets_t *w, const bench_results_t *r)
+{
+    set_bench_label(w->lbl_bench_lat_l1,   &r->stats[BENCH_LAT_L1],   r->lat_l1_ns,    "%.1f", "ns");
+    set_bench_label(w->lbl_bench_lat_l2,   &r->stats[BENCH_LAT_L2],   r->lat_l2_ns,    "%.1f", "ns");
+    set_bench_label(w->lbl_bench_lat_l3,   &r->stats[BENCH_LAT_L3],   r->lat_l3_ns,    "%.1f", "ns");
+    set_bench_label(w->lbl_bench_lat_dram, &r->stats[BENCH_LAT_DRAM], r->lat_dram_ns,  "%.1f", "ns");
+    set_bench_label(w->lbl_bench_bw_read,  &r->stats[BENCH_BW_READ],  r->bw_read_mbs,  "%.0f", "MB/s");
+    set_bench_label(w->lbl_bench_bw_write, &r->stats[BENCH_BW_WRITE], r->bw_write_mbs, "%.0f", "MB/s");
+    set_bench_label(w->lbl_bench_bw_copy,  &r->stats[BENCH_BW_COPY],  r->bw_copy_mbs,  "%.0f", "MB/s");
+}
+
 static gboolean bench_done(gpointer data)
 {
     bench_job_t *job = data;
     app_widgets_t *w = job->w;
     bench_results_t *r = &job->results;
 
-    set_label_fmt(w->lbl_bench_lat_l1,   "%.1f ns",  r->lat_l1_ns);
-    set_label_fmt(w->lbl_bench_lat_l2,   "%.1f ns",  r->lat_l2_ns);
-    set_label_fmt(w->lbl_bench_lat_l3,   "%.1f ns",  r->lat_l3_ns);
-    set_label_fmt(w->lbl_bench_lat_dram, "%.1f ns",  r->lat_dram_ns);
-    set_label_fmt(w->lbl_bench_bw_read,  "%.0f MB/s", r->bw_read_mbs);
-    set_label_fmt(w->lbl_bench_bw_write, "%.0f MB/s", r->bw_write_mbs);
-    set_label_fmt(w->lbl_bench_bw_copy,  "%.0f MB/s", r->bw_copy_mbs);
+    if (r->cancelled) {
+        set_label_text(w->lbl_bench_status, "Cancelled");
+        mem_bench_set_idle(w, TRUE);
+        free(job);
+        return G_SOURCE_REMOVE;
+    }
 
-    set_label_text(w->lbl_bench_status, "Done");
-    gtk_widget_set_sensitive(w->btn_bench_run, TRUE);
+    show_bench_results(w, r);
+    w->record.bench     = *r;
+    w->record.has_bench = 1;
+    results_record_run(w);
+
+    char pf[24] = "no prefetch";
+    if (r->pf_dist > 0) snprintf(pf, sizeof(pf), "prefetch %d KB", r->pf_dist / 1024);
+    set_label_fmt(w->lbl_bench_status, "Done%s — %s, %s%s",
+                  r->kernel ? " (kernel)" : "", bench_bw_kernel_name(r->bw_kernel), pf,
+                  r->bw_avx512 ? ", AVX-512" : "");
+    mem_bench_set_idle(w, TRUE);
     free(job);
     return G_SOURCE_REMOVE;
 }
@@ -638,46 +1084,1066 @@ static gboolean bench_done(gpointer data)
 static gpointer bench_thread(gpointer data)
 {
     bench_job_t *job = data;
-    bench_run(&job->results);
+    bench_run_ex(&job->cfg, &job->results);
     g_idle_add(bench_done, job);
     return NULL;
 }
 
-static void on_bench_run(GtkButton *btn, gpointer user_data)
+/* ── Soak ───────────────────────────────────────────────────────────── */
+
+/* combo_bench_repeat order: run count, or minutes when negative; 1 = once */
+static const int bench_repeats[] = { 1, 5, 20, -10, -30, -60 };
+
+typedef struct {
+    app_widgets_t  *w;
+    bench_config_t  cfg;
+    int             runs;         /* 0 = until the duration is up */
+    int             duration_s;
+} soak_job_t;
+
+typedef struct {
+    app_widgets_t  *w;
+    double          t_sec;
+    int             runs, duration_s;
+    bench_results_t results;
+} soak_step_t;
+
+/* Fold one sampler snapshot into the telemetry of the run in progress */
+static void soak_sample(app_widgets_t *w, const system_summary_t *s)
+{
+    const smu_metrics_t *m = &s->dyn.metrics;
+    float spd = 0.0f;
+
+    for (int i = 0; i < m->spd_temps_count && i < MAX_MODULES; i++)
+        if (m->spd_temps_c[i] > spd) spd = m->spd_temps_c[i];
+
+    w->soak_acc.n++;
+    w->soak_acc.fclk     += m->fclk_mhz;
+    w->soak_acc.uclk     += m->uclk_mhz;
+    w->soak_acc.vsoc     += m->vsoc;
+    w->soak_acc.cpu_temp += m->has_tdie ? m->tdie_c : m->cpu_temp_c;
+    w->soak_acc.spd_temp += spd;
+    if (spd > w->soak_acc.spd_max) w->soak_acc.spd_max = spd;
+}
+
+static void soak_text(const bench_soak_t *s, char *buf, size_t sz)
+{
+    static const char *names[BENCH_NR_TESTS] = {
+        "L1", "L2", "L3", "DRAM", "Read", "Write", "Copy"
+    };
+    int off = snprintf(buf, sz, "%-6s %9s %8s %9s %8s %7s %6s\n",
+                       "", "mean", "± sd", "min/max", "per hour", "drift", "r SPD");
+
+    for (int t = 0; t < BENCH_NR_TESTS && off < (int)sz; t++) {
+        bench_soak_stat_t st;
+        bench_soak_stats(s, t, &st);
+        if (st.n == 0) continue;
+        int    lat   = t <= BENCH_LAT_DRAM;
+        int    prec  = lat ? 1 : 0;
+        double worst = lat ? st.max : st.min;
+        off += snprintf(buf + off, sz - off,
+                        "%-6s %9.*f %8.*f %9.*f %+8.*f %+6.2f%% %6.2f%s\n",
+                        names[t], prec, st.mean, prec, st.stddev, prec, worst,
+                        prec, st.slope_per_hour, st.drift_pct, st.temp_corr,
+                        st.drifting ? "  ⚠ drift" : "");
+    }
+
+    /* Telemetry: averages over the runs that captured any, SPD first → last */
+    double fclk = 0, uclk = 0, vsoc = 0, cpu = 0;
+    float  spd_first = 0, spd_last = 0, spd_peak = 0;
+    int    n = 0;
+    for (int i = 0; i < s->nruns; i++) {
+        const bench_telemetry_t *m = &s->runs[i].tele;
+        if (m->nsamples <= 0) continue;
+        fclk += m->fclk_mhz; uclk += m->uclk_mhz; vsoc += m->vsoc; cpu += m->cpu_temp_c;
+        if (n == 0) spd_first = m->spd_temp_c;
+        spd_last = m->spd_temp_c;
+        if (m->spd_temp_max_c > spd_peak) spd_peak = m->spd_temp_max_c;
+        n++;
+    }
+    if (n > 0 && off < (int)sz) {
+        off += snprintf(buf + off, sz - off,
+                        "FCLK %.0f · UCLK %.0f MHz · VSOC %.3f V · CPU %.1f °C",
+                        fclk / n, uclk / n, vsoc / n, cpu / n);
+        if (spd_peak > 0.0f && off < (int)sz)
+            snprintf(buf + off, sz - off, " · SPD %.1f → %.1f °C (peak %.1f)",
+                     spd_first, spd_last, spd_peak);
+    }
+}
+
+/* One run finished — record it with the telemetry gathered meanwhile */
+static gboolean soak_step(gpointer data)
+{
+    soak_step_t *st = data;
+    app_widgets_t *w = st->w;
+    bench_soak_t *s = &w->soak;
+
+    if (s->nruns < BENCH_SOAK_MAX_RUNS) {
+        bench_soak_run_t  *r = &s->runs[s->nruns++];
+        bench_telemetry_t *m = &r->tele;
+        int n = w->soak_acc.n;
+
+        r->t_sec = st->t_sec;
+        r->value[BENCH_LAT_L1]   = st->results.lat_l1_ns;
+        r->value[BENCH_LAT_L2]   = st->results.lat_l2_ns;
+        r->value[BENCH_LAT_L3]   = st->results.lat_l3_ns;
+        r->value[BENCH_LAT_DRAM] = st->results.lat_dram_ns;
+        r->value[BENCH_BW_READ]  = st->results.bw_read_mbs;
+        r->value[BENCH_BW_WRITE] = st->results.bw_write_mbs;
+        r->value[BENCH_BW_COPY]  = st->results.bw_copy_mbs;
+        m->nsamples = n;
+        if (n > 0) {
+            m->fclk_mhz       = (float)(w->soak_acc.fclk / n);
+            m->uclk_mhz       = (float)(w->soak_acc.uclk / n);
+            m->vsoc           = (float)(w->soak_acc.vsoc / n);
+            m->cpu_temp_c     = (float)(w->soak_acc.cpu_temp / n);
+            m->spd_temp_c     = (float)(w->soak_acc.spd_temp / n);
+            m->spd_temp_max_c = w->soak_acc.spd_max;
+        }
+    }
+    memset(&w->soak_acc, 0, sizeof(w->soak_acc));
+
+    show_bench_results(w, &st->results);
+    char text[2048];
+    soak_text(s, text, sizeof(text));
+    set_label_text(w->lbl_soak, text);
+    if (st->runs > 0)
+        set_label_fmt(w->lbl_bench_status, "Soak: run %d of %d done…", s->nruns, st->runs);
+    else
+        set_label_fmt(w->lbl_bench_status, "Soak: run %d done, %d of %d min…", s->nruns,
+                      (int)(st->t_sec / 60.0), st->duration_s / 60);
+    free(st);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean soak_done(gpointer data)
+{
+    soak_job_t *job = data;
+    app_widgets_t *w = job->w;
+    int flagged = 0;
+
+    for (int t = 0; t < BENCH_NR_TESTS; t++) {
+        bench_soak_stat_t st;
+        bench_soak_stats(&w->soak, t, &st);
+        flagged += st.drifting;
+    }
+    w->soak_active = 0;
+    if (bench_token_cancelled(w->bench_token))
+        set_label_fmt(w->lbl_bench_status, "Stopped — %d runs, %d test%s drifting",
+                      w->soak.nruns, flagged, flagged == 1 ? "" : "s");
+    else if (flagged)
+        set_label_fmt(w->lbl_bench_status, "Soak done — %d runs, %d test%s drifting",
+                      w->soak.nruns, flagged, flagged == 1 ? "" : "s");
+    else
+        set_label_fmt(w->lbl_bench_status, "Soak done — %d runs, no drift", w->soak.nruns);
+    gtk_widget_set_sensitive(w->btn_soak_export, w->soak.nruns > 0);
+    mem_bench_set_idle(w, TRUE);
+    free(job);
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer soak_thread(gpointer data)
+{
+    soak_job_t *job = data;
+    gint64 t0 = g_get_monotonic_time();
+
+    for (int i = 0; i < BENCH_SOAK_MAX_RUNS; i++) {
+        double el = (double)(g_get_monotonic_time() - t0) / 1e6;
+        if (bench_token_cancelled(job->cfg.token)) break;
+        if (job->runs > 0 && i >= job->runs) break;
+        if (job->duration_s > 0 && el >= job->duration_s) break;
+
+        soak_step_t *st = malloc(sizeof(*st));
+        if (!st) break;
+        st->w          = job->w;
+        st->t_sec      = el;
+        st->runs       = job->runs;
+        st->duration_s = job->duration_s;
+        bench_run_ex(&job->cfg, &st->results);
+        if (st->results.cancelled) {   /* partial run: not a soak sample */
+            free(st);
+            break;
+        }
+        g_idle_add(soak_step, st);
+    }
+    g_idle_add(soak_done, job);
+    return NULL;
+}
+
+static void on_bench_stop(GtkButton *btn, gpointer user_data)
 {
     app_widgets_t *w = user_data;
+    bench_token_cancel(w->bench_token);
     gtk_widget_set_sensitive(GTK_WIDGET(btn), FALSE);
-    set_label_text(w->lbl_bench_status, "Running…");
+    set_label_text(w->lbl_bench_status, "Stopping…");
+}
+
+static void on_soak_export_done(GObject *src, GAsyncResult *res, gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    GFile *file = gtk_file_dialog_save_finish(GTK_FILE_DIALOG(src), res, NULL);
+    if (!file) return;   /* cancelled */
+
+    char *path = g_file_get_path(file);
+    if (path && bench_soak_write_csv(&w->soak, path) == 0)
+        set_label_text(w->lbl_bench_status, "Exported soak CSV");
+    else
+        set_label_text(w->lbl_bench_status, "Export failed");
+    g_free(path);
+    g_object_unref(file);
+}
+
+static void on_soak_export(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    app_widgets_t *w = user_data;
+    GtkFileDialog *dlg = gtk_file_dialog_new();
+    gtk_file_dialog_set_initial_name(dlg, "soak.csv");
+    gtk_file_dialog_save(dlg, GTK_WINDOW(w->window), NULL, on_soak_export_done, w);
+    g_object_unref(dlg);
+}
+
+static void on_bench_run(GtkButton *btn, gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    guint sel = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_bench_mode));
+    if (sel >= G_N_ELEMENTS(bench_modes)) sel = 0;
+    guint kern = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_bench_kernel));
+    guint pf   = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_bench_pf));
+    if (kern >= BENCH_BWK_COUNT) kern = BENCH_BWK_DEFAULT;
+    if (pf >= G_N_ELEMENTS(bench_pf_bytes)) pf = 0;
+
+    guint rep = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_bench_repeat));
+    if (rep >= G_N_ELEMENTS(bench_repeats)) rep = 0;
+
+    (void)btn;
+    if (bench_repeats[rep] != 1) {
+        soak_job_t *job = malloc(sizeof(*job));
+        if (!job) return;
+        job->w          = w;
+        job->cfg        = bench_modes[sel];
+        job->cfg.bw_kernel = (int)kern;
+        job->cfg.pf_dist   = bench_pf_bytes[pf];
+        job->runs       = bench_repeats[rep] > 0 ? bench_repeats[rep] : 0;
+        job->duration_s = bench_repeats[rep] < 0 ? -bench_repeats[rep] * 60 : 0;
+
+        memset(&w->soak, 0, sizeof(w->soak));
+        memset(&w->soak_acc, 0, sizeof(w->soak_acc));
+        w->soak_active = 1;
+        mem_bench_set_idle(w, FALSE);
+        job->cfg.token = w->bench_token;
+        gtk_widget_set_sensitive(w->btn_soak_export, FALSE);
+        set_label_text(w->lbl_soak, "—");
+        set_label_text(w->lbl_bench_status, "Soak: run 1…");
+        g_thread_unref(g_thread_new("soak", soak_thread, job));
+        return;
+    }
 
     bench_job_t *job = malloc(sizeof(*job));
     if (!job) return;
-    job->w = w;
+    mem_bench_set_idle(w, FALSE);
+    set_label_text(w->lbl_bench_status, "Running…");
+    w->bench_progress_id = g_timeout_add(250, bench_progress_tick, w);
+
+    job->w   = w;
+    job->cfg = bench_modes[sel];
+    job->cfg.bw_kernel = (int)kern;
+    job->cfg.pf_dist   = bench_pf_bytes[pf];
+    job->cfg.token     = w->bench_token;
     memset(&job->results, 0, sizeof(job->results));
     g_thread_unref(g_thread_new("bench", bench_thread, job));
 }
 
+/* ── Latency sweep ──────────────────────────────────────────────────── */
+
+typedef struct {
+    app_widgets_t *w;
+    lat_sweep_t    sweep;
+    int            total;
+    int            done;     /* 0 = progress update, 1 = final */
+    size_t         max_bytes;
+    int            huge_pages;
+    int            chain;
+    bench_token_t *tok;
+} sweep_job_t;
+
+/* "4K", "256K", "16M", "2G" */
+static void fmt_size(size_t bytes, char *buf, size_t sz)
+{
+    if (bytes >= (1UL << 30))      snprintf(buf, sz, "%zuG", bytes >> 30);
+    else if (bytes >= (1UL << 20)) snprintf(buf, sz, "%zuM", bytes >> 20);
+    else                           snprintf(buf, sz, "%zuK", bytes >> 10);
+}
+
+/* Round up to 1/2/5 × 10^n for the latency axis */
+static double nice_ceil(double v)
+{
+    double step = 1.0;
+    while (step * 10.0 < v) step *= 10.0;
+    if (v <= step)       return step;
+    if (v <= step * 2.0) return step * 2.0;
+    if (v <= step * 5.0) return step * 5.0;
+    return step * 10.0;
+}
+
+/* Plot margins (px) shared by both curves */
+#define PLOT_ML 34.0
+#define PLOT_MR 6.0
+#define PLOT_MT 6.0
+#define PLOT_MB 16.0
+
+/* Horizontal grid with latency labels, 0 … ymax ns */
+static void plot_grid(cairo_t *cr, int width, int height, double ymax)
+{
+    double pw = width - PLOT_ML - PLOT_MR, ph = height - PLOT_MT - PLOT_MB;
+
+    cairo_set_font_size(cr, 9.0);
+    cairo_set_line_width(cr, 1.0);
+    for (int i = 0; i <= 4; i++) {
+        double v = ymax * i / 4.0, y = PLOT_MT + ph - v / ymax * ph;
+        cairo_set_source_rgb(cr, 0x30 / 255.0, 0x36 / 255.0, 0x3D / 255.0);
+        cairo_move_to(cr, PLOT_ML, y);
+        cairo_line_to(cr, PLOT_ML + pw, y);
+        cairo_stroke(cr);
+        char t[16];
+        snprintf(t, sizeof(t), "%g", v);
+        cairo_set_source_rgb(cr, 0x8B / 255.0, 0x94 / 255.0, 0x9E / 255.0);
+        cairo_move_to(cr, 2, y + 3);
+        cairo_show_text(cr, t);
+    }
+}
+
+/* Polyline with point markers in the current source colour */
+static void plot_line(cairo_t *cr, const double *x, const double *y, int n)
+{
+    cairo_set_line_width(cr, 1.5);
+    cairo_move_to(cr, x[0], y[0]);
+    for (int i = 1; i < n; i++)
+        cairo_line_to(cr, x[i], y[i]);
+    cairo_stroke(cr);
+    for (int i = 0; i < n; i++) {
+        cairo_arc(cr, x[i], y[i], 1.5, 0, 2 * G_PI);
+        cairo_fill(cr);
+    }
+}
+
+static void plot_curve(cairo_t *cr, const double *x, const double *y, int n)
+{
+    if (n <= 0) return;
+    cairo_set_source_rgb(cr, 0x3F / 255.0, 0xB9 / 255.0, 0x50 / 255.0);
+    plot_line(cr, x, y, n);
+}
+
+/* Latency (linear, ns) vs working set (log2) — cache sizes as dashed markers */
+static void draw_sweep_curve(cairo_t *cr, int width, int height, const lat_sweep_t *s)
+{
+    double pw = width - PLOT_ML - PLOT_MR, ph = height - PLOT_MT - PLOT_MB;
+
+    double x0 = 12.0, x1 = 30.0;   /* 4 KB … 1 GB until there is data */
+    double ymax = 100.0;
+    if (s->count > 0) {
+        x0 = log2((double)s->bytes[0]);
+        x1 = log2((double)s->bytes[s->count - 1]);
+        if (x1 - x0 < 2.0) x1 = x0 + 2.0;
+        double mx = 0.0;
+        for (int i = 0; i < s->count; i++)
+            if (s->lat_ns[i] > mx) mx = s->lat_ns[i];
+        ymax = nice_ceil(mx * 1.05);
+    }
+#define SX(b) (PLOT_ML + (log2((double)(b)) - x0) / (x1 - x0) * pw)
+#define SY(v) (PLOT_MT + ph - (v) / ymax * ph)
+
+    plot_grid(cr, width, height, ymax);
+
+    /* Size labels every two octaves (4K, 16K, 64K, …) */
+    for (int e = (int)ceil(x0); e <= (int)floor(x1); e++) {
+        if (e % 2) continue;
+        char t[16];
+        fmt_size((size_t)1 << e, t, sizeof(t));
+        cairo_move_to(cr, SX((size_t)1 << e) - 6, height - 4);
+        cairo_show_text(cr, t);
+    }
+
+    /* L1D / L2 / L3 markers */
+    static const double dash[] = { 3.0, 3.0 };
+    cairo_set_dash(cr, dash, 2, 0);
+    cairo_set_source_rgb(cr, 0x58 / 255.0, 0xA6 / 255.0, 0xFF / 255.0);
+    for (int i = 0; i < 3; i++) {
+        size_t c = s->cache_bytes[i];
+        if (!c || log2((double)c) < x0 || log2((double)c) > x1) continue;
+        cairo_move_to(cr, SX(c), PLOT_MT);
+        cairo_line_to(cr, SX(c), PLOT_MT + ph);
+    }
+    cairo_stroke(cr);
+    cairo_set_dash(cr, NULL, 0, 0);
+
+    double px[LAT_SWEEP_MAX_POINTS], py[LAT_SWEEP_MAX_POINTS];
+    for (int i = 0; i < s->count; i++) {
+        px[i] = SX(s->bytes[i]);
+        py[i] = SY(s->lat_ns[i]);
+    }
+    plot_curve(cr, px, py, s->count);
+#undef SX
+#undef SY
+}
+
+/* Latency (ns) vs injected bandwidth (GB/s), both linear */
+static void draw_loaded_curve(cairo_t *cr, int width, int height, const loaded_lat_t *l)
+{
+    double pw = width - PLOT_ML - PLOT_MR, ph = height - PLOT_MT - PLOT_MB;
+
+    double xmax = 10.0, ymax = 100.0;
+    if (l->count > 0) {
+        double bx = 0.0, ly = 0.0;
+        for (int i = 0; i < l->count; i++) {
+            if (l->bw_mbs[i] / 1024.0 > bx) bx = l->bw_mbs[i] / 1024.0;
+            if (l->lat_ns[i] > ly)          ly = l->lat_ns[i];
+        }
+        xmax = nice_ceil(bx * 1.05 + 1.0);
+        ymax = nice_ceil(ly * 1.05);
+    }
+#define SX(g) (PLOT_ML + (g) / xmax * pw)
+#define SY(v) (PLOT_MT + ph - (v) / ymax * ph)
+
+    plot_grid(cr, width, height, ymax);
+
+    for (int i = 0; i <= 4; i++) {
+        char t[24];
+        snprintf(t, sizeof(t), i == 4 ? "%g GB/s" : "%g", xmax * i / 4.0);
+        cairo_move_to(cr, SX(xmax * i / 4.0) - (i == 4 ? 34 : 4), height - 4);
+        cairo_show_text(cr, t);
+    }
+
+    double px[LOADED_LAT_MAX_POINTS], py[LOADED_LAT_MAX_POINTS];
+    for (int i = 0; i < l->count; i++) {
+        px[i] = SX(l->bw_mbs[i] / 1024.0);
+        py[i] = SY(l->lat_ns[i]);
+    }
+    plot_curve(cr, px, py, l->count);
+#undef SX
+#undef SY
+}
+
+/* Per-chain latency (blue) and effective latency per load (green), ns,
+ * vs independent chains in flight */
+static void draw_mlp_curve(cairo_t *cr, int width, int height, const bench_mlp_t *m)
+{
+    double pw = width - PLOT_ML - PLOT_MR, ph = height - PLOT_MT - PLOT_MB;
+
+    double xmax = BENCH_MLP_MAX_CHAINS, ymax = 100.0;
+    if (m->count > 0) {
+        double ly = 0.0;
+        for (int i = 0; i < m->count; i++)
+            if (m->lat_ns[i] > ly) ly = m->lat_ns[i];
+        ymax = nice_ceil(ly * 1.05);
+    }
+#define SX(c) (PLOT_ML + ((c) - 1.0) / (xmax - 1.0) * pw)
+#define SY(v) (PLOT_MT + ph - (v) / ymax * ph)
+
+    plot_grid(cr, width, height, ymax);
+
+    static const int ticks[] = { 1, 8, 16, 24, 32 };
+    for (int i = 0; i < (int)G_N_ELEMENTS(ticks); i++) {
+        char t[24];
+        snprintf(t, sizeof(t), ticks[i] == 32 ? "%d chains" : "%d", ticks[i]);
+        cairo_move_to(cr, SX(ticks[i]) - (ticks[i] == 32 ? 40 : 3), height - 4);
+        cairo_show_text(cr, t);
+    }
+
+    double px[BENCH_MLP_MAX_POINTS], py[BENCH_MLP_MAX_POINTS];
+    if (m->count > 0) {
+        for (int i = 0; i < m->count; i++) {
+            px[i] = SX(m->chains[i]);
+            py[i] = SY(m->lat_ns[i]);
+        }
+        cairo_set_source_rgb(cr, 0x58 / 255.0, 0xA6 / 255.0, 0xFF / 255.0);
+        plot_line(cr, px, py, m->count);
+    }
+    for (int i = 0; i < m->count; i++)
+        py[i] = SY(m->eff_ns[i]);
+    plot_curve(cr, px, py, m->count);
+#undef SX
+#undef SY
+}
+
+static void draw_sweep(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data)
+{
+    (void)area;
+    app_widgets_t *w = user_data;
+    if (width - PLOT_ML - PLOT_MR <= 0 || height - PLOT_MT - PLOT_MB <= 0) return;
+
+    switch (w->plot) {
+    case PLOT_LOADED: draw_loaded_curve(cr, width, height, &w->loaded); break;
+    case PLOT_MLP:    draw_mlp_curve(cr, width, height, &w->mlp);       break;
+    default:          draw_sweep_curve(cr, width, height, &w->sweep);   break;
+    }
+}
+
+static gboolean sweep_update(gpointer data)
+{
+    sweep_job_t *job = data;
+    app_widgets_t *w = job->w;
+
+    w->sweep = job->sweep;
+    gtk_widget_queue_draw(w->area_sweep);
+
+    if (job->done) {
+        set_label_fmt(w->lbl_sweep_status, "%s — %d points",
+                      bench_token_cancelled(job->tok) ? "Cancelled" : "Done", w->sweep.count);
+        mem_bench_set_idle(w, TRUE);
+        gtk_widget_set_sensitive(w->btn_sweep_export, w->sweep.count > 0);
+    } else {
+        const lat_sweep_t *sw = &w->sweep;
+        char sz[16];
+        fmt_size(sw->bytes[sw->count - 1], sz, sizeof(sz));
+        set_label_fmt(w->lbl_sweep_status, "%d/%d  %s: %.1f ns",
+                      sw->count, job->total, sz, sw->lat_ns[sw->count - 1]);
+    }
+    free(job);
+    return G_SOURCE_REMOVE;
+}
+
+/* Bench thread → GTK thread: hand over a copy of the partial curve */
+static void sweep_progress(const lat_sweep_t *partial, int total, void *ctx)
+{
+    sweep_job_t *job = ctx;
+    sweep_job_t *p = malloc(sizeof(*p));
+    if (!p) return;
+    p->w     = job->w;
+    p->sweep = *partial;
+    p->total = total;
+    p->done  = 0;
+    g_idle_add(sweep_update, p);
+}
+
+static gpointer sweep_thread(gpointer data)
+{
+    sweep_job_t *job = data;
+    bench_latency_sweep(4096, job->max_bytes, 4, job->huge_pages, job->chain,
+                        &job->sweep, sweep_progress, job, job->tok);
+    job->done = 1;
+    g_idle_add(sweep_update, job);
+    return NULL;
+}
+
+static void on_sweep_run(GtkButton *btn, gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    static const size_t max_sizes[] = { 256UL << 20, 1UL << 30, 2UL << 30 };
+    guint sel = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_sweep_range));
+    if (sel >= G_N_ELEMENTS(max_sizes)) sel = 1;
+
+    sweep_job_t *job = malloc(sizeof(*job));
+    if (!job) return;
+    memset(job, 0, sizeof(*job));
+    job->w          = w;
+    job->max_bytes  = max_sizes[sel];
+    job->huge_pages = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_sweep_pages)) == 1;
+    job->chain      = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_sweep_chain)) == 1
+                    ? BENCH_CHAIN_PAGE_LOCAL : BENCH_CHAIN_RANDOM;
+
+    (void)btn;
+    mem_bench_set_idle(w, FALSE);
+    job->tok = w->bench_token;
+    gtk_widget_set_sensitive(w->btn_sweep_export, FALSE);
+    set_label_text(w->lbl_sweep_status, "Running…");
+    w->plot = PLOT_SWEEP;
+    memset(&w->sweep, 0, sizeof(w->sweep));
+    gtk_widget_queue_draw(w->area_sweep);
+
+    g_thread_unref(g_thread_new("sweep", sweep_thread, job));
+}
+
+typedef struct {
+    app_widgets_t *w;
+    loaded_lat_t   loaded;
+    int            total;
+    int            done;
+    int            copy_load;
+    bench_token_t *tok;
+} loaded_job_t;
+
+static gboolean loaded_update(gpointer data)
+{
+    loaded_job_t *job = data;
+    app_widgets_t *w = job->w;
+    const loaded_lat_t *l = &job->loaded;
+
+    w->loaded = *l;
+    gtk_widget_queue_draw(w->area_sweep);
+
+    if (job->done) {
+        set_label_fmt(w->lbl_sweep_status, "%s — %d loads, %d threads (%s)",
+                      bench_token_cancelled(job->tok) ? "Cancelled" : "Done",
+                      l->count, l->load_threads, l->kernel ? "kernel" : "userspace");
+        mem_bench_set_idle(w, TRUE);
+        gtk_widget_set_sensitive(w->btn_sweep_export, l->count > 0);
+    } else if (l->count > 0) {
+        int i = l->count - 1;
+        set_label_fmt(w->lbl_sweep_status, "%d/%d  %.1f GB/s: %.1f ns",
+                      l->count, job->total, l->bw_mbs[i] / 1024.0, l->lat_ns[i]);
+    }
+    free(job);
+    return G_SOURCE_REMOVE;
+}
+
+static void loaded_progress(const loaded_lat_t *partial, int total, void *ctx)
+{
+    loaded_job_t *job = ctx;
+    loaded_job_t *p = malloc(sizeof(*p));
+    if (!p) return;
+    p->w      = job->w;
+    p->loaded = *partial;
+    p->total  = total;
+    p->done   = 0;
+    g_idle_add(loaded_update, p);
+}
+
+static gpointer loaded_thread(gpointer data)
+{
+    loaded_job_t *job = data;
+    bench_loaded_latency(job->copy_load, &job->loaded, loaded_progress, job, job->tok);
+    job->done = 1;
+    g_idle_add(loaded_update, job);
+    return NULL;
+}
+
+static void on_loaded_run(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    app_widgets_t *w = user_data;
+
+    loaded_job_t *job = malloc(sizeof(*job));
+    if (!job) return;
+    memset(job, 0, sizeof(*job));
+    job->w = w;
+
+    mem_bench_set_idle(w, FALSE);
+    job->tok = w->bench_token;
+    gtk_widget_set_sensitive(w->btn_sweep_export, FALSE);
+    set_label_text(w->lbl_sweep_status, "Running loaded latency…");
+    w->plot = PLOT_LOADED;
+    memset(&w->loaded, 0, sizeof(w->loaded));
+    gtk_widget_queue_draw(w->area_sweep);
+
+    g_thread_unref(g_thread_new("loaded", loaded_thread, job));
+}
+
+typedef struct {
+    app_widgets_t *w;
+    bench_mlp_t    mlp;
+    int            total;
+    int            done;
+    int            chain;
+    bench_token_t *tok;
+} mlp_job_t;
+
+/* Point of highest overlap; -1 while there is none */
+static int mlp_peak(const bench_mlp_t *m)
+{
+    int best = -1;
+    for (int i = 0; i < m->count; i++)
+        if (best < 0 || m->mlp[i] > m->mlp[best]) best = i;
+    return best;
+}
+
+static gboolean mlp_update(gpointer data)
+{
+    mlp_job_t *job = data;
+    app_widgets_t *w = job->w;
+    const bench_mlp_t *m = &job->mlp;
+
+    w->mlp = *m;
+    gtk_widget_queue_draw(w->area_sweep);
+
+    if (job->done) {
+        int pk = mlp_peak(m);
+        if (pk >= 0)
+            set_label_fmt(w->lbl_sweep_status, "%s — MLP %.1f at %d chains, %.1f ns/load (%s)",
+                          bench_token_cancelled(job->tok) ? "Cancelled" : "Done",
+                          m->mlp[pk], m->chains[pk], m->eff_ns[pk],
+                          m->kernel ? "kernel" : "userspace");
+        else
+            set_label_text(w->lbl_sweep_status,
+                           bench_token_cancelled(job->tok) ? "Cancelled" : "MLP run failed");
+        mem_bench_set_idle(w, TRUE);
+        gtk_widget_set_sensitive(w->btn_sweep_export, m->count > 0);
+    } else if (m->count > 0) {
+        int i = m->count - 1;
+        set_label_fmt(w->lbl_sweep_status, "%d/%d  %d chains: %.1f ns, %.1f ns/load",
+                      m->count, job->total, m->chains[i], m->lat_ns[i], m->eff_ns[i]);
+    }
+    free(job);
+    return G_SOURCE_REMOVE;
+}
+
+static void mlp_progress(const bench_mlp_t *partial, int total, void *ctx)
+{
+    mlp_job_t *job = ctx;
+    mlp_job_t *p = malloc(sizeof(*p));
+    if (!p) return;
+    p->w     = job->w;
+    p->mlp   = *partial;
+    p->total = total;
+    p->done  = 0;
+    g_idle_add(mlp_update, p);
+}
+
+static gpointer mlp_thread(gpointer data)
+{
+    mlp_job_t *job = data;
+    bench_mlp(job->chain, &job->mlp, mlp_progress, job, job->tok);
+    job->done = 1;
+    g_idle_add(mlp_update, job);
+    return NULL;
+}
+
+static void on_mlp_run(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    app_widgets_t *w = user_data;
+
+    mlp_job_t *job = malloc(sizeof(*job));
+    if (!job) return;
+    memset(job, 0, sizeof(*job));
+    job->w     = w;
+    job->chain = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_sweep_chain)) == 1
+               ? BENCH_CHAIN_PAGE_LOCAL : BENCH_CHAIN_RANDOM;
+
+    mem_bench_set_idle(w, FALSE);
+    job->tok = w->bench_token;
+    gtk_widget_set_sensitive(w->btn_sweep_export, FALSE);
+    set_label_text(w->lbl_sweep_status, "Running MLP…");
+    w->plot = PLOT_MLP;
+    memset(&w->mlp, 0, sizeof(w->mlp));
+    gtk_widget_queue_draw(w->area_sweep);
+
+    g_thread_unref(g_thread_new("mlp", mlp_thread, job));
+}
+
+static void on_sweep_export_done(GObject *src, GAsyncResult *res, gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    GFile *file = gtk_file_dialog_save_finish(GTK_FILE_DIALOG(src), res, NULL);
+    if (!file) return;   /* cancelled */
+
+    char *path = g_file_get_path(file);
+    int rc = -1;
+    if (path) {
+        switch (w->plot) {
+        case PLOT_LOADED: rc = bench_loaded_write_csv(&w->loaded, path); break;
+        case PLOT_MLP:    rc = bench_mlp_write_csv(&w->mlp, path);       break;
+        default:          rc = bench_sweep_write_csv(&w->sweep, path);   break;
+        }
+    }
+    if (rc == 0)
+        set_label_text(w->lbl_sweep_status, "Exported CSV");
+    else
+        set_label_text(w->lbl_sweep_status, "Export failed");
+    g_free(path);
+    g_object_unref(file);
+}
+
+static void on_sweep_export(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    app_widgets_t *w = user_data;
+    GtkFileDialog *dlg = gtk_file_dialog_new();
+    int local = w->sweep.chain == BENCH_CHAIN_PAGE_LOCAL;
+    const char *name = w->plot == PLOT_LOADED ? "loaded-latency.csv" :
+                       w->plot == PLOT_MLP    ? "mlp.csv"            :
+                       w->sweep.huge_pages    ? (local ? "latency-2m-local.csv" : "latency-2m.csv")
+                                              : (local ? "latency-4k-local.csv" : "latency-4k.csv");
+    gtk_file_dialog_set_initial_name(dlg, name);
+    gtk_file_dialog_save(dlg, GTK_WINDOW(w->window), NULL, on_sweep_export_done, w);
+    g_object_unref(dlg);
+}
+
+/* ── Topology ───────────────────────────────────────────────────────── */
+
+typedef struct {
+    app_widgets_t *w;
+    bench_topo_t   topo;
+    int            step, total;
+    int            done;     /* 0 = progress update, 1 = final */
+    bench_token_t *tok;
+} topo_job_t;
+
+/* #3FB950 → #D29922 → #F85149 as t goes 0 → 1 */
+static void heat_rgb(cairo_t *cr, double t)
+{
+    static const double c[3][3] = {
+        { 0x3F, 0xB9, 0x50 }, { 0xD2, 0x99, 0x22 }, { 0xF8, 0x51, 0x49 },
+    };
+    if (t < 0.0) t = 0.0;
+    if (t > 1.0) t = 1.0;
+    int    i = t < 0.5 ? 0 : 1;
+    double f = t < 0.5 ? t * 2.0 : (t - 0.5) * 2.0;
+    cairo_set_source_rgb(cr, (c[i][0] + (c[i + 1][0] - c[i][0]) * f) / 255.0,
+                             (c[i][1] + (c[i + 1][1] - c[i][1]) * f) / 255.0,
+                             (c[i][2] + (c[i + 1][2] - c[i][2]) * f) / 255.0);
+}
+
+/* Smallest / largest measured core-to-core latency; both 0 if none */
+static void c2c_range(const bench_topo_t *t, double *lo, double *hi)
+{
+    *lo = *hi = 0.0;
+    for (int i = 0; i < t->ncores; i++)
+        for (int j = 0; j < t->ncores; j++) {
+            double v = t->c2c_ns[i][j];
+            if (v <= 0.0) continue;
+            if (*lo == 0.0 || v < *lo) *lo = v;
+            if (v > *hi) *hi = v;
+        }
+}
+
+/* Core-to-core heat map; thin blue lines mark L3 domain boundaries */
+static void draw_c2c(GtkDrawingArea *area, cairo_t *cr, int width, int height, gpointer user_data)
+{
+    (void)area;
+    app_widgets_t *w = user_data;
+    const bench_topo_t *t = &w->topo;
+    int n = t->ncores;
+
+    if (n < 2) return;
+
+    double lo, hi;
+    c2c_range(t, &lo, &hi);
+
+    double cell = fmin((width - PLOT_ML) / n, (height - PLOT_MT - PLOT_MB) / n);
+    if (cell < 1.0) return;
+    double x0 = PLOT_ML, y0 = PLOT_MT;
+
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            double v = t->c2c_ns[i][j];
+            if (v <= 0.0)
+                cairo_set_source_rgb(cr, 0x30 / 255.0, 0x36 / 255.0, 0x3D / 255.0);
+            else
+                heat_rgb(cr, hi > lo ? (v - lo) / (hi - lo) : 0.0);
+            cairo_rectangle(cr, x0 + j * cell, y0 + i * cell, cell - 0.5, cell - 0.5);
+            cairo_fill(cr);
+        }
+
+    /* Values inside cells when they fit, CPU numbers on the axes */
+    cairo_set_font_size(cr, 9.0);
+    if (cell >= 22.0) {
+        cairo_set_source_rgb(cr, 0x0D / 255.0, 0x11 / 255.0, 0x17 / 255.0);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++) {
+                if (t->c2c_ns[i][j] <= 0.0) continue;
+                char v[16];
+                snprintf(v, sizeof(v), "%.0f", t->c2c_ns[i][j]);
+                cairo_move_to(cr, x0 + j * cell + 2, y0 + i * cell + cell / 2 + 3);
+                cairo_show_text(cr, v);
+            }
+    }
+    int every = cell >= 12.0 ? 1 : (int)ceil(12.0 / cell);
+    cairo_set_source_rgb(cr, 0x8B / 255.0, 0x94 / 255.0, 0x9E / 255.0);
+    for (int i = 0; i < n; i += every) {
+        char c[16];
+        snprintf(c, sizeof(c), "%d", t->core_cpu[i]);
+        cairo_move_to(cr, 2, y0 + i * cell + cell / 2 + 3);
+        cairo_show_text(cr, c);
+        cairo_move_to(cr, x0 + i * cell + 1, y0 + n * cell + 11);
+        cairo_show_text(cr, c);
+    }
+
+    cairo_set_source_rgb(cr, 0x58 / 255.0, 0xA6 / 255.0, 0xFF / 255.0);
+    cairo_set_line_width(cr, 1.0);
+    for (int i = 1; i < n; i++) {
+        if (t->core_domain[i] == t->core_domain[i - 1]) continue;
+        cairo_move_to(cr, x0 + i * cell, y0);
+        cairo_line_to(cr, x0 + i * cell, y0 + n * cell);
+        cairo_move_to(cr, x0, y0 + i * cell);
+        cairo_line_to(cr, x0 + n * cell, y0 + i * cell);
+    }
+    cairo_stroke(cr);
+}
+
+/* Per-domain lines, then the node matrix when there is more than one node */
+static void topo_bw_text(const bench_topo_t *t, char *buf, size_t sz)
+{
+    size_t off = 0;
+#define APPEND(...) do { \
+        int n_ = snprintf(buf + off, sz - off, __VA_ARGS__); \
+        if (n_ > 0) off += (size_t)n_ < sz - off ? (size_t)n_ : sz - off - 1; \
+    } while (0)
+
+    buf[0] = '\0';
+    for (int d = 0; d < t->ndomains; d++) {
+        if (t->domain_bw_mbs[d] > 0)
+            APPEND("L3 #%d (CPU %d, %2d cores): %8.0f MB/s\n", d, t->domain_cpu[d],
+                   t->domain_cores[d], t->domain_bw_mbs[d]);
+        else
+            APPEND("L3 #%d (CPU %d, %2d cores):        —\n", d, t->domain_cpu[d],
+                   t->domain_cores[d]);
+    }
+    if (t->all_bw_mbs > 0)
+        APPEND("All domains:              %8.0f MB/s\n", t->all_bw_mbs);
+
+    if (t->nnodes > 1) {
+        APPEND("\nCPU node → memory node (MB/s)\n       ");
+        for (int c = 0; c < t->nnodes; c++) APPEND(" %8s%d", "N", t->node_id[c]);
+        APPEND("\n");
+        for (int r = 0; r < t->nnodes; r++) {
+            APPEND("N%-6d", t->node_id[r]);
+            for (int c = 0; c < t->nnodes; c++) APPEND(" %9.0f", t->node_bw_mbs[r][c]);
+            APPEND("\n");
+        }
+    }
+#undef APPEND
+    if (off > 0 && buf[off - 1] == '\n') buf[off - 1] = '\0';
+}
+
+static gboolean topo_update(gpointer data)
+{
+    topo_job_t *job = data;
+    app_widgets_t *w = job->w;
+    char text[2048];
+
+    w->topo = job->topo;
+    gtk_widget_queue_draw(w->area_c2c);
+    topo_bw_text(&w->topo, text, sizeof(text));
+    set_label_text(w->lbl_topo_bw, text);
+
+    if (job->done) {
+        double lo, hi;
+        c2c_range(&w->topo, &lo, &hi);
+        if (bench_token_cancelled(job->tok))
+            set_label_text(w->lbl_topo_status, "Cancelled");
+        else if (hi > 0.0)
+            set_label_fmt(w->lbl_topo_status, "Done%s — core-to-core %.0f–%.0f ns",
+                          w->topo.kernel ? " (kernel bandwidth)" : "", lo, hi);
+        else
+            set_label_fmt(w->lbl_topo_status, "Done%s — one core, no core-to-core matrix",
+                          w->topo.kernel ? " (kernel bandwidth)" : "");
+        mem_bench_set_idle(w, TRUE);
+    } else {
+        set_label_fmt(w->lbl_topo_status, "%d/%d…", job->step, job->total);
+    }
+    free(job);
+    return G_SOURCE_REMOVE;
+}
+
+/* Bench thread → GTK thread: hand over a copy of the partial results */
+static void topo_progress(const bench_topo_t *partial, int done, int total, void *ctx)
+{
+    topo_job_t *job = ctx;
+    topo_job_t *p = malloc(sizeof(*p));
+    if (!p) return;
+    p->w     = job->w;
+    p->topo  = *partial;
+    p->step  = done;
+    p->total = total;
+    p->done  = 0;
+    g_idle_add(topo_update, p);
+}
+
+static gpointer topo_thread(gpointer data)
+{
+    topo_job_t *job = data;
+    bench_topology(&job->topo, topo_progress, job, job->tok);
+    job->done = 1;
+    g_idle_add(topo_update, job);
+    return NULL;
+}
+
+static void on_topo_run(GtkButton *btn, gpointer user_data)
+{
+    (void)btn;
+    app_widgets_t *w = user_data;
+
+    topo_job_t *job = malloc(sizeof(*job));
+    if (!job) return;
+    memset(job, 0, sizeof(*job));
+    job->w = w;
+
+    mem_bench_set_idle(w, FALSE);
+    job->tok = w->bench_token;
+    set_label_text(w->lbl_topo_status, "Running…");
+    memset(&w->topo, 0, sizeof(w->topo));
+    gtk_widget_queue_draw(w->area_c2c);
+    g_thread_unref(g_thread_new("topo", topo_thread, job));
+}
+
 /* ── Pi benchmark tab ───────────────────────────────────────────────── */
 
 typedef struct {
     app_widgets_t *w;
     pi_results_t   results;
     int            n_digits;
+    int            rc;
+    bench_token_t *tok;
 } pi_job_t;
 
+static void set_label_sec(GtkWidget *lbl, double sec)
+{
+    if (sec < 1.0)
+        set_label_fmt(lbl, "%.1f ms", sec * 1000.0);
+    else
+        set_label_fmt(lbl, "%.3f s", sec);
+}
+
+static gboolean pi_progress_tick(gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    if (progress_tick(w->lbl_pi_status, w->pi_token) == G_SOURCE_REMOVE) {
+        w->pi_progress_id = 0;
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void pi_set_idle(app_widgets_t *w)
+{
+    if (w->pi_progress_id) {
+        g_source_remove(w->pi_progress_id);
+        w->pi_progress_id = 0;
+    }
+    bench_token_free(w->pi_token);
+    w->pi_token = NULL;
+    gtk_widget_set_sensitive(w->btn_pi_run, TRUE);
+    gtk_widget_set_sensitive(w->btn_pi_stop, FALSE);
+    gtk_widget_set_sensitive(w->combo_pi_digits, TRUE);
+}
+
 static gboolean pi_done(gpointer data)
 {
     pi_job_t *job = data;
     app_widgets_t *w = job->w;
     pi_results_t *r = &job->results;
 
-    if (r->time_sec < 1.0)
-        set_label_fmt(w->lbl_pi_time, "%.1f ms", r->time_sec * 1000.0);
+    if (job->rc < 0) {
+        if (r->cancelled)
+            set_label_text(w->lbl_pi_status, "Cancelled");
+        else if (r->mem_avail_kb && r->need_kb > r->mem_avail_kb)
+            set_label_fmt(w->lbl_pi_status, "Needs ~%.1f GB, %.1f GB available",
+                          r->need_kb / 1048576.0, r->mem_avail_kb / 1048576.0);
+        else
+            set_label_text(w->lbl_pi_status, "Out of memory");
+        pi_set_idle(w);
+        free(job);
+        return G_SOURCE_REMOVE;
+    }
+
+    set_label_sec(w->lbl_pi_time, r->time_sec);
+    set_label_sec(w->lbl_pi_series, r->series_sec);
+    set_label_fmt(w->lbl_pi_split, "%.2f s / %.2f s (CPU)", r->split_sec, r->merge_sec);
+    set_label_sec(w->lbl_pi_sqrt, r->sqrt_sec);
+    set_label_sec(w->lbl_pi_div, r->div_sec);
+    if (r->peak_rss_kb)
+        set_label_fmt(w->lbl_pi_rss, "%.0f MB (%.1f B/digit)", r->peak_rss_kb / 1024.0,
+                      r->peak_rss_kb * 1024.0 / r->n_digits);
     else
-        set_label_fmt(w->lbl_pi_time, "%.3f s", r->time_sec);
+        set_label_text(w->lbl_pi_rss, "N/A");
+
+    w->record.pi     = *r;
+    w->record.has_pi = 1;
+    results_record_run(w);
 
     set_label_text(w->lbl_pi_status, "Done");
-    gtk_widget_set_sensitive(w->btn_pi_run, TRUE);
-    gtk_widget_set_sensitive(w->combo_pi_digits, TRUE);
+    pi_set_idle(w);
     free(job);
     return G_SOURCE_REMOVE;
 }
@@ -685,7 +2151,7 @@ static gboolean pi_done(gpointer data)
 static gpointer pi_thread(gpointer data)
 {
     pi_job_t *job = data;
-    pi_bench_run(job->n_digits, &job->results);
+    job->rc = pi_bench_run(job->n_digits, &job->results, job->tok);
     g_idle_add(pi_done, job);
     return NULL;
 }
@@ -693,22 +2159,35 @@ static gpointer pi_thread(gpointer data)
 static void on_pi_run(GtkButton *btn, gpointer user_data)
 {
     app_widgets_t *w = user_data;
-    gtk_widget_set_sensitive(GTK_WIDGET(btn), FALSE);
-    gtk_widget_set_sensitive(w->combo_pi_digits, FALSE);
-    set_label_text(w->lbl_pi_status, "Running…");
-
-    static const int digit_counts[] = { 1000000, 10000000, 100000000, 200000000 };
+    static const int digit_counts[] = { 1000000, 10000000, 100000000, 200000000,
+                                        500000000, 1000000000 };
     guint sel = gtk_drop_down_get_selected(GTK_DROP_DOWN(w->combo_pi_digits));
     if (sel >= G_N_ELEMENTS(digit_counts)) sel = 0;
 
     pi_job_t *job = malloc(sizeof(*job));
     if (!job) return;
+    gtk_widget_set_sensitive(GTK_WIDGET(btn), FALSE);
+    gtk_widget_set_sensitive(w->btn_pi_stop, TRUE);
+    gtk_widget_set_sensitive(w->combo_pi_digits, FALSE);
+    set_label_text(w->lbl_pi_status, "Running…");
+    w->pi_token       = bench_token_new();
+    w->pi_progress_id = g_timeout_add(250, pi_progress_tick, w);
+
     job->w        = w;
     job->n_digits = digit_counts[sel];
+    job->tok      = w->pi_token;
     memset(&job->results, 0, sizeof(job->results));
     g_thread_unref(g_thread_new("pi", pi_thread, job));
 }
 
+static void on_pi_stop(GtkButton *btn, gpointer user_data)
+{
+    app_widgets_t *w = user_data;
+    bench_token_cancel(w->pi_token);
+    gtk_widget_set_sensitive(GTK_WIDGET(btn), FALSE);
+    set_label_text(w->lbl_pi_status, "Stopping…");
+}
+
 static GtkWidget *build_bench_tab(app_widgets_t *w)
 {
     GtkWidget *vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 8);
@@ -721,9 +2200,39 @@ static GtkWidget *build_bench_tab(app_widgets_t *w)
     GtkWidget *btn_row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
     w->btn_bench_run = gtk_button_new_with_label("Run Benchmark");
     g_signal_connect(w->btn_bench_run, "clicked", G_CALLBACK(on_bench_run), w);
+    static const char *mode_opts[] = {
+        "Full suite", "Quick: DRAM latency + read", "Precise (64 passes)", NULL
+    };
+    w->combo_bench_mode = gtk_drop_down_new_from_strings(mode_opts);
+    /* BENCH_BWK_* order */
+    static const char *kern_opts[] = {
+        "Default stores", "NT stores", "Regular stores", "rep movsb/stosb", NULL
+    };
+    w->combo_bench_kernel = gtk_drop_down_new_from_strings(kern_opts);
+    gtk_widget_set_tooltip_text(w->combo_bench_kernel,
+        "Write/copy store strategy — regular stores include the RFO read");
+    static const char *pf_opts[] = {
+        "Prefetch 8 KB", "No prefetch", "Prefetch 2 KB", "Prefetch 32 KB", NULL
+    };
+    w->combo_bench_pf = gtk_drop_down_new_from_strings(pf_opts);
+    /* bench_repeats order */
+    static const char *repeat_opts[] = {
+        "Once", "5 runs", "20 runs", "10 min", "30 min", "60 min", NULL
+    };
+    w->combo_bench_repeat = gtk_drop_down_new_from_strings(repeat_opts);
+    gtk_widget_set_tooltip_text(w->combo_bench_repeat,
+        "Repeat the suite, recording PM-table telemetry, and flag drift");
+    w->btn_bench_stop = gtk_button_new_with_label("Stop");
+    gtk_widget_set_sensitive(w->btn_bench_stop, FALSE);
+    g_signal_connect(w->btn_bench_stop, "clicked", G_CALLBACK(on_bench_stop), w);
     w->lbl_bench_status = make_label("Ready", "header-muted");
     gtk_widget_set_valign(w->lbl_bench_status, GTK_ALIGN_CENTER);
     gtk_box_append(GTK_BOX(btn_row), w->btn_bench_run);
+    gtk_box_append(GTK_BOX(btn_row), w->combo_bench_mode);
+    gtk_box_append(GTK_BOX(btn_row), w->combo_bench_kernel);
+    gtk_box_append(GTK_BOX(btn_row), w->combo_bench_pf);
+    gtk_box_append(GTK_BOX(btn_row), w->combo_bench_repeat);
+    gtk_box_append(GTK_BOX(btn_row), w->btn_bench_stop);
     gtk_box_append(GTK_BOX(btn_row), w->lbl_bench_status);
     gtk_box_append(GTK_BOX(vbox), btn_row);
 
@@ -769,6 +2278,109 @@ static GtkWidget *build_bench_tab(app_widgets_t *w)
     gtk_box_append(GTK_BOX(cols), bw_box);
     gtk_box_append(GTK_BOX(vbox), cols);
 
+    /* ── Soak section ─────────────────────────────────────────────────── */
+    GtkWidget *soak_box = make_section_box();
+    {
+        GtkWidget *head = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+        GtkWidget *title = make_label("Soak", "section-title");
+        gtk_widget_set_hexpand(title, TRUE);
+        w->btn_soak_export = gtk_button_new_from_icon_name("document-save-symbolic");
+        gtk_widget_set_tooltip_text(w->btn_soak_export, "Export per-run CSV");
+        gtk_widget_set_sensitive(w->btn_soak_export, FALSE);
+        g_signal_connect(w->btn_soak_export, "clicked", G_CALLBACK(on_soak_export), w);
+        gtk_box_append(GTK_BOX(head), title);
+        gtk_box_append(GTK_BOX(head), w->btn_soak_export);
+        gtk_box_append(GTK_BOX(soak_box), head);
+
+        w->lbl_soak = make_label("—", "value-mono");
+        gtk_box_append(GTK_BOX(soak_box), w->lbl_soak);
+    }
+    gtk_box_append(GTK_BOX(vbox), soak_box);
+
+    /* ── Latency sweep section ────────────────────────────────────────── */
+    GtkWidget *sw_box = make_section_box();
+    {
+        GtkWidget *title = make_label("Latency Curves", "section-title");
+        gtk_box_append(GTK_BOX(sw_box), title);
+
+        /* Controls: [range] [pages] [chain] [Sweep] [Loaded] [MLP] [Export] */
+        GtkWidget *ctrl = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+        static const char *range_opts[] = { "256 MB", "1 GB", "2 GB", NULL };
+        w->combo_sweep_range = gtk_drop_down_new_from_strings(range_opts);
+        gtk_drop_down_set_selected(GTK_DROP_DOWN(w->combo_sweep_range), 1);
+        static const char *page_opts[] = { "4 KB pages", "2 MB pages", NULL };
+        w->combo_sweep_pages = gtk_drop_down_new_from_strings(page_opts);
+        static const char *chain_opts[] = { "Random", "Page-local", NULL };
+        w->combo_sweep_chain = gtk_drop_down_new_from_strings(chain_opts);
+        gtk_widget_set_tooltip_text(w->combo_sweep_chain,
+                                    "Page-local: random lines within each 4 KB page, "
+                                    "pages in order — one TLB miss per page");
+
+        w->btn_sweep_run = gtk_button_new_with_label("Sweep");
+        g_signal_connect(w->btn_sweep_run, "clicked", G_CALLBACK(on_sweep_run), w);
+        w->btn_loaded_run = gtk_button_new_with_label("Loaded");
+        gtk_widget_set_tooltip_text(w->btn_loaded_run, "DRAM latency under bandwidth load");
+        g_signal_connect(w->btn_loaded_run, "clicked", G_CALLBACK(on_loaded_run), w);
+        w->btn_mlp_run = gtk_button_new_with_label("MLP");
+        gtk_widget_set_tooltip_text(w->btn_mlp_run,
+                                    "DRAM latency with 1–32 independent chains in flight");
+        g_signal_connect(w->btn_mlp_run, "clicked", G_CALLBACK(on_mlp_run), w);
+        w->btn_sweep_export = gtk_button_new_from_icon_name("document-save-symbolic");
+        gtk_widget_set_tooltip_text(w->btn_sweep_export, "Export CSV");
+        gtk_widget_set_sensitive(w->btn_sweep_export, FALSE);
+        g_signal_connect(w->btn_sweep_export, "clicked", G_CALLBACK(on_sweep_export), w);
+
+        gtk_box_append(GTK_BOX(ctrl), w->combo_sweep_range);
+        gtk_box_append(GTK_BOX(ctrl), w->combo_sweep_pages);
+        gtk_box_append(GTK_BOX(ctrl), w->combo_sweep_chain);
+        gtk_box_append(GTK_BOX(ctrl), w->btn_sweep_run);
+        gtk_box_append(GTK_BOX(ctrl), w->btn_loaded_run);
+        gtk_box_append(GTK_BOX(ctrl), w->btn_mlp_run);
+        gtk_box_append(GTK_BOX(ctrl), w->btn_sweep_export);
+        gtk_box_append(GTK_BOX(sw_box), ctrl);
+
+        w->area_sweep = gtk_drawing_area_new();
+        gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(w->area_sweep), 150);
+        gtk_widget_set_hexpand(w->area_sweep, TRUE);
+        gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(w->area_sweep), draw_sweep, w, NULL);
+        gtk_box_append(GTK_BOX(sw_box), w->area_sweep);
+
+        w->lbl_sweep_status = make_label("Ready", "header-muted");
+        gtk_box_append(GTK_BOX(sw_box), w->lbl_sweep_status);
+    }
+    gtk_box_append(GTK_BOX(vbox), sw_box);
+
+    /* ── Topology section ─────────────────────────────────────────────── */
+    GtkWidget *topo_box = make_section_box();
+    {
+        GtkWidget *title = make_label("Topology", "section-title");
+        gtk_box_append(GTK_BOX(topo_box), title);
+
+        GtkWidget *ctrl = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+        w->btn_topo_run = gtk_button_new_with_label("Run Topology");
+        gtk_widget_set_tooltip_text(w->btn_topo_run,
+            "Core-to-core latency, per-L3 and per-NUMA-node bandwidth");
+        g_signal_connect(w->btn_topo_run, "clicked", G_CALLBACK(on_topo_run), w);
+        w->lbl_topo_status = make_label("Ready", "header-muted");
+        gtk_widget_set_valign(w->lbl_topo_status, GTK_ALIGN_CENTER);
+        gtk_box_append(GTK_BOX(ctrl), w->btn_topo_run);
+        gtk_box_append(GTK_BOX(ctrl), w->lbl_topo_status);
+        gtk_box_append(GTK_BOX(topo_box), ctrl);
+
+        /* Bandwidth table | core-to-core heat map */
+        GtkWidget *row = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+        w->lbl_topo_bw = make_label("—", "value-mono");
+        gtk_widget_set_valign(w->lbl_topo_bw, GTK_ALIGN_START);
+        w->area_c2c = gtk_drawing_area_new();
+        gtk_drawing_area_set_content_height(GTK_DRAWING_AREA(w->area_c2c), 220);
+        gtk_widget_set_hexpand(w->area_c2c, TRUE);
+        gtk_drawing_area_set_draw_func(GTK_DRAWING_AREA(w->area_c2c), draw_c2c, w, NULL);
+        gtk_box_append(GTK_BOX(row), w->lbl_topo_bw);
+        gtk_box_append(GTK_BOX(row), w->area_c2c);
+        gtk_box_append(GTK_BOX(topo_box), row);
+    }
+    gtk_box_append(GTK_BOX(vbox), topo_box);
+
     /* ── Pi benchmark section ─────────────────────────────────────────── */
     GtkWidget *pi_box = make_section_box();
     gtk_widget_set_hexpand(pi_box, TRUE);
@@ -776,22 +2388,27 @@ static GtkWidget *build_bench_tab(app_widgets_t *w)
     GtkWidget *pi_title = make_label("Pi Computation", "section-title");
     gtk_box_append(GTK_BOX(pi_box), pi_title);
 
-    /* Controls: [digit dropdown] [Run Pi button] [status] */
+    /* Controls: [digit dropdown] [Run Pi] [Stop] [status] */
     GtkWidget *pi_ctrl = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
     gtk_widget_set_margin_top(pi_ctrl, 4);
 
-    static const char *digit_opts[] = { "1 M digits", "10 M digits", "100 M digits", "200 M digits", NULL };
+    static const char *digit_opts[] = { "1 M digits", "10 M digits", "100 M digits", "200 M digits",
+                                        "500 M digits", "1 B digits", NULL };
     w->combo_pi_digits = gtk_drop_down_new_from_strings(digit_opts);
     gtk_drop_down_set_selected(GTK_DROP_DOWN(w->combo_pi_digits), 0); /* default: 1 M */
 
     w->btn_pi_run = gtk_button_new_with_label("Run Pi");
     g_signal_connect(w->btn_pi_run, "clicked", G_CALLBACK(on_pi_run), w);
+    w->btn_pi_stop = gtk_button_new_with_label("Stop");
+    gtk_widget_set_sensitive(w->btn_pi_stop, FALSE);
+    g_signal_connect(w->btn_pi_stop, "clicked", G_CALLBACK(on_pi_stop), w);
 
     w->lbl_pi_status = make_label("Ready", "header-muted");
     gtk_widget_set_valign(w->lbl_pi_status, GTK_ALIGN_CENTER);
 
     gtk_box_append(GTK_BOX(pi_ctrl), w->combo_pi_digits);
     gtk_box_append(GTK_BOX(pi_ctrl), w->btn_pi_run);
+    gtk_box_append(GTK_BOX(pi_ctrl), w->btn_pi_stop);
     gtk_box_append(GTK_BOX(pi_ctrl), w->lbl_pi_status);
     gtk_box_append(GTK_BOX(pi_box), pi_ctrl);
 
@@ -803,11 +2420,46 @@ static GtkWidget *build_bench_tab(app_widgets_t *w)
     {
         int pr = 0;
         grid_row(pi_grid, pr++, "Time:", &w->lbl_pi_time);
+        grid_row(pi_grid, pr++, "Series:", &w->lbl_pi_series);
+        grid_row(pi_grid, pr++, "Split / merge:", &w->lbl_pi_split);
+        grid_row(pi_grid, pr++, "Sqrt:", &w->lbl_pi_sqrt);
+        grid_row(pi_grid, pr++, "Division:", &w->lbl_pi_div);
+        grid_row(pi_grid, pr++, "Peak RSS:", &w->lbl_pi_rss);
     }
     gtk_box_append(GTK_BOX(pi_box), pi_grid);
 
     gtk_box_append(GTK_BOX(vbox), pi_box);
 
+    /* ── Results section ──────────────────────────────────────────────── */
+    GtkWidget *res_box = make_section_box();
+    {
+        GtkWidget *head = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 8);
+        GtkWidget *title = make_label("Results vs Baseline", "section-title");
+        gtk_widget_set_hexpand(title, TRUE);
+        w->btn_results_baseline = gtk_button_new_with_label("Set as Baseline");
+        gtk_widget_set_tooltip_text(w->btn_results_baseline,
+            "Compare later runs against the latest results and this configuration");
+        gtk_widget_set_sensitive(w->btn_results_baseline, FALSE);
+        g_signal_connect(w->btn_results_baseline, "clicked", G_CALLBACK(on_results_baseline), w);
+        GtkWidget *btn_open = gtk_button_new_from_icon_name("document-open-symbolic");
+        gtk_widget_set_tooltip_text(btn_open, "Compare with a saved run");
+        g_signal_connect(btn_open, "clicked", G_CALLBACK(on_results_open), w);
+        gtk_box_append(GTK_BOX(head), title);
+        gtk_box_append(GTK_BOX(head), w->btn_results_baseline);
+        gtk_box_append(GTK_BOX(head), btn_open);
+        gtk_box_append(GTK_BOX(res_box), head);
+
+        w->lbl_results_status = make_label("Runs are saved to ~/.config/tuxtimings/results",
+                                           "header-muted");
+        gtk_box_append(GTK_BOX(res_box), w->lbl_results_status);
+        w->lbl_results = make_label("—", "value-mono");
+        gtk_box_append(GTK_BOX(res_box), w->lbl_results);
+    }
+    gtk_box_append(GTK_BOX(vbox), res_box);
+
+    w->has_baseline = results_load_baseline(&w->baseline) == 0;
+    results_refresh(w);
+
     return vbox;
 }
 
@@ -817,6 +2469,7 @@ static void on_module_changed(GtkDropDown *dropdown, GParamSpec *pspec, gpointer
     (void)pspec;
     app_widgets_t *w = (app_widgets_t *)user_data;
     w->selected_module = (int)gtk_drop_down_get_selected(dropdown);
+    refresh_ui(w);
 }
 
 /* ── App activate ───────────────────────────────────────────────────── */
@@ -867,10 +2520,21 @@ static void on_activate(GtkApplication *app, gpointer user_data)
     g_signal_connect(w->combo_modules, "notify::selected", G_CALLBACK(on_module_changed), w);
     gtk_box_append(GTK_BOX(header_top), w->combo_modules);
 
+    GtkWidget *btn_timings = gtk_button_new_from_icon_name("view-refresh-symbolic");
+    gtk_widget_set_tooltip_text(btn_timings, "Re-read DRAM timings");
+    g_signal_connect(btn_timings, "clicked", G_CALLBACK(on_timings_reread), NULL);
+    gtk_box_append(GTK_BOX(header_top), btn_timings);
+
     GtkWidget *btn_debug = gtk_button_new_with_label("Debug");
     g_signal_connect(btn_debug, "clicked", G_CALLBACK(on_debug_dump), w->window);
     gtk_box_append(GTK_BOX(header_top), btn_debug);
 
+    if (profile_enabled()) {
+        GtkWidget *btn_profile = gtk_button_new_with_label("Profile");
+        g_signal_connect(btn_profile, "clicked", G_CALLBACK(on_profile), w->window);
+        gtk_box_append(GTK_BOX(header_top), btn_profile);
+    }
+
     gtk_box_append(GTK_BOX(header), header_top);
 
     w->lbl_codename = make_label("", "header-muted");
@@ -899,14 +2563,14 @@ static void on_activate(GtkApplication *app, gpointer user_data)
 
     GtkWidget *bench_tab = build_bench_tab(w);
     gtk_notebook_append_page(GTK_NOTEBOOK(notebook), bench_tab, gtk_label_new("Benchmark"));
+    w->current_page = PAGE_RAM;
+    g_signal_connect(notebook, "switch-page", G_CALLBACK(on_switch_page), w);
 
     gtk_box_append(GTK_BOX(main_box), notebook);
 
-    /* Initial data load */
-    refresh_ui(w);
-
-    /* 1-second refresh timer */
-    g_timeout_add(1000, on_refresh, w);
+    /* Background sampler: static snapshot once, then a hot sample every
+     * second. Labels update as snapshots are published. */
+    sampler_start(1000, notify_snapshot, w);
 
     gtk_window_present(GTK_WINDOW(w->window));
 }
@@ -2,8 +2,16 @@
 #define UI_H
 
 #include "types.h"
+#include "bench.h"
+#include "results.h"
 #include <gtk/gtk.h>
 
+/* Notebook page order */
+enum { PAGE_RAM, PAGE_CPU, PAGE_BENCH };
+
+/* Curve shown in the Latency Curves plot */
+enum { PLOT_SWEEP, PLOT_LOADED, PLOT_MLP };
+
 /* Holds all UI label widgets for live updates. */
 typedef struct {
     GtkWidget *window;
@@ -59,9 +67,21 @@ typedef struct {
     /* CPU tab — Fans */
     GtkWidget *lbl_fans;
 
+    /* CPU tab — High-rate PM sampling */
+    GtkWidget *combo_pm_rate, *combo_pm_window;
+    GtkWidget *lbl_pm_hist[PMH_FIELD_COUNT];
+    GtkWidget *lbl_pm_rate;
+
     /* Benchmark tab — RAM */
     GtkWidget *btn_bench_run;
+    GtkWidget *combo_bench_mode;     /* full / quick / precise */
+    GtkWidget *combo_bench_kernel;   /* BENCH_BWK_* store strategy */
+    GtkWidget *combo_bench_pf;       /* prefetch distance */
+    GtkWidget *combo_bench_repeat;   /* once / ×N / for a duration */
+    GtkWidget *btn_bench_stop;       /* cancels whichever memory bench runs */
     GtkWidget *lbl_bench_status;
+    bench_token_t *bench_token;      /* memory bench in flight, NULL = idle */
+    guint      bench_progress_id;    /* lbl_bench_status percentage timer  */
     GtkWidget *lbl_bench_lat_l1;
     GtkWidget *lbl_bench_lat_l2;
     GtkWidget *lbl_bench_lat_l3;
@@ -70,16 +90,62 @@ typedef struct {
     GtkWidget *lbl_bench_bw_write;
     GtkWidget *lbl_bench_bw_copy;
 
+    /* Benchmark tab — Soak (repeated suite + telemetry) */
+    GtkWidget   *lbl_soak;
+    GtkWidget   *btn_soak_export;
+    bench_soak_t soak;              /* runs so far */
+    int          soak_active;       /* snapshots feed soak_acc */
+    struct {                        /* telemetry of the run in progress */
+        int    n;
+        double fclk, uclk, vsoc, cpu_temp, spd_temp;
+        float  spd_max;
+    } soak_acc;
+
+    /* Benchmark tab — Latency curves (sweep / loaded latency / MLP) */
+    GtkWidget *btn_sweep_run, *btn_loaded_run, *btn_mlp_run, *btn_sweep_export;
+    GtkWidget *combo_sweep_range, *combo_sweep_pages, *combo_sweep_chain;
+    GtkWidget *lbl_sweep_status;
+    GtkWidget *area_sweep;
+    int        plot;                /* PLOT_*: curve the area shows */
+    lat_sweep_t  sweep;             /* last (possibly partial) curves */
+    loaded_lat_t loaded;
+    bench_mlp_t  mlp;
+
+    /* Benchmark tab — Topology */
+    GtkWidget   *btn_topo_run;
+    GtkWidget   *lbl_topo_status;
+    GtkWidget   *lbl_topo_bw;
+    GtkWidget   *area_c2c;
+    bench_topo_t topo;              /* last (possibly partial) results */
+
     /* Benchmark tab — Pi */
-    GtkWidget *btn_pi_run;
+    GtkWidget *btn_pi_run, *btn_pi_stop;
+    bench_token_t *pi_token;        /* run in flight, NULL = idle */
+    guint      pi_progress_id;
     GtkWidget *combo_pi_digits;
     GtkWidget *lbl_pi_status;
     GtkWidget *lbl_pi_time;
+    GtkWidget *lbl_pi_series, *lbl_pi_split, *lbl_pi_sqrt, *lbl_pi_div;
+    GtkWidget *lbl_pi_rss;
+
+    /* Benchmark tab — Results (saved runs, baseline comparison) */
+    GtkWidget        *btn_results_baseline;
+    GtkWidget        *lbl_results_status;
+    GtkWidget        *lbl_results;
+    results_record_t  record;        /* this session's latest runs */
+    results_record_t  baseline;
+    int               has_baseline;
 
     /* Data */
-    system_summary_t summary;
+    const system_summary_t *summary;   /* latest sampler snapshot */
     int selected_module;
     int modules_populated;
+    int current_page;               /* PAGE_* — only this tab is refreshed */
+
+    /* Last timing set written to the labels (dirty check) */
+    dram_timings_t timings_shown_dram;
+    int timings_shown_module;
+    int timings_shown;
 } app_widgets_t;
 
 /* Build the UI and start the refresh timer. Returns the GtkApplication. */
@@ -130,7 +130,7 @@ Version: $PKG_VERSION
 Section: utils
 Priority: optional
 Architecture: amd64
-Depends: libgtk-4-1, libgmp10, policykit-1, dmidecode, kmod
+Depends: libgtk-4-1, libgmp10, policykit-1, kmod
 Recommends: dkms, linux-headers-generic
 Maintainer: Death4two <https://github.com/Death4two>
 Description: AMD Ryzen DRAM timings and CPU telemetry viewer (GTK4)
@@ -346,7 +346,7 @@ install_aod_voltages() {
 
     local DKMS_SRC="/usr/src/aod-voltages-$AOD_VER"
     mkdir -p "$DKMS_SRC"
-    cp "$AOD_SRC/dkms.conf" "$AOD_SRC/Makefile" "$AOD_SRC"/*.c "$DKMS_SRC/"
+    cp "$AOD_SRC/dkms.conf" "$AOD_SRC/Makefile" "$AOD_SRC"/*.c "$AOD_SRC"/*.h "$DKMS_SRC/"
 
     if dkms add aod-voltages/"$AOD_VER" 2>/dev/null || true; then
         if dkms build aod-voltages/"$AOD_VER" && dkms install aod-voltages/"$AOD_VER"; then